@@ -0,0 +1,109 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
+  delta="$BATS_TEST_TMPDIR"/scene.delta
+  packed="$BATS_TEST_TMPDIR"/scene.bin
+}
+
+# Normal usage
+# ------------
+
+@test "kover apply writes the scene edited by a delta" {
+  run kover apply --input "$examples_dir"/3b2a.scene \
+    --delta "$examples_dir"/3b2a.delta
+  assert_success
+  assert_output "begin scene
+  building b1 -5 -5 1 1
+  building b2 7 8 2 3
+  building b3 15 1 4 1
+  building b4 30 30 2 2
+  antenna a1 16 3 6
+end scene"
+}
+
+@test "kover apply writes a binary scene edited by a delta" {
+  kover pack --input "$examples_dir"/3b2a.scene --output "$packed"
+  kover apply --input "$packed" --delta "$examples_dir"/3b2a.delta \
+    --output "$packed"
+  run kover summarize --input "$packed"
+  assert_success
+  assert_output "A scene with 4 buildings and 1 antenna"
+}
+
+@test "kover apply accepts an object moved where another one was" {
+  printf 'move building b1 30 30\nadd building b4 0 0 1 1\n' > "$delta"
+  run kover apply --input "$examples_dir"/3b2a.scene --delta "$delta"
+  assert_success
+  assert_line --index 1 "  building b1 30 30 1 1"
+  assert_line --index 4 "  building b4 0 0 1 1"
+}
+
+@test "kover apply edits objects with identifiers longer than 10 characters" {
+  printf '%s\n' 'move building building_long_10 20 0' \
+    'remove antenna antenna_long_name' 'add antenna antenna_long_other 0 5 1' \
+    'add building building_long_1 30 0 1 1' > "$delta"
+  run kover apply --input "$examples_dir"/3b2a_long_ids.scene --delta "$delta"
+  assert_success
+  assert_output "begin scene
+  building building 0 0 1 1
+  building building_long_1 30 0 1 1
+  building building_long_10 20 0 1 1
+  building building_long_2 10 0 1 1
+  antenna antenna_long 5 5 1
+  antenna antenna_long_other 0 5 1
+end scene"
+}
+
+# Invalid usage
+# -------------
+
+@test "kover apply reports an error when --delta is missing" {
+  run kover apply --input "$examples_dir"/3b2a.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--delta' is mandatory"
+}
+
+@test "kover apply reports an edit making buildings overlap" {
+  printf 'remove antenna a1\nmove building b3 8 8\n' > "$delta"
+  run kover apply --input "$examples_dir"/3b2a.scene --delta "$delta"
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b2 and b3 are overlapping (line #2)"
+}
+
+@test "kover apply reports an edit giving antennas the same position" {
+  printf 'add antenna a0 16 3 1\n' > "$delta"
+  run kover apply --input "$examples_dir"/3b2a.scene --delta "$delta"
+  [ "$status" -eq 1 ]
+  assert_output "error: antennas a0 and a2 have the same position (line #1)"
+}
+
+@test "kover apply reports an unknown identifier" {
+  printf 'remove building b9\n' > "$delta"
+  run kover apply --input "$examples_dir"/3b2a.scene --delta "$delta"
+  [ "$status" -eq 1 ]
+  assert_output "error: building identifier b9 is unknown (line #1)"
+}
+
+@test "kover apply reports a non unique identifier" {
+  printf 'add building b1 40 40 1 1\n' > "$delta"
+  run kover apply --input "$examples_dir"/3b2a.scene --delta "$delta"
+  [ "$status" -eq 1 ]
+  assert_output "error: building identifier b1 is non unique (line #1)"
+}
+
+@test "kover apply reports an unrecognized edit" {
+  printf 'rename building b1 b5\n' > "$delta"
+  run kover apply --input "$examples_dir"/3b2a.scene --delta "$delta"
+  [ "$status" -eq 1 ]
+  assert_output "error: unrecognized line (line #1)"
+}
+
+@test "kover apply reports an invalid scene before the delta" {
+  run kover apply --input "$examples_dir"/2b_overlapping.invalid \
+    --delta "$examples_dir"/3b2a.delta
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b2 are overlapping"
+}
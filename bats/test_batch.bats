@@ -0,0 +1,86 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
+}
+
+# Normal usage
+# ------------
+
+@test "kover batch runs a subcommand on each file in order" {
+  run kover batch summarize "$examples_dir"/1b.scene \
+    "$examples_dir"/empty.scene "$examples_dir"/3b2a.scene
+  assert_success
+  assert_line --index 0 "==> $examples_dir/1b.scene <=="
+  assert_line --index 1 "A scene with 1 building"
+  assert_line --index 2 "==> $examples_dir/empty.scene <=="
+  assert_line --index 3 "An empty scene"
+  assert_line --index 4 "==> $examples_dir/3b2a.scene <=="
+  assert_line --index 5 "A scene with 3 buildings and 2 antennas"
+}
+
+@test "kover batch reads the files listed on stdin" {
+  run bash -c "printf '%s\n\n%s\n' '$examples_dir/1b.scene' \
+    '$examples_dir/empty.scene' | kover batch bounding-box"
+  assert_success
+  assert_line --index 0 "==> $examples_dir/1b.scene <=="
+  assert_line --index 1 "bounding box [-1, 1] x [-1, 1]"
+  assert_line --index 2 "==> $examples_dir/empty.scene <=="
+  assert_line --index 3 "undefined (empty scene)"
+}
+
+@test "kover batch keeps the order of the files on several threads" {
+  run kover batch summarize --threads 4 "$examples_dir"/1b.scene \
+    "$examples_dir"/empty.scene "$examples_dir"/3b2a.scene \
+    "$examples_dir"/1b.scene
+  assert_success
+  assert_line --index 1 "A scene with 1 building"
+  assert_line --index 3 "An empty scene"
+  assert_line --index 5 "A scene with 3 buildings and 2 antennas"
+  assert_line --index 7 "A scene with 1 building"
+}
+
+@test "kover batch passes the options to the subcommand" {
+  run kover batch place --radius 30 --step 1 "$examples_dir"/3b2a.scene
+  assert_success
+  assert_line --index 5 "  antenna a1 2 -18 30"
+}
+
+# Invalid usage
+# -------------
+
+@test "kover batch reports the invalid files without stopping" {
+  run kover batch describe "$examples_dir"/2b_overlapping.invalid \
+    "$examples_dir"/1b.scene
+  [ "$status" -eq 1 ]
+  assert_line --index 0 "==> $examples_dir/2b_overlapping.invalid <=="
+  assert_line --index 1 "error: buildings b1 and b2 are overlapping"
+  assert_line --index 2 "==> $examples_dir/1b.scene <=="
+  assert_line --index 3 "A scene with 1 building"
+}
+
+@test "kover batch reports the files that cannot be read" {
+  run kover batch summarize /nonexistent.scene
+  [ "$status" -eq 1 ]
+  assert_line --index 1 "error: cannot read file '/nonexistent.scene'"
+}
+
+@test "kover batch reports an error when the subcommand is missing" {
+  run kover batch
+  [ "$status" -eq 1 ]
+  assert_output "error: subcommand is mandatory"
+}
+
+@test "kover batch reports an error when the subcommand cannot be batched" {
+  run kover batch pack "$examples_dir"/1b.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: subcommand 'pack' cannot be run by batch"
+}
+
+@test "kover batch reports an error when --input is given" {
+  run kover batch summarize --input "$examples_dir"/1b.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--input' cannot be given to batch"
+}
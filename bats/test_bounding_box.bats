@@ -45,6 +45,47 @@ setup() {
   assert_output "bounding box [-3, 7] x [-2, 8]"
 }
 
+@test "kover bounding-box reads the scene from the file given with --input" {
+  run kover bounding-box --input "$examples_dir"/1b1a.scene
+  assert_success
+  assert_output "bounding box [-3, 7] x [-2, 8]"
+}
+
+@test "kover bounding-box runs correctly on a scene with long lines" {
+  run kover bounding-box < "$examples_dir"/1b1a_long_lines.scene
+  assert_success
+  assert_output "bounding box [-3, 7] x [-2, 8]"
+}
+
+@test "kover bounding-box does not overflow on objects reaching beyond int" {
+  run kover bounding-box < "$examples_dir"/1b1a_extreme.scene
+  assert_success
+  assert_output "bounding box [-4294967295, 4294967294] x [-4294967295, 1]"
+}
+
+@test "kover bounding-box does not overflow on a binary scene" {
+  kover pack --input "$examples_dir"/1b1a_extreme.scene \
+    --output "$BATS_TEST_TMPDIR"/scene.bin
+  run kover bounding-box --input "$BATS_TEST_TMPDIR"/scene.bin
+  assert_success
+  assert_output "bounding box [-4294967295, 4294967294] x [-4294967295, 1]"
+}
+
+@test "kover bounding-box gives the same box on a text and a binary scene" {
+  kover-gen --buildings 1003 --antennas 517 --seed 3 > "$BATS_TEST_TMPDIR"/scene
+  kover pack --input "$BATS_TEST_TMPDIR"/scene \
+    --output "$BATS_TEST_TMPDIR"/scene.bin
+  run kover bounding-box --input "$BATS_TEST_TMPDIR"/scene.bin
+  assert_success
+  assert_output "$(kover bounding-box --input "$BATS_TEST_TMPDIR"/scene)"
+}
+
+@test "kover bounding-box --no-validate skips the validation of the scene" {
+  run kover bounding-box --no-validate < "$examples_dir"/2a_same_position.invalid
+  assert_success
+  assert_output "bounding box [-2, 2] x [-2, 2]"
+}
+
 # Wrong lines
 # -----------
 
@@ -81,6 +122,18 @@ setup() {
   assert_output "error: buildings b1 and b2 are overlapping"
 }
 
+@test "kover bounding-box reports an error when a building crosses another one" {
+  run kover bounding-box < "$examples_dir"/2b_nested.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b2 are overlapping"
+}
+
+@test "kover bounding-box reports the first pair of overlapping buildings" {
+  run kover bounding-box < "$examples_dir"/3b_overlapping.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b3 are overlapping"
+}
+
 @test "kover bounding-box reports an error when a building line has a wrong number of arguments" {
   run kover bounding-box < "$examples_dir"/1b_wrong_number_of_arguments.invalid
   [ "$status" -eq 1 ]
@@ -117,6 +170,12 @@ setup() {
   assert_output 'error: invalid positive integer "-2" (line #2)'
 }
 
+@test "kover bounding-box reports an error when a building coordinate overflows" {
+  run kover bounding-box < "$examples_dir"/1b_overflow_x.invalid
+  [ "$status" -eq 1 ]
+  assert_output 'error: invalid integer "2147483648" (line #2)'
+}
+
 # Wrong antennas
 # --------------
 
@@ -126,6 +185,12 @@ setup() {
   assert_output "error: antennas a1 and a2 have the same position"
 }
 
+@test "kover bounding-box reports the first pair of antennas with the same position" {
+  run kover bounding-box < "$examples_dir"/4a_same_position.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: antennas a1 and a4 have the same position"
+}
+
 @test "kover bounding-box reports an error when an antenna line has the wrong number of arguments" {
   run kover bounding-box < "$examples_dir"/1a_wrong_number_of_arguments.invalid
   [ "$status" -eq 1 ]
@@ -155,3 +220,9 @@ setup() {
   [ "$status" -eq 1 ]
   assert_output 'error: invalid positive integer "-1" (line #2)'
 }
+
+@test "kover bounding-box reports an error when an antenna range overflows" {
+  run kover bounding-box < "$examples_dir"/1a_overflow_r.invalid
+  [ "$status" -eq 1 ]
+  assert_output 'error: invalid positive integer "99999999999" (line #2)'
+}
@@ -0,0 +1,105 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
+}
+
+# Normal usage
+# ------------
+
+@test "kover coverage runs correctly on an empty scene" {
+  run kover coverage < "$examples_dir"/empty.scene
+  assert_success
+  assert_line --index 0 "Coverage"
+  assert_line --index 1 "Uncovered buildings"
+}
+
+@test "kover coverage lists the buildings without antenna as uncovered" {
+  run kover coverage < "$examples_dir"/2b.scene
+  assert_success
+  assert_line --index 0 "Coverage"
+  assert_line --index 1 "Uncovered buildings"
+  assert_line --index 2 "  building b1"
+  assert_line --index 3 "  building b2"
+}
+
+@test "kover coverage runs correctly on a scene with 3 buildings and 2 antennas" {
+  run kover coverage < "$examples_dir"/3b2a.scene
+  assert_success
+  assert_line --index 0 "Coverage"
+  assert_line --index 1 "  building b1: partial a1"
+  assert_line --index 2 "  building b2: partial a1"
+  assert_line --index 3 "  building b3: partial a2"
+  assert_line --index 4 "Uncovered buildings"
+}
+
+@test "kover coverage distinguishes full and partial coverage" {
+  run kover coverage --input "$examples_dir"/4b3a_coverage.scene
+  assert_success
+  assert_line --index 0 "Coverage"
+  assert_line --index 1 "  building b1: full a1"
+  assert_line --index 2 "  building b2: full a2, partial a3"
+  assert_line --index 3 "  building b4: partial a3"
+  assert_line --index 4 "Uncovered buildings"
+  assert_line --index 5 "  building b3"
+}
+
+@test "kover coverage gives the same result with several threads" {
+  run kover coverage --threads 4 --input "$examples_dir"/4b3a_coverage.scene
+  assert_success
+  assert_output "$(kover coverage --input "$examples_dir"/4b3a_coverage.scene)"
+}
+
+@test "kover coverage does not count an antenna touching a building" {
+  run kover coverage < "$examples_dir"/1b1a_tangent.scene
+  assert_success
+  assert_line --index 0 "Coverage"
+  assert_line --index 1 "Uncovered buildings"
+  assert_line --index 2 "  building b1"
+}
+
+@test "kover coverage --exact prints the covered fraction of each building" {
+  run kover coverage --exact < "$examples_dir"/4b3a_coverage.scene
+  assert_success
+  assert_line --index 0 "Covered fractions"
+  assert_line --index 1 "  building b1: 1.000000"
+  assert_line --index 2 "  building b2: 1.000000"
+  assert_line --index 3 "  building b3: 0.000000"
+  assert_line --index 4 "  building b4: 0.971740"
+}
+
+@test "kover coverage --exact measures the union of several antennas" {
+  run kover coverage --exact < "$examples_dir"/1b2a_union.scene
+  assert_success
+  assert_line --index 0 "Covered fractions"
+  assert_line --index 1 "  building b1: 0.956611"
+}
+
+@test "kover coverage --exact gives the same result with several threads" {
+  run kover coverage --exact --threads 2 < "$examples_dir"/3b2a.scene
+  assert_success
+  assert_output "$(kover coverage --exact < "$examples_dir"/3b2a.scene)"
+}
+
+# Invalid scenes
+# --------------
+
+@test "kover coverage reports an error when two buildings are overlapping" {
+  run kover coverage < "$examples_dir"/2b_overlapping.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b2 are overlapping"
+}
+
+@test "kover coverage reports the first pair of overlapping buildings with several threads" {
+  run kover coverage --threads 3 < "$examples_dir"/3b_overlapping.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b3 are overlapping"
+}
+
+@test "kover coverage reports an error when two antennas have the same position" {
+  run kover coverage < "$examples_dir"/2a_same_position.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: antennas a1 and a2 have the same position"
+}
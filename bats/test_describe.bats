@@ -78,6 +78,62 @@ setup() {
   assert_line --index 2 "  antenna a1 at 2 3 with range 5"
 }
 
+@test "kover describe sorts identifiers longer than 10 characters" {
+  run kover describe < "$examples_dir"/3b2a_long_ids.scene
+  assert_success
+  assert_output "A scene with 3 buildings and 2 antennas
+  building building at 0 0 with dimensions 1 1
+  building building_long_10 at 5 0 with dimensions 1 1
+  building building_long_2 at 10 0 with dimensions 1 1
+  antenna antenna_long at 5 5 with range 1
+  antenna antenna_long_name at 0 5 with range 1"
+}
+
+@test "kover describe reads the scene from the file given with --input" {
+  run kover describe --input "$examples_dir"/1b1a.scene
+  assert_success
+  assert_line --index 0 "A scene with 1 building and 1 antenna"
+  assert_line --index 1 "  building b1 at 0 0 with dimensions 1 1"
+  assert_line --index 2 "  antenna a1 at 2 3 with range 5"
+}
+
+@test "kover describe runs correctly on a scene with long lines" {
+  run kover describe < "$examples_dir"/1b1a_long_lines.scene
+  assert_success
+  assert_line --index 0 "A scene with 1 building and 1 antenna"
+  assert_line --index 1 "  building b1 at 0 0 with dimensions 1 1"
+  assert_line --index 2 "  antenna a1 at 2 3 with range 5"
+}
+
+# Large scenes
+# ------------
+
+@test "kover describe gives the same result when a large scene is parsed on several threads" {
+  kover-gen --buildings 40000 --antennas 20000 > "$BATS_TEST_TMPDIR/l.scene"
+  expected="$(kover describe --threads 1 --input "$BATS_TEST_TMPDIR/l.scene")"
+  run kover describe --threads 4 --input "$BATS_TEST_TMPDIR/l.scene"
+  assert_success
+  assert_output "$expected"
+}
+
+@test "kover describe reports the line of an error in a large scene parsed on several threads" {
+  kover-gen --buildings 40000 --antennas 20000 |
+    sed '50000s/.*/unknown/' > "$BATS_TEST_TMPDIR/l.scene"
+  run kover describe --threads 4 --input "$BATS_TEST_TMPDIR/l.scene"
+  [ "$status" -eq 1 ]
+  assert_output "error: unrecognized line (line #50000)"
+}
+
+@test "kover describe gives the same result on long identifiers parsed on several threads" {
+  kover-gen --buildings 40000 --antennas 20000 |
+    sed 's/ \([ab]\)\([0-9]\)/ \1_long_name_\2/' > "$BATS_TEST_TMPDIR/l.scene"
+  expected="$(kover describe --threads 1 --input "$BATS_TEST_TMPDIR/l.scene")"
+  run kover describe --threads 4 --input "$BATS_TEST_TMPDIR/l.scene"
+  assert_success
+  assert_output "$expected"
+  assert_line --index 1 --regexp "^  building b_long_name_0 "
+}
+
 # Wrong lines
 # -----------
 
@@ -108,12 +164,30 @@ setup() {
   assert_output "error: building identifier b1 is non unique"
 }
 
+@test "kover describe reports an error when two buildings have same long id" {
+  run kover describe < "$examples_dir"/3b_non_unique_long_id.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: building identifier building_long_1 is non unique"
+}
+
 @test "kover describe reports an error when two buildings are overlapping" {
   run kover describe < "$examples_dir"/2b_overlapping.invalid
   [ "$status" -eq 1 ]
   assert_output "error: buildings b1 and b2 are overlapping"
 }
 
+@test "kover describe reports an error when a building crosses another one" {
+  run kover describe < "$examples_dir"/2b_nested.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b2 are overlapping"
+}
+
+@test "kover describe reports the first pair of overlapping buildings" {
+  run kover describe < "$examples_dir"/3b_overlapping.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b3 are overlapping"
+}
+
 @test "kover describe reports an error when a building line has a wrong number of arguments" {
   run kover describe < "$examples_dir"/1b_wrong_number_of_arguments.invalid
   [ "$status" -eq 1 ]
@@ -150,6 +224,12 @@ setup() {
   assert_output 'error: invalid positive integer "-2" (line #2)'
 }
 
+@test "kover describe reports an error when a building coordinate overflows" {
+  run kover describe < "$examples_dir"/1b_overflow_x.invalid
+  [ "$status" -eq 1 ]
+  assert_output 'error: invalid integer "2147483648" (line #2)'
+}
+
 # Wrong antennas
 # --------------
 
@@ -159,6 +239,12 @@ setup() {
   assert_output "error: antennas a1 and a2 have the same position"
 }
 
+@test "kover describe reports the first pair of antennas with the same position" {
+  run kover describe < "$examples_dir"/4a_same_position.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: antennas a1 and a4 have the same position"
+}
+
 @test "kover describe reports an error when an antenna line has the wrong number of arguments" {
   run kover describe < "$examples_dir"/1a_wrong_number_of_arguments.invalid
   [ "$status" -eq 1 ]
@@ -188,3 +274,9 @@ setup() {
   [ "$status" -eq 1 ]
   assert_output 'error: invalid positive integer "-1" (line #2)'
 }
+
+@test "kover describe reports an error when an antenna range overflows" {
+  run kover describe < "$examples_dir"/1a_overflow_r.invalid
+  [ "$status" -eq 1 ]
+  assert_output 'error: invalid positive integer "99999999999" (line #2)'
+}
@@ -0,0 +1,47 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+}
+
+# Normal usage
+# ------------
+
+@test "kover-gen generates a valid scene with the requested objects" {
+  kover-gen --buildings 300 --antennas 200 > "$BATS_TEST_TMPDIR/g.scene"
+  run kover summarize --input "$BATS_TEST_TMPDIR/g.scene"
+  assert_success
+  assert_output "A scene with 300 buildings and 200 antennas"
+}
+
+@test "kover-gen generates a valid clustered scene filling all the cells" {
+  kover-gen --distribution clustered --clusters 2 --density 100 \
+    --buildings 2000 --antennas 2000 --output "$BATS_TEST_TMPDIR/g.scene"
+  run kover summarize --input "$BATS_TEST_TMPDIR/g.scene"
+  assert_success
+  assert_output "A scene with 2000 buildings and 2000 antennas"
+}
+
+@test "kover-gen generates the same scene for the same seed" {
+  first="$(kover-gen --seed 3 --buildings 50 | md5sum)"
+  run bash -c "kover-gen --seed 3 --buildings 50 | md5sum"
+  assert_output "$first"
+  run bash -c "kover-gen --seed 4 --buildings 50 | md5sum"
+  refute_output "$first"
+}
+
+# Invalid usage
+# -------------
+
+@test "kover-gen reports an error when the density is out of range" {
+  run kover-gen --density 101
+  [ "$status" -eq 1 ]
+  assert_output "error: invalid argument '101' for option '--density'"
+}
+
+@test "kover-gen reports an error when the coordinates would overflow" {
+  run kover-gen --size 1000000000 --buildings 100
+  [ "$status" -eq 1 ]
+  assert_output "error: generated scene is too large"
+}
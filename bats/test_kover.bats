@@ -3,12 +3,38 @@ setup() {
   load 'bats-assert/load'
   root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
   PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
 }
 
 function filter_stderr_out {
   "$@" 2> /dev/null
 }
 
+# Measures
+# --------
+
+@test "kover --stats prints the measures on stderr only" {
+  expected="$(kover describe --input "$examples_dir"/3b2a.scene)"
+  run filter_stderr_out kover describe --stats --input "$examples_dir"/3b2a.scene
+  assert_success
+  assert_output "$expected"
+}
+
+@test "kover --stats-json prints the phases and counters as JSON" {
+  run bash -c "kover coverage --stats-json \
+    --input '$examples_dir/3b2a.scene' 2>&1 >/dev/null"
+  assert_success
+  assert_output --regexp '^\{"phases": \{"read": \{"wall_ms": [0-9.]+, '
+  assert_output --partial '"validate_buildings": {'
+  assert_output --partial '"counters": {"lines": 7, "bytes": '
+}
+
+@test "kover --stats is rejected by batch" {
+  run kover batch summarize --stats "$examples_dir"/1b.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--stats' cannot be given to batch"
+}
+
 # Wrong usage
 # -----------
 
@@ -28,3 +54,52 @@ function filter_stderr_out {
   [ "$status" -eq 1 ]
   assert_output "error: subcommand 'thing' is not recognized"
 }
+
+@test "kover with unrecognized option reports wrong usage" {
+  run kover summarize --thing
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--thing' is not recognized"
+}
+
+@test "kover with option missing its argument reports wrong usage" {
+  run kover summarize --input
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--input' requires an argument"
+}
+
+@test "kover reports an error when the input file cannot be read" {
+  run kover summarize --input /nonexistent.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: cannot read file '/nonexistent.scene'"
+}
+
+@test "kover reports an error when the number of threads is not a positive integer" {
+  run kover summarize --threads 0
+  [ "$status" -eq 1 ]
+  assert_output "error: invalid argument '0' for option '--threads'"
+}
+
+@test "kover reports an error when the threads cannot be started" {
+  run bash -c "ulimit -v 300000 && \
+    kover summarize --threads 256 --input '$examples_dir'/1b.scene"
+  [ "$status" -eq 1 ]
+  assert_output "error: cannot start thread"
+}
+
+@test "kover with an option unused by the subcommand reports wrong usage" {
+  run kover describe --output "$BATS_TEST_TMPDIR"/describe.txt
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--output' cannot be given to describe"
+  run kover summarize --k 3 --exact --radius 5 --resolution 9
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--k' cannot be given to summarize"
+  run kover describe --delta /nonexistent
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--delta' cannot be given to describe"
+}
+
+@test "kover with unrecognized subcommand ignores its options" {
+  run kover thing --threads 0
+  [ "$status" -eq 1 ]
+  assert_output "error: subcommand 'thing' is not recognized"
+}
@@ -0,0 +1,121 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  src_dir="$root_dir/src"
+  program="$BATS_TEST_TMPDIR/embed"
+  cat > "$program.c" <<'PROGRAM'
+#include <stdio.h>
+#include <string.h>
+
+#include "pool.h"
+#include "scene.h"
+#include "validation.h"
+
+int main(int argc, char* argv[]) {
+  struct ThreadPool pool;
+  struct Error error;
+  if (!create_thread_pool(&pool, 2, &error)) {
+    print_error(&error, stderr);
+    return 1;
+  }
+  for (int i = 1; i < argc; ++i) {
+    struct Scene* scene = create_scene();
+    if (load_scene_from_buffer(scene, argv[i], strlen(argv[i]), &error) &&
+        validate_scene(scene, &pool, &error)) {
+      const struct Building* building = find_building(scene, "b2");
+      printf("%u buildings, b2 %s\n", scene->num_buildings,
+             building == NULL ? "missing" : "found");
+    } else {
+      printf("%s, line %d, ids '%s' '%s'\n",
+             error.kind == ERROR_OVERLAPPING_BUILDINGS ? "overlapping"
+             : error.kind == ERROR_INVALID_INTEGER ? "integer" : "other",
+             error.line_number, error.ids[0], error.ids[1]);
+    }
+    delete_scene(scene);
+  }
+  destroy_thread_pool(&pool);
+  return 0;
+}
+PROGRAM
+}
+
+# Normal usage
+# ------------
+
+@test "libkover.a loads and queries scenes from buffers" {
+  gcc -I"$src_dir" "$program.c" "$src_dir"/libkover.a -o "$program" \
+    -pthread -lm
+  run "$program" "$(printf 'begin scene\nbuilding b1 0 0 1 1\nbuilding b2 5 0 1 1\nend scene\n')" \
+    "$(printf 'begin scene\nbuilding b1 0 0 1 1\nend scene\n')"
+  assert_success
+  assert_line --index 0 "2 buildings, b2 found"
+  assert_line --index 1 "1 buildings, b2 missing"
+}
+
+@test "libkover.so reports structured errors without exiting" {
+  gcc -I"$src_dir" "$program.c" -L"$src_dir" -l:libkover.so -o "$program" \
+    -pthread -lm
+  run env LD_LIBRARY_PATH="$src_dir" "$program" \
+    "$(printf 'begin scene\nbuilding b1 0 0 1 1\nbuilding b2 1 0 1 1\nend scene\n')" \
+    "$(printf 'begin scene\nbuilding b1 0 0 x 1\nend scene\n')" \
+    "$(printf 'begin scene\nbuilding b2 5 0 1 1\nend scene\n')"
+  assert_success
+  assert_line --index 0 "overlapping, line 0, ids 'b1' 'b2'"
+  assert_line --index 1 "integer, line 2, ids '' ''"
+  assert_line --index 2 "1 buildings, b2 found"
+}
+
+@test "libkover.a keeps reading its input when a signal interrupts it" {
+  cat > "$program.c" <<'PROGRAM'
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "input.h"
+#include "validation.h"
+
+void tick(int signal) {
+  (void)signal;
+}
+
+int main(int argc, char* argv[]) {
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = tick;
+  sigaction(SIGALRM, &action, NULL);
+  struct itimerval timer = {{0, 1000}, {0, 1000}};
+  setitimer(ITIMER_REAL, &timer, NULL);
+  struct Error error;
+  if (argc > 1) {
+    struct LineReader reader;
+    struct StringView line;
+    unsigned int num_lines = 0;
+    open_line_reader(&reader, NULL, &error);
+    while (read_next_line(&reader, &line))
+      ++num_lines;
+    printf("%u lines%s\n", num_lines, reader.has_failed ? ", failed" : "");
+    close_line_reader(&reader);
+    return 0;
+  }
+  struct Input input;
+  if (!open_stdin_input(&input, &error)) {
+    print_error(&error, stdout);
+    return 1;
+  }
+  printf("%zu bytes\n", input.size);
+  close_input(&input);
+  return 0;
+}
+PROGRAM
+  gcc -I"$src_dir" "$program.c" "$src_dir"/libkover.a -o "$program" \
+    -pthread -lm
+  run bash -c "for i in 1 2 3 4 5; do echo line; sleep 0.05; done | '$program'"
+  assert_success
+  assert_output "25 bytes"
+  run bash -c "for i in 1 2 3 4 5; do echo line; sleep 0.05; done \
+    | '$program' lines"
+  assert_success
+  assert_output "5 lines"
+}
@@ -0,0 +1,63 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
+}
+
+# Normal usage
+# ------------
+
+@test "kover nearest lists the nearest antenna of each building" {
+  run kover nearest --input "$examples_dir"/3b2a.scene
+  assert_success
+  assert_output "Nearest antennas
+  building b1: a1
+  building b2: a1
+  building b3: a2"
+}
+
+@test "kover nearest lists the k nearest antennas, the nearest first" {
+  run kover nearest --k 2 --input "$examples_dir"/4b3a_coverage.scene
+  assert_success
+  assert_output "Nearest antennas
+  building b1: a1 a3
+  building b2: a2 a3
+  building b3: a2 a3
+  building b4: a3 a1"
+}
+
+@test "kover nearest lists at most all the antennas" {
+  run kover nearest --k 10 --input "$examples_dir"/3b2a.scene
+  assert_success
+  assert_output "Nearest antennas
+  building b1: a1 a2
+  building b2: a1 a2
+  building b3: a2 a1"
+}
+
+@test "kover nearest lists no antenna in a scene without antenna" {
+  run kover nearest <<< "begin scene
+building b1 0 0 1 1
+end scene"
+  assert_success
+  assert_output "Nearest antennas
+  building b1:"
+}
+
+@test "kover nearest does not depend on the number of threads" {
+  kover-gen --buildings 2000 --antennas 500 --seed 7 > "$BATS_TEST_TMPDIR"/scene
+  run kover nearest --k 3 --threads 4 --input "$BATS_TEST_TMPDIR"/scene
+  assert_success
+  assert_output "$(kover nearest --k 3 --input "$BATS_TEST_TMPDIR"/scene)"
+}
+
+# Invalid usage
+# -------------
+
+@test "kover nearest rejects a non positive k" {
+  run kover nearest --k 0 --input "$examples_dir"/3b2a.scene
+  assert_failure
+  assert_output "error: invalid argument '0' for option '--k'"
+}
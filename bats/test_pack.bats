@@ -0,0 +1,143 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
+  packed="$BATS_TEST_TMPDIR"/scene.bin
+}
+
+# Normal usage
+# ------------
+
+@test "kover pack writes a binary scene starting with its magic number" {
+  kover pack --input "$examples_dir"/3b2a.scene --output "$packed"
+  run head -c 8 "$packed"
+  assert_output "KOVERBIN"
+}
+
+@test "kover pack writes the binary scene on stdout by default" {
+  kover pack < "$examples_dir"/3b2a.scene > "$packed"
+  run kover summarize --input "$packed"
+  assert_success
+  assert_output "A scene with 3 buildings and 2 antennas"
+}
+
+@test "kover describe runs correctly on a packed scene" {
+  kover pack --input "$examples_dir"/3b2a.scene --output "$packed"
+  run kover describe < "$packed"
+  assert_success
+  assert_line --index 0 "A scene with 3 buildings and 2 antennas"
+  assert_line --index 1 "  building b1 at 0 0 with dimensions 1 1"
+  assert_line --index 2 "  building b2 at 7 8 with dimensions 2 3"
+  assert_line --index 3 "  building b3 at 15 1 with dimensions 4 1"
+  assert_line --index 4 "  antenna a1 at 5 4 with range 6"
+  assert_line --index 5 "  antenna a2 at 16 3 with range 4"
+}
+
+@test "kover bounding-box runs correctly on a packed scene" {
+  kover pack --input "$examples_dir"/1b1a.scene --output "$packed"
+  run kover bounding-box --input "$packed"
+  assert_success
+  assert_output "bounding box [-3, 7] x [-2, 8]"
+}
+
+@test "kover summarize runs correctly on a packed empty scene" {
+  kover pack --input "$examples_dir"/empty.scene --output "$packed"
+  run kover summarize --input "$packed"
+  assert_success
+  assert_output "An empty scene"
+}
+
+@test "kover summarize reads a packed scene from a pipe" {
+  run bash -c "kover pack --input '$examples_dir'/3b2a.scene | kover summarize"
+  assert_success
+  assert_output "A scene with 3 buildings and 2 antennas"
+}
+
+@test "kover unpack writes a packed scene in the text format" {
+  kover pack --input "$examples_dir"/2b_rev.scene --output "$packed"
+  run kover unpack --input "$packed"
+  assert_success
+  assert_line --index 0 "begin scene"
+  assert_line --index 1 "  building b1 0 0 1 1"
+  assert_line --index 2 "  building b2 5 8 2 3"
+  assert_line --index 3 "end scene"
+}
+
+@test "kover unpack writes a text scene sorted by identifier" {
+  run kover unpack --input "$examples_dir"/2a_rev.scene
+  assert_success
+  assert_line --index 0 "begin scene"
+  assert_line --index 1 "  antenna a1 0 0 1"
+  assert_line --index 2 "  antenna a2 2 3 5"
+  assert_line --index 3 "end scene"
+}
+
+@test "kover unpack keeps identifiers longer than 10 characters" {
+  kover pack --input "$examples_dir"/3b2a_long_ids.scene --output "$packed"
+  run kover unpack --input "$packed"
+  assert_success
+  assert_output "begin scene
+  building building 0 0 1 1
+  building building_long_10 5 0 1 1
+  building building_long_2 10 0 1 1
+  antenna antenna_long 5 5 1
+  antenna antenna_long_name 0 5 1
+end scene"
+}
+
+# Errors
+# ------
+
+@test "kover pack reports an error when the scene is invalid" {
+  run kover pack --input "$examples_dir"/2b_overlapping.invalid \
+                 --output "$packed"
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b2 are overlapping"
+}
+
+@test "kover pack reports an error when the output cannot be written" {
+  run kover pack --input "$examples_dir"/1b.scene --output /nonexistent/x.bin
+  [ "$status" -eq 1 ]
+  assert_output "error: cannot write file '/nonexistent/x.bin'"
+}
+
+@test "kover summarize reports an error when a binary scene is truncated" {
+  kover pack --input "$examples_dir"/3b2a.scene --output "$packed"
+  head -c 50 "$packed" > "$BATS_TEST_TMPDIR"/truncated.bin
+  run kover summarize --input "$BATS_TEST_TMPDIR"/truncated.bin
+  [ "$status" -eq 1 ]
+  assert_output "error: invalid binary scene"
+}
+
+@test "kover summarize reports an error when the identifiers size wraps around" {
+  # 100000000 buildings, with an identifiers size wrapping to the file size
+  printf 'KOVERBIN\x01\x00\x00\x00\x04\x03\x02\x01\x01\x00\x00\x00\x00\xe1\xf5\x05\x00\x00\x00\x00\x00\x00\x00\x00\x08\x6c\xca\x88\xff\xff\xff\xff' \
+    > "$BATS_TEST_TMPDIR"/wrapped.bin
+  head -c 24 /dev/zero >> "$BATS_TEST_TMPDIR"/wrapped.bin
+  run kover summarize --input "$BATS_TEST_TMPDIR"/wrapped.bin
+  [ "$status" -eq 1 ]
+  assert_output "error: invalid binary scene"
+  run bash -c "kover describe < '$BATS_TEST_TMPDIR'/wrapped.bin"
+  [ "$status" -eq 1 ]
+  assert_output "error: invalid binary scene"
+}
+
+@test "kover summarize reports an error when the number of objects is too large" {
+  # 4294967295 buildings, with an identifiers size wrapping to the file size
+  printf 'KOVERBIN\x01\x00\x00\x00\x04\x03\x02\x01\x01\x00\x00\x00\xff\xff\xff\xff\x00\x00\x00\x00\x00\x00\x00\x00\x20\x00\x00\x00\xec\xff\xff\xff' \
+    > "$BATS_TEST_TMPDIR"/wrapped.bin
+  head -c 24 /dev/zero >> "$BATS_TEST_TMPDIR"/wrapped.bin
+  run timeout 10 kover summarize --input "$BATS_TEST_TMPDIR"/wrapped.bin
+  [ "$status" -eq 1 ]
+  assert_output "error: invalid binary scene"
+}
+
+@test "kover summarize reports an error when a packed scene has duplicate ids" {
+  kover pack --input "$examples_dir"/3b2a.scene --output "$packed"
+  LC_ALL=C sed 's/b2\x00/b1\x00/' "$packed" > "$BATS_TEST_TMPDIR"/duplicate.bin
+  run kover summarize --input "$BATS_TEST_TMPDIR"/duplicate.bin
+  [ "$status" -eq 1 ]
+  assert_output "error: building identifier b1 is non unique"
+}
@@ -0,0 +1,74 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
+}
+
+# Normal usage
+# ------------
+
+@test "kover place runs correctly on an empty scene" {
+  run kover place < "$examples_dir"/empty.scene
+  assert_success
+  assert_line --index 0 "begin scene"
+  assert_line --index 1 "end scene"
+}
+
+@test "kover place replaces the antennas of a scene" {
+  run kover place < "$examples_dir"/3b2a.scene
+  assert_success
+  assert_line --index 0 "begin scene"
+  assert_line --index 1 "  building b1 0 0 1 1"
+  assert_line --index 2 "  building b2 7 8 2 3"
+  assert_line --index 3 "  building b3 15 1 4 1"
+  assert_line --index 4 "  antenna a1 5 5 10"
+  assert_line --index 5 "  antenna a2 15 -5 10"
+  assert_line --index 6 "end scene"
+}
+
+@test "kover place uses the given radius and step" {
+  run kover place --radius 30 --step 1 < "$examples_dir"/3b2a.scene
+  assert_success
+  assert_line --index 4 "  antenna a1 2 -18 30"
+  assert_line --index 5 "end scene"
+}
+
+@test "kover place writes a scene whose buildings are all fully covered" {
+  run bash -c "kover place --radius 7 --step 2 < '$examples_dir'/3b2a.scene \
+    | kover coverage"
+  assert_success
+  assert_line --index 1 "  building b1: full a1"
+  assert_line --index 2 "  building b2: full a2"
+  assert_line --index 3 "  building b3: full a3, partial a2"
+  assert_line --index 4 "Uncovered buildings"
+  refute_line --index 5 --regexp "building"
+}
+
+# Invalid usage
+# -------------
+
+@test "kover place reports an error when a building cannot be covered" {
+  run kover place --radius 2 < "$examples_dir"/3b2a.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: building b2 cannot be covered by an antenna of radius 2"
+}
+
+@test "kover place reports an error when the radius is not positive" {
+  run kover place --radius 0 < "$examples_dir"/3b2a.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: invalid argument '0' for option '--radius'"
+}
+
+@test "kover place reports an error when the step is missing" {
+  run kover place --step
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--step' requires an argument"
+}
+
+@test "kover place reports an error when a building has too many sites" {
+  run timeout 10 kover place --radius 100000 --step 1 < "$examples_dir"/1b.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: building b1 has too many candidate sites for radius 100000 and step 1"
+}
@@ -0,0 +1,76 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
+  packed="$BATS_TEST_TMPDIR"/scene.bin
+}
+
+# Normal usage
+# ------------
+
+@test "kover query answers the queries of a file" {
+  run kover query --input "$examples_dir"/4b3a_coverage.scene \
+    --queries "$examples_dir"/4b3a_coverage.queries
+  assert_success
+  assert_output "antennas 10 0: a2
+buildings 10 0: b2
+window -1 -1 5 5: buildings b1 b4, antennas a1 a2 a3
+antennas 100 100:"
+}
+
+@test "kover query reads the queries on stdin by default" {
+  run kover query --input "$examples_dir"/4b3a_coverage.scene \
+    <<< "antennas 0 0
+buildings 0 0"
+  assert_success
+  assert_output "antennas 0 0: a1
+buildings 0 0: b1"
+}
+
+@test "kover query finds the objects touching a window" {
+  run kover query --input "$examples_dir"/4b3a_coverage.scene \
+    <<< "window 29 29 40 40
+window 20 20 25 25"
+  assert_success
+  assert_output "window 29 29 40 40: buildings b3
+window 20 20 25 25:"
+}
+
+@test "kover query answers queries on a binary scene" {
+  kover pack --input "$examples_dir"/4b3a_coverage.scene --output "$packed"
+  run kover query --input "$packed" <<< "antennas 7 0"
+  assert_success
+  assert_output "antennas 7 0: a2 a3"
+}
+
+# Invalid usage
+# -------------
+
+@test "kover query requires an input scene" {
+  run kover query <<< "antennas 0 0"
+  assert_failure
+  assert_output "error: option '--input' is mandatory"
+}
+
+@test "kover query reports a query with the wrong number of arguments" {
+  run kover query --input "$examples_dir"/4b3a_coverage.scene <<< "antennas 0"
+  assert_failure
+  assert_output "error: antennas line has wrong number of arguments (line #1)"
+}
+
+@test "kover query answers the queries preceding an invalid one" {
+  run kover query --input "$examples_dir"/4b3a_coverage.scene \
+    <<< "buildings 4 0
+buildings x 0"
+  assert_failure
+  assert_output "buildings 4 0: b4
+error: invalid integer \"x\" (line #2)"
+}
+
+@test "kover query rejects an invalid scene" {
+  run kover query --input "$examples_dir"/2b_overlapping.invalid <<< ""
+  assert_failure
+  assert_output "error: buildings b1 and b2 are overlapping"
+}
@@ -0,0 +1,75 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
+}
+
+# Normal usage
+# ------------
+
+@test "kover render writes a PGM image of 1024 pixels by default" {
+  run bash -c "kover render --input '$examples_dir'/1b1a.scene | head -n 3"
+  assert_success
+  assert_output "P5
+1024 1024
+255"
+}
+
+@test "kover render maps the longest side of the scene to the resolution" {
+  run bash -c "kover render --resolution 100 --input '$examples_dir'/2b.scene | head -n 3"
+  assert_success
+  assert_output "P5
+67 100
+255"
+}
+
+@test "kover render draws the buildings and the antenna coverage" {
+  run bash -c "kover render --resolution 16 --input '$examples_dir'/1b1a.scene | tail -c 256 | od -An -tu1 -v | tr -s ' ' '\n' | grep . | sort -n | uniq -c"
+  assert_success
+  assert_output "     48 0
+    199 8
+      9 143"
+}
+
+@test "kover render writes a single pixel for an empty scene" {
+  run bash -c "kover render --input '$examples_dir'/empty.scene | od -An -c"
+  assert_success
+  assert_output "   P   5  \n   1       1  \n   2   5   5  \n  \0"
+}
+
+@test "kover render writes the image in the file given with --output" {
+  run kover render --resolution 16 --input "$examples_dir"/1b1a.scene \
+    --output "$BATS_TEST_TMPDIR"/map.pgm
+  assert_success
+  assert_output ""
+  run cmp "$BATS_TEST_TMPDIR"/map.pgm \
+    <(kover render --resolution 16 --input "$examples_dir"/1b1a.scene)
+  assert_success
+}
+
+@test "kover render does not depend on the number of threads" {
+  kover-gen --buildings 2000 --antennas 500 --seed 7 > "$BATS_TEST_TMPDIR"/scene
+  kover render --resolution 600 --input "$BATS_TEST_TMPDIR"/scene \
+    > "$BATS_TEST_TMPDIR"/map1.pgm
+  kover render --resolution 600 --threads 4 --input "$BATS_TEST_TMPDIR"/scene \
+    > "$BATS_TEST_TMPDIR"/map4.pgm
+  run cmp "$BATS_TEST_TMPDIR"/map1.pgm "$BATS_TEST_TMPDIR"/map4.pgm
+  assert_success
+}
+
+# Invalid usage
+# -------------
+
+@test "kover render rejects a resolution beyond 65536" {
+  run kover render --resolution 65537 --input "$examples_dir"/1b1a.scene
+  assert_failure
+  assert_output "error: invalid argument '65537' for option '--resolution'"
+}
+
+@test "kover render reports an error when the scene is invalid" {
+  run kover render --input "$examples_dir"/2b_overlapping.invalid
+  assert_failure
+  assert_output "error: buildings b1 and b2 are overlapping"
+}
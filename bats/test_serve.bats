@@ -0,0 +1,99 @@
+setup() {
+  load 'bats-support/load'
+  load 'bats-assert/load'
+  root_dir="$(cd "$( dirname "$BATS_TEST_FILENAME" )/.." >/dev/null 2>&1 && pwd)"
+  PATH="$root_dir/bin:$PATH"
+  examples_dir="$root_dir/examples"
+  socket="$BATS_TEST_TMPDIR/kover.socket"
+  kover serve --socket "$socket" 3>&- &
+  server_pid=$!
+  for i in $(seq 50); do
+    [ -S "$socket" ] && break
+    sleep 0.1
+  done
+}
+
+teardown() {
+  kill -TERM "$server_pid" 2>/dev/null || true
+  wait "$server_pid" 2>/dev/null || true
+}
+
+# Normal usage
+# ------------
+
+@test "kover client summarizes a scene through the server" {
+  run kover client summarize --socket "$socket" \
+    --input "$examples_dir"/3b2a.scene
+  assert_success
+  assert_output "A scene with 3 buildings and 2 antennas"
+}
+
+@test "kover client reads the scene from stdin" {
+  run bash -c "kover client bounding-box --socket '$socket' \
+    < '$examples_dir/1b.scene'"
+  assert_success
+  assert_output "bounding box [-1, 1] x [-1, 1]"
+}
+
+@test "kover client answers like the subcommand run on its own" {
+  for subcommand in describe coverage "coverage --exact"; do
+    expected="$(kover $subcommand --input "$examples_dir"/4b3a_coverage.scene)"
+    for i in 1 2; do
+      run kover client $subcommand --socket "$socket" \
+        --input "$examples_dir"/4b3a_coverage.scene
+      assert_success
+      assert_output "$expected"
+    done
+  done
+}
+
+@test "kover serve removes its socket when it is stopped" {
+  kill -TERM "$server_pid"
+  wait "$server_pid"
+  [ ! -e "$socket" ]
+}
+
+# Invalid usage
+# -------------
+
+@test "kover client reports the errors of an invalid scene" {
+  run kover client describe --socket "$socket" \
+    --input "$examples_dir"/2b_overlapping.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b2 are overlapping"
+}
+
+@test "kover client reports an error when the subcommand cannot be served" {
+  run kover client place --socket "$socket" --input "$examples_dir"/1b.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: subcommand 'place' cannot be served"
+}
+
+@test "kover client reports an error when --socket is missing" {
+  run kover client summarize --input "$examples_dir"/1b.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: option '--socket' is mandatory"
+}
+
+@test "kover client reports an error when there is no server" {
+  run kover client summarize --socket "$BATS_TEST_TMPDIR/none" \
+    --input "$examples_dir"/1b.scene
+  [ "$status" -eq 1 ]
+  assert_output "error: cannot exchange with server on socket '$BATS_TEST_TMPDIR/none'"
+}
+
+@test "kover client reports an error when the scene exceeds the budget" {
+  small_socket="$BATS_TEST_TMPDIR/small.socket"
+  kover serve --socket "$small_socket" --memory 1 3>&- &
+  small_pid=$!
+  for i in $(seq 50); do
+    [ -S "$small_socket" ] && break
+    sleep 0.1
+  done
+  run bash -c "head -c 2000000 /dev/zero \
+    | kover client summarize --socket '$small_socket'"
+  kill -TERM "$small_pid"
+  wait "$small_pid"
+  [ "$status" -eq 1 ]
+  assert_output "error: request larger than 1048576 bytes"
+}
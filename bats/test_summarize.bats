@@ -45,6 +45,30 @@ setup() {
   assert_output "A scene with 1 building and 1 antenna"
 }
 
+@test "kover summarize reads the scene from the file given with --input" {
+  run kover summarize --input "$examples_dir"/1b1a.scene
+  assert_success
+  assert_output "A scene with 1 building and 1 antenna"
+}
+
+@test "kover summarize runs correctly on a scene with long lines" {
+  run kover summarize < "$examples_dir"/1b1a_long_lines.scene
+  assert_success
+  assert_output "A scene with 1 building and 1 antenna"
+}
+
+@test "kover summarize --no-validate skips the validation of the scene" {
+  run kover summarize --no-validate < "$examples_dir"/2b_overlapping.invalid
+  assert_success
+  assert_output "A scene with 2 buildings"
+}
+
+@test "kover summarize --no-validate still reports invalid lines" {
+  run kover summarize --no-validate < "$examples_dir"/1b_wrong_x.invalid
+  [ "$status" -eq 1 ]
+  assert_output 'error: invalid integer "a" (line #2)'
+}
+
 # Wrong lines
 # -----------
 
@@ -75,12 +99,30 @@ setup() {
   assert_output "error: building identifier b1 is non unique"
 }
 
+@test "kover summarize reports an error when two buildings have same long id" {
+  run kover summarize < "$examples_dir"/3b_non_unique_long_id.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: building identifier building_long_1 is non unique"
+}
+
 @test "kover summarize reports an error when two buildings are overlapping" {
   run kover summarize < "$examples_dir"/2b_overlapping.invalid
   [ "$status" -eq 1 ]
   assert_output "error: buildings b1 and b2 are overlapping"
 }
 
+@test "kover summarize reports an error when a building crosses another one" {
+  run kover summarize < "$examples_dir"/2b_nested.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b2 are overlapping"
+}
+
+@test "kover summarize reports the first pair of overlapping buildings" {
+  run kover summarize < "$examples_dir"/3b_overlapping.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: buildings b1 and b3 are overlapping"
+}
+
 @test "kover summarize reports an error when a building line has a wrong number of arguments" {
   run kover summarize < "$examples_dir"/1b_wrong_number_of_arguments.invalid
   [ "$status" -eq 1 ]
@@ -117,6 +159,12 @@ setup() {
   assert_output 'error: invalid positive integer "-2" (line #2)'
 }
 
+@test "kover summarize reports an error when a building coordinate overflows" {
+  run kover summarize < "$examples_dir"/1b_overflow_x.invalid
+  [ "$status" -eq 1 ]
+  assert_output 'error: invalid integer "2147483648" (line #2)'
+}
+
 # Wrong antennas
 # --------------
 
@@ -132,6 +180,12 @@ setup() {
   assert_output "error: antennas a1 and a2 have the same position"
 }
 
+@test "kover summarize reports the first pair of antennas with the same position" {
+  run kover summarize < "$examples_dir"/4a_same_position.invalid
+  [ "$status" -eq 1 ]
+  assert_output "error: antennas a1 and a4 have the same position"
+}
+
 @test "kover summarize reports an error when an antenna line has the wrong number of arguments" {
   run kover summarize < "$examples_dir"/1a_wrong_number_of_arguments.invalid
   [ "$status" -eq 1 ]
@@ -161,3 +215,9 @@ setup() {
   [ "$status" -eq 1 ]
   assert_output 'error: invalid positive integer "-1" (line #2)'
 }
+
+@test "kover summarize reports an error when an antenna range overflows" {
+  run kover summarize < "$examples_dir"/1a_overflow_r.invalid
+  [ "$status" -eq 1 ]
+  assert_output 'error: invalid positive integer "99999999999" (line #2)'
+}
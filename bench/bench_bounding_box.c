@@ -0,0 +1,198 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 10
+
+// Generation
+// ----------
+
+/**
+ * Returns a random coordinate in [-RAND_MAX, RAND_MAX]
+ *
+ * The coordinate is computed on 64 bits, and fits in an int since RAND_MAX
+ * is at most INT_MAX.
+ *
+ * @return  The coordinate
+ */
+int random_coordinate(void) {
+  return (long long)rand() * 2 - RAND_MAX;
+}
+
+/**
+ * Returns a random positive size in [1, RAND_MAX]
+ *
+ * @return  The size
+ */
+int random_size(void) {
+  return 1 + rand() % RAND_MAX;
+}
+
+/**
+ * Fills a scene with objects spread over the whole range of int
+ *
+ * @param scene        The scene, which must be empty
+ * @param num_objects  The number of buildings, and of antennas
+ */
+void fill_scene(struct Scene* scene, unsigned int num_objects) {
+  reserve_scene(scene, num_objects, num_objects);
+  for (unsigned int o = 0; o < num_objects; ++o) {
+    struct Building* building = scene->buildings + o;
+    char building_id[16];
+    snprintf(building_id, sizeof(building_id), "b%u", o % 1000000000);
+    set_building_identifier(scene, building, building_id);
+    building->x = random_coordinate();
+    building->y = random_coordinate();
+    building->w = random_size();
+    building->h = random_size();
+    struct Antenna* antenna = scene->antennas + o;
+    char antenna_id[16];
+    snprintf(antenna_id, sizeof(antenna_id), "a%u", o % 1000000000);
+    set_antenna_identifier(scene, antenna, antenna_id);
+    antenna->x = random_coordinate();
+    antenna->y = random_coordinate();
+    antenna->r = random_size();
+  }
+  scene->num_buildings = num_objects;
+  scene->num_antennas = num_objects;
+  sync_scene_columns(scene);
+}
+
+// Kernels
+// -------
+
+/**
+ * Computes the bounds of a scene by folding its objects one at a time
+ *
+ * @param scene       The scene
+ * @param aggregates  The resulting aggregates
+ */
+void fold_records(const struct Scene* scene,
+                  struct SceneAggregates* aggregates) {
+  initialize_scene_aggregates(aggregates);
+  for (unsigned int b = 0; b < scene->num_buildings; ++b)
+    fold_building(aggregates, scene->buildings + b);
+  for (unsigned int a = 0; a < scene->num_antennas; ++a)
+    fold_antenna(aggregates, scene->antennas + a);
+}
+
+/**
+ * Computes the bounds of a scene from its columns, one object at a time
+ *
+ * @param scene       The scene
+ * @param aggregates  The resulting aggregates
+ */
+void fold_columns_scalar(const struct Scene* scene,
+                         struct SceneAggregates* aggregates) {
+  const struct SceneColumns* columns = &scene->columns;
+  initialize_scene_aggregates(aggregates);
+  fold_box_columns_scalar(aggregates, columns->building_x,
+                          columns->building_y, columns->building_w,
+                          columns->building_h, scene->num_buildings);
+  fold_box_columns_scalar(aggregates, columns->antenna_x, columns->antenna_y,
+                          columns->antenna_r, columns->antenna_r,
+                          scene->num_antennas);
+}
+
+/**
+ * Computes the bounds of a scene from its columns, with AVX2
+ *
+ * @param scene       The scene
+ * @param aggregates  The resulting aggregates
+ */
+void fold_columns_avx2(const struct Scene* scene,
+                       struct SceneAggregates* aggregates) {
+  const struct SceneColumns* columns = &scene->columns;
+  initialize_scene_aggregates(aggregates);
+  fold_box_columns_avx2(aggregates, columns->building_x, columns->building_y,
+                        columns->building_w, columns->building_h,
+                        scene->num_buildings);
+  fold_box_columns_avx2(aggregates, columns->antenna_x, columns->antenna_y,
+                        columns->antenna_r, columns->antenna_r,
+                        scene->num_antennas);
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in milliseconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now_ms(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+/**
+ * Measures the best running time of a bounds computation
+ *
+ * @param compute   The computation
+ * @param scene     The scene
+ * @param expected  The expected bounds (NULL if unknown)
+ * @param result    The resulting bounds
+ * @return          The best running time, in milliseconds
+ */
+double measure(void (*compute)(const struct Scene*, struct SceneAggregates*),
+               const struct Scene* scene,
+               const struct SceneAggregates* expected,
+               struct SceneAggregates* result) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    double start = now_ms();
+    compute(scene, result);
+    double elapsed = now_ms() - start;
+    if (expected != NULL &&
+        (result->xmin != expected->xmin || result->xmax != expected->xmax ||
+         result->ymin != expected->ymin || result->ymax != expected->ymax)) {
+      fprintf(stderr, "error: bounds computations disagree\n");
+      exit(1);
+    }
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints, for a scene fitting in the caches and a larger one, the time taken
+ * to compute its bounding box from its array of objects, and from its columns
+ * with the scalar and AVX2 kernels.
+ */
+int main(void) {
+  const unsigned int sizes[] = {10000, 4000000};
+  const unsigned int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+  bool has_avx2 = __builtin_cpu_supports("avx2");
+  srand(2025);
+  printf("%10s %14s %14s %14s\n", "objects", "records (ms)", "columns (ms)",
+         "avx2 (ms)");
+  for (unsigned int s = 0; s < num_sizes; ++s) {
+    struct Scene* scene = create_scene();
+    fill_scene(scene, sizes[s]);
+    struct SceneAggregates expected, result;
+    double records = measure(fold_records, scene, NULL, &expected),
+           scalar = measure(fold_columns_scalar, scene, &expected, &result);
+    printf("%10u %14.3f %14.3f", 2 * sizes[s], records, scalar);
+    if (has_avx2)
+      printf(" %14.3f\n",
+             measure(fold_columns_avx2, scene, &expected, &result));
+    else
+      printf(" %14s\n", "-");
+    delete_scene(scene);
+  }
+  return 0;
+}
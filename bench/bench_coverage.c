@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "arena.h"
+#include "coverage.h"
+#include "pool.h"
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The side of the grid cell holding one building
+#define CELL_SIZE 10
+// The maximum radius of an antenna
+#define MAX_RADIUS 30
+// The largest scene size on which the pairwise computation is run
+#define MAX_NAIVE_SIZE 20000
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 3
+
+// Generation
+// ----------
+
+/**
+ * Generates a scene with as many buildings as antennas
+ *
+ * Each building lies inside its own cell of a square grid, and the antennas
+ * are spread uniformly over the grid.
+ *
+ * @param scene        The resulting scene, which must be empty
+ * @param num_objects  The number of buildings and of antennas
+ */
+void fill_scene(struct Scene* scene, unsigned int num_objects) {
+  unsigned int side = 1;
+  while (side * side < num_objects)
+    ++side;
+  reserve_scene(scene, num_objects, num_objects);
+  for (unsigned int b = 0; b < num_objects; ++b) {
+    struct Building* building = scene->buildings + b;
+    char building_id[16];
+    snprintf(building_id, sizeof(building_id), "b%u", b % 1000000000);
+    set_building_identifier(scene, building, building_id);
+    building->w = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->h = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->x = (b % side) * CELL_SIZE + CELL_SIZE / 2;
+    building->y = (b / side) * CELL_SIZE + CELL_SIZE / 2;
+  }
+  for (unsigned int a = 0; a < num_objects; ++a) {
+    struct Antenna* antenna = scene->antennas + a;
+    char antenna_id[16];
+    snprintf(antenna_id, sizeof(antenna_id), "a%u", a % 1000000000);
+    set_antenna_identifier(scene, antenna, antenna_id);
+    antenna->x = rand() % (side * CELL_SIZE);
+    antenna->y = rand() % (side * CELL_SIZE);
+    antenna->r = 1 + rand() % MAX_RADIUS;
+  }
+  scene->num_buildings = num_objects;
+  scene->num_antennas = num_objects;
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in milliseconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now_ms(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+/**
+ * Counts the coverage relations by testing every pair of objects
+ *
+ * @param scene  The scene
+ * @return       The number of pairs whose antenna covers the building
+ */
+unsigned long long count_coverage_naive(const struct Scene* scene) {
+  unsigned long long count = 0;
+  for (unsigned int b = 0; b < scene->num_buildings; ++b)
+    for (unsigned int a = 0; a < scene->num_antennas; ++a)
+      if (antenna_coverage(scene->antennas + a, scene->buildings + b)
+          != COVERAGE_NONE)
+        ++count;
+  return count;
+}
+
+/**
+ * Counts the coverage relations with compute_scene_coverage
+ *
+ * @param scene  The scene
+ * @return       The number of pairs whose antenna covers the building
+ */
+unsigned long long count_coverage(const struct Scene* scene) {
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct ThreadPool pool;
+  struct Error error;
+  if (!create_thread_pool(&pool, 1, &error)) {
+    print_error(&error, stderr);
+    exit(1);
+  }
+  struct SceneCoverage coverage;
+  compute_scene_coverage(scene, &coverage, &pool, &arena);
+  unsigned long long count = coverage.offsets[scene->num_buildings];
+  destroy_thread_pool(&pool);
+  free_arena(&arena);
+  return count;
+}
+
+/**
+ * Measures the best running time of a coverage computation
+ *
+ * @param count     The computation
+ * @param scene     The scene
+ * @param expected  The expected number of coverage relations (0 if unknown)
+ * @return          The best running time, in milliseconds
+ */
+double measure(unsigned long long (*count)(const struct Scene*),
+               const struct Scene* scene, unsigned long long expected) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    double start = now_ms();
+    unsigned long long result = count(scene);
+    double elapsed = now_ms() - start;
+    if (expected != 0 && result != expected) {
+      fprintf(stderr, "error: coverage computations disagree\n");
+      exit(1);
+    }
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints, for increasing scene sizes, the running time of the pairwise and
+ * R-tree coverage computations.
+ */
+int main(void) {
+  const unsigned int sizes[] = {1000, 2000, 5000, 10000, 20000,
+                                100000, 1000000};
+  const unsigned int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+  srand(2025);
+  printf("%10s %14s %14s %10s\n", "objects", "pairwise (ms)",
+         "r-tree (ms)", "speedup");
+  for (unsigned int s = 0; s < num_sizes; ++s) {
+    struct Scene* scene = create_scene();
+    fill_scene(scene, sizes[s]);
+    if (sizes[s] <= MAX_NAIVE_SIZE) {
+      unsigned long long expected = count_coverage_naive(scene);
+      double naive = measure(count_coverage_naive, scene, expected);
+      double rtree = measure(count_coverage, scene, expected);
+      printf("%10u %14.2f %14.2f %9.1fx\n", sizes[s], naive, rtree,
+             naive / rtree);
+    } else {
+      double rtree = measure(count_coverage, scene, 0);
+      printf("%10u %14s %14.2f %10s\n", sizes[s], "-", rtree, "-");
+    }
+    delete_scene(scene);
+  }
+  return 0;
+}
@@ -0,0 +1,189 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 5
+// The maximum length of the generated identifiers
+#define MAX_LENGTH_NAME 23
+
+// Generation
+// ----------
+
+/**
+ * Shuffles the numbers from 0 to n - 1
+ *
+ * @param numbers  The resulting numbers (n items)
+ * @param n        The number of numbers
+ */
+void shuffle_numbers(unsigned int* numbers, unsigned int n) {
+  for (unsigned int i = 0; i < n; ++i)
+    numbers[i] = i;
+  for (unsigned int i = n; i > 1; --i) {
+    unsigned int j = ((unsigned int)rand() * (RAND_MAX + 1u) + rand()) % i;
+    unsigned int swap = numbers[i - 1];
+    numbers[i - 1] = numbers[j];
+    numbers[j] = swap;
+  }
+}
+
+/**
+ * Fills a scene with objects whose identifiers are in a random order
+ *
+ * The identifiers are made of a prefix, "b" for the buildings and "a" for
+ * the antennas, followed by a number.
+ *
+ * @param scene        The scene, which must be empty
+ * @param num_objects  The number of buildings, and of antennas
+ * @param prefix       The string following the prefix of the identifiers
+ * @param names        The resulting identifiers of the buildings, in the
+ *                     order of the scene (num_objects items)
+ */
+void fill_scene(struct Scene* scene, unsigned int num_objects,
+                const char* prefix, char (*names)[MAX_LENGTH_NAME + 1]) {
+  unsigned int* numbers = malloc(num_objects * sizeof(unsigned int));
+  shuffle_numbers(numbers, num_objects);
+  reserve_scene(scene, num_objects, num_objects);
+  for (unsigned int o = 0; o < num_objects; ++o) {
+    char id[MAX_LENGTH_NAME + 1];
+    struct Building* building = scene->buildings + o;
+    snprintf(names[o], MAX_LENGTH_NAME + 1, "b%s%u", prefix,
+             numbers[o] % 1000000000);
+    set_building_identifier(scene, building, names[o]);
+    building->x = 4 * o;
+    building->y = 0;
+    building->w = 1;
+    building->h = 1;
+    struct Antenna* antenna = scene->antennas + o;
+    snprintf(id, sizeof(id), "a%s%u", prefix, numbers[o] % 1000000000);
+    set_antenna_identifier(scene, antenna, id);
+    antenna->x = 4 * o;
+    antenna->y = 4;
+    antenna->r = 1;
+  }
+  scene->num_buildings = num_objects;
+  scene->num_antennas = num_objects;
+  free(numbers);
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in milliseconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now_ms(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+/**
+ * Measures the best time taken to sort the objects of a scene
+ *
+ * @param scene  The scene, sorted on return
+ * @return       The best sorting time, in milliseconds
+ */
+double measure_sort(struct Scene* scene) {
+  size_t buildings_size = scene->num_buildings * sizeof(struct Building),
+         antennas_size = scene->num_antennas * sizeof(struct Antenna);
+  struct Building* buildings = malloc(buildings_size);
+  struct Antenna* antennas = malloc(antennas_size);
+  memcpy(buildings, scene->buildings, buildings_size);
+  memcpy(antennas, scene->antennas, antennas_size);
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    memcpy(scene->buildings, buildings, buildings_size);
+    memcpy(scene->antennas, antennas, antennas_size);
+    double start = now_ms();
+    sort_scene(scene);
+    double elapsed = now_ms() - start;
+    for (unsigned int b = 1; b < scene->num_buildings; ++b)
+      if (strcmp(building_identifier(scene, scene->buildings + b - 1),
+                 building_identifier(scene, scene->buildings + b)) >= 0) {
+        fprintf(stderr, "error: the buildings are not sorted\n");
+        exit(1);
+      }
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  free(buildings);
+  free(antennas);
+  return best;
+}
+
+/**
+ * Measures the best time taken to find every building of a scene by
+ * identifier
+ *
+ * @param scene  The scene, sorted
+ * @param names  The identifiers of the buildings, in a random order
+ * @return       The best time, in milliseconds
+ */
+double measure_lookups(const struct Scene* scene,
+                       char (*names)[MAX_LENGTH_NAME + 1]) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    unsigned int num_found = 0;
+    double start = now_ms();
+    for (unsigned int b = 0; b < scene->num_buildings; ++b)
+      num_found += find_building(scene, names[b]) != NULL;
+    double elapsed = now_ms() - start;
+    if (num_found != scene->num_buildings) {
+      fprintf(stderr, "error: %u buildings not found\n",
+              scene->num_buildings - num_found);
+      exit(1);
+    }
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints the size of the objects, then, for scenes of increasing sizes whose
+ * identifiers are shuffled, the size of their identifiers in the pool and the
+ * time taken to sort them and to find each building by identifier. The
+ * identifiers are short first, so that their keys are distinct, then share
+ * their first 10 characters, so that their keys are all tied.
+ */
+int main(void) {
+  const unsigned int sizes[] = {10000, 100000, 1000000, 4000000};
+  const unsigned int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+  const char* prefixes[] = {"", "_long_name_"};
+  const unsigned int num_prefixes = sizeof(prefixes) / sizeof(prefixes[0]);
+  srand(2025);
+  printf("building: %zu bytes, antenna: %zu bytes, plus their identifiers\n",
+         sizeof(struct Building), sizeof(struct Antenna));
+  for (unsigned int p = 0; p < num_prefixes; ++p) {
+    printf("\nidentifiers b%s0, a%s0, ...\n", prefixes[p], prefixes[p]);
+    printf("%10s %14s %14s %14s\n", "objects", "pool (B/obj)", "sort (ms)",
+           "lookups (ms)");
+    for (unsigned int s = 0; s < num_sizes; ++s) {
+      struct Scene* scene = create_scene();
+      char (*names)[MAX_LENGTH_NAME + 1] = malloc(sizes[s] * sizeof(*names));
+      fill_scene(scene, sizes[s], prefixes[p], names);
+      double sort = measure_sort(scene);
+      printf("%10u %14.1f %14.3f %14.3f\n", 2 * sizes[s],
+             (double)scene->ids.size / (2 * sizes[s]), sort,
+             measure_lookups(scene, names));
+      free(names);
+      delete_scene(scene);
+    }
+  }
+  return 0;
+}
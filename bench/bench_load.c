@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "input.h"
+#include "scene.h"
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The side of the grid cell holding one object
+#define CELL_SIZE 10
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 3
+
+// Generation
+// ----------
+
+/**
+ * Writes a valid scene in a file
+ *
+ * The buildings and the antennas lie in distinct cells of a square grid, and
+ * are written in a random order.
+ *
+ * @param file         The file
+ * @param num_objects  The number of objects in the scene
+ */
+void write_scene(FILE* file, unsigned int num_objects) {
+  unsigned int side = 1;
+  while (side * side < num_objects)
+    ++side;
+  unsigned int* order = malloc(num_objects * sizeof(unsigned int));
+  for (unsigned int o = 0; o < num_objects; ++o)
+    order[o] = o;
+  for (unsigned int o = num_objects; o > 1; --o) {
+    unsigned int other = rand() % o, swap = order[o - 1];
+    order[o - 1] = order[other];
+    order[other] = swap;
+  }
+  fprintf(file, "begin scene\n");
+  for (unsigned int o = 0; o < num_objects; ++o) {
+    unsigned int cell = order[o];
+    int x = (cell % side) * CELL_SIZE, y = (cell / side) * CELL_SIZE;
+    if (cell % 2 == 0)
+      fprintf(file, "  building b%u %d %d %d %d\n", cell, x, y,
+              1 + rand() % 4, 1 + rand() % 4);
+    else
+      fprintf(file, "  antenna a%u %d %d %d\n", cell, x, y, 1 + rand() % 20);
+  }
+  fprintf(file, "end scene\n");
+  free(order);
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in seconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Measures the best loading time of a scene file
+ *
+ * @param path  The path of the scene file
+ * @param size  The resulting size of the file, in bytes
+ * @return      The best loading time, in seconds
+ */
+double measure_load(const char* path, size_t* size) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    double start = now();
+    struct Input input;
+    struct Error error;
+    struct Scene* scene = create_scene();
+    if (!open_file_input(&input, path, &error) ||
+        !load_scene(scene, &input, &error)) {
+      print_error(&error, stderr);
+      exit(1);
+    }
+    *size = input.size;
+    close_input(&input);
+    delete_scene(scene);
+    double elapsed = now() - start;
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints, for increasing scene sizes, the time taken to load a scene file
+ * and the corresponding parse throughput.
+ */
+int main(void) {
+  const unsigned int sizes[] = {1000, 10000, 100000, 1000000};
+  const unsigned int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+  srand(2025);
+  printf("%10s %12s %12s %12s\n", "objects", "size (MB)", "load (ms)",
+         "MB/s");
+  for (unsigned int s = 0; s < num_sizes; ++s) {
+    char path[] = "/tmp/kover-bench-XXXXXX";
+    int fd = mkstemp(path);
+    FILE* file = fdopen(fd, "w");
+    write_scene(file, sizes[s]);
+    fclose(file);
+    size_t size;
+    double elapsed = measure_load(path, &size);
+    printf("%10u %12.2f %12.2f %12.1f\n", sizes[s], size / 1e6,
+           elapsed * 1e3, size / 1e6 / elapsed);
+    unlink(path);
+  }
+  return 0;
+}
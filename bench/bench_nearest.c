@@ -0,0 +1,211 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "arena.h"
+#include "nearest.h"
+#include "pool.h"
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The side of the grid cell holding one building
+#define CELL_SIZE 10
+// The maximum radius of an antenna
+#define MAX_RADIUS 30
+// The number of antennas found for each building
+#define NUM_NEAREST 4
+// The largest scene size on which the pairwise computation is run
+#define MAX_NAIVE_SIZE 20000
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 3
+
+// Generation
+// ----------
+
+/**
+ * Generates a scene with as many buildings as antennas
+ *
+ * Each building lies inside its own cell of a square grid, and the antennas
+ * are spread uniformly over the grid.
+ *
+ * @param scene        The resulting scene, which must be empty
+ * @param num_objects  The number of buildings and of antennas
+ */
+void fill_scene(struct Scene* scene, unsigned int num_objects) {
+  unsigned int side = 1;
+  while (side * side < num_objects)
+    ++side;
+  reserve_scene(scene, num_objects, num_objects);
+  for (unsigned int b = 0; b < num_objects; ++b) {
+    struct Building* building = scene->buildings + b;
+    char building_id[16];
+    snprintf(building_id, sizeof(building_id), "b%u", b % 1000000000);
+    set_building_identifier(scene, building, building_id);
+    building->w = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->h = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->x = (b % side) * CELL_SIZE + CELL_SIZE / 2;
+    building->y = (b / side) * CELL_SIZE + CELL_SIZE / 2;
+  }
+  for (unsigned int a = 0; a < num_objects; ++a) {
+    struct Antenna* antenna = scene->antennas + a;
+    char antenna_id[16];
+    snprintf(antenna_id, sizeof(antenna_id), "a%u", a % 1000000000);
+    set_antenna_identifier(scene, antenna, antenna_id);
+    antenna->x = rand() % (side * CELL_SIZE);
+    antenna->y = rand() % (side * CELL_SIZE);
+    antenna->r = 1 + rand() % MAX_RADIUS;
+  }
+  scene->num_buildings = num_objects;
+  scene->num_antennas = num_objects;
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in milliseconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now_ms(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+/**
+ * Returns the squared distance from a building to an antenna
+ *
+ * @param building  The building
+ * @param antenna   The antenna
+ * @return          The squared distance from the rectangle of the building
+ *                  to the position of the antenna
+ */
+uint64_t building_antenna_distance(const struct Building* building,
+                                   const struct Antenna* antenna) {
+  long long dx = llabs((long long)antenna->x - building->x) - building->w,
+            dy = llabs((long long)antenna->y - building->y) - building->h;
+  dx = dx > 0 ? dx : 0;
+  dy = dy > 0 ? dy : 0;
+  return dx * dx + dy * dy;
+}
+
+/**
+ * Sums the indices of the nearest antennas by scanning every pair of objects
+ *
+ * @param scene  The scene
+ * @return       The sum of the indices of the antennas nearest to each
+ *               building
+ */
+unsigned long long sum_nearest_naive(const struct Scene* scene) {
+  unsigned long long sum = 0;
+  for (unsigned int b = 0; b < scene->num_buildings; ++b) {
+    uint64_t distances[NUM_NEAREST];
+    unsigned int antennas[NUM_NEAREST], size = 0;
+    for (unsigned int a = 0; a < scene->num_antennas; ++a) {
+      uint64_t distance = building_antenna_distance(scene->buildings + b,
+                                                    scene->antennas + a);
+      if (size == NUM_NEAREST && distance >= distances[size - 1])
+        continue;
+      unsigned int n = size < NUM_NEAREST ? size++ : size - 1;
+      for (; n > 0 && distances[n - 1] > distance; --n) {
+        distances[n] = distances[n - 1];
+        antennas[n] = antennas[n - 1];
+      }
+      distances[n] = distance;
+      antennas[n] = a;
+    }
+    for (unsigned int n = 0; n < size; ++n)
+      sum += antennas[n];
+  }
+  return sum;
+}
+
+/**
+ * Sums the indices of the nearest antennas with compute_scene_nearest
+ *
+ * @param scene  The scene
+ * @return       The sum of the indices of the antennas nearest to each
+ *               building
+ */
+unsigned long long sum_nearest(const struct Scene* scene) {
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct ThreadPool pool;
+  struct Error error;
+  if (!create_thread_pool(&pool, 1, &error)) {
+    print_error(&error, stderr);
+    exit(1);
+  }
+  struct SceneNearest nearest;
+  compute_scene_nearest(scene, NUM_NEAREST, &nearest, &pool, &arena);
+  unsigned long long sum = 0;
+  for (size_t n = 0; n < (size_t)nearest.num_buildings * nearest.k; ++n)
+    sum += nearest.antennas[n];
+  destroy_thread_pool(&pool);
+  free_arena(&arena);
+  return sum;
+}
+
+/**
+ * Measures the best running time of a nearest computation
+ *
+ * @param sum       The computation
+ * @param scene     The scene
+ * @param expected  The expected sum of indices (0 if unknown)
+ * @return          The best running time, in milliseconds
+ */
+double measure(unsigned long long (*sum)(const struct Scene*),
+               const struct Scene* scene, unsigned long long expected) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    double start = now_ms();
+    unsigned long long result = sum(scene);
+    double elapsed = now_ms() - start;
+    if (expected != 0 && result != expected) {
+      fprintf(stderr, "error: nearest computations disagree\n");
+      exit(1);
+    }
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints, for increasing scene sizes, the running time of the pairwise and
+ * k-d tree computations of the antennas nearest to each building.
+ */
+int main(void) {
+  const unsigned int sizes[] = {1000, 2000, 5000, 10000, 20000,
+                                100000, 1000000};
+  const unsigned int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+  srand(2025);
+  printf("%u nearest antennas per building\n", NUM_NEAREST);
+  printf("%10s %14s %14s %10s\n", "objects", "pairwise (ms)",
+         "k-d tree (ms)", "speedup");
+  for (unsigned int s = 0; s < num_sizes; ++s) {
+    struct Scene* scene = create_scene();
+    fill_scene(scene, sizes[s]);
+    if (sizes[s] <= MAX_NAIVE_SIZE) {
+      unsigned long long expected = sum_nearest_naive(scene);
+      double naive = measure(sum_nearest_naive, scene, expected);
+      double kdtree = measure(sum_nearest, scene, expected);
+      printf("%10u %14.2f %14.2f %9.1fx\n", sizes[s], naive, kdtree,
+             naive / kdtree);
+    } else {
+      double kdtree = measure(sum_nearest, scene, 0);
+      printf("%10u %14s %14.2f %10s\n", sizes[s], "-", kdtree, "-");
+    }
+    delete_scene(scene);
+  }
+  return 0;
+}
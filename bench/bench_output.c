@@ -0,0 +1,183 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The number of buildings and of antennas of the scene
+#define NUM_OBJECTS 1000000
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 3
+// The size of the reads draining a pipe
+#define DRAIN_SIZE (1 << 16)
+
+// Generation
+// ----------
+
+/**
+ * Fills a scene with objects of random coordinates
+ *
+ * The scene is only printed, so it does not need to be valid.
+ *
+ * @param scene        The resulting scene, which must be empty
+ * @param num_objects  The number of buildings and of antennas
+ */
+void fill_scene(struct Scene* scene, unsigned int num_objects) {
+  reserve_scene(scene, num_objects, num_objects);
+  for (unsigned int o = 0; o < num_objects; ++o) {
+    struct Building* building = scene->buildings + o;
+    char building_id[16];
+    snprintf(building_id, sizeof(building_id), "b%u", o % 1000000000);
+    set_building_identifier(scene, building, building_id);
+    building->x = rand() - RAND_MAX / 2;
+    building->y = rand() - RAND_MAX / 2;
+    building->w = 1 + rand() % 1000;
+    building->h = 1 + rand() % 1000;
+    struct Antenna* antenna = scene->antennas + o;
+    char antenna_id[16];
+    snprintf(antenna_id, sizeof(antenna_id), "a%u", o % 1000000000);
+    set_antenna_identifier(scene, antenna, antenna_id);
+    antenna->x = rand() - RAND_MAX / 2;
+    antenna->y = rand() - RAND_MAX / 2;
+    antenna->r = 1 + rand() % 1000;
+  }
+  scene->num_buildings = num_objects;
+  scene->num_antennas = num_objects;
+}
+
+// Printing
+// --------
+
+/**
+ * Prints the objects of a scene as describe did with one fprintf per object
+ *
+ * @param scene  The scene
+ * @param file   The file
+ */
+void print_objects_with_fprintf(const struct Scene* scene, FILE* file) {
+  for (unsigned int b = 0; b < scene->num_buildings; ++b) {
+    const struct Building* building = scene->buildings + b;
+    fprintf(file, "  building %s at %d %d with dimensions %d %d\n",
+            building_identifier(scene, building), building->x, building->y,
+            building->w, building->h);
+  }
+  for (unsigned int a = 0; a < scene->num_antennas; ++a) {
+    const struct Antenna* antenna = scene->antennas + a;
+    fprintf(file, "  antenna %s at %d %d with range %d\n",
+            antenna_identifier(scene, antenna), antenna->x, antenna->y,
+            antenna->r);
+  }
+}
+
+/**
+ * Prints the objects of a scene with the buffered writer
+ *
+ * @param scene  The scene
+ * @param file   The file
+ */
+void print_objects_with_writer(const struct Scene* scene, FILE* file) {
+  print_scene_buildings(scene, file);
+  print_scene_antennas(scene, file);
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in seconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Reads a pipe until its end
+ *
+ * @param context  The descriptor of the read end of the pipe
+ * @return         NULL
+ */
+void* drain_pipe(void* context) {
+  int fd = *(int*)context;
+  char* buffer = malloc(DRAIN_SIZE);
+  while (read(fd, buffer, DRAIN_SIZE) > 0)
+    continue;
+  free(buffer);
+  return NULL;
+}
+
+/**
+ * Measures the best time taken to print the objects of a scene
+ *
+ * @param scene     The scene
+ * @param print     The printing function
+ * @param use_pipe  true to print on a pipe read by another thread, false to
+ *                  print on /dev/null
+ * @return          The best time, in seconds
+ */
+double measure_print(const struct Scene* scene,
+                     void (*print)(const struct Scene*, FILE*),
+                     int use_pipe) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    int fds[2];
+    pthread_t reader;
+    FILE* file;
+    if (use_pipe) {
+      if (pipe(fds) != 0)
+        exit(1);
+      pthread_create(&reader, NULL, drain_pipe, fds);
+      file = fdopen(fds[1], "w");
+    } else {
+      file = fopen("/dev/null", "w");
+    }
+    double start = now();
+    print(scene, file);
+    fclose(file);
+    double elapsed = now() - start;
+    if (use_pipe) {
+      pthread_join(reader, NULL);
+      close(fds[0]);
+    }
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints the time taken to print the buildings and antennas of a scene as
+ * describe does, with one fprintf per object and with the buffered writer,
+ * on /dev/null and on a pipe.
+ */
+int main(void) {
+  srand(2025);
+  struct Scene* scene = create_scene();
+  fill_scene(scene, NUM_OBJECTS);
+  printf("%10s %14s %14s %10s\n", "output", "fprintf (ms)", "writer (ms)",
+         "speedup");
+  const char* outputs[] = {"/dev/null", "pipe"};
+  for (int use_pipe = 0; use_pipe < 2; ++use_pipe) {
+    double reference = measure_print(scene, print_objects_with_fprintf,
+                                     use_pipe),
+           buffered = measure_print(scene, print_objects_with_writer,
+                                    use_pipe);
+    printf("%10s %14.1f %14.1f %9.2fx\n", outputs[use_pipe],
+           reference * 1e3, buffered * 1e3, reference / buffered);
+  }
+  delete_scene(scene);
+  return 0;
+}
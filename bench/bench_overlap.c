@@ -0,0 +1,183 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "overlap.h"
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The side of the grid cell holding one building
+#define CELL_SIZE 10
+// The largest scene size on which the pairwise search is run
+#define MAX_NAIVE_SIZE 20000
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 3
+
+// Generation
+// ----------
+
+/**
+ * Generates buildings that do not overlap
+ *
+ * Each building lies inside its own cell of a square grid, with a random
+ * position and random dimensions.
+ *
+ * @param buildings      The resulting buildings
+ * @param num_buildings  The number of buildings to generate
+ */
+void generate_buildings(struct Building* buildings,
+                        unsigned int num_buildings) {
+  unsigned int side = 1;
+  while (side * side < num_buildings)
+    ++side;
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    struct Building* building = buildings + b;
+    // The searches do not read the identifiers
+    building->key = 0;
+    building->id = 0;
+    building->w = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->h = 1 + rand() % (CELL_SIZE / 2 - 1);
+    int slack_x = CELL_SIZE / 2 - building->w,
+        slack_y = CELL_SIZE / 2 - building->h;
+    building->x = (b % side) * CELL_SIZE + CELL_SIZE / 2 +
+                  rand() % (2 * slack_x + 1) - slack_x;
+    building->y = (b / side) * CELL_SIZE + CELL_SIZE / 2 +
+                  rand() % (2 * slack_y + 1) - slack_y;
+  }
+}
+
+/**
+ * Generates buildings stacked in one column, the last two overlapping
+ *
+ * All the buildings share the same left side, which is the worst case of a
+ * sweep along the x axis keeping the buildings crossing the sweep line.
+ *
+ * @param buildings      The resulting buildings
+ * @param num_buildings  The number of buildings to generate (at least 2)
+ */
+void generate_column(struct Building* buildings, unsigned int num_buildings) {
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    struct Building* building = buildings + b;
+    // The searches do not read the identifiers
+    building->key = 0;
+    building->id = 0;
+    building->x = 0;
+    building->y = 3 * (b < num_buildings - 1 ? b : b - 1);
+    building->w = 1;
+    building->h = 1;
+  }
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in milliseconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now_ms(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+/**
+ * Measures the best running time of an overlap search
+ *
+ * @param find           The search function
+ * @param buildings      The buildings
+ * @param num_buildings  The number of buildings
+ * @return               The best running time, in milliseconds
+ */
+double measure(bool (*find)(const struct Building*, unsigned int,
+                            unsigned int*, unsigned int*),
+               const struct Building* buildings, unsigned int num_buildings) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    unsigned int b1, b2;
+    double start = now_ms();
+    if (find(buildings, num_buildings, &b1, &b2)) {
+      fprintf(stderr, "error: generated buildings are overlapping\n");
+      exit(1);
+    }
+    double elapsed = now_ms() - start;
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+/**
+ * Measures the best running time of the search of a known overlapping pair
+ *
+ * @param buildings      The buildings
+ * @param num_buildings  The number of buildings
+ * @param b1             The index of the first building of the pair
+ * @param b2             The index of the second building of the pair
+ * @return               The best running time, in milliseconds
+ */
+double measure_pair(const struct Building* buildings,
+                    unsigned int num_buildings, unsigned int b1,
+                    unsigned int b2) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    unsigned int found1, found2;
+    double start = now_ms();
+    if (!find_overlapping_buildings(buildings, num_buildings, &found1,
+                                    &found2) ||
+        found1 != b1 || found2 != b2) {
+      fprintf(stderr, "error: wrong overlapping pair\n");
+      exit(1);
+    }
+    double elapsed = now_ms() - start;
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints, for increasing scene sizes, the running time of the pairwise and
+ * sweep-line overlap searches on scenes without overlapping buildings, then
+ * the time taken to report the overlapping pair of a column of buildings.
+ */
+int main(void) {
+  const unsigned int sizes[] = {1000, 2000, 5000, 10000, 20000,
+                                100000, 1000000};
+  const unsigned int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+  srand(2025);
+  printf("%10s %14s %14s %10s\n", "buildings", "pairwise (ms)",
+         "sweep (ms)", "speedup");
+  for (unsigned int s = 0; s < num_sizes; ++s) {
+    struct Building* buildings = malloc(sizes[s] * sizeof(struct Building));
+    generate_buildings(buildings, sizes[s]);
+    double sweep = measure(find_overlapping_buildings, buildings, sizes[s]);
+    if (sizes[s] <= MAX_NAIVE_SIZE) {
+      double naive = measure(find_overlapping_buildings_naive,
+                             buildings, sizes[s]);
+      printf("%10u %14.2f %14.2f %9.1fx\n", sizes[s], naive, sweep,
+             naive / sweep);
+    } else {
+      printf("%10u %14s %14.2f %10s\n", sizes[s], "-", sweep, "-");
+    }
+    free(buildings);
+  }
+  printf("\n%10s %14s\n", "column", "report (ms)");
+  for (unsigned int s = 0; s < num_sizes; ++s) {
+    struct Building* buildings = malloc(sizes[s] * sizeof(struct Building));
+    generate_column(buildings, sizes[s]);
+    printf("%10u %14.2f\n", sizes[s],
+           measure_pair(buildings, sizes[s], sizes[s] - 2, sizes[s] - 1));
+    free(buildings);
+  }
+  return 0;
+}
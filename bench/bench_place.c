@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "arena.h"
+#include "placement.h"
+#include "scene.h"
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The side of the grid cell holding one building
+#define CELL_SIZE 10
+// The number of buildings of the scene
+#define NUM_BUILDINGS 100000
+// The radius of the placed antennas
+#define RADIUS 20
+
+// Generation
+// ----------
+
+/**
+ * Generates a valid scene of buildings without antenna
+ *
+ * Each building lies inside its own cell of a square grid.
+ *
+ * @param scene          The resulting scene, which must be empty
+ * @param num_buildings  The number of buildings
+ */
+void generate_buildings(struct Scene* scene, unsigned int num_buildings) {
+  unsigned int side = 1;
+  while (side * side < num_buildings)
+    ++side;
+  reserve_scene(scene, num_buildings, 0);
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    struct Building* building = scene->buildings + b;
+    char building_id[16];
+    snprintf(building_id, sizeof(building_id), "b%u", b % 1000000000);
+    set_building_identifier(scene, building, building_id);
+    building->w = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->h = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->x = (b % side) * CELL_SIZE + CELL_SIZE / 2;
+    building->y = (b / side) * CELL_SIZE + CELL_SIZE / 2;
+  }
+  scene->num_buildings = num_buildings;
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in milliseconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now_ms(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints, for decreasing spacings of the candidate sites, their number, the
+ * number of antennas chosen and the running time of the placement.
+ */
+int main(void) {
+  const int steps[] = {8, 4, 2};
+  const unsigned int num_steps = sizeof(steps) / sizeof(steps[0]);
+  srand(2025);
+  struct Scene* scene = create_scene();
+  generate_buildings(scene, NUM_BUILDINGS);
+  printf("%u buildings, antennas of radius %d\n", NUM_BUILDINGS, RADIUS);
+  printf("%10s %12s %12s %12s\n", "step", "sites", "antennas", "time (ms)");
+  for (unsigned int s = 0; s < num_steps; ++s) {
+    struct Arena arena;
+    initialize_arena(&arena);
+    struct PlacementSites sites;
+    struct Error error;
+    if (!find_placement_sites(scene, steps[s], RADIUS, &sites, &arena,
+                              &error)) {
+      print_error(&error, stderr);
+      exit(1);
+    }
+    free_arena(&arena);
+    initialize_arena(&arena);
+    struct Antenna* antennas;
+    unsigned int num_antennas;
+    double start = now_ms();
+    place_antennas(scene, steps[s], RADIUS, &antennas, &num_antennas, &arena,
+                   &error);
+    double elapsed = now_ms() - start;
+    free_arena(&arena);
+    printf("%10d %12u %12u %12.2f\n", steps[s], sites.num_sites,
+           num_antennas, elapsed);
+  }
+  delete_scene(scene);
+  return 0;
+}
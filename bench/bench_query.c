@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "input.h"
+#include "query.h"
+#include "scene.h"
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The side of the grid cell holding one object
+#define CELL_SIZE 10
+// The number of buildings and of antennas of the scene
+#define NUM_OBJECTS 500000
+// The number of queries of each kind
+#define NUM_QUERIES 1000000
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 3
+
+// Generation
+// ----------
+
+/**
+ * Fills an empty scene with buildings and antennas in a square grid
+ *
+ * Each building and each antenna lies in its own cell, and the discs of the
+ * antennas reach a few neighbouring cells.
+ *
+ * @param scene        The scene, which must be empty
+ * @param num_objects  The number of buildings, and of antennas
+ * @return             The side of the grid, in cells
+ */
+unsigned int fill_grid_scene(struct Scene* scene, unsigned int num_objects) {
+  unsigned int side = 1;
+  while (side * side < 2 * num_objects)
+    ++side;
+  reserve_scene(scene, num_objects, num_objects);
+  for (unsigned int o = 0; o < num_objects; ++o) {
+    struct Building* building = scene->buildings + o;
+    char building_id[16];
+    snprintf(building_id, sizeof(building_id), "b%u", o % 1000000000);
+    set_building_identifier(scene, building, building_id);
+    building->x = (2 * o % side) * CELL_SIZE;
+    building->y = (2 * o / side) * CELL_SIZE;
+    building->w = 1 + rand() % 4;
+    building->h = 1 + rand() % 4;
+    struct Antenna* antenna = scene->antennas + o;
+    char antenna_id[16];
+    snprintf(antenna_id, sizeof(antenna_id), "a%u", o % 1000000000);
+    set_antenna_identifier(scene, antenna, antenna_id);
+    antenna->x = ((2 * o + 1) % side) * CELL_SIZE;
+    antenna->y = ((2 * o + 1) / side) * CELL_SIZE;
+    antenna->r = 1 + rand() % (2 * CELL_SIZE);
+  }
+  scene->num_buildings = num_objects;
+  scene->num_antennas = num_objects;
+  return side;
+}
+
+/**
+ * Writes random queries of one kind in a file
+ *
+ * @param path         The path of the file
+ * @param kind         The kind of the queries
+ * @param side         The side of the grid of the scene, in cells
+ * @param num_queries  The number of queries
+ */
+void write_queries(const char* path, enum SceneQueryKind kind,
+                   unsigned int side, unsigned int num_queries) {
+  FILE* file = fopen(path, "w");
+  if (file == NULL)
+    exit(1);
+  int extent = side * CELL_SIZE;
+  for (unsigned int q = 0; q < num_queries; ++q) {
+    int x = rand() % extent, y = rand() % extent;
+    if (kind == QUERY_ANTENNAS_AT_POINT)
+      fprintf(file, "antennas %d %d\n", x, y);
+    else if (kind == QUERY_BUILDINGS_AT_POINT)
+      fprintf(file, "buildings %d %d\n", x, y);
+    else
+      fprintf(file, "window %d %d %d %d\n", x, y, x + rand() % 50,
+              y + rand() % 50);
+  }
+  fclose(file);
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in seconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Measures the best time taken to answer the queries of a file
+ *
+ * @param index  The index of the scene
+ * @param path   The path of the query file
+ * @return       The best time, in seconds
+ */
+double measure_queries(const struct SceneIndex* index, const char* path) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    struct Error error;
+    struct LineReader reader;
+    FILE* file = fopen("/dev/null", "w");
+    double start = now();
+    if (!open_line_reader(&reader, path, &error)
+        || !answer_scene_queries(index, &reader, file, &error)) {
+      print_error(&error, stderr);
+      exit(1);
+    }
+    close_line_reader(&reader);
+    fclose(file);
+    double elapsed = now() - start;
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints the time taken to index a scene, then the time taken to answer
+ * random queries of each kind and the corresponding throughput.
+ */
+int main(void) {
+  srand(2025);
+  struct Scene* scene = create_scene();
+  unsigned int side = fill_grid_scene(scene, NUM_OBJECTS);
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct SceneIndex index;
+  double start = now();
+  build_scene_index(&index, scene, &arena);
+  printf("%u buildings and %u antennas indexed in %.1f ms\n", NUM_OBJECTS,
+         NUM_OBJECTS, (now() - start) * 1e3);
+  printf("%10s %12s %12s %14s\n", "query", "queries", "time (ms)",
+         "queries/s");
+  const char* names[] = {"antennas", "buildings", "window"};
+  const enum SceneQueryKind kinds[] = {QUERY_ANTENNAS_AT_POINT,
+                                       QUERY_BUILDINGS_AT_POINT, QUERY_WINDOW};
+  char path[] = "/tmp/bench_query_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0)
+    return 1;
+  close(fd);
+  for (unsigned int k = 0; k < 3; ++k) {
+    write_queries(path, kinds[k], side, NUM_QUERIES);
+    double elapsed = measure_queries(&index, path);
+    printf("%10s %12u %12.1f %14.0f\n", names[k], NUM_QUERIES, elapsed * 1e3,
+           NUM_QUERIES / elapsed);
+  }
+  unlink(path);
+  free_arena(&arena);
+  delete_scene(scene);
+  return 0;
+}
@@ -0,0 +1,208 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "arena.h"
+#include "pool.h"
+#include "query.h"
+#include "render.h"
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The side of the grid cell holding one building
+#define CELL_SIZE 10
+// The maximum radius of an antenna
+#define MAX_RADIUS 30
+// The largest number of pixels on which the per-pixel rendering is run
+#define MAX_NAIVE_PIXELS 300000
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 3
+
+// Generation
+// ----------
+
+/**
+ * Generates a scene with as many buildings as antennas
+ *
+ * Each building lies inside its own cell of a square grid, and the antennas
+ * are spread uniformly over the grid.
+ *
+ * @param scene        The resulting scene, which must be empty
+ * @param num_objects  The number of buildings and of antennas
+ */
+void fill_scene(struct Scene* scene, unsigned int num_objects) {
+  unsigned int side = 1;
+  while (side * side < num_objects)
+    ++side;
+  reserve_scene(scene, num_objects, num_objects);
+  for (unsigned int b = 0; b < num_objects; ++b) {
+    struct Building* building = scene->buildings + b;
+    char building_id[16];
+    snprintf(building_id, sizeof(building_id), "b%u", b % 1000000000);
+    set_building_identifier(scene, building, building_id);
+    building->w = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->h = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->x = (b % side) * CELL_SIZE + CELL_SIZE / 2;
+    building->y = (b / side) * CELL_SIZE + CELL_SIZE / 2;
+  }
+  for (unsigned int a = 0; a < num_objects; ++a) {
+    struct Antenna* antenna = scene->antennas + a;
+    char antenna_id[16];
+    snprintf(antenna_id, sizeof(antenna_id), "a%u", a % 1000000000);
+    set_antenna_identifier(scene, antenna, antenna_id);
+    antenna->x = rand() % (side * CELL_SIZE);
+    antenna->y = rand() % (side * CELL_SIZE);
+    antenna->r = 1 + rand() % MAX_RADIUS;
+  }
+  scene->num_buildings = num_objects;
+  scene->num_antennas = num_objects;
+}
+
+// Rendering
+// ---------
+
+/**
+ * Renders the pixels of a map by testing every object at every pixel
+ *
+ * @param scene   The scene
+ * @param frame   The frame of the map
+ * @param pixels  The resulting gray levels (frame->width * frame->height
+ *                items, row by row)
+ */
+void render_naive(const struct Scene* scene, const struct RenderFrame* frame,
+                  unsigned char* pixels) {
+  for (unsigned int j = 0; j < frame->height; ++j) {
+    double y = frame->ymax + (j + 0.5) * -frame->scale;
+    for (unsigned int i = 0; i < frame->width; ++i) {
+      double x = frame->xmin + (i + 0.5) * frame->scale;
+      int level = 0, num_antennas = 0;
+      for (unsigned int b = 0; b < scene->num_buildings; ++b) {
+        const struct Building* building = scene->buildings + b;
+        if (x >= (double)building->x - building->w &&
+            x <= (double)building->x + building->w &&
+            y >= (double)building->y - building->h &&
+            y <= (double)building->y + building->h)
+          level = RENDER_BUILDING_LEVEL;
+      }
+      for (unsigned int a = 0; a < scene->num_antennas; ++a) {
+        const struct Antenna* antenna = scene->antennas + a;
+        double ax = antenna->x, ay = antenna->y, r = antenna->r;
+        if (y < ay - r || y > ay + r)
+          continue;
+        double dy = y - ay, half = sqrt(r * r - dy * dy);
+        num_antennas += x >= ax - half && x <= ax + half;
+      }
+      pixels[(size_t)j * frame->width + i] =
+        level + (num_antennas < RENDER_MAX_ANTENNAS
+                 ? num_antennas : RENDER_MAX_ANTENNAS) * RENDER_ANTENNA_LEVEL;
+    }
+  }
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in milliseconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now_ms(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+/**
+ * Measures the best time taken to render a map by tiles
+ *
+ * @param index     The index of the scene
+ * @param frame     The frame of the map
+ * @param pool      The thread pool
+ * @param expected  The expected gray levels (NULL if unknown)
+ * @return          The best time, in milliseconds
+ */
+double measure_tiles(const struct SceneIndex* index,
+                     const struct RenderFrame* frame,
+                     struct ThreadPool* pool,
+                     const unsigned char* expected) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    char* image = NULL;
+    size_t size = 0;
+    FILE* file = expected == NULL ? fopen("/dev/null", "wb")
+                                  : open_memstream(&image, &size);
+    double start = now_ms();
+    render_scene(index, frame, pool, file);
+    fflush(file);
+    double elapsed = now_ms() - start;
+    fclose(file);
+    size_t num_pixels = (size_t)frame->width * frame->height;
+    if (expected != NULL &&
+        (size < num_pixels ||
+         memcmp(image + size - num_pixels, expected, num_pixels) != 0)) {
+      fprintf(stderr, "error: the renderings disagree\n");
+      exit(1);
+    }
+    free(image);
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints, for scenes and maps of increasing sizes, the time taken to render
+ * the coverage map by testing every object at every pixel (on the smaller
+ * maps), and by tiles from the spatial index of the scene.
+ */
+int main(void) {
+  const unsigned int num_objects[] = {1000, 5000, 500000},
+                     resolutions[] = {256, 512, 16384};
+  const unsigned int num_sizes = sizeof(num_objects) / sizeof(num_objects[0]);
+  struct ThreadPool pool;
+  struct Error error;
+  if (!create_thread_pool(&pool, 1, &error)) {
+    print_error(&error, stderr);
+    return 1;
+  }
+  srand(2025);
+  printf("%10s %10s %14s %14s\n", "objects", "pixels", "naive (ms)",
+         "tiles (ms)");
+  for (unsigned int s = 0; s < num_sizes; ++s) {
+    struct Scene* scene = create_scene();
+    fill_scene(scene, num_objects[s]);
+    struct Arena arena;
+    initialize_arena(&arena);
+    struct SceneIndex index;
+    build_scene_index(&index, scene, &arena);
+    struct RenderFrame frame;
+    compute_render_frame(scene, resolutions[s], &frame);
+    size_t num_pixels = (size_t)frame.width * frame.height;
+    printf("%10u %10zu", 2 * num_objects[s], num_pixels);
+    unsigned char* expected = NULL;
+    if (num_pixels <= MAX_NAIVE_PIXELS) {
+      expected = malloc(num_pixels);
+      double start = now_ms();
+      render_naive(scene, &frame, expected);
+      printf(" %14.3f", now_ms() - start);
+    } else {
+      printf(" %14s", "-");
+    }
+    printf(" %14.3f\n", measure_tiles(&index, &frame, &pool, expected));
+    free(expected);
+    free_arena(&arena);
+    delete_scene(scene);
+  }
+  destroy_thread_pool(&pool);
+  return 0;
+}
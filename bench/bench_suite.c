@@ -0,0 +1,243 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "coverage.h"
+#include "generator.h"
+#include "input.h"
+#include "pool.h"
+#include "scene.h"
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The smallest number of objects of a scene
+#define MIN_OBJECTS 100
+// The default largest number of objects of a scene
+#define DEFAULT_MAX_OBJECTS 10000000
+// The seed of the generated scenes
+#define SUITE_SEED 2025
+
+// Types
+// -----
+
+// An operation whose time is measured on a scene
+enum Operation {
+  OPERATION_LOAD,
+  OPERATION_VALIDATE,
+  OPERATION_DESCRIBE,
+  OPERATION_BOUNDING_BOX,
+  OPERATION_COVERAGE,
+  NUM_OPERATIONS
+};
+
+// The names of the operations, as printed in the CSV
+const char* OPERATION_NAMES[NUM_OPERATIONS] = {
+  "load", "validate", "describe", "bounding-box", "coverage"
+};
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in seconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Returns the number of runs of each measure on a scene
+ *
+ * The smaller scenes are measured more often, since their times are both
+ * shorter and noisier.
+ *
+ * @param num_objects  The number of objects of the scene
+ * @return             The number of runs
+ */
+unsigned int suite_runs(unsigned int num_objects) {
+  if (num_objects <= 10000)
+    return 100;
+  if (num_objects <= 100000)
+    return 20;
+  return num_objects <= 1000000 ? 5 : 3;
+}
+
+/**
+ * Exits after printing an error
+ *
+ * @param error  The error
+ */
+void fail(const struct Error* error) {
+  print_error(error, stderr);
+  exit(1);
+}
+
+/**
+ * Loads a scene file
+ *
+ * @param path  The path of the scene file
+ * @return      The scene, to be deleted with delete_scene
+ */
+struct Scene* load_suite_scene(const char* path) {
+  struct Input input;
+  struct Error error;
+  struct Scene* scene = create_scene();
+  if (!open_file_input(&input, path, &error) ||
+      !load_scene(scene, &input, &error))
+    fail(&error);
+  close_input(&input);
+  return scene;
+}
+
+/**
+ * Measures an operation once
+ *
+ * The load is measured from the file. The bounding box is streamed and
+ * validated from the file, as by the bounding-box subcommand. The other
+ * operations are measured on the scene already loaded, their output being
+ * discarded.
+ *
+ * @param operation  The operation
+ * @param path       The path of the scene file
+ * @param scene      The loaded scene
+ * @param pool       The thread pool
+ * @param null       A file discarding what is written
+ * @return           The time taken, in seconds
+ */
+double measure_operation(enum Operation operation, const char* path,
+                         const struct Scene* scene, struct ThreadPool* pool,
+                         FILE* null) {
+  struct Error error;
+  double start = now();
+  switch (operation) {
+    case OPERATION_LOAD:
+      delete_scene(load_suite_scene(path));
+      break;
+    case OPERATION_VALIDATE:
+      if (!validate_scene(scene, pool, &error))
+        fail(&error);
+      break;
+    case OPERATION_DESCRIBE:
+      print_scene_summary(scene, null);
+      print_scene_buildings(scene, null);
+      print_scene_antennas(scene, null);
+      break;
+    case OPERATION_BOUNDING_BOX: {
+      struct LineReader reader;
+      struct SceneAggregates aggregates;
+      if (!open_line_reader(&reader, path, &error) ||
+          !stream_scene(&reader, true, &aggregates, &error))
+        fail(&error);
+      close_line_reader(&reader);
+      print_aggregates_bounding_box(&aggregates, null);
+      break;
+    }
+    default: {
+      struct Arena arena;
+      struct SceneCoverage coverage;
+      initialize_arena(&arena);
+      compute_scene_coverage(scene, &coverage, pool, &arena);
+      print_scene_coverage(scene, &coverage, null);
+      free_arena(&arena);
+    }
+  }
+  return now() - start;
+}
+
+/**
+ * Compares two times, for qsort
+ *
+ * @param a  The first time
+ * @param b  The second time
+ * @return   A negative, null or positive number if a < b, a = b or a > b
+ */
+int compare_times(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * Returns a percentile of sorted times, by the nearest-rank method
+ *
+ * @param times       The times, in increasing order
+ * @param num_times   The number of times
+ * @param percentile  The percentile, between 1 and 100
+ * @return            The time
+ */
+double percentile_time(const double* times, unsigned int num_times,
+                       unsigned int percentile) {
+  unsigned int rank = (num_times * percentile + 99) / 100;
+  return times[rank == 0 ? 0 : rank - 1];
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Generates uniform scenes of 10^2 objects to the largest number given as
+ * argument (10^7 by default), half buildings and half antennas, and prints
+ * as CSV the median and the 99th percentile of the time of each operation,
+ * in milliseconds.
+ *
+ * @param argc  The number of arguments
+ * @param argv  The arguments
+ * @return      0
+ */
+int main(int argc, char* argv[]) {
+  unsigned long max_objects = argc >= 2 ? strtoul(argv[1], NULL, 10)
+                                        : DEFAULT_MAX_OBJECTS;
+  FILE* null = fopen("/dev/null", "w");
+  struct ThreadPool pool;
+  struct Error error;
+  if (!create_thread_pool(&pool, 1, &error))
+    fail(&error);
+  printf("operation,objects,runs,median_ms,p99_ms\n");
+  for (unsigned long n = MIN_OBJECTS; n <= max_objects; n *= 10) {
+    struct GeneratorOptions options;
+    initialize_generator_options(&options);
+    options.num_buildings = n / 2;
+    options.num_antennas = n - n / 2;
+    options.seed = SUITE_SEED;
+    char path[] = "/tmp/kover-suite-XXXXXX";
+    int fd = mkstemp(path);
+    FILE* file = fd < 0 ? NULL : fdopen(fd, "w");
+    if (file == NULL) {
+      if (fd >= 0)
+        unlink(path);
+      report_error_cannot_write_file(&error, path);
+      fail(&error);
+    }
+    if (!generate_scene(&options, file, &error))
+      fail(&error);
+    fclose(file);
+    struct Scene* scene = load_suite_scene(path);
+    unsigned int num_runs = suite_runs(n);
+    double* times = malloc(num_runs * sizeof(double));
+    for (unsigned int o = 0; o < NUM_OPERATIONS; ++o) {
+      for (unsigned int r = 0; r < num_runs; ++r)
+        times[r] = measure_operation(o, path, scene, &pool, null);
+      qsort(times, num_runs, sizeof(double), compare_times);
+      printf("%s,%lu,%u,%.3f,%.3f\n", OPERATION_NAMES[o], n, num_runs,
+             percentile_time(times, num_runs, 50) * 1e3,
+             percentile_time(times, num_runs, 99) * 1e3);
+      fflush(stdout);
+    }
+    free(times);
+    delete_scene(scene);
+    unlink(path);
+  }
+  destroy_thread_pool(&pool);
+  fclose(null);
+  return 0;
+}
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "coverage.h"
+#include "input.h"
+#include "overlap.h"
+#include "pool.h"
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The side of the grid cell holding one building
+#define CELL_SIZE 10
+// The maximum radius of an antenna
+#define MAX_RADIUS 30
+// The number of buildings and of antennas of the scene
+#define NUM_OBJECTS 1000000
+// The number of repetitions of each measure
+#define NUM_REPETITIONS 3
+
+// Generation
+// ----------
+
+/**
+ * Generates a valid scene with as many buildings as antennas
+ *
+ * Each building lies inside its own cell of a square grid, and the antennas
+ * are spread uniformly over the grid.
+ *
+ * @param scene        The resulting scene, which must be empty
+ * @param num_objects  The number of buildings and of antennas
+ */
+void fill_scene(struct Scene* scene, unsigned int num_objects) {
+  unsigned int side = 1;
+  while (side * side < num_objects)
+    ++side;
+  reserve_scene(scene, num_objects, num_objects);
+  for (unsigned int b = 0; b < num_objects; ++b) {
+    struct Building* building = scene->buildings + b;
+    char building_id[16];
+    snprintf(building_id, sizeof(building_id), "b%u", b % 1000000000);
+    set_building_identifier(scene, building, building_id);
+    building->w = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->h = 1 + rand() % (CELL_SIZE / 2 - 1);
+    building->x = (b % side) * CELL_SIZE + CELL_SIZE / 2;
+    building->y = (b / side) * CELL_SIZE + CELL_SIZE / 2;
+  }
+  for (unsigned int a = 0; a < num_objects; ++a) {
+    struct Antenna* antenna = scene->antennas + a;
+    char antenna_id[16];
+    snprintf(antenna_id, sizeof(antenna_id), "a%u", a % 1000000000);
+    set_antenna_identifier(scene, antenna, antenna_id);
+    antenna->x = rand() % (side * CELL_SIZE);
+    antenna->y = rand() % (side * CELL_SIZE);
+    antenna->r = 1 + rand() % MAX_RADIUS;
+  }
+  scene->num_buildings = num_objects;
+  scene->num_antennas = num_objects;
+}
+
+// Measures
+// --------
+
+/**
+ * Returns the current time in milliseconds
+ *
+ * @return  The time elapsed since an arbitrary origin
+ */
+double now_ms(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+/**
+ * Measures the best running time of the loading of a text scene
+ *
+ * @param text  The text of the scene
+ * @param pool  The thread pool
+ * @return      The best running time, in milliseconds
+ */
+double measure_loading(const struct Input* text, struct ThreadPool* pool) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    struct Scene* scene = create_scene();
+    struct Error error;
+    double start = now_ms();
+    if (!load_scene_in_parallel(scene, text, pool, &error)) {
+      fprintf(stderr, "error: %s\n", error.message);
+      exit(1);
+    }
+    double elapsed = now_ms() - start;
+    delete_scene(scene);
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+/**
+ * Measures the best running time of the overlap validation
+ *
+ * @param scene  The scene
+ * @param pool   The thread pool
+ * @return       The best running time, in milliseconds
+ */
+double measure_validation(const struct Scene* scene,
+                          struct ThreadPool* pool) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    unsigned int b1, b2;
+    double start = now_ms();
+    if (find_overlapping_buildings_in_parallel(scene->buildings,
+                                               scene->num_buildings,
+                                               &b1, &b2, pool)) {
+      fprintf(stderr, "error: generated buildings are overlapping\n");
+      exit(1);
+    }
+    double elapsed = now_ms() - start;
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+/**
+ * Measures the best running time of the coverage computation
+ *
+ * @param scene  The scene
+ * @param pool   The thread pool
+ * @return       The best running time, in milliseconds
+ */
+double measure_coverage(const struct Scene* scene, struct ThreadPool* pool) {
+  double best = -1;
+  for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+    struct Arena arena;
+    initialize_arena(&arena);
+    struct SceneCoverage coverage;
+    double start = now_ms();
+    compute_scene_coverage(scene, &coverage, pool, &arena);
+    double elapsed = now_ms() - start;
+    free_arena(&arena);
+    if (best < 0 || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Main function
+// -------------
+
+/**
+ * Main function
+ *
+ * Prints, for increasing numbers of threads, the running time of the loading
+ * of a large text scene, of the overlap validation and of the coverage
+ * computation, and their speedup over one thread.
+ */
+int main(void) {
+  const unsigned int threads[] = {1, 2, 4, 8, 16, 32};
+  const unsigned int num_threads = sizeof(threads) / sizeof(threads[0]);
+  srand(2025);
+  struct Scene* scene = create_scene();
+  fill_scene(scene, NUM_OBJECTS);
+  char* data;
+  size_t size;
+  FILE* file = open_memstream(&data, &size);
+  print_scene(scene, file);
+  fclose(file);
+  struct Input text = {data, size, false};
+  printf("%u buildings and %u antennas, %ld online processors\n",
+         NUM_OBJECTS, NUM_OBJECTS, sysconf(_SC_NPROCESSORS_ONLN));
+  printf("%10s %16s %10s %16s %10s %16s %10s\n", "threads", "loading (ms)",
+         "speedup", "validation (ms)", "speedup", "coverage (ms)", "speedup");
+  double loading_1 = 0, validation_1 = 0, coverage_1 = 0;
+  for (unsigned int t = 0; t < num_threads; ++t) {
+    struct ThreadPool pool;
+    struct Error error;
+    if (!create_thread_pool(&pool, threads[t], &error)) {
+      print_error(&error, stderr);
+      return 1;
+    }
+    double loading = measure_loading(&text, &pool),
+           validation = measure_validation(scene, &pool),
+           coverage = measure_coverage(scene, &pool);
+    destroy_thread_pool(&pool);
+    if (t == 0) {
+      loading_1 = loading;
+      validation_1 = validation;
+      coverage_1 = coverage;
+    }
+    printf("%10u %16.2f %9.2fx %16.2f %9.2fx %16.2f %9.2fx\n", threads[t],
+           loading, loading_1 / loading, validation,
+           validation_1 / validation, coverage, coverage_1 / coverage);
+  }
+  free(data);
+  delete_scene(scene);
+  return 0;
+}
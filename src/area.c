@@ -0,0 +1,344 @@
+#include "area.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "arena.h"
+#include "coverage.h"
+#include "pool.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The number of buildings handled by a task of the fraction computation
+#define FRACTION_CHUNK_SIZE 64
+
+// Types
+// -----
+
+// A computation of covered fractions, split in chunks of buildings
+struct FractionJob {
+  // The scene
+  const struct Scene* scene;
+  // The coverage of its buildings
+  const struct SceneCoverage* coverage;
+  // The resulting fractions
+  double* fractions;
+};
+
+// Analytic areas
+// --------------
+
+/**
+ * Clamps a value to an interval
+ *
+ * @param value  The value
+ * @param low    The lower bound of the interval
+ * @param high   The upper bound of the interval
+ * @return       The closest value of the interval
+ */
+double clamp(double value, double low, double high) {
+  return value < low ? low : value > high ? high : value;
+}
+
+/**
+ * Returns a primitive of the height of a disc above a horizontal line
+ *
+ * The height of the disc of radius r centered at the origin above the line
+ * y = h, at abscissa x, is sqrt(r^2 - x^2) - h.
+ *
+ * @param x  The abscissa, in [-r, r]
+ * @param h  The ordinate of the line
+ * @param r  The radius of the disc
+ * @return   The value of the primitive at x
+ */
+double height_primitive(double x, double h, double r) {
+  double root = r * r - x * x;
+  return 0.5 * (x * sqrt(root > 0 ? root : 0) +
+                r * r * asin(clamp(x / r, -1, 1))) - h * x;
+}
+
+/**
+ * Returns the area of a disc above a horizontal line, within a vertical band
+ *
+ * @param xmin  The left side of the band
+ * @param xmax  The right side of the band
+ * @param h     The ordinate of the line, which must be nonnegative
+ * @param r     The radius of the disc, centered at the origin
+ * @return      The area of the disc in [xmin, xmax] x [h, +infinity)
+ */
+double area_above(double xmin, double xmax, double h, double r) {
+  if (h >= r)
+    return 0;
+  double half_chord = sqrt(r * r - h * h);
+  return height_primitive(clamp(xmax, -half_chord, half_chord), h, r) -
+         height_primitive(clamp(xmin, -half_chord, half_chord), h, r);
+}
+
+// Quadtree
+// --------
+
+/**
+ * Returns the area of a cell covered by the union of discs
+ *
+ * @param cell     The cell
+ * @param discs    The discs that may meet the cell
+ * @param depth    The depth of the cell in the quadtree
+ * @param buffers  The discs meeting the cells of each depth
+ * @return         The covered area
+ */
+double covered_area(const struct Cell* cell, const struct DiscSet* discs,
+                    unsigned int depth, struct DiscSet* buffers) {
+  struct DiscSet* meeting = buffers + depth;
+  bool contains;
+  select_meeting_discs(discs, cell, meeting, &contains);
+  if (contains)
+    return (cell->xmax - cell->xmin) * (cell->ymax - cell->ymin);
+  double largest = 0;
+  if (meeting->size == 1 || depth == MAX_QUADTREE_DEPTH) {
+    for (unsigned int d = 0; d < meeting->size; ++d) {
+      struct Cell relative = {cell->xmin - meeting->x[d],
+                              cell->ymin - meeting->y[d],
+                              cell->xmax - meeting->x[d],
+                              cell->ymax - meeting->y[d]};
+      double area = disc_rectangle_area(&relative, meeting->r[d]);
+      largest = area > largest ? area : largest;
+    }
+    return largest;
+  }
+  if (meeting->size == 0)
+    return 0;
+  double x = 0.5 * (cell->xmin + cell->xmax),
+         y = 0.5 * (cell->ymin + cell->ymax);
+  struct Cell children[4] = {{cell->xmin, cell->ymin, x, y},
+                             {x, cell->ymin, cell->xmax, y},
+                             {cell->xmin, y, x, cell->ymax},
+                             {x, y, cell->xmax, cell->ymax}};
+  double area = 0;
+  for (unsigned int c = 0; c < 4; ++c)
+    area += covered_area(children + c, meeting, depth + 1, buffers);
+  return area;
+}
+
+/**
+ * Allocates the arrays of a disc set
+ *
+ * @param discs     The disc set
+ * @param capacity  The number of discs the set must hold
+ * @param arena     The arena from which the arrays are allocated
+ */
+void allocate_disc_set(struct DiscSet* discs, unsigned int capacity,
+                       struct Arena* arena) {
+  discs->size = 0;
+  discs->x = arena_allocate(arena, capacity * sizeof(double));
+  discs->y = arena_allocate(arena, capacity * sizeof(double));
+  discs->r = arena_allocate(arena, capacity * sizeof(double));
+}
+
+/**
+ * Returns the fraction of the area of a building covered by antennas
+ *
+ * @param scene     The scene
+ * @param coverage  The coverage of its buildings
+ * @param b         The index of the building
+ * @param arena     The arena used for temporary storage
+ * @return          The covered fraction, in [0, 1]
+ */
+double covered_fraction(const struct Scene* scene,
+                        const struct SceneCoverage* coverage, unsigned int b,
+                        struct Arena* arena) {
+  unsigned int first = coverage->offsets[b], end = coverage->offsets[b + 1];
+  if (coverage->num_full[b] > 0)
+    return 1;
+  if (first == end)
+    return 0;
+  const struct Building* building = scene->buildings + b;
+  struct DiscSet discs, buffers[MAX_QUADTREE_DEPTH + 1];
+  allocate_disc_set(&discs, end - first, arena);
+  for (unsigned int d = 0; d <= MAX_QUADTREE_DEPTH; ++d)
+    allocate_disc_set(buffers + d, end - first, arena);
+  for (unsigned int i = first; i < end; ++i) {
+    const struct Antenna* antenna = scene->antennas + coverage->antennas[i];
+    discs.x[discs.size] = (double)((long long)antenna->x - building->x);
+    discs.y[discs.size] = (double)((long long)antenna->y - building->y);
+    discs.r[discs.size++] = antenna->r;
+  }
+  struct Cell cell = {-building->w, -building->h, building->w, building->h};
+  double area = covered_area(&cell, &discs, 0, buffers);
+  return clamp(area / (4.0 * building->w * building->h), 0, 1);
+}
+
+/**
+ * Computes the covered fractions of a chunk of consecutive buildings
+ *
+ * @param context  The FractionJob
+ * @param chunk    The index of the chunk
+ * @param worker   The index of the worker running the task (unused)
+ */
+void compute_chunk_fractions(void* context, unsigned int chunk,
+                             unsigned int worker) {
+  (void)worker;
+  struct FractionJob* job = context;
+  unsigned int num_buildings = job->scene->num_buildings,
+               start = chunk * FRACTION_CHUNK_SIZE,
+               end = num_buildings - start < FRACTION_CHUNK_SIZE
+                   ? num_buildings : start + FRACTION_CHUNK_SIZE;
+  struct Arena arena;
+  initialize_arena(&arena);
+  for (unsigned int b = start; b < end; ++b)
+    job->fractions[b] = covered_fraction(job->scene, job->coverage, b, &arena);
+  free_arena(&arena);
+}
+
+// Public functions definition
+// ===========================
+
+// Kernels
+// -------
+
+double disc_rectangle_area(const struct Cell* cell, double r) {
+  double area;
+  if (cell->ymin >= 0)
+    area = area_above(cell->xmin, cell->xmax, cell->ymin, r) -
+           area_above(cell->xmin, cell->xmax, cell->ymax, r);
+  else if (cell->ymax <= 0)
+    area = area_above(cell->xmin, cell->xmax, -cell->ymax, r) -
+           area_above(cell->xmin, cell->xmax, -cell->ymin, r);
+  else
+    area = 2 * area_above(cell->xmin, cell->xmax, 0, r) -
+           area_above(cell->xmin, cell->xmax, cell->ymax, r) -
+           area_above(cell->xmin, cell->xmax, -cell->ymin, r);
+  return area > 0 ? area : 0;
+}
+
+void select_meeting_discs(const struct DiscSet* discs, const struct Cell* cell,
+                          struct DiscSet* meeting, bool* contains) {
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("avx2")) {
+    select_meeting_discs_avx2(discs, cell, meeting, contains);
+    return;
+  }
+#endif
+  select_meeting_discs_scalar(discs, cell, meeting, contains);
+}
+
+void select_meeting_discs_scalar(const struct DiscSet* discs,
+                                 const struct Cell* cell,
+                                 struct DiscSet* meeting, bool* contains) {
+  meeting->size = 0;
+  *contains = false;
+  for (unsigned int d = 0; d < discs->size; ++d) {
+    double x = discs->x[d], y = discs->y[d], r2 = discs->r[d] * discs->r[d];
+    double near_x = fmax(fmax(cell->xmin - x, x - cell->xmax), 0),
+           near_y = fmax(fmax(cell->ymin - y, y - cell->ymax), 0),
+           far_x = fmax(x - cell->xmin, cell->xmax - x),
+           far_y = fmax(y - cell->ymin, cell->ymax - y);
+    if (far_x * far_x + far_y * far_y <= r2) {
+      *contains = true;
+      return;
+    }
+    if (near_x * near_x + near_y * near_y < r2) {
+      meeting->x[meeting->size] = x;
+      meeting->y[meeting->size] = y;
+      meeting->r[meeting->size++] = discs->r[d];
+    }
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2")))
+void select_meeting_discs_avx2(const struct DiscSet* discs,
+                               const struct Cell* cell,
+                               struct DiscSet* meeting, bool* contains) {
+  meeting->size = 0;
+  *contains = false;
+  __m256d xmin = _mm256_set1_pd(cell->xmin), ymin = _mm256_set1_pd(cell->ymin),
+          xmax = _mm256_set1_pd(cell->xmax), ymax = _mm256_set1_pd(cell->ymax),
+          zero = _mm256_setzero_pd();
+  unsigned int d = 0;
+  for (; d + 8 <= discs->size; d += 8) {
+    // The 8 discs are handled as two vectors of 4 coordinates
+    for (unsigned int half = 0; half < 8; half += 4) {
+      __m256d x = _mm256_loadu_pd(discs->x + d + half),
+              y = _mm256_loadu_pd(discs->y + d + half),
+              r = _mm256_loadu_pd(discs->r + d + half),
+              r2 = _mm256_mul_pd(r, r);
+      __m256d near_x = _mm256_max_pd(_mm256_max_pd(_mm256_sub_pd(xmin, x),
+                                                   _mm256_sub_pd(x, xmax)),
+                                     zero),
+              near_y = _mm256_max_pd(_mm256_max_pd(_mm256_sub_pd(ymin, y),
+                                                   _mm256_sub_pd(y, ymax)),
+                                     zero),
+              far_x = _mm256_max_pd(_mm256_sub_pd(x, xmin),
+                                    _mm256_sub_pd(xmax, x)),
+              far_y = _mm256_max_pd(_mm256_sub_pd(y, ymin),
+                                    _mm256_sub_pd(ymax, y));
+      __m256d far = _mm256_add_pd(_mm256_mul_pd(far_x, far_x),
+                                  _mm256_mul_pd(far_y, far_y)),
+              near = _mm256_add_pd(_mm256_mul_pd(near_x, near_x),
+                                   _mm256_mul_pd(near_y, near_y));
+      if (_mm256_movemask_pd(_mm256_cmp_pd(far, r2, _CMP_LE_OQ)) != 0) {
+        *contains = true;
+        return;
+      }
+      unsigned int mask =
+        _mm256_movemask_pd(_mm256_cmp_pd(near, r2, _CMP_LT_OQ));
+      for (; mask != 0; mask &= mask - 1) {
+        unsigned int i = d + half + __builtin_ctz(mask);
+        meeting->x[meeting->size] = discs->x[i];
+        meeting->y[meeting->size] = discs->y[i];
+        meeting->r[meeting->size++] = discs->r[i];
+      }
+    }
+  }
+  // The remaining discs are handled by the scalar kernel
+  struct DiscSet tail = {discs->size - d, discs->x + d, discs->y + d,
+                         discs->r + d};
+  struct DiscSet tail_meeting = {0, meeting->x + meeting->size,
+                                 meeting->y + meeting->size,
+                                 meeting->r + meeting->size};
+  select_meeting_discs_scalar(&tail, cell, &tail_meeting, contains);
+  meeting->size += tail_meeting.size;
+}
+
+#else
+
+void select_meeting_discs_avx2(const struct DiscSet* discs,
+                               const struct Cell* cell,
+                               struct DiscSet* meeting, bool* contains) {
+  select_meeting_discs_scalar(discs, cell, meeting, contains);
+}
+
+#endif
+
+// Computation
+// -----------
+
+void compute_covered_fractions(const struct Scene* scene,
+                               const struct SceneCoverage* coverage,
+                               double* fractions, struct ThreadPool* pool) {
+  struct FractionJob job = {scene, coverage, fractions};
+  unsigned int num_chunks =
+    (scene->num_buildings + FRACTION_CHUNK_SIZE - 1) / FRACTION_CHUNK_SIZE;
+  run_pool_tasks(pool, num_chunks, compute_chunk_fractions, &job);
+}
+
+// Printing
+// --------
+
+void print_covered_fractions(const struct Scene* scene,
+                             const double* fractions, FILE* file) {
+  fprintf(file, "Covered fractions\n");
+  for (unsigned int b = 0; b < scene->num_buildings; ++b)
+    fprintf(file, "  building %s: %.6f\n",
+            building_identifier(scene, scene->buildings + b), fractions[b]);
+}
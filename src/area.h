@@ -0,0 +1,142 @@
+#ifndef AREA_H_
+#define AREA_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "coverage.h"
+#include "pool.h"
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The maximum number of subdivisions of a building by the quadtree
+#define MAX_QUADTREE_DEPTH 8
+
+// Types
+// -----
+
+// An axis-aligned cell of the quadtree
+struct Cell {
+  // The minimum x coordinate
+  double xmin;
+  // The minimum y coordinate
+  double ymin;
+  // The maximum x coordinate
+  double xmax;
+  // The maximum y coordinate
+  double ymax;
+};
+
+// A set of discs stored as a structure of arrays
+//
+// The coordinates are relative to the center of the building being measured,
+// so that they stay small enough to be represented exactly.
+struct DiscSet {
+  // The number of discs
+  unsigned int size;
+  // The x coordinates of the centers
+  double* x;
+  // The y coordinates of the centers
+  double* y;
+  // The radii
+  double* r;
+};
+
+// Kernels
+// -------
+
+/**
+ * Returns the area of the intersection of a disc and a rectangle
+ *
+ * The area is computed analytically, by integrating the height of the disc
+ * over the rectangle.
+ *
+ * @param cell  The rectangle, relative to the center of the disc
+ * @param r     The radius of the disc
+ * @return      The area of the intersection
+ */
+double disc_rectangle_area(const struct Cell* cell, double r);
+
+/**
+ * Selects the discs meeting a cell
+ *
+ * A disc meets a cell if their intersection has a strictly positive area.
+ * The search stops as soon as a disc containing the cell is found. The
+ * discs are processed 8 at a time with AVX2 when the processor supports it,
+ * and one at a time otherwise, with identical results.
+ *
+ * @param discs     The discs
+ * @param cell      The cell
+ * @param meeting   The resulting discs meeting the cell, in order (its
+ *                  arrays must hold discs->size items)
+ * @param contains  Set to true if and only if a disc contains the cell
+ */
+void select_meeting_discs(const struct DiscSet* discs, const struct Cell* cell,
+                          struct DiscSet* meeting, bool* contains);
+
+/**
+ * Selects the discs meeting a cell, one disc at a time
+ *
+ * This is the scalar implementation of select_meeting_discs.
+ *
+ * @param discs     The discs
+ * @param cell      The cell
+ * @param meeting   The resulting discs meeting the cell
+ * @param contains  Set to true if and only if a disc contains the cell
+ */
+void select_meeting_discs_scalar(const struct DiscSet* discs,
+                                 const struct Cell* cell,
+                                 struct DiscSet* meeting, bool* contains);
+
+/**
+ * Selects the discs meeting a cell, 8 discs at a time with AVX2
+ *
+ * This function must only be called if the processor supports AVX2.
+ *
+ * @param discs     The discs
+ * @param cell      The cell
+ * @param meeting   The resulting discs meeting the cell
+ * @param contains  Set to true if and only if a disc contains the cell
+ */
+void select_meeting_discs_avx2(const struct DiscSet* discs,
+                               const struct Cell* cell,
+                               struct DiscSet* meeting, bool* contains);
+
+// Computation
+// -----------
+
+/**
+ * Computes the fraction of the area of each building covered by antennas
+ *
+ * A building covered fully by an antenna has fraction 1, and a building
+ * covered by no antenna has fraction 0. Otherwise, the area covered by the
+ * union of the discs is computed with an adaptive quadtree: a cell contained
+ * in a disc or met by a single disc is measured exactly, and the other cells
+ * are subdivided, down to MAX_QUADTREE_DEPTH levels, where the largest area
+ * covered by a single disc is used.
+ *
+ * @param scene      The scene
+ * @param coverage   The coverage of its buildings
+ * @param fractions  The resulting fractions (num_buildings items)
+ * @param pool       The thread pool
+ */
+void compute_covered_fractions(const struct Scene* scene,
+                               const struct SceneCoverage* coverage,
+                               double* fractions, struct ThreadPool* pool);
+
+// Printing
+// --------
+
+/**
+ * Prints the fraction of the area of each building covered
+ *
+ * @param scene      The scene
+ * @param fractions  The fractions of its buildings
+ * @param file       The file on which the fractions are printed
+ */
+void print_covered_fractions(const struct Scene* scene,
+                             const double* fractions, FILE* file);
+
+#endif
@@ -0,0 +1,133 @@
+#include "arena.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The capacity of the first block of an arena, in bytes
+#define ARENA_INITIAL_CAPACITY 4096
+
+// Types
+// -----
+
+// A block of memory owned by an arena
+struct ArenaBlock {
+  // The block allocated before this one (NULL if none)
+  struct ArenaBlock* previous;
+  // The number of bytes available in the block
+  size_t capacity;
+  // The number of bytes already handed out
+  size_t used;
+  // The memory of the block
+  max_align_t data[];
+};
+
+// Alignment
+// ---------
+
+/**
+ * Rounds a size up to the maximal alignment
+ *
+ * @param size  The size to round
+ * @return      The rounded size
+ */
+size_t align_size(size_t size) {
+  size_t alignment = sizeof(max_align_t);
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Adds a new block to an arena
+ *
+ * The capacity of the new block is at least twice the capacity of the
+ * previous one, and large enough to hold the given size.
+ *
+ * @param arena  The arena
+ * @param size   The minimal number of available bytes in the new block
+ */
+void add_arena_block(struct Arena* arena, size_t size) {
+  size_t capacity = arena->block == NULL ? ARENA_INITIAL_CAPACITY
+                                         : 2 * arena->block->capacity;
+  while (capacity < size)
+    capacity *= 2;
+  struct ArenaBlock* block = malloc(sizeof(struct ArenaBlock) + capacity);
+  if (block == NULL)
+    report_error_out_of_memory();
+  block->previous = arena->block;
+  block->capacity = capacity;
+  block->used = 0;
+  arena->block = block;
+  ++arena->num_blocks;
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void initialize_arena(struct Arena* arena) {
+  arena->block = NULL;
+  arena->num_blocks = 0;
+}
+
+void free_arena(struct Arena* arena) {
+  struct ArenaBlock* block = arena->block;
+  while (block != NULL) {
+    struct ArenaBlock* previous = block->previous;
+    free(block);
+    block = previous;
+  }
+  initialize_arena(arena);
+}
+
+// Allocation
+// ----------
+
+void* arena_allocate(struct Arena* arena, size_t size) {
+  size = align_size(size);
+  if (arena->block == NULL ||
+      arena->block->capacity - arena->block->used < size)
+    add_arena_block(arena, size);
+  void* data = (char*)arena->block->data + arena->block->used;
+  arena->block->used += size;
+  return data;
+}
+
+void* arena_grow(struct Arena* arena, void* data,
+                 size_t old_size, size_t new_size) {
+  if (new_size <= old_size)
+    return data;
+  struct ArenaBlock* block = arena->block;
+  size_t old_aligned = align_size(old_size),
+         new_aligned = align_size(new_size);
+  if (data != NULL && block != NULL &&
+      (char*)data + old_aligned == (char*)block->data + block->used &&
+      block->capacity - block->used >= new_aligned - old_aligned) {
+    block->used += new_aligned - old_aligned;
+    return data;
+  }
+  void* grown = arena_allocate(arena, new_size);
+  if (old_size > 0)
+    memcpy(grown, data, old_size);
+  return grown;
+}
+
+// Accessors
+// ---------
+
+size_t arena_size(const struct Arena* arena) {
+  size_t size = 0;
+  for (const struct ArenaBlock* block = arena->block; block != NULL;
+       block = block->previous)
+    size += sizeof(struct ArenaBlock) + block->capacity;
+  return size;
+}
@@ -0,0 +1,87 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stddef.h>
+
+// Types
+// -----
+
+// A block of memory owned by an arena
+struct ArenaBlock;
+
+// An arena allocator
+//
+// Memory is handed out from blocks whose capacities double, so that n bytes
+// are served with O(log n) calls to malloc. Individual allocations are never
+// freed: the whole arena is released at once.
+struct Arena {
+  // The most recently allocated block (NULL if none)
+  struct ArenaBlock* block;
+  // The number of blocks allocated so far
+  unsigned int num_blocks;
+};
+
+// Construction
+// ------------
+
+/**
+ * Initializes an empty arena
+ *
+ * No memory is allocated until the first allocation request.
+ *
+ * @param arena  The arena to initialize
+ */
+void initialize_arena(struct Arena* arena);
+
+/**
+ * Frees all the memory owned by an arena
+ *
+ * The arena is left empty and can be reused.
+ *
+ * @param arena  The arena to free
+ */
+void free_arena(struct Arena* arena);
+
+// Allocation
+// ----------
+
+/**
+ * Allocates a memory region from an arena
+ *
+ * The region is suitably aligned for any type. If the memory cannot be
+ * allocated, an error is printed on stderr and the program exits with 1.
+ *
+ * @param arena  The arena
+ * @param size   The size of the region, in bytes
+ * @return       The allocated region
+ */
+void* arena_allocate(struct Arena* arena, size_t size);
+
+/**
+ * Grows a memory region previously allocated from an arena
+ *
+ * If the region is the last one allocated from the current block and the
+ * block has enough room left, it is extended in place. Otherwise, a new
+ * region is allocated and the old content is copied into it.
+ *
+ * @param arena     The arena
+ * @param data      The region to grow (may be NULL if old_size is 0)
+ * @param old_size  The current size of the region, in bytes
+ * @param new_size  The requested size of the region, in bytes
+ * @return          The grown region
+ */
+void* arena_grow(struct Arena* arena, void* data,
+                 size_t old_size, size_t new_size);
+
+// Accessors
+// ---------
+
+/**
+ * Returns the memory held by an arena
+ *
+ * @param arena  The arena
+ * @return       The size of all its blocks, in bytes
+ */
+size_t arena_size(const struct Arena* arena);
+
+#endif
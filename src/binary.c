@@ -0,0 +1,304 @@
+#include "binary.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "identifier.h"
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The byte order mark of the writer
+#define BINARY_BYTE_ORDER 0x01020304u
+// The alignment of the sections, in bytes
+#define BINARY_ALIGNMENT 8
+
+// Types
+// -----
+
+// The layout of the sections of a binary scene
+struct BinaryLayout {
+  // The offset of the building columns
+  uint64_t buildings;
+  // The offset of the antenna columns
+  uint64_t antennas;
+  // The offset of the building identifier offsets
+  uint64_t building_ids;
+  // The offset of the antenna identifier offsets
+  uint64_t antenna_ids;
+  // The offset of the identifiers
+  uint64_t ids;
+};
+
+// Layout
+// ------
+
+/**
+ * Rounds a size up to the alignment of the sections
+ *
+ * @param size  The size to round
+ * @return      The rounded size
+ */
+uint64_t align_section(uint64_t size) {
+  return (size + BINARY_ALIGNMENT - 1) / BINARY_ALIGNMENT * BINARY_ALIGNMENT;
+}
+
+/**
+ * Computes the layout of a binary scene
+ *
+ * The offsets cannot overflow, since the numbers of objects hold on 32 bits.
+ *
+ * @param header  The header of the binary scene
+ * @param layout  The resulting layout
+ */
+void compute_layout(const struct BinaryHeader* header,
+                    struct BinaryLayout* layout) {
+  uint64_t num_buildings = header->num_buildings,
+           num_antennas = header->num_antennas;
+  layout->buildings = sizeof(struct BinaryHeader);
+  layout->antennas = layout->buildings +
+                     align_section(4 * num_buildings * sizeof(int32_t));
+  layout->building_ids = layout->antennas +
+                         align_section(3 * num_antennas * sizeof(int32_t));
+  layout->antenna_ids = layout->building_ids +
+                        align_section((num_buildings + 1) * sizeof(uint32_t));
+  layout->ids = layout->antenna_ids +
+                align_section((num_antennas + 1) * sizeof(uint32_t));
+}
+
+// Loading
+// -------
+
+/**
+ * Reads an identifier from the identifiers section
+ *
+ * The identifier is rejected if it is out of bounds, is not null-terminated
+ * or has invalid characters. The identifiers section is copied in the pool
+ * of the scene, so that the identifier is not copied again.
+ *
+ * @param ids       The identifiers section
+ * @param ids_size  The size of the identifiers section
+ * @param offsets   The identifier offsets
+ * @param i         The index of the identifier
+ * @param first_id  The offset of the identifiers section in the pool
+ * @param key       The key of the identifier
+ * @param id        The resulting identifier, as a handle in the pool
+ * @param error     The error reported if the identifier is rejected
+ * @return          true if and only if the identifier was read
+ */
+bool read_identifier(const char* ids, uint64_t ids_size,
+                     const uint32_t* offsets, unsigned int i,
+                     uint32_t first_id, uint64_t* key, uint32_t* id,
+                     struct Error* error) {
+  uint32_t start = offsets[i], end = offsets[i + 1];
+  if (start >= end || end > ids_size || ids[end - 1] != '\0' ||
+      !is_valid_id(ids + start, end - start - 1))
+    return report_error_invalid_binary_scene(error);
+  *key = identifier_key(ids + start, end - start - 1);
+  *id = first_id + start;
+  return true;
+}
+
+/**
+ * Checks that an identifier follows the previous one
+ *
+ * @param object        The type of object ("building" or "antenna")
+ * @param previous_key  The key of the previous identifier
+ * @param previous      The previous identifier (NULL for the first one)
+ * @param key           The key of the identifier
+ * @param id            The identifier
+ * @param error         The error reported if the identifier is not sorted
+ * @return              true if and only if the identifier is accepted
+ */
+bool check_identifier(const char* object, uint64_t previous_key,
+                      const char* previous, uint64_t key, const char* id,
+                      struct Error* error) {
+  if (previous == NULL)
+    return true;
+  int comparison = compare_identifiers(previous_key, previous, key, id);
+  if (comparison < 0)
+    return true;
+  if (comparison == 0)
+    return report_error_non_unique_identifiers(error, object, id);
+  return report_error_invalid_binary_scene(error);
+}
+
+/**
+ * Writes an identifier, with its null terminator
+ *
+ * @param id    The identifier
+ * @param file  The file
+ */
+void write_binary_identifier(const char* id, FILE* file) {
+  fwrite(id, 1, strlen(id) + 1, file);
+}
+
+// Writing
+// -------
+
+/**
+ * Writes zeros up to the alignment of the sections
+ *
+ * @param size  The number of bytes written so far
+ * @param file  The file
+ */
+void write_padding(uint64_t size, FILE* file) {
+  static const char zeros[BINARY_ALIGNMENT] = {0};
+  fwrite(zeros, 1, align_section(size) - size, file);
+}
+
+/**
+ * Writes an integer on 32 bits
+ *
+ * @param value  The integer
+ * @param file   The file
+ */
+void write_int32(int value, FILE* file) {
+  int32_t column_value = value;
+  fwrite(&column_value, sizeof(column_value), 1, file);
+}
+
+// Public functions definition
+// ===========================
+
+// Detection
+// ---------
+
+bool is_binary_input(const struct Input* input) {
+  return input->size >= BINARY_MAGIC_LENGTH &&
+         memcmp(input->data, BINARY_MAGIC, BINARY_MAGIC_LENGTH) == 0;
+}
+
+// Loading
+// -------
+
+bool load_binary_scene(struct Scene* scene, const struct Input* input,
+                       struct Error* error) {
+  struct BinaryHeader header;
+  struct BinaryLayout layout;
+  if (input->size < sizeof(header))
+    return report_error_invalid_binary_scene(error);
+  memcpy(&header, input->data, sizeof(header));
+  if (header.version != BINARY_VERSION ||
+      header.byte_order != BINARY_BYTE_ORDER)
+    return report_error_invalid_binary_scene(error);
+  compute_layout(&header, &layout);
+  if (layout.ids > input->size || header.ids_size != input->size - layout.ids)
+    return report_error_invalid_binary_scene(error);
+  bool validated = (header.flags & BINARY_FLAG_VALIDATED) != 0;
+  unsigned int num_buildings = header.num_buildings,
+               num_antennas = header.num_antennas;
+  const int32_t* buildings =
+    (const int32_t*)(input->data + layout.buildings);
+  const int32_t* antennas = (const int32_t*)(input->data + layout.antennas);
+  const uint32_t* building_ids =
+    (const uint32_t*)(input->data + layout.building_ids);
+  const uint32_t* antenna_ids =
+    (const uint32_t*)(input->data + layout.antenna_ids);
+  const char* ids = input->data + layout.ids;
+  reserve_scene(scene, num_buildings, num_antennas);
+  uint32_t first_id = scene->ids.size;
+  reserve_identifier_pool(&scene->ids, first_id + header.ids_size);
+  if (header.ids_size > 0)
+    memcpy(scene->ids.chars + first_id, ids, header.ids_size);
+  scene->ids.size += header.ids_size;
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    struct Building* building = scene->buildings + b;
+    if (!read_identifier(ids, header.ids_size, building_ids, b, first_id,
+                         &building->key, &building->id, error) ||
+        !check_identifier("building", b == 0 ? 0 : building[-1].key,
+            b == 0 ? NULL : building_identifier(scene, building - 1),
+            building->key, building_identifier(scene, building), error))
+      return false;
+    building->x = buildings[b];
+    building->y = buildings[num_buildings + b];
+    building->w = buildings[2 * num_buildings + b];
+    building->h = buildings[3 * num_buildings + b];
+    if (building->w <= 0 || building->h <= 0)
+      return report_error_invalid_binary_scene(error);
+  }
+  for (unsigned int a = 0; a < num_antennas; ++a) {
+    struct Antenna* antenna = scene->antennas + a;
+    if (!read_identifier(ids, header.ids_size, antenna_ids, a, first_id,
+                         &antenna->key, &antenna->id, error) ||
+        !check_identifier("antenna", a == 0 ? 0 : antenna[-1].key,
+            a == 0 ? NULL : antenna_identifier(scene, antenna - 1),
+            antenna->key, antenna_identifier(scene, antenna), error))
+      return false;
+    antenna->x = antennas[a];
+    antenna->y = antennas[num_antennas + a];
+    antenna->r = antennas[2 * num_antennas + a];
+    if (antenna->r <= 0)
+      return report_error_invalid_binary_scene(error);
+  }
+  scene->num_buildings = num_buildings;
+  scene->num_antennas = num_antennas;
+  scene->is_validated = validated;
+  return true;
+}
+
+// Writing
+// -------
+
+void write_binary_scene(const struct Scene* scene, bool validated,
+                        FILE* file) {
+  struct BinaryHeader header;
+  memcpy(header.magic, BINARY_MAGIC, BINARY_MAGIC_LENGTH);
+  header.version = BINARY_VERSION;
+  header.byte_order = BINARY_BYTE_ORDER;
+  header.flags = validated ? BINARY_FLAG_VALIDATED : 0;
+  header.num_buildings = scene->num_buildings;
+  header.num_antennas = scene->num_antennas;
+  header.reserved = 0;
+  header.ids_size = 0;
+  for (unsigned int b = 0; b < scene->num_buildings; ++b)
+    header.ids_size +=
+      strlen(building_identifier(scene, scene->buildings + b)) + 1;
+  for (unsigned int a = 0; a < scene->num_antennas; ++a)
+    header.ids_size +=
+      strlen(antenna_identifier(scene, scene->antennas + a)) + 1;
+  fwrite(&header, sizeof(header), 1, file);
+  const struct Building* buildings = scene->buildings;
+  unsigned int num_buildings = scene->num_buildings;
+  for (unsigned int b = 0; b < num_buildings; ++b)
+    write_int32(buildings[b].x, file);
+  for (unsigned int b = 0; b < num_buildings; ++b)
+    write_int32(buildings[b].y, file);
+  for (unsigned int b = 0; b < num_buildings; ++b)
+    write_int32(buildings[b].w, file);
+  for (unsigned int b = 0; b < num_buildings; ++b)
+    write_int32(buildings[b].h, file);
+  write_padding(4 * num_buildings * sizeof(int32_t), file);
+  const struct Antenna* antennas = scene->antennas;
+  unsigned int num_antennas = scene->num_antennas;
+  for (unsigned int a = 0; a < num_antennas; ++a)
+    write_int32(antennas[a].x, file);
+  for (unsigned int a = 0; a < num_antennas; ++a)
+    write_int32(antennas[a].y, file);
+  for (unsigned int a = 0; a < num_antennas; ++a)
+    write_int32(antennas[a].r, file);
+  write_padding(3 * num_antennas * sizeof(int32_t), file);
+  uint32_t offset = 0;
+  for (unsigned int b = 0; b <= num_buildings; ++b) {
+    fwrite(&offset, sizeof(offset), 1, file);
+    if (b < num_buildings)
+      offset += strlen(building_identifier(scene, buildings + b)) + 1;
+  }
+  write_padding((num_buildings + 1) * sizeof(uint32_t), file);
+  for (unsigned int a = 0; a <= num_antennas; ++a) {
+    fwrite(&offset, sizeof(offset), 1, file);
+    if (a < num_antennas)
+      offset += strlen(antenna_identifier(scene, antennas + a)) + 1;
+  }
+  write_padding((num_antennas + 1) * sizeof(uint32_t), file);
+  for (unsigned int b = 0; b < num_buildings; ++b)
+    write_binary_identifier(building_identifier(scene, buildings + b), file);
+  for (unsigned int a = 0; a < num_antennas; ++a)
+    write_binary_identifier(antenna_identifier(scene, antennas + a), file);
+}
@@ -0,0 +1,105 @@
+#ifndef BINARY_H_
+#define BINARY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "input.h"
+#include "scene.h"
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The magic number starting a binary scene
+#define BINARY_MAGIC "KOVERBIN"
+// The length of the magic number
+#define BINARY_MAGIC_LENGTH 8
+// The current version of the binary format
+#define BINARY_VERSION 1
+// The flag indicating that the scene was validated before being written
+#define BINARY_FLAG_VALIDATED 1u
+
+// Types
+// -----
+
+// The header of a binary scene
+//
+// A binary scene is made of the header, followed by the following sections,
+// each starting on a multiple of 8 bytes:
+//
+//   1. The building columns x, y, w and h (int32_t[num_buildings] each)
+//   2. The antenna columns x, y and r (int32_t[num_antennas] each)
+//   3. The building identifier offsets (uint32_t[num_buildings + 1])
+//   4. The antenna identifier offsets (uint32_t[num_antennas + 1])
+//   5. The identifiers, null-terminated (char[ids_size])
+//
+// The objects are sorted by identifier, and the identifier of an object
+// starts at its offset in the identifiers section. All values are stored in
+// the byte order of the writer, which is recorded in the header.
+struct BinaryHeader {
+  // The magic number (BINARY_MAGIC, not null-terminated)
+  char magic[BINARY_MAGIC_LENGTH];
+  // The version of the format
+  uint32_t version;
+  // The byte order mark (0x01020304 in the byte order of the writer)
+  uint32_t byte_order;
+  // The flags (see BINARY_FLAG_*)
+  uint32_t flags;
+  // The number of buildings
+  uint32_t num_buildings;
+  // The number of antennas
+  uint32_t num_antennas;
+  // Unused, always 0
+  uint32_t reserved;
+  // The size of the identifiers section, in bytes
+  uint64_t ids_size;
+};
+
+// Detection
+// ---------
+
+/**
+ * Indicates if an input holds a binary scene
+ *
+ * @param input  The input
+ * @return       true if and only if the input starts with BINARY_MAGIC
+ */
+bool is_binary_input(const struct Input* input);
+
+// Loading
+// -------
+
+/**
+ * Loads a binary scene from an input
+ *
+ * The columns are copied in the scene, and the identifiers section in its
+ * pool of identifiers, without any parsing or sorting. The order of the
+ * identifiers is always checked, since the lookups rely on it, but the scene
+ * is marked as validated, without checking the positions of its objects, if
+ * the binary scene was.
+ *
+ * @param scene  The resulting scene, which must be empty
+ * @param input  The input
+ * @param error  The error reported if the input is not a well-formed binary
+ *               scene
+ * @return       true if and only if the scene was loaded
+ */
+bool load_binary_scene(struct Scene* scene, const struct Input* input,
+                       struct Error* error);
+
+// Writing
+// -------
+
+/**
+ * Writes a scene in the binary format
+ *
+ * @param scene      The scene to write
+ * @param validated  true if the scene is known to be valid
+ * @param file       The file to which the scene is written
+ */
+void write_binary_scene(const struct Scene* scene, bool validated,
+                        FILE* file);
+
+#endif
@@ -0,0 +1,203 @@
+#include "cache.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "area.h"
+#include "arena.h"
+#include "coverage.h"
+#include "hash.h"
+#include "scene.h"
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Entries
+// -------
+
+/**
+ * Returns the memory held by a cache entry
+ *
+ * @param entry  The entry
+ * @return       The size of the entry, of its content, of its scene and of
+ *               its arena
+ */
+size_t cached_scene_memory(const struct CachedScene* entry) {
+  return sizeof(struct CachedScene) + entry->size + sizeof(struct Scene) +
+         arena_size(&entry->scene->arena) + arena_size(&entry->arena);
+}
+
+/**
+ * Releases a cache entry
+ *
+ * @param entry  The entry, which must not be in a cache anymore
+ */
+void delete_cached_scene(struct CachedScene* entry) {
+  delete_scene(entry->scene);
+  free_arena(&entry->arena);
+  free(entry->content);
+  free(entry);
+}
+
+// List
+// ----
+
+/**
+ * Removes an entry from the list of a cache
+ *
+ * @param cache  The cache
+ * @param entry  The entry
+ */
+void unlink_cached_scene(struct SceneCache* cache,
+                         struct CachedScene* entry) {
+  if (entry->previous == NULL)
+    cache->first = entry->next;
+  else
+    entry->previous->next = entry->next;
+  if (entry->next == NULL)
+    cache->last = entry->previous;
+  else
+    entry->next->previous = entry->previous;
+}
+
+/**
+ * Inserts an entry at the front of the list of a cache
+ *
+ * @param cache  The cache
+ * @param entry  The entry, which must not be in the list
+ */
+void push_cached_scene(struct SceneCache* cache, struct CachedScene* entry) {
+  entry->previous = NULL;
+  entry->next = cache->first;
+  if (cache->first == NULL)
+    cache->last = entry;
+  else
+    cache->first->previous = entry;
+  cache->first = entry;
+}
+
+/**
+ * Updates the memory held by an entry and evicts entries over the budget
+ *
+ * The least recently used entries are evicted first. The given entry is
+ * never evicted, even if it exceeds the budget by itself.
+ *
+ * @param cache  The cache
+ * @param entry  The entry whose memory changed
+ */
+void account_cached_scene(struct SceneCache* cache,
+                          struct CachedScene* entry) {
+  size_t memory = cached_scene_memory(entry);
+  cache->memory += memory - entry->memory;
+  entry->memory = memory;
+  while (cache->memory > cache->budget && cache->last != entry) {
+    struct CachedScene* evicted = cache->last;
+    unlink_cached_scene(cache, evicted);
+    cache->memory -= evicted->memory;
+    --cache->num_scenes;
+    delete_cached_scene(evicted);
+  }
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void initialize_scene_cache(struct SceneCache* cache, size_t budget) {
+  cache->budget = budget;
+  cache->memory = 0;
+  cache->num_scenes = 0;
+  cache->first = NULL;
+  cache->last = NULL;
+  cache->num_hits = 0;
+  cache->num_misses = 0;
+}
+
+void free_scene_cache(struct SceneCache* cache) {
+  struct CachedScene* entry = cache->first;
+  while (entry != NULL) {
+    struct CachedScene* next = entry->next;
+    delete_cached_scene(entry);
+    entry = next;
+  }
+  initialize_scene_cache(cache, cache->budget);
+}
+
+// Lookup
+// ------
+
+struct CachedScene* find_cached_scene(struct SceneCache* cache,
+                                      const char* data, size_t size,
+                                      struct ThreadPool* pool,
+                                      struct Error* error) {
+  uint64_t hash = content_hash(data, size);
+  for (struct CachedScene* entry = cache->first; entry != NULL;
+       entry = entry->next)
+    if (entry->hash == hash && entry->size == size &&
+        memcmp(entry->content, data, size) == 0) {
+      ++cache->num_hits;
+      unlink_cached_scene(cache, entry);
+      push_cached_scene(cache, entry);
+      return entry;
+    }
+  ++cache->num_misses;
+  struct Scene* scene = create_scene();
+  if (!load_scene_from_buffer(scene, data, size, error) ||
+      (!scene->is_validated && !validate_scene(scene, pool, error))) {
+    delete_scene(scene);
+    return NULL;
+  }
+  scene->is_validated = true;
+  struct CachedScene* entry = malloc(sizeof(struct CachedScene));
+  char* content = malloc(size > 0 ? size : 1);
+  if (entry == NULL || content == NULL)
+    report_error_out_of_memory();
+  memcpy(content, data, size);
+  entry->hash = hash;
+  entry->size = size;
+  entry->content = content;
+  entry->scene = scene;
+  compute_scene_aggregates(scene, &entry->aggregates);
+  entry->has_coverage = false;
+  entry->fractions = NULL;
+  initialize_arena(&entry->arena);
+  entry->memory = 0;
+  push_cached_scene(cache, entry);
+  ++cache->num_scenes;
+  account_cached_scene(cache, entry);
+  return entry;
+}
+
+const struct SceneCoverage* get_cached_coverage(struct SceneCache* cache,
+                                                struct CachedScene* entry,
+                                                struct ThreadPool* pool) {
+  if (!entry->has_coverage) {
+    compute_scene_coverage(entry->scene, &entry->coverage, pool,
+                           &entry->arena);
+    entry->has_coverage = true;
+    account_cached_scene(cache, entry);
+  }
+  return &entry->coverage;
+}
+
+const double* get_cached_fractions(struct SceneCache* cache,
+                                   struct CachedScene* entry,
+                                   struct ThreadPool* pool) {
+  if (entry->fractions == NULL) {
+    const struct SceneCoverage* coverage =
+      get_cached_coverage(cache, entry, pool);
+    entry->fractions = arena_allocate(&entry->arena,
+                                      entry->scene->num_buildings *
+                                      sizeof(double));
+    compute_covered_fractions(entry->scene, coverage, entry->fractions,
+                              pool);
+    account_cached_scene(cache, entry);
+  }
+  return entry->fractions;
+}
@@ -0,0 +1,137 @@
+#ifndef CACHE_H_
+#define CACHE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "coverage.h"
+#include "pool.h"
+#include "scene.h"
+#include "validation.h"
+
+// Types
+// -----
+
+// A validated scene kept in a cache, with the results computed on it
+//
+// The coverage and the covered fractions are only computed when first
+// requested, and are then allocated from the arena of the entry.
+struct CachedScene {
+  // The hash of the content the scene was loaded from
+  uint64_t hash;
+  // The size of the content the scene was loaded from, in bytes
+  size_t size;
+  // The content the scene was loaded from
+  char* content;
+  // The scene
+  struct Scene* scene;
+  // The aggregates of the scene
+  struct SceneAggregates aggregates;
+  // true if the coverage was computed
+  bool has_coverage;
+  // The coverage of the buildings, if computed
+  struct SceneCoverage coverage;
+  // The covered fractions of the buildings (NULL if not computed)
+  double* fractions;
+  // The arena from which the coverage and the fractions are allocated
+  struct Arena arena;
+  // The memory held by the entry, in bytes
+  size_t memory;
+  // The entry used more recently (NULL if none)
+  struct CachedScene* previous;
+  // The entry used less recently (NULL if none)
+  struct CachedScene* next;
+};
+
+// A cache of validated scenes keyed by the hash of their content
+//
+// Since distinct contents may share a hash, each entry keeps a copy of its
+// content, which is compared to the one looked up. The entries form a list
+// from the most recently used to the least recently used one. Whenever the
+// memory held by the entries exceeds the budget, the least recently used
+// entries are evicted, except the one being used.
+struct SceneCache {
+  // The maximum memory held by the entries, in bytes
+  size_t budget;
+  // The memory held by the entries, in bytes
+  size_t memory;
+  // The number of entries
+  unsigned int num_scenes;
+  // The most recently used entry (NULL if none)
+  struct CachedScene* first;
+  // The least recently used entry (NULL if none)
+  struct CachedScene* last;
+  // The number of lookups that found their scene
+  unsigned long num_hits;
+  // The number of lookups that loaded their scene
+  unsigned long num_misses;
+};
+
+// Construction
+// ------------
+
+/**
+ * Initializes an empty scene cache
+ *
+ * @param cache   The cache to initialize
+ * @param budget  The maximum memory held by the entries, in bytes
+ */
+void initialize_scene_cache(struct SceneCache* cache, size_t budget);
+
+/**
+ * Releases all the entries of a scene cache
+ *
+ * @param cache  The cache to free
+ */
+void free_scene_cache(struct SceneCache* cache);
+
+// Lookup
+// ------
+
+/**
+ * Returns the cached scene loaded from a buffer
+ *
+ * The buffer is matched by the hash and the size of its content, then by
+ * the content itself. If no entry matches, the scene is loaded from the
+ * buffer, validated and added to the cache. The entry becomes the most
+ * recently used one.
+ *
+ * @param cache  The cache
+ * @param data   The content of the buffer
+ * @param size   The size of the buffer, in bytes
+ * @param pool   The thread pool running the validation
+ * @param error  The error reported if the scene is invalid
+ * @return       The entry, or NULL if the scene is invalid
+ */
+struct CachedScene* find_cached_scene(struct SceneCache* cache,
+                                      const char* data, size_t size,
+                                      struct ThreadPool* pool,
+                                      struct Error* error);
+
+/**
+ * Returns the coverage of a cached scene, computing it if needed
+ *
+ * @param cache  The cache
+ * @param entry  The entry
+ * @param pool   The thread pool running the computation
+ * @return       The coverage of the buildings of the scene
+ */
+const struct SceneCoverage* get_cached_coverage(struct SceneCache* cache,
+                                                struct CachedScene* entry,
+                                                struct ThreadPool* pool);
+
+/**
+ * Returns the covered fractions of a cached scene, computing them if needed
+ *
+ * @param cache  The cache
+ * @param entry  The entry
+ * @param pool   The thread pool running the computation
+ * @return       The fraction of each building covered
+ */
+const double* get_cached_fractions(struct SceneCache* cache,
+                                   struct CachedScene* entry,
+                                   struct ThreadPool* pool);
+
+#endif
@@ -0,0 +1,320 @@
+#include "coverage.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "pool.h"
+#include "rtree.h"
+#include "writer.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The initial capacity of an antenna list
+#define INITIAL_LIST_CAPACITY 16
+// The number of buildings handled by a task of the coverage computation
+#define COVERAGE_CHUNK_SIZE 256
+
+// Types
+// -----
+
+// A growable list of antenna indices
+struct AntennaList {
+  // The number of antennas in the list
+  unsigned int size;
+  // The number of antennas the list can hold before growing
+  unsigned int capacity;
+  // The antenna indices
+  unsigned int* items;
+};
+
+// The storage of a worker of the coverage computation
+struct CoverageWorker {
+  // The arena from which the antennas of the chunks are allocated
+  struct Arena arena;
+  // The arena from which the partial list is allocated
+  struct Arena scratch_arena;
+  // The antennas covering the current building partially
+  struct AntennaList partial;
+};
+
+// A coverage computation, split in chunks of consecutive buildings
+struct CoverageJob {
+  // The scene
+  const struct Scene* scene;
+  // The R-tree over the antennas
+  const struct RTree* tree;
+  // The resulting coverage, whose offsets[b + 1] first holds the number of
+  // antennas covering the building b
+  struct SceneCoverage* coverage;
+  // The antennas covering the buildings of each chunk
+  struct AntennaList* chunks;
+  // The storage of each worker
+  struct CoverageWorker* workers;
+};
+
+// Geometry
+// --------
+
+/**
+ * Returns the absolute value of a difference of integers
+ *
+ * @param a  The first integer
+ * @param b  The second integer
+ * @return   |a - b|, without overflow
+ */
+uint64_t distance(int a, int b) {
+  return a < b ? (uint64_t)((long long)b - a) : (uint64_t)((long long)a - b);
+}
+
+/**
+ * Indicates if a point lies in a disc centered at the origin
+ *
+ * The squares are only computed when both coordinates are at most r, so that
+ * they cannot overflow.
+ *
+ * @param dx      The absolute x coordinate of the point
+ * @param dy      The absolute y coordinate of the point
+ * @param r       The radius of the disc
+ * @param strict  true to exclude the boundary of the disc
+ * @return        true if and only if the point lies in the disc
+ */
+bool is_in_disc(uint64_t dx, uint64_t dy, uint64_t r, bool strict) {
+  if (dx > r || dy > r)
+    return false;
+  uint64_t d2 = dx * dx + dy * dy, r2 = r * r;
+  return strict ? d2 < r2 : d2 <= r2;
+}
+
+// Antenna lists
+// -------------
+
+/**
+ * Initializes an empty antenna list
+ *
+ * @param list   The list to initialize
+ * @param arena  The arena from which the list is allocated
+ */
+void initialize_antenna_list(struct AntennaList* list, struct Arena* arena) {
+  list->size = 0;
+  list->capacity = INITIAL_LIST_CAPACITY;
+  list->items = arena_allocate(arena, list->capacity * sizeof(unsigned int));
+}
+
+/**
+ * Appends an antenna to a list
+ *
+ * @param list     The list
+ * @param antenna  The index of the antenna
+ * @param arena    The arena from which the list is allocated
+ */
+void append_to_antenna_list(struct AntennaList* list, unsigned int antenna,
+                            struct Arena* arena) {
+  if (list->size == list->capacity) {
+    unsigned int capacity = 2 * list->capacity;
+    list->items = arena_grow(arena, list->items,
+                             list->capacity * sizeof(unsigned int),
+                             capacity * sizeof(unsigned int));
+    list->capacity = capacity;
+  }
+  list->items[list->size++] = antenna;
+}
+
+/**
+ * Compares two antenna indices
+ *
+ * @param a  The first index
+ * @param b  The second index
+ * @return   A negative, null or positive value as for strcmp
+ */
+int compare_antenna_indices(const void* a, const void* b) {
+  unsigned int index1 = *(const unsigned int*)a,
+               index2 = *(const unsigned int*)b;
+  return (index1 > index2) - (index1 < index2);
+}
+
+/**
+ * Prints the antennas of a list
+ *
+ * @param scene     The scene
+ * @param antennas  The antenna indices
+ * @param first     The first index to print
+ * @param end       The end of the indices to print
+ * @param writer    The writer on which the antennas are printed
+ */
+void print_antennas(const struct Scene* scene, const unsigned int* antennas,
+                    unsigned int first, unsigned int end,
+                    struct Writer* writer) {
+  for (unsigned int i = first; i < end; ++i) {
+    write_char(writer, ' ');
+    write_string(writer,
+                 antenna_identifier(scene, scene->antennas + antennas[i]));
+  }
+}
+
+// Computation
+// -----------
+
+/**
+ * Computes the coverage of a chunk of consecutive buildings
+ *
+ * @param context  The CoverageJob
+ * @param chunk    The index of the chunk
+ * @param worker   The index of the worker running the task
+ */
+void compute_chunk_coverage(void* context, unsigned int chunk,
+                            unsigned int worker) {
+  struct CoverageJob* job = context;
+  const struct Scene* scene = job->scene;
+  struct CoverageWorker* storage = job->workers + worker;
+  struct AntennaList* covering = job->chunks + chunk,
+                    * partial = &storage->partial;
+  initialize_antenna_list(covering, &storage->arena);
+  unsigned int start = chunk * COVERAGE_CHUNK_SIZE,
+               end = scene->num_buildings - start < COVERAGE_CHUNK_SIZE
+                   ? scene->num_buildings : start + COVERAGE_CHUNK_SIZE;
+  for (unsigned int b = start; b < end; ++b) {
+    const struct Building* building = scene->buildings + b;
+    struct RTreeBox box = {(long long)building->x - building->w,
+                           (long long)building->y - building->h,
+                           (long long)building->x + building->w,
+                           (long long)building->y + building->h};
+    struct RTreeSearch search;
+    start_rtree_search(&search, job->tree, &box);
+    unsigned int first = covering->size, a;
+    partial->size = 0;
+    while (next_rtree_entry(&search, &a)) {
+      enum CoverageKind kind = antenna_coverage(scene->antennas + a, building);
+      if (kind == COVERAGE_FULL)
+        append_to_antenna_list(covering, a, &storage->arena);
+      else if (kind == COVERAGE_PARTIAL)
+        append_to_antenna_list(partial, a, &storage->scratch_arena);
+    }
+    job->coverage->num_full[b] = covering->size - first;
+    qsort(covering->items + first, covering->size - first,
+          sizeof(unsigned int), compare_antenna_indices);
+    qsort(partial->items, partial->size, sizeof(unsigned int),
+          compare_antenna_indices);
+    for (unsigned int p = 0; p < partial->size; ++p)
+      append_to_antenna_list(covering, partial->items[p], &storage->arena);
+    job->coverage->offsets[b + 1] = covering->size - first;
+  }
+}
+
+// Public functions definition
+// ===========================
+
+// Predicates
+// ----------
+
+enum CoverageKind antenna_coverage(const struct Antenna* antenna,
+                                   const struct Building* building) {
+  uint64_t dx = distance(antenna->x, building->x),
+           dy = distance(antenna->y, building->y),
+           w = building->w, h = building->h, r = antenna->r;
+  if (!is_in_disc(dx > w ? dx - w : 0, dy > h ? dy - h : 0, r, true))
+    return COVERAGE_NONE;
+  return is_in_disc(dx + w, dy + h, r, false)
+       ? COVERAGE_FULL : COVERAGE_PARTIAL;
+}
+
+// Computation
+// -----------
+
+void compute_scene_coverage(const struct Scene* scene,
+                            struct SceneCoverage* coverage,
+                            struct ThreadPool* pool, struct Arena* arena) {
+  unsigned int num_buildings = scene->num_buildings,
+               num_antennas = scene->num_antennas;
+  struct RTreeBox* boxes =
+    arena_allocate(arena, num_antennas * sizeof(struct RTreeBox));
+  for (unsigned int a = 0; a < num_antennas; ++a) {
+    const struct Antenna* antenna = scene->antennas + a;
+    boxes[a].xmin = (long long)antenna->x - antenna->r;
+    boxes[a].ymin = (long long)antenna->y - antenna->r;
+    boxes[a].xmax = (long long)antenna->x + antenna->r;
+    boxes[a].ymax = (long long)antenna->y + antenna->r;
+  }
+  struct RTree tree;
+  build_rtree(&tree, boxes, num_antennas, arena);
+  coverage->num_buildings = num_buildings;
+  coverage->offsets =
+    arena_allocate(arena, (num_buildings + 1) * sizeof(unsigned int));
+  coverage->num_full =
+    arena_allocate(arena, num_buildings * sizeof(unsigned int));
+  unsigned int num_chunks =
+    (num_buildings + COVERAGE_CHUNK_SIZE - 1) / COVERAGE_CHUNK_SIZE;
+  struct CoverageJob job = {
+    scene, &tree, coverage,
+    arena_allocate(arena, num_chunks * sizeof(struct AntennaList)),
+    arena_allocate(arena, pool->num_threads * sizeof(struct CoverageWorker))
+  };
+  for (unsigned int w = 0; w < pool->num_threads; ++w) {
+    initialize_arena(&job.workers[w].arena);
+    initialize_arena(&job.workers[w].scratch_arena);
+    initialize_antenna_list(&job.workers[w].partial,
+                            &job.workers[w].scratch_arena);
+  }
+  run_pool_tasks(pool, num_chunks, compute_chunk_coverage, &job);
+  // The chunks are concatenated in order, so that the result does not
+  // depend on the number of threads
+  coverage->offsets[0] = 0;
+  for (unsigned int b = 0; b < num_buildings; ++b)
+    coverage->offsets[b + 1] += coverage->offsets[b];
+  coverage->antennas = arena_allocate(arena, coverage->offsets[num_buildings] *
+                                             sizeof(unsigned int));
+  unsigned int size = 0;
+  for (unsigned int c = 0; c < num_chunks; ++c) {
+    memcpy(coverage->antennas + size, job.chunks[c].items,
+           job.chunks[c].size * sizeof(unsigned int));
+    size += job.chunks[c].size;
+  }
+  for (unsigned int w = 0; w < pool->num_threads; ++w) {
+    free_arena(&job.workers[w].arena);
+    free_arena(&job.workers[w].scratch_arena);
+  }
+}
+
+// Printing
+// --------
+
+void print_scene_coverage(const struct Scene* scene,
+                          const struct SceneCoverage* coverage, FILE* file) {
+  struct Writer writer;
+  open_writer(&writer, file);
+  write_string(&writer, "Coverage\n");
+  for (unsigned int b = 0; b < coverage->num_buildings; ++b) {
+    unsigned int first = coverage->offsets[b],
+                 middle = first + coverage->num_full[b],
+                 end = coverage->offsets[b + 1];
+    if (first == end)
+      continue;
+    write_string(&writer, "  building ");
+    write_string(&writer, building_identifier(scene, scene->buildings + b));
+    write_char(&writer, ':');
+    if (first < middle) {
+      write_string(&writer, " full");
+      print_antennas(scene, coverage->antennas, first, middle, &writer);
+    }
+    if (middle < end) {
+      write_string(&writer, first < middle ? ", partial" : " partial");
+      print_antennas(scene, coverage->antennas, middle, end, &writer);
+    }
+    write_char(&writer, '\n');
+  }
+  write_string(&writer, "Uncovered buildings\n");
+  for (unsigned int b = 0; b < coverage->num_buildings; ++b)
+    if (coverage->offsets[b] == coverage->offsets[b + 1]) {
+      write_string(&writer, "  building ");
+      write_string(&writer, building_identifier(scene, scene->buildings + b));
+      write_char(&writer, '\n');
+    }
+  close_writer(&writer);
+}
@@ -0,0 +1,94 @@
+#ifndef COVERAGE_H_
+#define COVERAGE_H_
+
+#include <stdio.h>
+
+#include "arena.h"
+#include "pool.h"
+#include "scene.h"
+
+// Types
+// -----
+
+// The way an antenna covers a building
+enum CoverageKind {
+  // The disc of the antenna does not meet the interior of the building
+  COVERAGE_NONE,
+  // The disc of the antenna meets the building without containing it
+  COVERAGE_PARTIAL,
+  // The disc of the antenna contains the building
+  COVERAGE_FULL
+};
+
+// The coverage of the buildings of a scene by its antennas
+//
+// The antennas covering the building b are the indices
+// antennas[offsets[b]] to antennas[offsets[b + 1] - 1]: first the ones
+// covering it fully, then the ones covering it partially, each group being
+// sorted by index.
+struct SceneCoverage {
+  // The number of buildings
+  unsigned int num_buildings;
+  // The offsets of the antennas of each building (num_buildings + 1 items)
+  unsigned int* offsets;
+  // The number of antennas covering each building fully
+  unsigned int* num_full;
+  // The antennas covering the buildings
+  unsigned int* antennas;
+};
+
+// Predicates
+// ----------
+
+/**
+ * Returns the way an antenna covers a building
+ *
+ * The building is covered fully if it is contained in the disc of the
+ * antenna (boundary included), and partially if the disc meets it on a
+ * region of strictly positive area.
+ *
+ * @param antenna   The antenna
+ * @param building  The building
+ * @return          The kind of coverage
+ */
+enum CoverageKind antenna_coverage(const struct Antenna* antenna,
+                                   const struct Building* building);
+
+// Computation
+// -----------
+
+/**
+ * Computes the coverage of the buildings of a scene
+ *
+ * The antennas are indexed by an R-tree over their bounding boxes, so that
+ * each building is only tested against the antennas that may reach it. The
+ * buildings are handled in chunks by the threads of the pool, and the result
+ * does not depend on the number of threads.
+ *
+ * @param scene     The scene, which must be valid
+ * @param coverage  The resulting coverage
+ * @param pool      The thread pool
+ * @param arena     The arena from which the coverage is allocated
+ */
+void compute_scene_coverage(const struct Scene* scene,
+                            struct SceneCoverage* coverage,
+                            struct ThreadPool* pool, struct Arena* arena);
+
+// Printing
+// --------
+
+/**
+ * Prints the coverage of the buildings of a scene
+ *
+ * Each building reached by at least one antenna is listed with the antennas
+ * covering it fully and partially, followed by the list of the buildings
+ * reached by no antenna.
+ *
+ * @param scene     The scene
+ * @param coverage  The coverage of its buildings
+ * @param file      The file on which the coverage is printed
+ */
+void print_scene_coverage(const struct Scene* scene,
+                          const struct SceneCoverage* coverage, FILE* file);
+
+#endif
@@ -0,0 +1,358 @@
+#include "edit.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "arena.h"
+#include "hash.h"
+#include "identifier.h"
+#include "input.h"
+#include "overlap.h"
+#include "pool.h"
+#include "scene.h"
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Errors
+// ------
+
+/**
+ * Records in an error that two buildings are overlapping, in the order of
+ * their identifiers
+ *
+ * @param editor  The editor
+ * @param id1     The identifier of the first building, as a handle
+ * @param id2     The identifier of the second building, as a handle
+ * @param error   The error
+ * @return        false
+ */
+bool report_overlapping_ids(const struct SceneEditor* editor, uint32_t id1,
+                            uint32_t id2, struct Error* error) {
+  const char* string1 = identifier_string(&editor->scene->ids, id1),
+            * string2 = identifier_string(&editor->scene->ids, id2);
+  bool is_first = strcmp(string1, string2) < 0;
+  return report_error_overlapping_buildings(error,
+      is_first ? string1 : string2, is_first ? string2 : string1);
+}
+
+/**
+ * Records in an error that two antennas share a position, in the order of
+ * their identifiers
+ *
+ * @param editor  The editor
+ * @param id1     The identifier of the first antenna, as a handle
+ * @param id2     The identifier of the second antenna, as a handle
+ * @param error   The error
+ * @return        false
+ */
+bool report_same_position_ids(const struct SceneEditor* editor, uint32_t id1,
+                              uint32_t id2, struct Error* error) {
+  const char* string1 = identifier_string(&editor->scene->ids, id1),
+            * string2 = identifier_string(&editor->scene->ids, id2);
+  bool is_first = strcmp(string1, string2) < 0;
+  return report_error_same_position_antennas(error,
+      is_first ? string1 : string2, is_first ? string2 : string1);
+}
+
+/**
+ * Finds an identifier of the pool of the edited scene in an index
+ *
+ * @param editor  The editor
+ * @param index   The index
+ * @param id      The identifier, as a handle
+ * @param value   The value associated with the identifier, if found
+ * @return        true if and only if the identifier is in the index
+ */
+bool find_edited_identifier(const struct SceneEditor* editor,
+                            const struct IdentifierIndex* index, uint32_t id,
+                            unsigned int* value) {
+  const char* string = identifier_string(&editor->scene->ids, id);
+  return find_in_identifier_index(index, string, strlen(string), value);
+}
+
+// Buildings
+// ---------
+
+/**
+ * Adds a building to a scene being edited, unless it overlaps another one
+ *
+ * @param editor    The editor
+ * @param building  The building, whose identifier must be unused
+ * @param error     The error reported if the building overlaps another one
+ * @return          true if and only if the building was added
+ */
+bool place_edited_building(struct SceneEditor* editor,
+                           const struct Building* building,
+                           struct Error* error) {
+  uint32_t other;
+  if (find_in_building_grid(&editor->buildings, building, &other))
+    return report_overlapping_ids(editor, building->id, other, error);
+  unsigned int slot = insert_in_building_grid(&editor->buildings, building),
+               existing;
+  insert_in_identifier_index(&editor->building_ids, building->id, slot,
+                             &existing);
+  ++editor->num_buildings;
+  return true;
+}
+
+/**
+ * Removes a building from a scene being edited
+ *
+ * @param editor    The editor
+ * @param slot      The slot of the building in the grid
+ * @param building  The removed building
+ */
+void take_edited_building(struct SceneEditor* editor, unsigned int slot,
+                          struct Building* building) {
+  const struct GridBuilding* stored = editor->buildings.buildings + slot;
+  building->key = stored->key;
+  building->id = stored->id;
+  building->x = stored->x;
+  building->y = stored->y;
+  building->w = stored->w;
+  building->h = stored->h;
+  remove_from_identifier_index(&editor->building_ids, stored->id);
+  remove_from_building_grid(&editor->buildings, slot);
+  --editor->num_buildings;
+}
+
+/**
+ * Applies an edit of a building to a scene being edited
+ *
+ * @param editor  The editor
+ * @param edit    The edit
+ * @param error   The error reported if the edit is invalid
+ * @return        true if and only if the edit was applied
+ */
+bool apply_building_edit(struct SceneEditor* editor,
+                         const struct SceneEdit* edit, struct Error* error) {
+  const char* id = identifier_string(&editor->scene->ids, edit->building.id);
+  unsigned int slot;
+  bool exists = find_edited_identifier(editor, &editor->building_ids,
+                                       edit->building.id, &slot);
+  if (edit->kind == EDIT_ADD_BUILDING)
+    return exists ? report_error_non_unique_identifiers(error, "building", id)
+                  : place_edited_building(editor, &edit->building, error);
+  if (!exists)
+    return report_error_unknown_identifier(error, "building", id);
+  struct Building building;
+  take_edited_building(editor, slot, &building);
+  if (edit->kind == EDIT_REMOVE_BUILDING)
+    return true;
+  struct Building moved = building;
+  moved.x = edit->building.x;
+  moved.y = edit->building.y;
+  if (place_edited_building(editor, &moved, error))
+    return true;
+  // The building fitted at its former position
+  struct Error ignored;
+  place_edited_building(editor, &building, &ignored);
+  return false;
+}
+
+// Antennas
+// --------
+
+/**
+ * Adds an antenna to a scene being edited, unless its position is used
+ *
+ * @param editor   The editor
+ * @param antenna  The antenna, whose identifier must be unused
+ * @param error    The error reported if the position is used
+ * @return         true if and only if the antenna was added
+ */
+bool place_edited_antenna(struct SceneEditor* editor,
+                          const struct EditedAntenna* antenna,
+                          struct Error* error) {
+  unsigned int a = editor->num_antennas, other;
+  if (!insert_in_hash_index(&editor->antenna_positions,
+                            position_key(antenna->x, antenna->y), a, &other))
+    return report_same_position_ids(editor, antenna->id,
+                                    editor->antennas[other].id, error);
+  if (a == editor->capacity_antennas) {
+    unsigned int capacity = a == 0 ? 16 : 2 * a;
+    editor->antennas = arena_grow(&editor->arena, editor->antennas,
+                                  a * sizeof(struct EditedAntenna),
+                                  capacity * sizeof(struct EditedAntenna));
+    editor->capacity_antennas = capacity;
+  }
+  editor->antennas[a] = *antenna;
+  insert_in_identifier_index(&editor->antenna_ids, antenna->id, a, &other);
+  ++editor->num_antennas;
+  return true;
+}
+
+/**
+ * Removes an antenna from a scene being edited
+ *
+ * The last antenna of the array takes the place of the removed one.
+ *
+ * @param editor   The editor
+ * @param a        The index of the antenna
+ * @param antenna  The removed antenna
+ */
+void take_edited_antenna(struct SceneEditor* editor, unsigned int a,
+                         struct EditedAntenna* antenna) {
+  *antenna = editor->antennas[a];
+  remove_from_identifier_index(&editor->antenna_ids, antenna->id);
+  remove_from_hash_index(&editor->antenna_positions,
+                         position_key(antenna->x, antenna->y));
+  unsigned int last = --editor->num_antennas, existing;
+  if (a == last)
+    return;
+  const struct EditedAntenna* moved = editor->antennas + last;
+  uint64_t position = position_key(moved->x, moved->y);
+  remove_from_identifier_index(&editor->antenna_ids, moved->id);
+  remove_from_hash_index(&editor->antenna_positions, position);
+  insert_in_identifier_index(&editor->antenna_ids, moved->id, a, &existing);
+  insert_in_hash_index(&editor->antenna_positions, position, a, &existing);
+  editor->antennas[a] = *moved;
+}
+
+/**
+ * Applies an edit of an antenna to a scene being edited
+ *
+ * @param editor  The editor
+ * @param edit    The edit
+ * @param error   The error reported if the edit is invalid
+ * @return        true if and only if the edit was applied
+ */
+bool apply_antenna_edit(struct SceneEditor* editor,
+                        const struct SceneEdit* edit, struct Error* error) {
+  struct EditedAntenna antenna = {edit->antenna.key, edit->antenna.id,
+                                  edit->antenna.x, edit->antenna.y,
+                                  edit->antenna.r};
+  const char* id = identifier_string(&editor->scene->ids, antenna.id);
+  unsigned int a;
+  bool exists = find_edited_identifier(editor, &editor->antenna_ids,
+                                       antenna.id, &a);
+  if (edit->kind == EDIT_ADD_ANTENNA)
+    return exists ? report_error_non_unique_identifiers(error, "antenna", id)
+                  : place_edited_antenna(editor, &antenna, error);
+  if (!exists)
+    return report_error_unknown_identifier(error, "antenna", id);
+  struct EditedAntenna former;
+  take_edited_antenna(editor, a, &former);
+  if (edit->kind == EDIT_REMOVE_ANTENNA)
+    return true;
+  antenna.id = former.id;
+  antenna.r = former.r;
+  if (place_edited_antenna(editor, &antenna, error))
+    return true;
+  // The antenna fitted at its former position
+  struct Error ignored;
+  place_edited_antenna(editor, &former, &ignored);
+  return false;
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+bool initialize_scene_editor(struct SceneEditor* editor, struct Scene* scene,
+                             struct ThreadPool* pool, struct Error* error) {
+  if (!scene->is_validated && !validate_scene(scene, pool, error))
+    return false;
+  editor->scene = scene;
+  initialize_arena(&editor->arena);
+  initialize_identifier_index(&editor->building_ids, &scene->ids,
+                              scene->num_buildings, &editor->arena);
+  initialize_building_grid(&editor->buildings, &scene->ids, &editor->arena);
+  editor->num_buildings = 0;
+  initialize_identifier_index(&editor->antenna_ids, &scene->ids,
+                              scene->num_antennas, &editor->arena);
+  initialize_hash_index(&editor->antenna_positions, scene->num_antennas,
+                        &editor->arena);
+  editor->num_antennas = 0;
+  editor->capacity_antennas = 0;
+  editor->antennas = NULL;
+  for (unsigned int b = 0; b < scene->num_buildings; ++b)
+    place_edited_building(editor, scene->buildings + b, error);
+  for (unsigned int a = 0; a < scene->num_antennas; ++a) {
+    const struct Antenna* antenna = scene->antennas + a;
+    struct EditedAntenna edited = {antenna->key, antenna->id, antenna->x,
+                                   antenna->y, antenna->r};
+    place_edited_antenna(editor, &edited, error);
+  }
+  return true;
+}
+
+void free_scene_editor(struct SceneEditor* editor) {
+  free_arena(&editor->arena);
+}
+
+// Edition
+// -------
+
+bool apply_scene_edit(struct SceneEditor* editor, const struct SceneEdit* edit,
+                      struct Error* error) {
+  switch (edit->kind) {
+    case EDIT_ADD_BUILDING:
+    case EDIT_REMOVE_BUILDING:
+    case EDIT_MOVE_BUILDING:
+      return apply_building_edit(editor, edit, error);
+    default:
+      return apply_antenna_edit(editor, edit, error);
+  }
+}
+
+bool apply_scene_delta(struct SceneEditor* editor, const struct Input* delta,
+                       struct Error* error) {
+  const char* c = delta->data, * end = delta->data + delta->size;
+  int line_number = 1;
+  while (c != end) {
+    const char* newline = memchr(c, '\n', end - c);
+    struct StringView line = {c, (newline == NULL ? end : newline) - c};
+    c = newline == NULL ? end : newline + 1;
+    struct SceneEdit edit;
+    size_t num_chars = editor->scene->ids.size;
+    if (!read_scene_edit(line, line_number, &editor->scene->ids, &edit,
+                         error))
+      return false;
+    bool success = apply_scene_edit(editor, &edit, error);
+    // Only the identifier of an added object is kept in the pool
+    if (!success || (edit.kind != EDIT_ADD_BUILDING &&
+                     edit.kind != EDIT_ADD_ANTENNA))
+      editor->scene->ids.size = num_chars;
+    if (!success)
+      return append_error_line(error, line_number);
+    ++line_number;
+  }
+  return true;
+}
+
+void write_edited_scene(struct SceneEditor* editor) {
+  struct Scene* scene = editor->scene;
+  const struct BuildingGrid* grid = &editor->buildings;
+  scene->num_buildings = 0;
+  scene->num_antennas = 0;
+  reserve_scene(scene, editor->num_buildings, editor->num_antennas);
+  for (unsigned int slot = 0; slot < grid->num_buildings; ++slot) {
+    const struct GridBuilding* stored = grid->buildings + slot;
+    if (stored->key == 0)
+      continue;
+    struct Building* building = scene->buildings + scene->num_buildings++;
+    building->key = stored->key;
+    building->id = stored->id;
+    building->x = stored->x;
+    building->y = stored->y;
+    building->w = stored->w;
+    building->h = stored->h;
+  }
+  for (unsigned int a = 0; a < editor->num_antennas; ++a) {
+    const struct EditedAntenna* edited = editor->antennas + a;
+    struct Antenna* antenna = scene->antennas + scene->num_antennas++;
+    antenna->key = edited->key;
+    antenna->id = edited->id;
+    antenna->x = edited->x;
+    antenna->y = edited->y;
+    antenna->r = edited->r;
+  }
+  sort_scene(scene);
+  scene->is_validated = true;
+}
@@ -0,0 +1,136 @@
+#ifndef EDIT_H_
+#define EDIT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "hash.h"
+#include "identifier.h"
+#include "input.h"
+#include "overlap.h"
+#include "pool.h"
+#include "scene.h"
+#include "validation.h"
+
+// Types
+// -----
+
+// An antenna of a scene being edited
+struct EditedAntenna {
+  // The sort key of the identifier of the antenna
+  uint64_t key;
+  // The identifier of the antenna, as a handle in the pool of the scene
+  uint32_t id;
+  // The x coordinate of the antenna
+  int x;
+  // The y coordinate of the antenna
+  int y;
+  // The radius of the antenna
+  int r;
+};
+
+// A valid scene being edited
+//
+// The buildings are held in a building grid and the antennas in an array,
+// both indexed by their identifiers, and the antennas are also indexed by
+// their positions. An edit thus only checks the identifier and the
+// neighborhood of the object it changes, in constant expected time, and the
+// scene stays valid after each edit. The identifiers stay in the pool of the
+// scene, and the scene itself is only rewritten by write_edited_scene.
+struct SceneEditor {
+  // The edited scene
+  struct Scene* scene;
+  // The arena from which the editor is allocated
+  struct Arena arena;
+  // The slot in the grid of each building identifier
+  struct IdentifierIndex building_ids;
+  // The buildings
+  struct BuildingGrid buildings;
+  // The number of buildings
+  unsigned int num_buildings;
+  // The index in antennas of each antenna identifier
+  struct IdentifierIndex antenna_ids;
+  // The index in antennas of each antenna position
+  struct HashIndex antenna_positions;
+  // The number of antennas
+  unsigned int num_antennas;
+  // The number of antennas that can be held before growing
+  unsigned int capacity_antennas;
+  // The antennas
+  struct EditedAntenna* antennas;
+};
+
+// Construction
+// ------------
+
+/**
+ * Starts editing a scene
+ *
+ * The scene is validated first, unless it is known to be valid, and its
+ * objects are indexed in linear expected time.
+ *
+ * @param editor  The editor to initialize
+ * @param scene   The scene to edit
+ * @param pool    The thread pool running the validation
+ * @param error   The error reported if the scene is invalid
+ * @return        true if and only if the editor was initialized
+ */
+bool initialize_scene_editor(struct SceneEditor* editor, struct Scene* scene,
+                             struct ThreadPool* pool, struct Error* error);
+
+/**
+ * Releases the memory held by an editor
+ *
+ * The edits not written with write_edited_scene are discarded.
+ *
+ * @param editor  The editor
+ */
+void free_scene_editor(struct SceneEditor* editor);
+
+// Edition
+// -------
+
+/**
+ * Applies an edit to a scene being edited
+ *
+ * An added object must have an unused identifier and a removed or moved one
+ * must exist. A building cannot overlap another one, and an antenna cannot
+ * have the position of another one. The same errors as validate_scene are
+ * reported, with the identifiers in the same order. If the edit fails, the
+ * edited scene is left unchanged. The identifier of the edit must be stored
+ * in the pool of the edited scene.
+ *
+ * @param editor  The editor
+ * @param edit    The edit
+ * @param error   The error reported if the edit is invalid
+ * @return        true if and only if the edit was applied
+ */
+bool apply_scene_edit(struct SceneEditor* editor, const struct SceneEdit* edit,
+                      struct Error* error);
+
+/**
+ * Applies the edits of a delta to a scene being edited
+ *
+ * The edits are applied in order, and the first invalid one stops the
+ * delta, the previous ones being kept. Its error mentions its line.
+ *
+ * @param editor  The editor
+ * @param delta   The delta, one edit per line
+ * @param error   The error reported if an edit is invalid
+ * @return        true if and only if all the edits were applied
+ */
+bool apply_scene_delta(struct SceneEditor* editor, const struct Input* delta,
+                       struct Error* error);
+
+/**
+ * Writes the edited objects into the edited scene
+ *
+ * The objects are sorted by identifier, in O(n) time, and the scene is
+ * marked as validated.
+ *
+ * @param editor  The editor
+ */
+void write_edited_scene(struct SceneEditor* editor);
+
+#endif
@@ -0,0 +1,358 @@
+#include "generator.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The largest side of a generated scene, so that no coordinate overflows
+#define MAX_GENERATED_SIDE (1ll << 30)
+// The largest number of objects of each type, so that identifiers are valid
+#define MAX_GENERATED_OBJECTS 100000000u
+// The number of tries to place an object in a cluster before any cell is
+// accepted
+#define MAX_CLUSTER_TRIES 64
+
+// Types
+// -----
+
+// A pseudo-random generator (xorshift64*)
+struct Random {
+  // The state of the generator (never 0)
+  uint64_t state;
+};
+
+// The square grid of cells of a generated scene
+struct SceneGrid {
+  // The number of cells (at most side * side)
+  uint64_t num_cells;
+  // The number of cells of a row
+  uint64_t side;
+  // The side of a cell
+  int cell_size;
+  // The coordinate of the lower left corner of the grid, on both axes
+  long long origin;
+};
+
+// A sampler of distinct cells of a grid
+//
+// A uniform sampler visits the cells in order and selects each of them with
+// the probability that leaves the right number of cells to the others
+// (selection sampling), without any memory. A clustered sampler draws cells
+// around the centers of the clusters and rejects those already selected.
+struct CellSampler {
+  // The grid
+  const struct SceneGrid* grid;
+  // The distribution of the cells
+  enum SceneDistribution distribution;
+  // The number of cells still to select
+  uint64_t num_remaining;
+  // The next cell to visit, for a uniform sampler
+  uint64_t next_cell;
+  // One bit per cell, set if the cell was selected, for a clustered sampler
+  unsigned char* selected;
+  // The number of clusters
+  unsigned int num_clusters;
+  // The coordinates of the centers of the clusters, in cells (2 per center)
+  double* centers;
+  // The standard deviation of the clusters, in cells
+  double deviation;
+};
+
+// Random numbers
+// --------------
+
+/**
+ * Initializes a pseudo-random generator
+ *
+ * @param random  The generator
+ * @param seed    The seed, mixed so that close seeds give distinct sequences
+ */
+void initialize_random(struct Random* random, uint64_t seed) {
+  uint64_t state = seed + 0x9e3779b97f4a7c15ull;
+  state = (state ^ state >> 30) * 0xbf58476d1ce4e5b9ull;
+  state = (state ^ state >> 27) * 0x94d049bb133111ebull;
+  state ^= state >> 31;
+  random->state = state == 0 ? 1 : state;
+}
+
+/**
+ * Returns the next pseudo-random number of a generator
+ *
+ * @param random  The generator
+ * @return        A pseudo-random 64-bit number
+ */
+uint64_t next_random(struct Random* random) {
+  random->state ^= random->state >> 12;
+  random->state ^= random->state << 25;
+  random->state ^= random->state >> 27;
+  return random->state * 0x2545f4914f6cdd1dull;
+}
+
+/**
+ * Returns a pseudo-random integer in [0, n)
+ *
+ * @param random  The generator
+ * @param n       The bound (positive)
+ * @return        The integer
+ */
+uint64_t random_below(struct Random* random, uint64_t n) {
+  return (next_random(random) >> 11) % n;
+}
+
+/**
+ * Returns a pseudo-random integer in [low, high]
+ *
+ * @param random  The generator
+ * @param low     The lower bound
+ * @param high    The upper bound, at least low
+ * @return        The integer
+ */
+int random_between(struct Random* random, int low, int high) {
+  return low + (int)random_below(random, (uint64_t)high - low + 1);
+}
+
+/**
+ * Returns a pseudo-random number of the standard normal distribution
+ *
+ * @param random  The generator
+ * @return        The number, drawn with the Box-Muller transform
+ */
+double random_normal(struct Random* random) {
+  double u = ((next_random(random) >> 11) + 1.0) / 9007199254740993.0,
+         v = (next_random(random) >> 11) / 9007199254740992.0;
+  return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+// Cells
+// -----
+
+/**
+ * Initializes a sampler of distinct cells
+ *
+ * @param sampler    The sampler to initialize
+ * @param grid       The grid
+ * @param options    The parameters of the scene
+ * @param num_cells  The number of cells to select
+ * @param random     The generator placing the clusters
+ */
+void initialize_cell_sampler(struct CellSampler* sampler,
+                             const struct SceneGrid* grid,
+                             const struct GeneratorOptions* options,
+                             uint64_t num_cells, struct Random* random) {
+  sampler->grid = grid;
+  sampler->distribution = options->distribution;
+  sampler->num_remaining = num_cells;
+  sampler->next_cell = 0;
+  sampler->selected = NULL;
+  sampler->centers = NULL;
+  if (options->distribution != DISTRIBUTION_CLUSTERED)
+    return;
+  sampler->selected = calloc(grid->num_cells / 8 + 1, 1);
+  sampler->num_clusters = options->num_clusters;
+  sampler->centers = malloc(2 * options->num_clusters * sizeof(double));
+  if (sampler->selected == NULL || sampler->centers == NULL)
+    report_error_out_of_memory();
+  for (unsigned int c = 0; c < 2 * options->num_clusters; ++c)
+    sampler->centers[c] = random_below(random, grid->side);
+  sampler->deviation = grid->side / (4 * sqrt(options->num_clusters)) + 1;
+}
+
+/**
+ * Releases the memory held by a sampler of cells
+ *
+ * @param sampler  The sampler
+ */
+void free_cell_sampler(struct CellSampler* sampler) {
+  free(sampler->selected);
+  free(sampler->centers);
+}
+
+/**
+ * Marks a cell as selected by a clustered sampler, unless it already is
+ *
+ * @param sampler  The sampler
+ * @param cell     The cell
+ * @return         true if and only if the cell was not selected yet
+ */
+bool select_cell(struct CellSampler* sampler, uint64_t cell) {
+  unsigned char bit = 1 << (cell % 8);
+  if (sampler->selected[cell / 8] & bit)
+    return false;
+  sampler->selected[cell / 8] |= bit;
+  return true;
+}
+
+/**
+ * Returns the next cell selected by a sampler
+ *
+ * @param sampler  The sampler, which must have cells left to select
+ * @param random   The generator
+ * @return         The index of the cell
+ */
+uint64_t next_sampled_cell(struct CellSampler* sampler,
+                           struct Random* random) {
+  const struct SceneGrid* grid = sampler->grid;
+  --sampler->num_remaining;
+  if (sampler->distribution == DISTRIBUTION_UNIFORM) {
+    while (random_below(random, grid->num_cells - sampler->next_cell) >
+           sampler->num_remaining)
+      ++sampler->next_cell;
+    return sampler->next_cell++;
+  }
+  for (unsigned int t = 0; t < MAX_CLUSTER_TRIES; ++t) {
+    const double* center =
+      sampler->centers + 2 * random_below(random, sampler->num_clusters);
+    double x = floor(center[0] + sampler->deviation * random_normal(random)),
+           y = floor(center[1] + sampler->deviation * random_normal(random));
+    if (x < 0 || y < 0 || x >= grid->side || y >= grid->side)
+      continue;
+    uint64_t cell = (uint64_t)y * grid->side + (uint64_t)x;
+    if (cell < grid->num_cells && select_cell(sampler, cell))
+      return cell;
+  }
+  while (true) {
+    uint64_t cell = random_below(random, grid->num_cells);
+    if (select_cell(sampler, cell))
+      return cell;
+  }
+}
+
+// Objects
+// -------
+
+/**
+ * Returns a multiplier shuffling the identifiers of n objects
+ *
+ * The object i is given the identifier (a * i + 1) mod n, which is a
+ * permutation when a and n are coprime.
+ *
+ * @param n  The number of objects
+ * @return   The multiplier a
+ */
+uint64_t shuffling_multiplier(uint64_t n) {
+  uint64_t a = 2654435761u % (n == 0 ? 1 : n);
+  while (true) {
+    uint64_t x = a, y = n;
+    while (y != 0) {
+      uint64_t r = x % y;
+      x = y;
+      y = r;
+    }
+    if (x <= 1)
+      return a;
+    ++a;
+  }
+}
+
+/**
+ * Writes the buildings of a generated scene
+ *
+ * @param options  The parameters of the scene
+ * @param grid     The grid
+ * @param random   The generator
+ * @param file     The file on which the buildings are written
+ */
+void generate_buildings(const struct GeneratorOptions* options,
+                        const struct SceneGrid* grid, struct Random* random,
+                        FILE* file) {
+  struct CellSampler sampler;
+  initialize_cell_sampler(&sampler, grid, options, options->num_buildings,
+                          random);
+  uint64_t n = options->num_buildings, a = shuffling_multiplier(n);
+  int size = options->max_size, cell_size = grid->cell_size;
+  for (uint64_t b = 0; b < n; ++b) {
+    uint64_t cell = next_sampled_cell(&sampler, random);
+    int w = random_between(random, 1, size),
+        h = random_between(random, 1, size);
+    long long x = grid->origin + (long long)(cell % grid->side) * cell_size +
+                  random_between(random, w, cell_size - w),
+              y = grid->origin + (long long)(cell / grid->side) * cell_size +
+                  random_between(random, h, cell_size - h);
+    fprintf(file, "  building b%llu %lld %lld %d %d\n",
+            (unsigned long long)((a * b + 1) % n), x, y, w, h);
+  }
+  free_cell_sampler(&sampler);
+}
+
+/**
+ * Writes the antennas of a generated scene
+ *
+ * @param options  The parameters of the scene
+ * @param grid     The grid
+ * @param random   The generator
+ * @param file     The file on which the antennas are written
+ */
+void generate_antennas(const struct GeneratorOptions* options,
+                       const struct SceneGrid* grid, struct Random* random,
+                       FILE* file) {
+  struct CellSampler sampler;
+  initialize_cell_sampler(&sampler, grid, options, options->num_antennas,
+                          random);
+  uint64_t n = options->num_antennas, a = shuffling_multiplier(n);
+  int cell_size = grid->cell_size;
+  for (uint64_t i = 0; i < n; ++i) {
+    uint64_t cell = next_sampled_cell(&sampler, random);
+    long long x = grid->origin + (long long)(cell % grid->side) * cell_size +
+                  random_between(random, 0, cell_size - 1),
+              y = grid->origin + (long long)(cell / grid->side) * cell_size +
+                  random_between(random, 0, cell_size - 1);
+    fprintf(file, "  antenna a%llu %lld %lld %d\n",
+            (unsigned long long)((a * i + 1) % n), x, y,
+            random_between(random, 1, options->max_radius));
+  }
+  free_cell_sampler(&sampler);
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void initialize_generator_options(struct GeneratorOptions* options) {
+  options->num_buildings = DEFAULT_GENERATED_BUILDINGS;
+  options->num_antennas = DEFAULT_GENERATED_ANTENNAS;
+  options->density = DEFAULT_GENERATED_DENSITY;
+  options->max_size = DEFAULT_GENERATED_SIZE;
+  options->max_radius = DEFAULT_GENERATED_RADIUS;
+  options->distribution = DISTRIBUTION_UNIFORM;
+  options->num_clusters = DEFAULT_GENERATED_CLUSTERS;
+  options->seed = 0;
+}
+
+// Generation
+// ----------
+
+bool generate_scene(const struct GeneratorOptions* options, FILE* file,
+                    struct Error* error) {
+  uint64_t num_objects = options->num_buildings > options->num_antennas
+                       ? options->num_buildings : options->num_antennas;
+  struct SceneGrid grid;
+  grid.num_cells = (num_objects * 100 + options->density - 1) /
+                   options->density;
+  grid.side = (uint64_t)ceil(sqrt((double)grid.num_cells));
+  while (grid.side * grid.side < grid.num_cells)
+    ++grid.side;
+  grid.cell_size = 2 * options->max_size;
+  if (num_objects > MAX_GENERATED_OBJECTS ||
+      (long double)grid.side * grid.cell_size > MAX_GENERATED_SIDE)
+    return report_error_too_large_scene(error);
+  grid.origin = -(long long)(grid.side * grid.cell_size / 2);
+  struct Random random;
+  initialize_random(&random, options->seed);
+  fprintf(file, "begin scene\n");
+  generate_buildings(options, &grid, &random, file);
+  generate_antennas(options, &grid, &random, file);
+  fprintf(file, "end scene\n");
+  return true;
+}
@@ -0,0 +1,88 @@
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The default number of buildings of a generated scene
+#define DEFAULT_GENERATED_BUILDINGS 1000
+// The default number of antennas of a generated scene
+#define DEFAULT_GENERATED_ANTENNAS 500
+// The default percentage of the cells of a generated scene holding a building
+#define DEFAULT_GENERATED_DENSITY 50
+// The default maximum half side of a generated building
+#define DEFAULT_GENERATED_SIZE 10
+// The default maximum radius of a generated antenna
+#define DEFAULT_GENERATED_RADIUS 40
+// The default number of clusters of a clustered scene
+#define DEFAULT_GENERATED_CLUSTERS 16
+
+// Types
+// -----
+
+// The distributions of the objects of a generated scene
+enum SceneDistribution {
+  // The objects are spread uniformly over the scene
+  DISTRIBUTION_UNIFORM,
+  // The objects are gathered around the centers of normal clusters
+  DISTRIBUTION_CLUSTERED
+};
+
+// The parameters of a generated scene
+struct GeneratorOptions {
+  // The number of buildings
+  unsigned int num_buildings;
+  // The number of antennas
+  unsigned int num_antennas;
+  // The percentage of the cells holding a building (1 to 100)
+  int density;
+  // The maximum half width and half height of the buildings
+  int max_size;
+  // The maximum radius of the antennas
+  int max_radius;
+  // The distribution of the objects
+  enum SceneDistribution distribution;
+  // The number of clusters of a clustered scene
+  unsigned int num_clusters;
+  // The seed of the pseudo-random generator
+  uint64_t seed;
+};
+
+// Construction
+// ------------
+
+/**
+ * Initializes the parameters of a generated scene to their defaults
+ *
+ * @param options  The parameters to initialize
+ */
+void initialize_generator_options(struct GeneratorOptions* options);
+
+// Generation
+// ----------
+
+/**
+ * Writes a valid text scene generated pseudo-randomly
+ *
+ * The scene is a square grid of cells of side 2 * max_size, of which density
+ * percent hold a building, so that the buildings, which never leave their
+ * cell, cannot overlap. The antennas are placed in distinct cells of the same
+ * grid, at distinct positions. The identifiers are shuffled, and the same
+ * parameters always give the same scene.
+ *
+ * @param options  The parameters of the scene
+ * @param file     The file on which the scene is written
+ * @param error    The error reported if the coordinates of the scene would
+ *                 not fit in an int
+ * @return         true if and only if the scene was written
+ */
+bool generate_scene(const struct GeneratorOptions* options, FILE* file,
+                    struct Error* error);
+
+#endif
@@ -0,0 +1,187 @@
+#include "hash.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "arena.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The smallest capacity of a hash index
+#define HASH_INDEX_MIN_CAPACITY 16
+
+// Hashing
+// -------
+
+/**
+ * Hashes a 64-bit key
+ *
+ * This is the finalizer of splitmix64, which spreads every input bit over the
+ * whole output.
+ *
+ * @param key  The key to hash
+ * @return     The hash of the key
+ */
+uint64_t hash_key(uint64_t key) {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ull;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebull;
+  key ^= key >> 31;
+  return key;
+}
+
+/**
+ * Returns the slot where a key is or would be stored
+ *
+ * @param index  The index
+ * @param key    The key
+ * @return       The slot of the key
+ */
+unsigned int find_slot(const struct HashIndex* index, uint64_t key) {
+  unsigned int mask = index->capacity - 1,
+               slot = (unsigned int)hash_key(key) & mask;
+  while (index->values[slot] != HASH_INDEX_EMPTY &&
+         index->keys[slot] != key)
+    slot = (slot + 1) & mask;
+  return slot;
+}
+
+/**
+ * Allocates empty slots for a hash index
+ *
+ * @param index     The index
+ * @param capacity  The number of slots (a power of two)
+ */
+void allocate_slots(struct HashIndex* index, unsigned int capacity) {
+  index->capacity = capacity;
+  index->keys = arena_allocate(index->arena, capacity * sizeof(uint64_t));
+  index->values = arena_allocate(index->arena,
+                                 capacity * sizeof(unsigned int));
+  for (unsigned int slot = 0; slot < capacity; ++slot)
+    index->values[slot] = HASH_INDEX_EMPTY;
+}
+
+/**
+ * Doubles the capacity of a hash index
+ *
+ * @param index  The index to grow
+ */
+void grow_hash_index(struct HashIndex* index) {
+  unsigned int old_capacity = index->capacity;
+  uint64_t* old_keys = index->keys;
+  unsigned int* old_values = index->values;
+  allocate_slots(index, 2 * old_capacity);
+  for (unsigned int slot = 0; slot < old_capacity; ++slot)
+    if (old_values[slot] != HASH_INDEX_EMPTY) {
+      unsigned int new_slot = find_slot(index, old_keys[slot]);
+      index->keys[new_slot] = old_keys[slot];
+      index->values[new_slot] = old_values[slot];
+    }
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void initialize_hash_index(struct HashIndex* index,
+                           unsigned int expected_size,
+                           struct Arena* arena) {
+  unsigned int capacity = HASH_INDEX_MIN_CAPACITY;
+  while (capacity / 2 < expected_size)
+    capacity *= 2;
+  index->size = 0;
+  index->arena = arena;
+  allocate_slots(index, capacity);
+}
+
+// Accessors
+// ---------
+
+bool find_in_hash_index(const struct HashIndex* index, uint64_t key,
+                        unsigned int* value) {
+  unsigned int slot = find_slot(index, key);
+  if (index->values[slot] == HASH_INDEX_EMPTY)
+    return false;
+  *value = index->values[slot];
+  return true;
+}
+
+uint64_t count_hash_index_comparisons(const struct HashIndex* index) {
+  unsigned int mask = index->capacity - 1;
+  uint64_t num_comparisons = 0;
+  for (unsigned int slot = 0; slot < index->capacity; ++slot)
+    if (index->values[slot] != HASH_INDEX_EMPTY) {
+      unsigned int home = (unsigned int)hash_key(index->keys[slot]) & mask;
+      num_comparisons += ((slot - home) & mask) + 1;
+    }
+  return num_comparisons;
+}
+
+// Modifiers
+// ---------
+
+bool insert_in_hash_index(struct HashIndex* index, uint64_t key,
+                          unsigned int value, unsigned int* existing) {
+  unsigned int slot = find_slot(index, key);
+  if (index->values[slot] != HASH_INDEX_EMPTY) {
+    *existing = index->values[slot];
+    return false;
+  }
+  index->keys[slot] = key;
+  index->values[slot] = value;
+  ++index->size;
+  if (2 * index->size > index->capacity)
+    grow_hash_index(index);
+  return true;
+}
+
+bool remove_from_hash_index(struct HashIndex* index, uint64_t key) {
+  unsigned int slot = find_slot(index, key);
+  if (index->values[slot] == HASH_INDEX_EMPTY)
+    return false;
+  unsigned int mask = index->capacity - 1, next = slot;
+  while (true) {
+    next = (next + 1) & mask;
+    if (index->values[next] == HASH_INDEX_EMPTY)
+      break;
+    // The key of next can fill the hole if the hole is between its home
+    // slot and next, cyclically
+    unsigned int home = (unsigned int)hash_key(index->keys[next]) & mask;
+    if (((next - home) & mask) >= ((next - slot) & mask)) {
+      index->keys[slot] = index->keys[next];
+      index->values[slot] = index->values[next];
+      slot = next;
+    }
+  }
+  index->values[slot] = HASH_INDEX_EMPTY;
+  --index->size;
+  return true;
+}
+
+// Keys
+// ----
+
+uint64_t position_key(int x, int y) {
+  return (uint64_t)(uint32_t)x << 32 | (uint32_t)y;
+}
+
+uint64_t content_hash(const char* data, size_t size) {
+  uint64_t hash = hash_key(size), word;
+  size_t i = 0;
+  for (; i + sizeof(word) <= size; i += sizeof(word)) {
+    memcpy(&word, data + i, sizeof(word));
+    hash = hash_key(hash ^ word);
+  }
+  word = 0;
+  memcpy(&word, data + i, size - i);
+  return hash_key(hash ^ word);
+}
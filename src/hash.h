@@ -0,0 +1,129 @@
+#ifndef HASH_H_
+#define HASH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+// Constants
+// ---------
+
+// The value marking an empty slot (cannot be stored in an index)
+#define HASH_INDEX_EMPTY 0xFFFFFFFFu
+
+// Types
+// -----
+
+// A hash index associating 64-bit keys to unsigned integers
+//
+// The index uses open addressing with linear probing. Its capacity doubles
+// whenever it becomes more than half full, and all its memory is allocated
+// from an arena.
+struct HashIndex {
+  // The number of slots (a power of two)
+  unsigned int capacity;
+  // The number of keys in the index
+  unsigned int size;
+  // The keys of the slots
+  uint64_t* keys;
+  // The values of the slots (HASH_INDEX_EMPTY for an empty slot)
+  unsigned int* values;
+  // The arena from which the slots are allocated
+  struct Arena* arena;
+};
+
+// Construction
+// ------------
+
+/**
+ * Initializes an empty hash index
+ *
+ * @param index          The index to initialize
+ * @param expected_size  The number of keys expected, to avoid growing
+ * @param arena          The arena from which the index is allocated
+ */
+void initialize_hash_index(struct HashIndex* index,
+                           unsigned int expected_size,
+                           struct Arena* arena);
+
+// Accessors
+// ---------
+
+/**
+ * Returns the value associated with a key in a hash index
+ *
+ * @param index  The index
+ * @param key    The key
+ * @param value  The value associated with the key, if found
+ * @return       true if and only if the key is in the index
+ */
+bool find_in_hash_index(const struct HashIndex* index, uint64_t key,
+                        unsigned int* value);
+
+/**
+ * Returns the number of key comparisons needed to find all the keys of a
+ * hash index
+ *
+ * Each key is compared once per slot between its home slot and its own, so
+ * that the result measures the clustering of the index without counting
+ * anything while it is used.
+ *
+ * @param index  The index
+ * @return       The number of comparisons
+ */
+uint64_t count_hash_index_comparisons(const struct HashIndex* index);
+
+// Modifiers
+// ---------
+
+/**
+ * Inserts a key in a hash index, unless it is already there
+ *
+ * @param index     The index
+ * @param key       The key
+ * @param value     The value to associate with the key
+ * @param existing  The value already associated with the key, if any
+ * @return          true if and only if the key was inserted
+ */
+bool insert_in_hash_index(struct HashIndex* index, uint64_t key,
+                          unsigned int value, unsigned int* existing);
+
+/**
+ * Removes a key from a hash index, if it is there
+ *
+ * The keys following the removed one in its cluster are shifted back, so
+ * that no tombstone is left and the lookups stay as fast as before.
+ *
+ * @param index  The index
+ * @param key    The key
+ * @return       true if and only if the key was removed
+ */
+bool remove_from_hash_index(struct HashIndex* index, uint64_t key);
+
+// Keys
+// ----
+
+/**
+ * Packs a position into a 64-bit key
+ *
+ * @param x  The x coordinate
+ * @param y  The y coordinate
+ * @return   The key
+ */
+uint64_t position_key(int x, int y);
+
+/**
+ * Returns a 64-bit hash of the content of a buffer
+ *
+ * The buffer is read 8 bytes at a time, each word being mixed into the hash
+ * with the finalizer of splitmix64.
+ *
+ * @param data  The content of the buffer
+ * @param size  The size of the buffer, in bytes
+ * @return      The hash of the content
+ */
+uint64_t content_hash(const char* data, size_t size);
+
+#endif
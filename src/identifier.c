@@ -0,0 +1,282 @@
+#include "identifier.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "arena.h"
+#include "hash.h"
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The smallest capacity of a pool of identifiers, in characters
+#define IDENTIFIER_POOL_MIN_CAPACITY 256
+// The smallest capacity of an index of identifiers
+#define IDENTIFIER_INDEX_MIN_CAPACITY 16
+
+// Keys
+// ----
+
+/**
+ * Returns the base 64 digit of a character of an identifier
+ *
+ * @param c  The character
+ * @return   The digit, from 1 to 63 (0 for a character that cannot appear in
+ *           an identifier)
+ */
+unsigned int identifier_digit(char c) {
+  if (c >= '0' && c <= '9')
+    return 1 + (c - '0');
+  if (c >= 'A' && c <= 'Z')
+    return 11 + (c - 'A');
+  if (c == '_')
+    return 37;
+  if (c >= 'a' && c <= 'z')
+    return 38 + (c - 'a');
+  return 0;
+}
+
+// Index
+// -----
+
+/**
+ * Indicates if an identifier of a pool is equal to a given one
+ *
+ * @param stored  The identifier of the pool, null-terminated
+ * @param id      The given identifier (not necessarily null-terminated)
+ * @param length  The length of the given identifier
+ * @return        true if and only if the identifiers are equal
+ */
+bool identifier_equals(const char* stored, const char* id, size_t length) {
+  return strncmp(stored, id, length) == 0 && stored[length] == '\0';
+}
+
+/**
+ * Returns the slot where an identifier is or would be stored
+ *
+ * @param index   The index
+ * @param hash    The hash of the identifier
+ * @param id      The identifier (not necessarily null-terminated)
+ * @param length  The length of the identifier
+ * @return        The slot of the identifier
+ */
+unsigned int find_identifier_slot(const struct IdentifierIndex* index,
+                                  uint64_t hash, const char* id,
+                                  size_t length) {
+  unsigned int mask = index->capacity - 1, slot = (unsigned int)hash & mask;
+  while (index->values[slot] != HASH_INDEX_EMPTY &&
+         (index->hashes[slot] != hash ||
+          !identifier_equals(identifier_string(index->pool,
+                                               index->handles[slot]),
+                             id, length)))
+    slot = (slot + 1) & mask;
+  return slot;
+}
+
+/**
+ * Returns the slot where an identifier of the pool is or would be stored
+ *
+ * @param index   The index
+ * @param handle  The handle of the identifier in the pool
+ * @param hash    The resulting hash of the identifier
+ * @return        The slot of the identifier
+ */
+unsigned int find_handle_slot(const struct IdentifierIndex* index,
+                              uint32_t handle, uint64_t* hash) {
+  const char* id = identifier_string(index->pool, handle);
+  size_t length = strlen(id);
+  *hash = content_hash(id, length);
+  return find_identifier_slot(index, *hash, id, length);
+}
+
+/**
+ * Allocates empty slots for an index of identifiers
+ *
+ * @param index     The index
+ * @param capacity  The number of slots (a power of two)
+ */
+void allocate_identifier_slots(struct IdentifierIndex* index,
+                               unsigned int capacity) {
+  index->capacity = capacity;
+  index->hashes = arena_allocate(index->arena, capacity * sizeof(uint64_t));
+  index->handles = arena_allocate(index->arena, capacity * sizeof(uint32_t));
+  index->values = arena_allocate(index->arena,
+                                 capacity * sizeof(unsigned int));
+  for (unsigned int slot = 0; slot < capacity; ++slot)
+    index->values[slot] = HASH_INDEX_EMPTY;
+}
+
+/**
+ * Doubles the capacity of an index of identifiers
+ *
+ * The identifiers are moved with their hashes, without reading them.
+ *
+ * @param index  The index to grow
+ */
+void grow_identifier_index(struct IdentifierIndex* index) {
+  unsigned int old_capacity = index->capacity;
+  uint64_t* old_hashes = index->hashes;
+  uint32_t* old_handles = index->handles;
+  unsigned int* old_values = index->values;
+  allocate_identifier_slots(index, 2 * old_capacity);
+  unsigned int mask = index->capacity - 1;
+  for (unsigned int slot = 0; slot < old_capacity; ++slot)
+    if (old_values[slot] != HASH_INDEX_EMPTY) {
+      unsigned int new_slot = (unsigned int)old_hashes[slot] & mask;
+      while (index->values[new_slot] != HASH_INDEX_EMPTY)
+        new_slot = (new_slot + 1) & mask;
+      index->hashes[new_slot] = old_hashes[slot];
+      index->handles[new_slot] = old_handles[slot];
+      index->values[new_slot] = old_values[slot];
+    }
+}
+
+// Public functions definition
+// ===========================
+
+// Pool
+// ----
+
+void initialize_identifier_pool(struct IdentifierPool* pool,
+                                struct Arena* arena) {
+  pool->chars = NULL;
+  pool->size = 0;
+  pool->capacity = 0;
+  pool->arena = arena;
+}
+
+void reserve_identifier_pool(struct IdentifierPool* pool, size_t size) {
+  if (size <= pool->capacity)
+    return;
+  if (size > (size_t)UINT32_MAX + 1)
+    report_error_out_of_memory();
+  size_t capacity = pool->capacity == 0
+                  ? IDENTIFIER_POOL_MIN_CAPACITY : 2 * pool->capacity;
+  while (capacity < size)
+    capacity *= 2;
+  pool->chars = arena_grow(pool->arena, pool->chars, pool->size, capacity);
+  pool->capacity = capacity;
+}
+
+uint32_t add_identifier(struct IdentifierPool* pool, const char* id,
+                        size_t length) {
+  reserve_identifier_pool(pool, pool->size + length + 1);
+  uint32_t handle = pool->size;
+  memcpy(pool->chars + handle, id, length);
+  pool->chars[handle + length] = '\0';
+  pool->size += length + 1;
+  return handle;
+}
+
+const char* identifier_string(const struct IdentifierPool* pool,
+                              uint32_t handle) {
+  return pool->chars + handle;
+}
+
+// Keys
+// ----
+
+uint64_t identifier_key(const char* id, size_t length) {
+  uint64_t key = 0;
+  for (unsigned int i = 0; i < IDENTIFIER_KEY_LENGTH; ++i)
+    key = key << 6 | (i < length ? identifier_digit(id[i]) : 0);
+  return key;
+}
+
+int compare_identifiers(uint64_t key1, const char* id1, uint64_t key2,
+                        const char* id2) {
+  if (key1 != key2)
+    return key1 < key2 ? -1 : 1;
+  // A key ending with the digit 0 encodes its whole identifier
+  if ((key1 & 63) == 0)
+    return 0;
+  return strcmp(id1, id2);
+}
+
+// Index
+// -----
+
+void initialize_identifier_index(struct IdentifierIndex* index,
+                                 const struct IdentifierPool* pool,
+                                 unsigned int expected_size,
+                                 struct Arena* arena) {
+  unsigned int capacity = IDENTIFIER_INDEX_MIN_CAPACITY;
+  while (capacity / 2 < expected_size)
+    capacity *= 2;
+  index->size = 0;
+  index->pool = pool;
+  index->arena = arena;
+  allocate_identifier_slots(index, capacity);
+}
+
+bool find_in_identifier_index(const struct IdentifierIndex* index,
+                              const char* id, size_t length,
+                              unsigned int* value) {
+  unsigned int slot = find_identifier_slot(index, content_hash(id, length),
+                                           id, length);
+  if (index->values[slot] == HASH_INDEX_EMPTY)
+    return false;
+  *value = index->values[slot];
+  return true;
+}
+
+uint64_t count_identifier_comparisons(const struct IdentifierIndex* index) {
+  unsigned int mask = index->capacity - 1;
+  uint64_t num_comparisons = 0;
+  for (unsigned int slot = 0; slot < index->capacity; ++slot)
+    if (index->values[slot] != HASH_INDEX_EMPTY) {
+      unsigned int home = (unsigned int)index->hashes[slot] & mask;
+      num_comparisons += ((slot - home) & mask) + 1;
+    }
+  return num_comparisons;
+}
+
+bool insert_in_identifier_index(struct IdentifierIndex* index,
+                                uint32_t handle, unsigned int value,
+                                unsigned int* existing) {
+  uint64_t hash;
+  unsigned int slot = find_handle_slot(index, handle, &hash);
+  if (index->values[slot] != HASH_INDEX_EMPTY) {
+    *existing = index->values[slot];
+    return false;
+  }
+  index->hashes[slot] = hash;
+  index->handles[slot] = handle;
+  index->values[slot] = value;
+  ++index->size;
+  if (2 * index->size > index->capacity)
+    grow_identifier_index(index);
+  return true;
+}
+
+bool remove_from_identifier_index(struct IdentifierIndex* index,
+                                  uint32_t handle) {
+  uint64_t hash;
+  unsigned int slot = find_handle_slot(index, handle, &hash);
+  if (index->values[slot] == HASH_INDEX_EMPTY)
+    return false;
+  unsigned int mask = index->capacity - 1, next = slot;
+  while (true) {
+    next = (next + 1) & mask;
+    if (index->values[next] == HASH_INDEX_EMPTY)
+      break;
+    // The identifier of next can fill the hole if the hole is between its
+    // home slot and next, cyclically
+    unsigned int home = (unsigned int)index->hashes[next] & mask;
+    if (((next - home) & mask) >= ((next - slot) & mask)) {
+      index->hashes[slot] = index->hashes[next];
+      index->handles[slot] = index->handles[next];
+      index->values[slot] = index->values[next];
+      slot = next;
+    }
+  }
+  index->values[slot] = HASH_INDEX_EMPTY;
+  --index->size;
+  return true;
+}
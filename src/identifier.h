@@ -0,0 +1,206 @@
+#ifndef IDENTIFIER_H_
+#define IDENTIFIER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+// Constants
+// ---------
+
+// The number of leading characters of an identifier encoded in its key
+#define IDENTIFIER_KEY_LENGTH 10
+
+// Types
+// -----
+
+// A pool of identifiers
+//
+// The identifiers are stored one after the other, each followed by a null
+// character, in a buffer whose capacity doubles when full. An identifier is
+// designated by its handle, the offset of its first character, which stays
+// valid when the buffer grows, so that an object only holds 32 bits whatever
+// the length of its identifier. The identifiers are never removed, and the
+// buffer is allocated from an arena.
+struct IdentifierPool {
+  // The characters of the identifiers
+  char* chars;
+  // The number of characters used
+  size_t size;
+  // The number of characters that can be held before growing
+  size_t capacity;
+  // The arena from which the buffer is allocated
+  struct Arena* arena;
+};
+
+// An index associating the identifiers of a pool to unsigned integers
+//
+// The index uses open addressing with linear probing, as a hash index, on a
+// 64-bit hash of the identifiers. Only the identifiers with the same hash are
+// compared as strings. Its capacity doubles whenever it becomes more than half
+// full, and all its memory is allocated from an arena.
+struct IdentifierIndex {
+  // The number of slots (a power of two)
+  unsigned int capacity;
+  // The number of identifiers in the index
+  unsigned int size;
+  // The hashes of the identifiers of the slots
+  uint64_t* hashes;
+  // The handles of the identifiers of the slots
+  uint32_t* handles;
+  // The values of the slots (HASH_INDEX_EMPTY for an empty slot)
+  unsigned int* values;
+  // The pool of the identifiers
+  const struct IdentifierPool* pool;
+  // The arena from which the slots are allocated
+  struct Arena* arena;
+};
+
+// Pool
+// ----
+
+/**
+ * Initializes an empty pool of identifiers
+ *
+ * @param pool   The pool to initialize
+ * @param arena  The arena from which the pool is allocated
+ */
+void initialize_identifier_pool(struct IdentifierPool* pool,
+                                struct Arena* arena);
+
+/**
+ * Ensures that a pool can hold a given number of characters without growing
+ *
+ * @param pool  The pool
+ * @param size  The number of characters, null characters included
+ */
+void reserve_identifier_pool(struct IdentifierPool* pool, size_t size);
+
+/**
+ * Adds an identifier to a pool
+ *
+ * A pool holds at most 4 GiB of identifiers: beyond, an error is printed on
+ * stderr and the program exits with 1, as when memory runs out.
+ *
+ * @param pool    The pool
+ * @param id      The identifier (not necessarily null-terminated)
+ * @param length  The length of the identifier
+ * @return        The handle of the identifier in the pool
+ */
+uint32_t add_identifier(struct IdentifierPool* pool, const char* id,
+                        size_t length);
+
+/**
+ * Returns an identifier of a pool
+ *
+ * The result is invalidated when an identifier is added to the pool.
+ *
+ * @param pool    The pool
+ * @param handle  The handle of the identifier
+ * @return        The identifier, null-terminated
+ */
+const char* identifier_string(const struct IdentifierPool* pool,
+                              uint32_t handle);
+
+// Keys
+// ----
+
+/**
+ * Returns the sort key of an identifier
+ *
+ * The first IDENTIFIER_KEY_LENGTH characters of a valid identifier are
+ * encoded in base 64, one digit per character in the order of the ASCII
+ * codes, and the missing characters of a shorter identifier as 0. Hence,
+ * an identifier preceding another one with strcmp never has a larger key,
+ * and an identifier whose key ends with the digit 0 is the only one with
+ * its key. Only the empty identifier has key 0.
+ *
+ * @param id      The identifier
+ * @param length  The length of the identifier
+ * @return        The key of the identifier
+ */
+uint64_t identifier_key(const char* id, size_t length);
+
+/**
+ * Compares two identifiers given with their keys
+ *
+ * The keys are compared first, and the identifiers themselves only when
+ * their keys are equal and may encode distinct identifiers.
+ *
+ * @param key1  The key of the first identifier
+ * @param id1   The first identifier
+ * @param key2  The key of the second identifier
+ * @param id2   The second identifier
+ * @return      A negative, zero or positive integer, as strcmp(id1, id2)
+ */
+int compare_identifiers(uint64_t key1, const char* id1, uint64_t key2,
+                        const char* id2);
+
+// Index
+// -----
+
+/**
+ * Initializes an empty index of the identifiers of a pool
+ *
+ * @param index          The index to initialize
+ * @param pool           The pool of the identifiers
+ * @param expected_size  The number of identifiers expected, to avoid growing
+ * @param arena          The arena from which the index is allocated
+ */
+void initialize_identifier_index(struct IdentifierIndex* index,
+                                 const struct IdentifierPool* pool,
+                                 unsigned int expected_size,
+                                 struct Arena* arena);
+
+/**
+ * Returns the value associated with an identifier in an index
+ *
+ * @param index   The index
+ * @param id      The identifier (not necessarily null-terminated)
+ * @param length  The length of the identifier
+ * @param value   The value associated with the identifier, if found
+ * @return        true if and only if the identifier is in the index
+ */
+bool find_in_identifier_index(const struct IdentifierIndex* index,
+                              const char* id, size_t length,
+                              unsigned int* value);
+
+/**
+ * Returns the number of comparisons needed to find all the identifiers of an
+ * index
+ *
+ * This is count_hash_index_comparisons for an index of identifiers.
+ *
+ * @param index  The index
+ * @return       The number of comparisons
+ */
+uint64_t count_identifier_comparisons(const struct IdentifierIndex* index);
+
+/**
+ * Inserts an identifier of the pool in an index, unless it is already there
+ *
+ * @param index     The index
+ * @param handle    The handle of the identifier in the pool
+ * @param value     The value to associate with the identifier
+ * @param existing  The value already associated with the identifier, if any
+ * @return          true if and only if the identifier was inserted
+ */
+bool insert_in_identifier_index(struct IdentifierIndex* index,
+                                uint32_t handle, unsigned int value,
+                                unsigned int* existing);
+
+/**
+ * Removes an identifier of the pool from an index, if it is there
+ *
+ * As with a hash index, no tombstone is left.
+ *
+ * @param index   The index
+ * @param handle  The handle of the identifier in the pool
+ * @return        true if and only if the identifier was removed
+ */
+bool remove_from_identifier_index(struct IdentifierIndex* index,
+                                  uint32_t handle);
+
+#endif
@@ -0,0 +1,275 @@
+#include "input.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The initial capacity of the buffer used to read a stream
+#define INITIAL_BUFFER_CAPACITY 65536
+// The initial capacity of the buffer of a line reader
+#define LINE_READER_CAPACITY 262144
+
+// Reading
+// -------
+
+/**
+ * Reads bytes from a file descriptor, retrying when interrupted by a signal
+ *
+ * @param fd      The file descriptor
+ * @param buffer  The buffer receiving the bytes
+ * @param size    The maximum number of bytes read
+ * @return        The number of bytes read, 0 at the end of the file, or -1 if
+ *                the file cannot be read
+ */
+ssize_t read_uninterrupted(int fd, char* buffer, size_t size) {
+  ssize_t num_read;
+  do
+    num_read = read(fd, buffer, size);
+  while (num_read < 0 && errno == EINTR);
+  return num_read;
+}
+
+/**
+ * Maps a regular file in memory
+ *
+ * @param input  The resulting input
+ * @param fd     The file descriptor of the file
+ * @return       true if and only if the file could be mapped
+ */
+bool map_input(struct Input* input, int fd) {
+  struct stat status;
+  if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode))
+    return false;
+  input->size = status.st_size;
+  input->is_mapped = true;
+  if (input->size == 0) {
+    input->data = "";
+    return true;
+  }
+  void* data = mmap(NULL, input->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED)
+    return false;
+  madvise(data, input->size, MADV_SEQUENTIAL);
+  input->data = data;
+  return true;
+}
+
+/**
+ * Reads the rest of a stream after the content of a buffer
+ *
+ * The capacity of the buffer doubles whenever it is full. The buffer is
+ * released if the stream cannot be read.
+ *
+ * @param input     The resulting input
+ * @param fd        The file descriptor of the stream
+ * @param buffer    The buffer, allocated with malloc
+ * @param capacity  The capacity of the buffer
+ * @param size      The number of bytes already in the buffer
+ * @return          true if and only if the stream could be read
+ */
+bool read_input_after(struct Input* input, int fd, char* buffer,
+                      size_t capacity, size_t size) {
+  while (true) {
+    if (size == capacity) {
+      capacity *= 2;
+      char* grown = realloc(buffer, capacity);
+      if (grown == NULL)
+        report_error_out_of_memory();
+      buffer = grown;
+    }
+    ssize_t num_read = read_uninterrupted(fd, buffer + size, capacity - size);
+    if (num_read == 0)
+      break;
+    if (num_read < 0) {
+      free(buffer);
+      return false;
+    }
+    size += num_read;
+  }
+  input->data = buffer;
+  input->size = size;
+  input->is_mapped = false;
+  return true;
+}
+
+/**
+ * Reads a stream into a single buffer
+ *
+ * @param input  The resulting input
+ * @param fd     The file descriptor of the stream
+ * @return       true if and only if the stream could be read
+ */
+bool read_input(struct Input* input, int fd) {
+  char* buffer = malloc(INITIAL_BUFFER_CAPACITY);
+  if (buffer == NULL)
+    report_error_out_of_memory();
+  return read_input_after(input, fd, buffer, INITIAL_BUFFER_CAPACITY, 0);
+}
+
+/**
+ * Reads more bytes in the buffer of a line reader
+ *
+ * The unread bytes are first moved to the start of the buffer, which only
+ * grows if it is full of them. If the file cannot be read, the reader is
+ * marked as failed and at its end.
+ *
+ * @param reader  The reader
+ */
+void fill_line_reader(struct LineReader* reader) {
+  memmove(reader->buffer, reader->buffer + reader->start,
+          reader->end - reader->start);
+  reader->end -= reader->start;
+  reader->start = 0;
+  if (reader->end == reader->capacity) {
+    reader->capacity *= 2;
+    char* grown = realloc(reader->buffer, reader->capacity);
+    if (grown == NULL)
+      report_error_out_of_memory();
+    reader->buffer = grown;
+  }
+  ssize_t num_read = read_uninterrupted(reader->fd,
+                                        reader->buffer + reader->end,
+                                        reader->capacity - reader->end);
+  if (num_read <= 0) {
+    reader->has_failed = num_read < 0;
+    reader->is_at_end = true;
+    return;
+  }
+  reader->end += num_read;
+  reader->num_bytes += num_read;
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+bool open_file_input(struct Input* input, const char* path,
+                     struct Error* error) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return report_error_cannot_read_file(error, path);
+  bool success = map_input(input, fd) || read_input(input, fd);
+  close(fd);
+  return success || report_error_cannot_read_file(error, path);
+}
+
+bool open_stdin_input(struct Input* input, struct Error* error) {
+  return map_input(input, STDIN_FILENO) ||
+         read_input(input, STDIN_FILENO) ||
+         report_error_cannot_read_file(error, "stdin");
+}
+
+bool open_line_reader(struct LineReader* reader, const char* path,
+                      struct Error* error) {
+  if (path == NULL) {
+    reader->fd = STDIN_FILENO;
+    reader->name = "stdin";
+  } else {
+    reader->fd = open(path, O_RDONLY);
+    reader->name = path;
+    if (reader->fd < 0)
+      return report_error_cannot_read_file(error, path);
+  }
+  reader->capacity = LINE_READER_CAPACITY;
+  reader->buffer = malloc(reader->capacity);
+  if (reader->buffer == NULL)
+    report_error_out_of_memory();
+  reader->start = 0;
+  reader->end = 0;
+  reader->is_at_end = false;
+  reader->has_failed = false;
+  reader->num_lines = 0;
+  reader->num_bytes = 0;
+  return true;
+}
+
+void close_line_reader(struct LineReader* reader) {
+  if (reader->fd != STDIN_FILENO)
+    close(reader->fd);
+  free(reader->buffer);
+  reader->buffer = NULL;
+}
+
+void close_input(struct Input* input) {
+  if (!input->is_mapped)
+    free((char*)input->data);
+  else if (input->size > 0)
+    munmap((char*)input->data, input->size);
+  input->data = NULL;
+  input->size = 0;
+}
+
+// Line reading
+// ------------
+
+bool line_reader_starts_with(struct LineReader* reader, const char* prefix,
+                             size_t length) {
+  while (reader->end - reader->start < length && !reader->is_at_end)
+    fill_line_reader(reader);
+  return reader->end - reader->start >= length &&
+         memcmp(reader->buffer + reader->start, prefix, length) == 0;
+}
+
+bool read_next_line(struct LineReader* reader, struct StringView* line) {
+  size_t searched = reader->start;
+  while (true) {
+    const char* newline = memchr(reader->buffer + searched, '\n',
+                                 reader->end - searched);
+    if (newline != NULL) {
+      line->start = reader->buffer + reader->start;
+      line->length = newline - line->start;
+      reader->start += line->length + 1;
+      ++reader->num_lines;
+      return true;
+    }
+    if (reader->is_at_end) {
+      if (reader->start == reader->end || reader->has_failed)
+        return false;
+      line->start = reader->buffer + reader->start;
+      line->length = reader->end - reader->start;
+      reader->start = reader->end;
+      ++reader->num_lines;
+      return true;
+    }
+    // Only the bytes read by fill_line_reader remain to be searched
+    searched = reader->end - reader->start;
+    fill_line_reader(reader);
+  }
+}
+
+bool read_remaining_input(struct LineReader* reader, struct Input* input,
+                          struct Error* error) {
+  memmove(reader->buffer, reader->buffer + reader->start,
+          reader->end - reader->start);
+  // The buffer is handed over to the input, or released on failure
+  bool success = read_input_after(input, reader->fd, reader->buffer,
+                                  reader->capacity,
+                                  reader->end - reader->start);
+  reader->buffer = NULL;
+  reader->start = 0;
+  reader->end = 0;
+  reader->is_at_end = true;
+  return success || report_error_cannot_read_file(error, reader->name);
+}
+
+// String views
+// ------------
+
+bool string_view_equals(struct StringView view, const char* s) {
+  return strlen(s) == view.length && memcmp(view.start, s, view.length) == 0;
+}
@@ -0,0 +1,160 @@
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "validation.h"
+
+// Types
+// -----
+
+// A view on a string that is not necessarily null-terminated
+struct StringView {
+  // The first character of the string
+  const char* start;
+  // The number of characters of the string
+  size_t length;
+};
+
+// A text input held in memory
+//
+// Regular files are mapped in memory, so that they are never copied. Other
+// streams (pipes, terminals) are read in a single buffer.
+struct Input {
+  // The content of the input
+  const char* data;
+  // The size of the content, in bytes
+  size_t size;
+  // true if the content is a memory mapping, false if it is a buffer
+  bool is_mapped;
+};
+
+// A reader of the lines of a file through a buffer of bounded size
+//
+// The buffer only grows when a line does not fit in it, so that reading a
+// file line by line takes memory proportional to its longest line instead of
+// its size.
+struct LineReader {
+  // The file descriptor of the file
+  int fd;
+  // The name of the file, for error messages
+  const char* name;
+  // The buffer
+  char* buffer;
+  // The capacity of the buffer, in bytes
+  size_t capacity;
+  // The position of the first byte not yet returned
+  size_t start;
+  // The position following the last byte read
+  size_t end;
+  // true if the end of the file was reached
+  bool is_at_end;
+  // true if the file could not be read
+  bool has_failed;
+  // The number of lines returned so far
+  uint64_t num_lines;
+  // The number of bytes read from the file so far
+  uint64_t num_bytes;
+};
+
+// Construction
+// ------------
+
+/**
+ * Opens a file as an input
+ *
+ * @param input  The resulting input
+ * @param path   The path of the file
+ * @param error  The error, if the file cannot be read
+ * @return       true if and only if the file could be read
+ */
+bool open_file_input(struct Input* input, const char* path,
+                     struct Error* error);
+
+/**
+ * Opens the standard input as an input
+ *
+ * @param input  The resulting input
+ * @param error  The error, if the standard input cannot be read
+ * @return       true if and only if the standard input could be read
+ */
+bool open_stdin_input(struct Input* input, struct Error* error);
+
+/**
+ * Releases the memory held by an input
+ *
+ * @param input  The input to close
+ */
+void close_input(struct Input* input);
+
+/**
+ * Opens a file for reading line by line
+ *
+ * @param reader  The resulting reader
+ * @param path    The path of the file, or NULL for the standard input
+ * @param error   The error, if the file cannot be opened
+ * @return        true if and only if the file could be opened
+ */
+bool open_line_reader(struct LineReader* reader, const char* path,
+                      struct Error* error);
+
+/**
+ * Closes a line reader
+ *
+ * @param reader  The reader to close
+ */
+void close_line_reader(struct LineReader* reader);
+
+// Line reading
+// ------------
+
+/**
+ * Indicates if the unread content of a line reader starts with a prefix
+ *
+ * @param reader  The reader
+ * @param prefix  The prefix
+ * @param length  The length of the prefix
+ * @return        true if and only if the unread content starts with prefix
+ */
+bool line_reader_starts_with(struct LineReader* reader, const char* prefix,
+                             size_t length);
+
+/**
+ * Reads the next line of a line reader
+ *
+ * The line does not include its newline character, and remains valid until
+ * the next call. If the file cannot be read, no line is returned and
+ * has_failed is set.
+ *
+ * @param reader  The reader
+ * @param line    The resulting line
+ * @return        true if and only if a line was read
+ */
+bool read_next_line(struct LineReader* reader, struct StringView* line);
+
+/**
+ * Reads all the unread content of a line reader into an input
+ *
+ * @param reader  The reader, which is left at the end of its file
+ * @param input   The resulting input, to be closed with close_input
+ * @param error   The error, if the file cannot be read
+ * @return        true if and only if the file could be read
+ */
+bool read_remaining_input(struct LineReader* reader, struct Input* input,
+                          struct Error* error);
+
+// String views
+// ------------
+
+/**
+ * Indicates if a string view is equal to a null-terminated string
+ *
+ * @param view  The view
+ * @param s     The string
+ * @return      true if and only if both strings are equal
+ */
+bool string_view_equals(struct StringView view, const char* s);
+
+#endif
@@ -0,0 +1,265 @@
+#include "kdtree.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtree.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Types
+// -----
+
+// A subtree waiting to be visited by a search
+struct KdSubtree {
+  // The first point of the subtree
+  unsigned int first;
+  // The end of the points of the subtree
+  unsigned int end;
+  // The axis of the median of the subtree (0 for x, 1 for y)
+  unsigned int axis;
+  // The distance along x from the searched box to the cell of the subtree
+  uint64_t dx;
+  // The distance along y from the searched box to the cell of the subtree
+  uint64_t dy;
+};
+
+// Geometry
+// --------
+
+/**
+ * Returns a coordinate of a point
+ *
+ * @param point  The point
+ * @param axis   The axis of the coordinate (0 for x, 1 for y)
+ * @return       The coordinate
+ */
+int kd_coordinate(const struct KdPoint* point, unsigned int axis) {
+  return axis == 0 ? point->x : point->y;
+}
+
+/**
+ * Returns the distance from an interval to a value
+ *
+ * @param min    The minimum of the interval
+ * @param max    The maximum of the interval
+ * @param value  The value
+ * @return       0 if the interval contains the value, the distance to its
+ *               nearest bound otherwise
+ */
+uint64_t interval_gap(long long min, long long max, long long value) {
+  return value < min ? (uint64_t)(min - value)
+       : value > max ? (uint64_t)(value - max) : 0;
+}
+
+/**
+ * Returns the square of a distance given by its coordinates
+ *
+ * @param dx  The distance along x
+ * @param dy  The distance along y
+ * @return    dx^2 + dy^2, or UINT64_MAX if it does not fit
+ */
+uint64_t saturated_squared_distance(uint64_t dx, uint64_t dy) {
+  if (dx > UINT32_MAX || dy > UINT32_MAX)
+    return UINT64_MAX;
+  uint64_t dx2 = dx * dx, dy2 = dy * dy;
+  return dx2 > UINT64_MAX - dy2 ? UINT64_MAX : dx2 + dy2;
+}
+
+// Construction
+// ------------
+
+/**
+ * Moves the n-th point of a range, by one coordinate, to its place
+ *
+ * The points before it end with a coordinate at most its own, and the points
+ * after it at least (Hoare's selection, with a median of three pivot).
+ *
+ * @param points  The points
+ * @param first   The first point of the range
+ * @param end     The end of the range
+ * @param nth     The position of the point to place, in the range
+ * @param axis    The axis of the coordinate
+ */
+void select_kd_point(struct KdPoint* points, unsigned int first,
+                     unsigned int end, unsigned int nth, unsigned int axis) {
+  long long left = first, right = (long long)end - 1;
+  while (left < right) {
+    int a = kd_coordinate(points + left, axis),
+        b = kd_coordinate(points + (left + right) / 2, axis),
+        c = kd_coordinate(points + right, axis);
+    int pivot = a < b ? (b < c ? b : a < c ? c : a)
+                      : (a < c ? a : b < c ? c : b);
+    long long i = left, j = right;
+    while (i <= j) {
+      while (kd_coordinate(points + i, axis) < pivot)
+        ++i;
+      while (kd_coordinate(points + j, axis) > pivot)
+        --j;
+      if (i <= j) {
+        struct KdPoint swap = points[i];
+        points[i++] = points[j];
+        points[j--] = swap;
+      }
+    }
+    if (j < nth)
+      left = i;
+    if (nth < i)
+      right = j;
+  }
+}
+
+/**
+ * Orders a range of points as a subtree of a k-d tree
+ *
+ * @param points  The points
+ * @param first   The first point of the range
+ * @param end     The end of the range
+ * @param axis    The axis along which the range is cut
+ */
+void build_kd_subtree(struct KdPoint* points, unsigned int first,
+                      unsigned int end, unsigned int axis) {
+  while (end - first > 1) {
+    unsigned int middle = first + (end - first) / 2;
+    select_kd_point(points, first, end, middle, axis);
+    axis = 1 - axis;
+    build_kd_subtree(points, first, middle, axis);
+    first = middle + 1;
+  }
+}
+
+// Neighbors
+// ---------
+
+/**
+ * Indicates if a neighbor comes after another one
+ *
+ * @param neighbor1  The first neighbor
+ * @param neighbor2  The second neighbor
+ * @return           true if and only if the first neighbor is farther, or as
+ *                   far with a greater index
+ */
+bool is_farther_neighbor(const struct KdNeighbor* neighbor1,
+                         const struct KdNeighbor* neighbor2) {
+  return neighbor1->distance != neighbor2->distance
+       ? neighbor1->distance > neighbor2->distance
+       : neighbor1->index > neighbor2->index;
+}
+
+/**
+ * Moves down the root of a max-heap of neighbors to its place
+ *
+ * @param heap  The heap, ordered by is_farther_neighbor
+ * @param size  The number of neighbors in the heap
+ * @param node  The position of the neighbor to move down
+ */
+void sift_neighbor_down(struct KdNeighbor* heap, unsigned int size,
+                        unsigned int node) {
+  struct KdNeighbor neighbor = heap[node];
+  for (unsigned int child = 2 * node + 1; child < size;
+       child = 2 * node + 1) {
+    if (child + 1 < size && is_farther_neighbor(heap + child + 1,
+                                                heap + child))
+      ++child;
+    if (!is_farther_neighbor(heap + child, &neighbor))
+      break;
+    heap[node] = heap[child];
+    node = child;
+  }
+  heap[node] = neighbor;
+}
+
+/**
+ * Offers a point to the max-heap of the nearest neighbors found so far
+ *
+ * @param heap      The heap, ordered by is_farther_neighbor
+ * @param size      The number of neighbors in the heap
+ * @param k         The capacity of the heap
+ * @param neighbor  The offered neighbor
+ */
+void offer_neighbor(struct KdNeighbor* heap, unsigned int* size,
+                    unsigned int k, const struct KdNeighbor* neighbor) {
+  if (*size < k) {
+    unsigned int node = (*size)++;
+    while (node > 0 && is_farther_neighbor(neighbor, heap + (node - 1) / 2)) {
+      heap[node] = heap[(node - 1) / 2];
+      node = (node - 1) / 2;
+    }
+    heap[node] = *neighbor;
+  } else if (is_farther_neighbor(heap, neighbor)) {
+    heap[0] = *neighbor;
+    sift_neighbor_down(heap, k, 0);
+  }
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void build_kdtree(struct KdTree* tree, struct KdPoint* points,
+                  unsigned int num_points) {
+  tree->num_points = num_points;
+  tree->points = points;
+  build_kd_subtree(points, 0, num_points, 0);
+}
+
+// Search
+// ------
+
+unsigned int find_nearest_points(const struct KdTree* tree,
+                                 const struct RTreeBox* box, unsigned int k,
+                                 struct KdNeighbor* neighbors) {
+  unsigned int size = 0;
+  if (k == 0 || tree->num_points == 0)
+    return 0;
+  struct KdSubtree stack[KDTREE_STACK_CAPACITY];
+  unsigned int stack_size = 1;
+  stack[0] = (struct KdSubtree){0, tree->num_points, 0, 0, 0};
+  while (stack_size > 0) {
+    struct KdSubtree subtree = stack[--stack_size];
+    if (size == k && saturated_squared_distance(subtree.dx, subtree.dy)
+                     > neighbors[0].distance)
+      continue;
+    unsigned int middle = subtree.first + (subtree.end - subtree.first) / 2;
+    const struct KdPoint* point = tree->points + middle;
+    struct KdNeighbor neighbor = {
+      saturated_squared_distance(interval_gap(box->xmin, box->xmax, point->x),
+                                 interval_gap(box->ymin, box->ymax, point->y)),
+      point->index
+    };
+    offer_neighbor(neighbors, &size, k, &neighbor);
+    // The cells of the halves are the cell of the subtree cut by the median
+    long long split = kd_coordinate(point, subtree.axis),
+              min = subtree.axis == 0 ? box->xmin : box->ymin,
+              max = subtree.axis == 0 ? box->xmax : box->ymax;
+    uint64_t gap = subtree.axis == 0 ? subtree.dx : subtree.dy,
+             low_gap = min > split && (uint64_t)(min - split) > gap
+                     ? (uint64_t)(min - split) : gap,
+             high_gap = split > max && (uint64_t)(split - max) > gap
+                      ? (uint64_t)(split - max) : gap;
+    struct KdSubtree low = subtree, high = subtree;
+    low.end = middle;
+    high.first = middle + 1;
+    low.axis = high.axis = 1 - subtree.axis;
+    *(subtree.axis == 0 ? &low.dx : &low.dy) = low_gap;
+    *(subtree.axis == 0 ? &high.dx : &high.dy) = high_gap;
+    // The nearest half is pushed last, so that it is visited first
+    bool is_low_nearer = low_gap <= high_gap;
+    struct KdSubtree* halves[2] = {is_low_nearer ? &high : &low,
+                                   is_low_nearer ? &low : &high};
+    for (unsigned int h = 0; h < 2; ++h)
+      if (halves[h]->first < halves[h]->end)
+        stack[stack_size++] = *halves[h];
+  }
+  // The heap is sorted in place, by increasing distance
+  for (unsigned int end = size; end > 1; --end) {
+    struct KdNeighbor farthest = neighbors[0];
+    neighbors[0] = neighbors[end - 1];
+    neighbors[end - 1] = farthest;
+    sift_neighbor_down(neighbors, end - 1, 0);
+  }
+  return size;
+}
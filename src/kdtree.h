@@ -0,0 +1,86 @@
+#ifndef KDTREE_H_
+#define KDTREE_H_
+
+#include <stdint.h>
+
+#include "rtree.h"
+
+// Constants
+// ---------
+
+// The maximum number of subtrees waiting to be visited during a search
+#define KDTREE_STACK_CAPACITY 64
+
+// Types
+// -----
+
+// A point of a k-d tree
+struct KdPoint {
+  // The x coordinate
+  int x;
+  // The y coordinate
+  int y;
+  // The index of the object located at the point
+  unsigned int index;
+};
+
+// A static k-d tree over a set of points
+//
+// The tree is implicit: it is the array of points itself, permuted in place
+// so that the median point of each range, cut alternately along x and y,
+// lies in its middle. The points of the first half have a coordinate at most
+// the one of the median, and those of the second half at least.
+struct KdTree {
+  // The number of points
+  unsigned int num_points;
+  // The points, in tree order
+  struct KdPoint* points;
+};
+
+// A point found by a nearest neighbor search
+struct KdNeighbor {
+  // The squared distance from the searched box to the point
+  uint64_t distance;
+  // The index of the object located at the point
+  unsigned int index;
+};
+
+// Construction
+// ------------
+
+/**
+ * Builds a k-d tree over a set of points, in place
+ *
+ * It runs in O(n log n) expected time and allocates no memory.
+ *
+ * @param tree        The resulting tree
+ * @param points      The points, permuted in tree order
+ * @param num_points  The number of points
+ */
+void build_kdtree(struct KdTree* tree, struct KdPoint* points,
+                  unsigned int num_points);
+
+// Search
+// ------
+
+/**
+ * Finds the points of a k-d tree nearest to a box
+ *
+ * The distance from the box to a point is 0 if the box contains it, and the
+ * Euclidean distance to the nearest point of the box otherwise. Its square
+ * saturates at UINT64_MAX, which is only reached beyond 2^32. The subtrees
+ * whose cells lie farther from the box than the k-th point found so far are
+ * skipped.
+ *
+ * @param tree       The tree
+ * @param box        The searched box
+ * @param k          The number of points to find
+ * @param neighbors  The resulting points (k items), by increasing distance,
+ *                   then by increasing index
+ * @return           The number of points found, min(k, tree->num_points)
+ */
+unsigned int find_nearest_points(const struct KdTree* tree,
+                                 const struct RTreeBox* box, unsigned int k,
+                                 struct KdNeighbor* neighbors);
+
+#endif
@@ -0,0 +1,164 @@
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "generator.h"
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The largest number of clusters
+#define MAX_GENERATED_CLUSTERS 1000000
+
+// The help to display
+#define HELP "Usage: kover-gen [OPTION]...\n\
+Writes a valid scene generated pseudo-randomly on stdout.\n\
+\n\
+The buildings never overlap and the antennas never share a position, and\n\
+the same options always give the same scene. OPTION is any of:\n\
+  --antennas N: generates N antennas (default 500)\n\
+  --buildings N: generates N buildings (default 1000)\n\
+  --clusters N: gathers the objects in N clusters (default 16)\n\
+  --density D: fills D percent of the cells with buildings (default 50)\n\
+  --distribution uniform|clustered: spreads the objects uniformly or around\n\
+    the centers of the clusters (default uniform)\n\
+  --help: shows this message\n\
+  --output FILE: writes the scene in FILE instead of stdout\n\
+  --radius R: bounds the radius of the antennas (default 40)\n\
+  --seed S: seeds the pseudo-random generator (default 0)\n\
+  --size S: bounds the half sides of the buildings (default 10)\n"
+
+// Functions
+// ---------
+
+/**
+ * Parses the integer argument of an option
+ *
+ * @param argc     The number of arguments
+ * @param argv     The arguments
+ * @param i        The index of the option, moved to its argument
+ * @param minimum  The smallest value accepted
+ * @param maximum  The largest value accepted
+ * @param value    The value of the argument
+ * @param error    The error reported if the argument is missing or out of
+ *                 range
+ * @return         true if and only if the argument was parsed
+ */
+bool parse_bounded_option(int argc, char* argv[], int* i, int minimum,
+                          int maximum, int* value, struct Error* error) {
+  const char* option = argv[*i];
+  if (*i + 1 == argc)
+    return report_error_missing_option_argument(error, option);
+  const char* argument = argv[++*i];
+  return (parse_integer(argument, strlen(argument), value) &&
+          *value >= minimum && *value <= maximum) ||
+         report_error_invalid_option_argument(error, option, argument);
+}
+
+/**
+ * Parses the options of kover-gen
+ *
+ * @param argc         The number of arguments
+ * @param argv         The arguments
+ * @param options      The resulting parameters of the scene
+ * @param output_path  The path of the file to write (NULL to write stdout)
+ * @param is_help      true if the help must be shown
+ * @param error        The error reported if an option is invalid
+ * @return             true if and only if all the options were parsed
+ */
+bool parse_generator_options(int argc, char* argv[],
+                             struct GeneratorOptions* options,
+                             const char** output_path, bool* is_help,
+                             struct Error* error) {
+  initialize_generator_options(options);
+  *output_path = NULL;
+  *is_help = false;
+  for (int i = 1; i < argc; ++i) {
+    int value;
+    if (strcmp(argv[i], "--antennas") == 0) {
+      if (!parse_bounded_option(argc, argv, &i, 0, INT_MAX, &value, error))
+        return false;
+      options->num_antennas = value;
+    } else if (strcmp(argv[i], "--buildings") == 0) {
+      if (!parse_bounded_option(argc, argv, &i, 0, INT_MAX, &value, error))
+        return false;
+      options->num_buildings = value;
+    } else if (strcmp(argv[i], "--clusters") == 0) {
+      if (!parse_bounded_option(argc, argv, &i, 1, MAX_GENERATED_CLUSTERS,
+                                &value, error))
+        return false;
+      options->num_clusters = value;
+    } else if (strcmp(argv[i], "--density") == 0) {
+      if (!parse_bounded_option(argc, argv, &i, 1, 100, &options->density,
+                                error))
+        return false;
+    } else if (strcmp(argv[i], "--distribution") == 0) {
+      if (i + 1 == argc)
+        return report_error_missing_option_argument(error, argv[i]);
+      ++i;
+      if (strcmp(argv[i], "uniform") == 0)
+        options->distribution = DISTRIBUTION_UNIFORM;
+      else if (strcmp(argv[i], "clustered") == 0)
+        options->distribution = DISTRIBUTION_CLUSTERED;
+      else
+        return report_error_invalid_option_argument(error, argv[i - 1],
+                                                    argv[i]);
+    } else if (strcmp(argv[i], "--help") == 0) {
+      *is_help = true;
+    } else if (strcmp(argv[i], "--output") == 0) {
+      if (i + 1 == argc)
+        return report_error_missing_option_argument(error, argv[i]);
+      *output_path = argv[++i];
+    } else if (strcmp(argv[i], "--radius") == 0) {
+      if (!parse_bounded_option(argc, argv, &i, 1, INT_MAX,
+                                &options->max_radius, error))
+        return false;
+    } else if (strcmp(argv[i], "--seed") == 0) {
+      if (!parse_bounded_option(argc, argv, &i, 0, INT_MAX, &value, error))
+        return false;
+      options->seed = value;
+    } else if (strcmp(argv[i], "--size") == 0) {
+      if (!parse_bounded_option(argc, argv, &i, 1, INT_MAX / 2,
+                                &options->max_size, error))
+        return false;
+    } else {
+      return report_error_unrecognized_option(error, argv[i]);
+    }
+  }
+  return true;
+}
+
+/**
+ * Generates a scene
+ *
+ * @param argc  The number of arguments
+ * @param argv  The arguments
+ * @return      0 if the scene was written, 1 otherwise
+ */
+int main(int argc, char* argv[]) {
+  struct GeneratorOptions options;
+  const char* output_path;
+  bool is_help, success;
+  struct Error error;
+  success = parse_generator_options(argc, argv, &options, &output_path,
+                                    &is_help, &error);
+  if (success && is_help) {
+    printf(HELP);
+  } else if (success) {
+    FILE* file = output_path == NULL ? stdout : fopen(output_path, "w");
+    if (file == NULL) {
+      success = report_error_cannot_write_file(&error, output_path);
+    } else {
+      success = generate_scene(&options, file, &error);
+      if (file != stdout && fclose(file) != 0 && success)
+        success = report_error_cannot_write_file(&error, output_path);
+    }
+  }
+  if (fflush(stdout) != 0 && success)
+    success = report_error_cannot_write_file(&error, "stdout");
+  if (!success)
+    print_error(&error, stderr);
+  return success ? 0 : 1;
+}
@@ -5,21 +5,110 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "arena.h"
+#include "area.h"
+#include "binary.h"
+#include "cache.h"
+#include "coverage.h"
+#include "edit.h"
+#include "input.h"
+#include "nearest.h"
+#include "placement.h"
+#include "pool.h"
+#include "query.h"
+#include "render.h"
 #include "scene.h"
+#include "server.h"
+#include "stats.h"
 #include "validation.h"
 
 // Constants
 // ---------
 
+// The number of files of a batch window per thread
+#define BATCH_WINDOW_PER_THREAD 16
+// The initial capacity of the list of files of a batch
+#define INITIAL_BATCH_CAPACITY 64
+// The default memory budget of the scenes cached by serve, in MB
+#define DEFAULT_CACHE_MEMORY 256
+// The default number of antennas listed by nearest for each building
+#define DEFAULT_NUM_NEAREST 1
+// The maximum number of arguments of a request sent to serve
+#define MAX_REQUEST_ARGUMENTS 32
+
 // The help to display
 #define HELP "Usage: kover SUBCOMMAND\n\
 Handles positioning of communication antennas by reading a scene on stdin.\n\
 \n\
 SUBCOMMAND is mandatory and must take one of the following values:\n\
+  apply: writes the loaded scene edited by the delta given with --delta\n\
+  batch: runs the subcommand that follows on each scene file given after\n\
+    the options, or listed one per line on stdin\n\
   bounding-box: returns a bounding box of the loaded scene\n\
+  client: sends the subcommand that follows to a server started by serve\n\
+  coverage: lists the antennas covering each building of the loaded scene\n\
   describe: describes the loaded scene in details\n\
   help: shows this message\n\
+  nearest: lists the antennas nearest to each building of the loaded scene\n\
+  pack: writes the loaded scene in the binary format\n\
+  place: writes the loaded buildings with antennas covering all of them\n\
+  query: answers the queries read from the file given with --queries, or\n\
+    from stdin, on the loaded scene\n\
+  render: writes a coverage map of the loaded scene as a PGM image\n\
+  serve: answers the requests of clients on a Unix domain socket\n\
   summarize: summarizes the loaded scene\n\
+  unpack: writes the loaded scene in the text format\n\
+\n\
+The subcommands accept the following options, and reject the ones they do\n\
+not use:\n\
+  --delta FILE: reads the edits of apply from FILE\n\
+  --exact: prints the fraction of each building covered with coverage\n\
+  --input FILE: reads the scene from FILE instead of stdin\n\
+  --k K: sets the number of antennas listed by nearest (default 1)\n\
+  --memory M: caps the memory of the scenes cached by serve (default 256 MB)\n\
+  --no-validate: skips the validation of summarize and bounding-box\n\
+  --output FILE: writes the result of apply, pack or render in FILE, not\n\
+    stdout\n\
+  --queries FILE: reads the queries of query from FILE instead of stdin\n\
+  --radius R: sets the radius of the antennas placed by place (default 10)\n\
+  --resolution R: sets the size of the longest side of the map of render,\n\
+    in pixels (default 1024, at most 65536)\n\
+  --socket PATH: sets the socket of serve and client\n\
+  --stats: prints the time and memory used by each phase on stderr\n\
+  --stats-json: prints the same measures on stderr as JSON\n\
+  --step S: sets the spacing of the sites considered by place (default 5)\n\
+  --threads N: runs the validation and the coverage on N threads (default 1)\n\
+\n\
+The batch subcommand runs bounding-box, coverage, describe, nearest, place,\n\
+summarize or unpack on N files at a time with --threads N. The result of each\n\
+file is printed on stdout after a line '==> FILE <==', in the order of the\n\
+files, and an invalid file prints its error instead without stopping the\n\
+batch.\n\
+\n\
+The serve subcommand keeps the scenes it receives, validated, in memory until\n\
+it is interrupted, and answers bounding-box, coverage, describe and summarize\n\
+sent by client for the same content without loading it again. It rejects the\n\
+scenes larger than its memory budget.\n\
+\n\
+The apply subcommand writes the edited scene in the format of the loaded one.\n\
+The delta has one edit per line, among 'add building ID X Y W H',\n\
+'add antenna ID X Y R', 'remove building ID', 'remove antenna ID',\n\
+'move building ID X Y' and 'move antenna ID X Y'. Each edit only checks the\n\
+objects near the edited one, and the first invalid edit stops apply.\n\
+\n\
+The query subcommand reads one query per line, among 'antennas X Y' (the\n\
+antennas whose disc contains the point), 'buildings X Y' (the buildings\n\
+containing the point) and 'window X1 Y1 X2 Y2' (the buildings and antenna\n\
+discs meeting the window of corners X1 Y1 and X2 Y2), and prints the\n\
+identifiers found by each query on one line, in the order of the queries.\n\
+\n\
+The render subcommand maps the bounding box of the scene to a grayscale image\n\
+with square pixels. A pixel whose center lies in a building has gray level\n\
+135 (0 otherwise), plus 8 for each antenna whose disc contains its center,\n\
+up to 15 antennas.\n\
+\n\
+The scene is either a text scene or a binary scene written by pack, which is\n\
+recognized automatically. A binary scene is not validated again.\n\
 \n\
 A scene is a text stream that must satisfy the following syntax:\n\
 \n\
@@ -41,46 +130,1327 @@ A scene is a text stream that must satisfy the following syntax:\n\
        Y is the y-coordinate of the antenna\n\
        R is the radius scope of the antenna\n"
 
+
+// Types
+// -----
+
+// The options accepted by the subcommands, one bit each, in the order of
+// OPTION_NAMES
+enum OptionFlag {
+  OPTION_DELTA = 1 << 0,
+  OPTION_EXACT = 1 << 1,
+  OPTION_INPUT = 1 << 2,
+  OPTION_K = 1 << 3,
+  OPTION_MEMORY = 1 << 4,
+  OPTION_NO_VALIDATE = 1 << 5,
+  OPTION_OUTPUT = 1 << 6,
+  OPTION_QUERIES = 1 << 7,
+  OPTION_RADIUS = 1 << 8,
+  OPTION_RESOLUTION = 1 << 9,
+  OPTION_SOCKET = 1 << 10,
+  OPTION_STATS = 1 << 11,
+  OPTION_STATS_JSON = 1 << 12,
+  OPTION_STEP = 1 << 13,
+  OPTION_THREADS = 1 << 14,
+  // The options accepted by all the subcommands reading a scene
+  OPTIONS_SCENE = OPTION_INPUT | OPTION_STATS | OPTION_STATS_JSON |
+                  OPTION_THREADS
+};
+
+// The options of a subcommand
+struct Options {
+  // The path of the file containing the scene (NULL to read stdin)
+  const char* input_path;
+  // The path of the file to write (NULL to write stdout)
+  const char* output_path;
+  // The path of the delta read by apply (NULL if none)
+  const char* delta_path;
+  // The path of the queries read by query (NULL to read stdin)
+  const char* queries_path;
+  // The number of threads
+  unsigned int num_threads;
+  // true if coverage must compute the exact covered fractions
+  bool is_exact;
+  // false if summarize and bounding-box must not validate the scene
+  bool is_validating;
+  // The number of antennas listed by nearest for each building
+  int num_nearest;
+  // The radius of the antennas placed by place
+  int radius;
+  // The number of pixels along the longest side of the map of render
+  int resolution;
+  // The spacing of the candidate sites of place
+  int step;
+  // The path of the socket of serve and client (NULL if none)
+  const char* socket_path;
+  // The memory budget of the scenes cached by serve, in MB
+  int memory;
+  // true if the phases of the subcommand must be measured
+  bool is_measured;
+  // true if the measures must be printed as JSON
+  bool is_json_stats;
+  // The measures of the subcommand (NULL if it is not measured)
+  struct RunStats* stats;
+};
+
+// A function running a subcommand
+//
+// The result is printed on the given file. If the subcommand fails, the
+// error is recorded and false is returned.
+typedef bool (*SubcommandFunction)(const struct Options* options,
+                                   struct ThreadPool* pool, FILE* file,
+                                   struct Error* error);
+
+// A function answering a subcommand sent to serve on a cached scene
+typedef bool (*ServeFunction)(struct SceneCache* cache,
+                              struct CachedScene* entry,
+                              const struct Options* options,
+                              struct ThreadPool* pool, FILE* file,
+                              struct Error* error);
+
+// A subcommand
+struct Subcommand {
+  // The name of the subcommand
+  const char* name;
+  // The function running the subcommand
+  SubcommandFunction run;
+  // true if the subcommand can be run by batch
+  bool is_batchable;
+  // The function answering the subcommand in serve (NULL if none)
+  ServeFunction serve;
+  // The options accepted by the subcommand (a combination of OptionFlag)
+  unsigned int options;
+};
+
+// The scene files of a batch
+struct BatchFiles {
+  // The paths of the files
+  const char** paths;
+  // The number of files
+  unsigned int num_files;
+  // The capacity of paths
+  unsigned int capacity;
+  // The arena holding the paths
+  struct Arena arena;
+};
+
+// A scene file processed by a batch
+struct BatchTask {
+  // The path of the file
+  const char* path;
+  // The result printed by the subcommand (allocated with malloc)
+  char* output;
+  // The size of the result
+  size_t output_size;
+  // true if the subcommand succeeded
+  bool success;
+  // The error of the subcommand if it failed
+  struct Error error;
+};
+
+// A window of scene files processed in parallel by a batch
+struct BatchJob {
+  // The subcommand run on each file
+  const struct Subcommand* subcommand;
+  // The options of the subcommand
+  const struct Options* options;
+  // The single-threaded pools of the workers, one per worker
+  struct ThreadPool* pools;
+  // The files of the window
+  struct BatchTask* tasks;
+};
+
+// The state of serve shared by the requests
+struct ServeContext {
+  // The cached scenes
+  struct SceneCache cache;
+  // The thread pool
+  struct ThreadPool* pool;
+};
+
+// Batch files
+// -----------
+
+/**
+ * Initializes an empty list of batch files
+ *
+ * @param files  The list to initialize
+ */
+void initialize_batch_files(struct BatchFiles* files) {
+  files->paths = NULL;
+  files->num_files = 0;
+  files->capacity = 0;
+  initialize_arena(&files->arena);
+}
+
+/**
+ * Appends a copy of a path to a list of batch files
+ *
+ * @param files   The list
+ * @param path    The path (not necessarily null-terminated)
+ * @param length  The length of the path
+ */
+void add_batch_file(struct BatchFiles* files, const char* path,
+                    size_t length) {
+  if (files->num_files == files->capacity) {
+    unsigned int capacity = files->capacity == 0
+                          ? INITIAL_BATCH_CAPACITY : 2 * files->capacity;
+    files->paths = arena_grow(&files->arena, files->paths,
+                              files->capacity * sizeof(const char*),
+                              capacity * sizeof(const char*));
+    files->capacity = capacity;
+  }
+  char* copy = arena_allocate(&files->arena, length + 1);
+  memcpy(copy, path, length);
+  copy[length] = '\0';
+  files->paths[files->num_files++] = copy;
+}
+
+/**
+ * Appends the paths listed on stdin, one per line, to a list of batch files
+ *
+ * Empty lines are skipped.
+ *
+ * @param files  The list
+ * @param error  The error reported if stdin cannot be read
+ * @return       true if and only if stdin was read entirely
+ */
+bool read_batch_files(struct BatchFiles* files, struct Error* error) {
+  struct LineReader reader;
+  if (!open_line_reader(&reader, NULL, error))
+    return false;
+  struct StringView line;
+  while (read_next_line(&reader, &line))
+    if (line.length > 0)
+      add_batch_file(files, line.start, line.length);
+  bool success = !reader.has_failed ||
+                 report_error_cannot_read_file(error, reader.name);
+  close_line_reader(&reader);
+  return success;
+}
+
+// Options processing
+// ------------------
+
+// The names of the options, in the order of their flags
+const char* const OPTION_NAMES[] = {
+  "--delta", "--exact", "--input", "--k", "--memory", "--no-validate",
+  "--output", "--queries", "--radius", "--resolution", "--socket", "--stats",
+  "--stats-json", "--step", "--threads"
+};
+
+/**
+ * Returns the flag of an option
+ *
+ * @param name  The name of the option
+ * @return      The flag of the option, or 0 if it is not recognized
+ */
+unsigned int find_option_flag(const char* name) {
+  unsigned int num_options = sizeof(OPTION_NAMES) / sizeof(OPTION_NAMES[0]);
+  for (unsigned int o = 0; o < num_options; ++o)
+    if (strcmp(OPTION_NAMES[o], name) == 0)
+      return 1u << o;
+  return 0;
+}
+
+/**
+ * Parses the positive integer argument of an option
+ *
+ * @param argc   The number of arguments
+ * @param argv   The arguments
+ * @param i      The index of the option, moved to its argument
+ * @param value  The value of the argument
+ * @param error  The error reported if the argument is missing or is not a
+ *               positive integer
+ * @return       true if and only if the argument was parsed
+ */
+bool parse_positive_option(int argc, char* argv[], int* i, int* value,
+                           struct Error* error) {
+  const char* option = argv[*i];
+  if (*i + 1 == argc)
+    return report_error_missing_option_argument(error, option);
+  const char* argument = argv[++*i];
+  return parse_positive_integer(argument, strlen(argument), value) ||
+         report_error_invalid_option_argument(error, option, argument);
+}
+
+/**
+ * Parses the options following the subcommand
+ *
+ * The arguments that are not options are the files of a batch, and are only
+ * accepted if a list of batch files is given.
+ *
+ * @param argc        The number of arguments
+ * @param argv        The arguments
+ * @param first       The index of the first option
+ * @param subcommand  The name of the subcommand
+ * @param allowed     The options accepted by the subcommand (a combination of
+ *                    OptionFlag)
+ * @param options     The resulting options
+ * @param files       The list receiving the batch files (NULL if none)
+ * @param error       The error reported if an option is unrecognized,
+ *                    incomplete or not accepted by the subcommand
+ * @return            true if and only if all the options were parsed
+ */
+bool parse_options(int argc, char* argv[], int first, const char* subcommand,
+                   unsigned int allowed, struct Options* options,
+                   struct BatchFiles* files, struct Error* error) {
+  options->input_path = NULL;
+  options->output_path = NULL;
+  options->num_threads = 1;
+  options->is_exact = false;
+  options->is_validating = true;
+  options->num_nearest = DEFAULT_NUM_NEAREST;
+  options->radius = DEFAULT_PLACEMENT_RADIUS;
+  options->resolution = DEFAULT_RENDER_RESOLUTION;
+  options->step = DEFAULT_PLACEMENT_STEP;
+  options->socket_path = NULL;
+  options->delta_path = NULL;
+  options->queries_path = NULL;
+  options->memory = DEFAULT_CACHE_MEMORY;
+  options->is_measured = false;
+  options->is_json_stats = false;
+  options->stats = NULL;
+  for (int i = first; i < argc; ++i) {
+    unsigned int flag = find_option_flag(argv[i]);
+    if (flag != 0 && (allowed & flag) == 0)
+      return report_error_unsupported_option(error, argv[i], subcommand);
+    if (strcmp(argv[i], "--delta") == 0) {
+      if (i + 1 == argc)
+        return report_error_missing_option_argument(error, argv[i]);
+      options->delta_path = argv[++i];
+    } else if (strcmp(argv[i], "--exact") == 0) {
+      options->is_exact = true;
+    } else if (strcmp(argv[i], "--input") == 0) {
+      if (i + 1 == argc)
+        return report_error_missing_option_argument(error, argv[i]);
+      options->input_path = argv[++i];
+    } else if (strcmp(argv[i], "--k") == 0) {
+      if (!parse_positive_option(argc, argv, &i, &options->num_nearest, error))
+        return false;
+    } else if (strcmp(argv[i], "--memory") == 0) {
+      if (!parse_positive_option(argc, argv, &i, &options->memory, error))
+        return false;
+    } else if (strcmp(argv[i], "--no-validate") == 0) {
+      options->is_validating = false;
+    } else if (strcmp(argv[i], "--output") == 0) {
+      if (i + 1 == argc)
+        return report_error_missing_option_argument(error, argv[i]);
+      options->output_path = argv[++i];
+    } else if (strcmp(argv[i], "--queries") == 0) {
+      if (i + 1 == argc)
+        return report_error_missing_option_argument(error, argv[i]);
+      options->queries_path = argv[++i];
+    } else if (strcmp(argv[i], "--radius") == 0) {
+      if (!parse_positive_option(argc, argv, &i, &options->radius, error))
+        return false;
+    } else if (strcmp(argv[i], "--resolution") == 0) {
+      if (!parse_positive_option(argc, argv, &i, &options->resolution, error))
+        return false;
+      if (options->resolution > MAX_RENDER_RESOLUTION)
+        return report_error_invalid_option_argument(error, argv[i - 1],
+                                                    argv[i]);
+    } else if (strcmp(argv[i], "--socket") == 0) {
+      if (i + 1 == argc)
+        return report_error_missing_option_argument(error, argv[i]);
+      options->socket_path = argv[++i];
+    } else if (strcmp(argv[i], "--stats") == 0) {
+      options->is_measured = true;
+    } else if (strcmp(argv[i], "--stats-json") == 0) {
+      options->is_measured = true;
+      options->is_json_stats = true;
+    } else if (strcmp(argv[i], "--step") == 0) {
+      if (!parse_positive_option(argc, argv, &i, &options->step, error))
+        return false;
+    } else if (strcmp(argv[i], "--threads") == 0) {
+      int num_threads;
+      if (!parse_positive_option(argc, argv, &i, &num_threads, error))
+        return false;
+      if (num_threads > MAX_NUM_THREADS)
+        return report_error_invalid_option_argument(error, argv[i - 1],
+                                                    argv[i]);
+      options->num_threads = num_threads;
+    } else if (files != NULL && strncmp(argv[i], "--", 2) != 0) {
+      add_batch_file(files, argv[i], strlen(argv[i]));
+    } else {
+      return report_error_unrecognized_option(error, argv[i]);
+    }
+  }
+  return true;
+}
+
+/**
+ * Charges a phase of the subcommand with the resources used since the
+ * previous one, if it is measured
+ *
+ * @param options  The options
+ * @param phase    The phase
+ */
+void record_options_phase(const struct Options* options,
+                          enum StatsPhase phase) {
+  if (options->stats != NULL)
+    record_stats_phase(options->stats, phase);
+}
+
+/**
+ * Opens the input designated by the options
+ *
+ * @param options  The options
+ * @param input    The resulting input, to be closed with close_input
+ * @param error    The error reported if the input cannot be read
+ * @return         true if and only if the input was opened
+ */
+bool open_options_input(const struct Options* options, struct Input* input,
+                        struct Error* error) {
+  return options->input_path == NULL
+         ? open_stdin_input(input, error)
+         : open_file_input(input, options->input_path, error);
+}
+
+/**
+ * Loads the scene designated by the options
+ *
+ * @param options    The options
+ * @param pool       The thread pool
+ * @param is_binary  Set to true if and only if the scene is a binary scene
+ * @param error      The error reported if the scene cannot be read or is
+ *                   malformed
+ * @return           The scene, to be deleted with delete_scene, or NULL
+ */
+struct Scene* load_options_scene(const struct Options* options,
+                                 struct ThreadPool* pool, bool* is_binary,
+                                 struct Error* error) {
+  struct Input input;
+  if (!open_options_input(options, &input, error))
+    return NULL;
+  record_options_phase(options, PHASE_READ);
+  *is_binary = is_binary_input(&input);
+  struct Scene* scene = create_scene();
+  scene->stats = options->stats;
+  bool success = load_scene_in_parallel(scene, &input, pool, error);
+  close_input(&input);
+  if (success)
+    return scene;
+  delete_scene(scene);
+  return NULL;
+}
+
+/**
+ * Loads and validates the scene designated by the options
+ *
+ * @param options  The options
+ * @param pool     The thread pool
+ * @param error    The error reported if the scene cannot be read or is
+ *                 invalid
+ * @return         The scene, to be deleted with delete_scene, or NULL
+ */
+struct Scene* load_validated_scene(const struct Options* options,
+                                   struct ThreadPool* pool,
+                                   struct Error* error) {
+  bool is_binary;
+  struct Scene* scene = load_options_scene(options, pool, &is_binary, error);
+  if (scene == NULL || scene->is_validated ||
+      validate_scene(scene, pool, error))
+    return scene;
+  delete_scene(scene);
+  return NULL;
+}
+
+/**
+ * Opens the output designated by the options
+ *
+ * @param options  The options
+ * @param file     The file to write without --output
+ * @param error    The error reported if the output cannot be opened
+ * @return         The output, or NULL if it cannot be opened
+ */
+FILE* open_options_output(const struct Options* options, FILE* file,
+                          struct Error* error) {
+  FILE* output = options->output_path == NULL
+               ? file : fopen(options->output_path, "wb");
+  if (output == NULL)
+    report_error_cannot_write_file(error, options->output_path);
+  return output;
+}
+
+/**
+ * Closes the output designated by the options
+ *
+ * @param options  The options
+ * @param output   The output opened by open_options_output
+ * @param file     The file to write without --output
+ * @param error    The error reported if the output cannot be written
+ * @return         true if and only if the output was written
+ */
+bool close_options_output(const struct Options* options, FILE* output,
+                          FILE* file, struct Error* error) {
+  return output == file || fclose(output) == 0 ||
+         report_error_cannot_write_file(error, options->output_path);
+}
+
+/**
+ * Writes a scene on the output designated by the options
+ *
+ * @param options    The options
+ * @param scene      The scene
+ * @param is_binary  true to write the binary format, false for the text one
+ * @param file       The file on which the scene is written without --output
+ * @param error      The error reported if the output cannot be written
+ * @return           true if and only if the scene was written
+ */
+bool write_options_scene(const struct Options* options,
+                         const struct Scene* scene, bool is_binary,
+                         FILE* file, struct Error* error) {
+  FILE* output = open_options_output(options, file, error);
+  if (output == NULL)
+    return false;
+  if (is_binary)
+    write_binary_scene(scene, true, output);
+  else
+    print_scene(scene, output);
+  return close_options_output(options, output, file, error);
+}
+
+/**
+ * Computes the aggregates of the scene designated by the options
+ *
+ * A text scene is streamed line by line, so that it is never held in
+ * memory, and a binary scene is loaded.
+ *
+ * @param options     The options
+ * @param pool        The thread pool
+ * @param aggregates  The resulting aggregates
+ * @param error       The error reported if the scene cannot be read or is
+ *                    invalid
+ * @return            true if and only if the aggregates were computed
+ */
+bool stream_scene_aggregates(const struct Options* options,
+                             struct ThreadPool* pool,
+                             struct SceneAggregates* aggregates,
+                             struct Error* error) {
+  struct LineReader reader;
+  if (!open_line_reader(&reader, options->input_path, error))
+    return false;
+  bool success;
+  if (line_reader_starts_with(&reader, BINARY_MAGIC, BINARY_MAGIC_LENGTH)) {
+    struct Input input;
+    success = read_remaining_input(&reader, &input, error);
+    record_options_phase(options, PHASE_READ);
+    if (success) {
+      struct Scene* scene = create_scene();
+      scene->stats = options->stats;
+      success = load_scene(scene, &input, error);
+      close_input(&input);
+      if (success && options->is_validating && !scene->is_validated)
+        success = validate_scene(scene, pool, error);
+      if (success)
+        compute_scene_aggregates(scene, aggregates);
+      delete_scene(scene);
+    }
+  } else {
+    success = stream_scene(&reader, options->is_validating, aggregates,
+                           error);
+    // The scene is read, tokenized and validated in a single pass
+    if (options->stats != NULL) {
+      options->stats->num_lines += reader.num_lines;
+      options->stats->num_bytes += reader.num_bytes;
+    }
+    record_options_phase(options, PHASE_TOKENIZE);
+  }
+  close_line_reader(&reader);
+  return success;
+}
+
 // Subcommands processing
 // ----------------------
 
+/**
+ * Runs the apply subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the scene is written without --output
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
+ */
+bool run_apply_subcommand(const struct Options* options,
+                          struct ThreadPool* pool, FILE* file,
+                          struct Error* error) {
+  if (options->delta_path == NULL)
+    return report_error_mandatory_option(error, "--delta");
+  bool is_binary;
+  struct Scene* scene = load_options_scene(options, pool, &is_binary, error);
+  if (scene == NULL)
+    return false;
+  struct SceneEditor editor;
+  struct Input delta;
+  bool success = initialize_scene_editor(&editor, scene, pool, error);
+  if (success) {
+    success = open_file_input(&delta, options->delta_path, error);
+    if (success) {
+      success = apply_scene_delta(&editor, &delta, error);
+      close_input(&delta);
+    }
+    if (success)
+      write_edited_scene(&editor);
+    free_scene_editor(&editor);
+    record_options_phase(options, PHASE_PROCESS);
+  }
+  if (success)
+    success = write_options_scene(options, scene, is_binary, file, error);
+  delete_scene(scene);
+  return success;
+}
+
 /**
  * Runs the bounding-box subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
  */
-void run_bounding_box_subcommand(void) {
-  struct Scene scene;
-  load_scene_from_stdin(&scene);
-  validate_scene(&scene);
-  print_scene_bounding_box(&scene);
+bool run_bounding_box_subcommand(const struct Options* options,
+                                 struct ThreadPool* pool, FILE* file,
+                                 struct Error* error) {
+  struct SceneAggregates aggregates;
+  if (!stream_scene_aggregates(options, pool, &aggregates, error))
+    return false;
+  print_aggregates_bounding_box(&aggregates, file);
+  return true;
+}
+
+/**
+ * Runs the coverage subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
+ */
+bool run_coverage_subcommand(const struct Options* options,
+                             struct ThreadPool* pool, FILE* file,
+                             struct Error* error) {
+  struct Scene* scene = load_validated_scene(options, pool, error);
+  if (scene == NULL)
+    return false;
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct SceneCoverage coverage;
+  compute_scene_coverage(scene, &coverage, pool, &arena);
+  if (options->is_exact) {
+    double* fractions =
+      arena_allocate(&arena, scene->num_buildings * sizeof(double));
+    compute_covered_fractions(scene, &coverage, fractions, pool);
+    record_options_phase(options, PHASE_PROCESS);
+    print_covered_fractions(scene, fractions, file);
+  } else {
+    record_options_phase(options, PHASE_PROCESS);
+    print_scene_coverage(scene, &coverage, file);
+  }
+  free_arena(&arena);
+  delete_scene(scene);
+  return true;
 }
 
 /**
  * Runs the describe subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
  */
-void run_describe_subcommand(void) {
-  struct Scene scene;
-  load_scene_from_stdin(&scene);
-  validate_scene(&scene);
-  print_scene_summary(&scene);
-  print_scene_buildings(&scene);
-  print_scene_antennas(&scene);
+bool run_describe_subcommand(const struct Options* options,
+                             struct ThreadPool* pool, FILE* file,
+                             struct Error* error) {
+  struct Scene* scene = load_validated_scene(options, pool, error);
+  if (scene == NULL)
+    return false;
+  print_scene_summary(scene, file);
+  print_scene_buildings(scene, file);
+  print_scene_antennas(scene, file);
+  delete_scene(scene);
+  return true;
 }
 
 /**
  * Runs the help subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the help is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true
  */
-void run_help_subcommand(void) {
-  printf("%s", HELP);
+bool run_help_subcommand(const struct Options* options,
+                         struct ThreadPool* pool, FILE* file,
+                         struct Error* error) {
+  (void)options;
+  (void)pool;
+  (void)error;
+  fputs(HELP, file);
+  return true;
+}
+
+/**
+ * Runs the nearest subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
+ */
+bool run_nearest_subcommand(const struct Options* options,
+                            struct ThreadPool* pool, FILE* file,
+                            struct Error* error) {
+  struct Scene* scene = load_validated_scene(options, pool, error);
+  if (scene == NULL)
+    return false;
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct SceneNearest nearest;
+  compute_scene_nearest(scene, options->num_nearest, &nearest, pool, &arena);
+  record_options_phase(options, PHASE_PROCESS);
+  print_scene_nearest(scene, &nearest, file);
+  free_arena(&arena);
+  delete_scene(scene);
+  return true;
+}
+
+/**
+ * Runs the pack subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the scene is written without --output
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
+ */
+bool run_pack_subcommand(const struct Options* options,
+                         struct ThreadPool* pool, FILE* file,
+                         struct Error* error) {
+  struct Scene* scene = load_validated_scene(options, pool, error);
+  if (scene == NULL)
+    return false;
+  bool success = write_options_scene(options, scene, true, file, error);
+  delete_scene(scene);
+  return success;
+}
+
+/**
+ * Runs the place subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
+ */
+bool run_place_subcommand(const struct Options* options,
+                          struct ThreadPool* pool, FILE* file,
+                          struct Error* error) {
+  struct Scene* scene = load_validated_scene(options, pool, error);
+  if (scene == NULL)
+    return false;
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct Antenna* antennas;
+  unsigned int num_antennas;
+  bool success = place_antennas(scene, options->step, options->radius,
+                                &antennas, &num_antennas, &arena, error);
+  record_options_phase(options, PHASE_PROCESS);
+  if (success) {
+    scene->num_antennas = 0;
+    reserve_scene(scene, scene->num_buildings, num_antennas);
+    memcpy(scene->antennas, antennas,
+           num_antennas * sizeof(struct Antenna));
+    scene->num_antennas = num_antennas;
+    print_scene(scene, file);
+  }
+  free_arena(&arena);
+  delete_scene(scene);
+  return success;
+}
+
+/**
+ * Runs the query subcommand
+ *
+ * The scene and the queries cannot both be read from stdin.
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the answers are printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
+ */
+bool run_query_subcommand(const struct Options* options,
+                          struct ThreadPool* pool, FILE* file,
+                          struct Error* error) {
+  if (options->input_path == NULL && options->queries_path == NULL)
+    return report_error_mandatory_option(error, "--input");
+  struct Scene* scene = load_validated_scene(options, pool, error);
+  if (scene == NULL)
+    return false;
+  struct LineReader reader;
+  bool success = open_line_reader(&reader, options->queries_path, error);
+  if (success) {
+    struct Arena arena;
+    initialize_arena(&arena);
+    struct SceneIndex index;
+    build_scene_index(&index, scene, &arena);
+    success = answer_scene_queries(&index, &reader, file, error);
+    record_options_phase(options, PHASE_PROCESS);
+    free_arena(&arena);
+    close_line_reader(&reader);
+  }
+  delete_scene(scene);
+  return success;
+}
+
+/**
+ * Runs the render subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the image is written without --output
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
+ */
+bool run_render_subcommand(const struct Options* options,
+                           struct ThreadPool* pool, FILE* file,
+                           struct Error* error) {
+  struct Scene* scene = load_validated_scene(options, pool, error);
+  if (scene == NULL)
+    return false;
+  FILE* output = open_options_output(options, file, error);
+  bool success = output != NULL;
+  if (success) {
+    struct Arena arena;
+    initialize_arena(&arena);
+    struct SceneIndex index;
+    build_scene_index(&index, scene, &arena);
+    struct RenderFrame frame;
+    compute_render_frame(scene, options->resolution, &frame);
+    render_scene(&index, &frame, pool, output);
+    record_options_phase(options, PHASE_PROCESS);
+    free_arena(&arena);
+    success = close_options_output(options, output, file, error);
+  }
+  delete_scene(scene);
+  return success;
 }
 
 /**
  * Runs the summarize subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
+ */
+bool run_summarize_subcommand(const struct Options* options,
+                              struct ThreadPool* pool, FILE* file,
+                              struct Error* error) {
+  struct SceneAggregates aggregates;
+  if (!stream_scene_aggregates(options, pool, &aggregates, error))
+    return false;
+  print_aggregates_summary(&aggregates, file);
+  return true;
+}
+
+/**
+ * Runs the unpack subcommand
+ *
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true if and only if the subcommand succeeded
+ */
+bool run_unpack_subcommand(const struct Options* options,
+                           struct ThreadPool* pool, FILE* file,
+                           struct Error* error) {
+  struct Scene* scene = load_validated_scene(options, pool, error);
+  if (scene == NULL)
+    return false;
+  print_scene(scene, file);
+  delete_scene(scene);
+  return true;
+}
+
+// Served subcommands processing
+// -----------------------------
+
+/**
+ * Answers the bounding-box subcommand on a cached scene
+ *
+ * @param cache    The cache
+ * @param entry    The cached scene
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true
+ */
+bool serve_bounding_box_subcommand(struct SceneCache* cache,
+                                   struct CachedScene* entry,
+                                   const struct Options* options,
+                                   struct ThreadPool* pool, FILE* file,
+                                   struct Error* error) {
+  (void)cache;
+  (void)options;
+  (void)pool;
+  (void)error;
+  print_aggregates_bounding_box(&entry->aggregates, file);
+  return true;
+}
+
+/**
+ * Answers the coverage subcommand on a cached scene
+ *
+ * @param cache    The cache
+ * @param entry    The cached scene
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true
+ */
+bool serve_coverage_subcommand(struct SceneCache* cache,
+                               struct CachedScene* entry,
+                               const struct Options* options,
+                               struct ThreadPool* pool, FILE* file,
+                               struct Error* error) {
+  (void)error;
+  if (options->is_exact)
+    print_covered_fractions(entry->scene,
+                            get_cached_fractions(cache, entry, pool), file);
+  else
+    print_scene_coverage(entry->scene,
+                         get_cached_coverage(cache, entry, pool), file);
+  return true;
+}
+
+/**
+ * Answers the describe subcommand on a cached scene
+ *
+ * @param cache    The cache
+ * @param entry    The cached scene
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true
+ */
+bool serve_describe_subcommand(struct SceneCache* cache,
+                               struct CachedScene* entry,
+                               const struct Options* options,
+                               struct ThreadPool* pool, FILE* file,
+                               struct Error* error) {
+  (void)cache;
+  (void)options;
+  (void)pool;
+  (void)error;
+  print_scene_summary(entry->scene, file);
+  print_scene_buildings(entry->scene, file);
+  print_scene_antennas(entry->scene, file);
+  return true;
+}
+
+/**
+ * Answers the summarize subcommand on a cached scene
+ *
+ * @param cache    The cache
+ * @param entry    The cached scene
+ * @param options  The options of the subcommand
+ * @param pool     The thread pool
+ * @param file     The file on which the result is printed
+ * @param error    The error reported if the subcommand fails
+ * @return         true
+ */
+bool serve_summarize_subcommand(struct SceneCache* cache,
+                                struct CachedScene* entry,
+                                const struct Options* options,
+                                struct ThreadPool* pool, FILE* file,
+                                struct Error* error) {
+  (void)cache;
+  (void)options;
+  (void)pool;
+  (void)error;
+  print_aggregates_summary(&entry->aggregates, file);
+  return true;
+}
+
+// The subcommands, except batch, client and serve
+const struct Subcommand SUBCOMMANDS[] = {
+  {"apply", run_apply_subcommand, false, NULL,
+   OPTIONS_SCENE | OPTION_DELTA | OPTION_OUTPUT},
+  {"bounding-box", run_bounding_box_subcommand, true,
+   serve_bounding_box_subcommand, OPTIONS_SCENE | OPTION_NO_VALIDATE},
+  {"coverage", run_coverage_subcommand, true, serve_coverage_subcommand,
+   OPTIONS_SCENE | OPTION_EXACT},
+  {"describe", run_describe_subcommand, true, serve_describe_subcommand,
+   OPTIONS_SCENE},
+  {"help", run_help_subcommand, false, NULL, 0},
+  {"nearest", run_nearest_subcommand, true, NULL, OPTIONS_SCENE | OPTION_K},
+  {"pack", run_pack_subcommand, false, NULL, OPTIONS_SCENE | OPTION_OUTPUT},
+  {"place", run_place_subcommand, true, NULL,
+   OPTIONS_SCENE | OPTION_RADIUS | OPTION_STEP},
+  {"query", run_query_subcommand, false, NULL,
+   OPTIONS_SCENE | OPTION_QUERIES},
+  {"render", run_render_subcommand, false, NULL,
+   OPTIONS_SCENE | OPTION_OUTPUT | OPTION_RESOLUTION},
+  {"summarize", run_summarize_subcommand, true, serve_summarize_subcommand,
+   OPTIONS_SCENE | OPTION_NO_VALIDATE},
+  {"unpack", run_unpack_subcommand, true, NULL, OPTIONS_SCENE},
+};
+
+/**
+ * Returns the subcommand with a given name
+ *
+ * @param name  The name of the subcommand
+ * @return      The subcommand, or NULL if there is none
+ */
+const struct Subcommand* find_subcommand(const char* name) {
+  unsigned int num_subcommands = sizeof(SUBCOMMANDS) / sizeof(SUBCOMMANDS[0]);
+  for (unsigned int s = 0; s < num_subcommands; ++s)
+    if (strcmp(SUBCOMMANDS[s].name, name) == 0)
+      return SUBCOMMANDS + s;
+  return NULL;
+}
+
+/**
+ * Runs a subcommand on its own
+ *
+ * @param argc   The number of arguments
+ * @param argv   The arguments
+ * @param error  The error reported if the subcommand fails
+ * @return       true if and only if the subcommand succeeded
+ */
+bool run_subcommand(int argc, char* argv[], struct Error* error) {
+  if (argc < 2)
+    return report_error_mandatory_subcommand(error);
+  const struct Subcommand* subcommand = find_subcommand(argv[1]);
+  if (subcommand == NULL)
+    return report_error_unrecognized_subcommand(error, argv[1]);
+  struct Options options;
+  if (!parse_options(argc, argv, 2, argv[1], subcommand->options, &options,
+                     NULL, error))
+    return false;
+  struct RunStats stats;
+  if (options.is_measured) {
+    start_run_stats(&stats);
+    options.stats = &stats;
+  }
+  struct ThreadPool pool;
+  if (!create_thread_pool(&pool, options.num_threads, error))
+    return false;
+  bool success = subcommand->run(&options, &pool, stdout, error);
+  destroy_thread_pool(&pool);
+  if (options.is_measured) {
+    fflush(stdout);
+    record_stats_phase(&stats, PHASE_OUTPUT);
+    print_run_stats(&stats, options.is_json_stats, stderr);
+  }
+  return success;
+}
+
+// Batch processing
+// ----------------
+
+/**
+ * Runs the subcommand of a batch on one of its files
+ *
+ * The result is kept in memory until the whole window is processed, so that
+ * the files are printed in order.
+ *
+ * @param context  The batch job
+ * @param task     The index of the file in the window
+ * @param worker   The worker running the task
+ */
+void run_batch_task(void* context, unsigned int task, unsigned int worker) {
+  struct BatchJob* job = context;
+  struct BatchTask* batch_task = job->tasks + task;
+  struct Options options = *job->options;
+  options.input_path = batch_task->path;
+  FILE* file = open_memstream(&batch_task->output, &batch_task->output_size);
+  if (file == NULL)
+    report_error_out_of_memory();
+  batch_task->success = job->subcommand->run(&options, job->pools + worker,
+                                             file, &batch_task->error);
+  if (fclose(file) != 0)
+    report_error_out_of_memory();
+}
+
+/**
+ * Prints the result of a file of a batch on stdout
+ *
+ * @param task      The file
+ * @param is_first  true if the file is the first one of the batch
  */
-void run_summarize_subcommand(void) {
-  struct Scene scene;
-  load_scene_from_stdin(&scene);
-  validate_scene(&scene);
-  print_scene_summary(&scene);
+void print_batch_task(struct BatchTask* task, bool is_first) {
+  printf("%s==> %s <==\n", is_first ? "" : "\n", task->path);
+  fwrite(task->output, 1, task->output_size, stdout);
+  if (!task->success)
+    print_error(&task->error, stdout);
+  free(task->output);
+}
+
+/**
+ * Runs the subcommand of a batch on all its files
+ *
+ * The files are processed by windows of BATCH_WINDOW_PER_THREAD files per
+ * thread, each file being handled by a single thread, and the results of a
+ * window are printed once it is complete.
+ *
+ * @param subcommand    The subcommand
+ * @param options       The options of the subcommand
+ * @param files         The files
+ * @param num_failures  The resulting number of files on which the subcommand
+ *                      failed
+ * @param error         The error reported if the threads cannot be started
+ * @return              true if and only if the files were processed
+ */
+bool run_batch_files(const struct Subcommand* subcommand,
+                     const struct Options* options, struct BatchFiles* files,
+                     unsigned int* num_failures, struct Error* error) {
+  *num_failures = 0;
+  struct ThreadPool pool;
+  if (!create_thread_pool(&pool, options->num_threads, error))
+    return false;
+  unsigned int window = options->num_threads * BATCH_WINDOW_PER_THREAD;
+  // The pools of one thread start no thread, and cannot fail
+  struct ThreadPool* pools =
+    arena_allocate(&files->arena, options->num_threads * sizeof(*pools));
+  for (unsigned int t = 0; t < options->num_threads; ++t)
+    create_thread_pool(pools + t, 1, error);
+  struct BatchTask* tasks =
+    arena_allocate(&files->arena, window * sizeof(struct BatchTask));
+  struct BatchJob job = {subcommand, options, pools, tasks};
+  for (unsigned int first = 0; first < files->num_files; first += window) {
+    unsigned int size = files->num_files - first < window
+                      ? files->num_files - first : window;
+    for (unsigned int f = 0; f < size; ++f)
+      tasks[f].path = files->paths[first + f];
+    run_pool_tasks(&pool, size, run_batch_task, &job);
+    for (unsigned int f = 0; f < size; ++f) {
+      print_batch_task(tasks + f, first + f == 0);
+      *num_failures += !tasks[f].success;
+    }
+  }
+  for (unsigned int t = 0; t < options->num_threads; ++t)
+    destroy_thread_pool(pools + t);
+  destroy_thread_pool(&pool);
+  return true;
+}
+
+/**
+ * Runs the batch subcommand
+ *
+ * @param argc          The number of arguments
+ * @param argv          The arguments
+ * @param num_failures  The resulting number of files on which the subcommand
+ *                      failed
+ * @param error         The error reported if the batch cannot be run
+ * @return              true if and only if the batch was run
+ */
+bool run_batch_subcommand(int argc, char* argv[], unsigned int* num_failures,
+                          struct Error* error) {
+  if (argc < 3)
+    return report_error_mandatory_subcommand(error);
+  const struct Subcommand* subcommand = find_subcommand(argv[2]);
+  if (subcommand == NULL)
+    return report_error_unrecognized_subcommand(error, argv[2]);
+  if (!subcommand->is_batchable)
+    return report_error_unbatchable_subcommand(error, argv[2]);
+  struct BatchFiles files;
+  initialize_batch_files(&files);
+  struct Options options;
+  // The options that batch rejects itself are reported as such below
+  unsigned int allowed = subcommand->options | OPTION_INPUT | OPTION_OUTPUT |
+                         OPTION_STATS | OPTION_STATS_JSON;
+  bool success = parse_options(argc, argv, 3, argv[2], allowed, &options,
+                               &files, error);
+  if (success && options.input_path != NULL)
+    success = report_error_unbatchable_option(error, "--input");
+  if (success && options.output_path != NULL)
+    success = report_error_unbatchable_option(error, "--output");
+  if (success && options.is_measured)
+    success = report_error_unbatchable_option(error, "--stats");
+  if (success && files.num_files == 0)
+    success = read_batch_files(&files, error);
+  if (success)
+    success = run_batch_files(subcommand, &options, &files, num_failures,
+                              error);
+  free_arena(&files.arena);
+  return success;
+}
+
+// Server processing
+// -----------------
+
+/**
+ * Answers a request received by serve
+ *
+ * The arguments of the request are a subcommand followed by its options, and
+ * its body is the scene, which is looked up in the cache of the server.
+ *
+ * @param context    The state of the server
+ * @param arguments  The subcommand and its options, separated by spaces
+ * @param body       The scene
+ * @param body_size  The size of the scene
+ * @param file       The file on which the answer is printed
+ * @param error      The error reported if the request fails
+ * @return           true if and only if the request succeeded
+ */
+bool handle_request(void* context, char* arguments, const char* body,
+                    size_t body_size, FILE* file, struct Error* error) {
+  struct ServeContext* serve_context = context;
+  char* argv[MAX_REQUEST_ARGUMENTS + 1];
+  int argc = 1;
+  argv[0] = "serve";
+  char* position;
+  for (char* token = strtok_r(arguments, " ", &position); token != NULL;
+       token = strtok_r(NULL, " ", &position)) {
+    if (argc == MAX_REQUEST_ARGUMENTS + 1)
+      return report_error_invalid_request(error);
+    argv[argc++] = token;
+  }
+  if (argc < 2)
+    return report_error_mandatory_subcommand(error);
+  const struct Subcommand* subcommand = find_subcommand(argv[1]);
+  if (subcommand == NULL)
+    return report_error_unrecognized_subcommand(error, argv[1]);
+  if (subcommand->serve == NULL)
+    return report_error_unservable_subcommand(error, argv[1]);
+  struct Options options;
+  if (!parse_options(argc, argv, 2, argv[1], subcommand->options, &options,
+                     NULL, error))
+    return false;
+  struct CachedScene* entry =
+    find_cached_scene(&serve_context->cache, body, body_size,
+                      serve_context->pool, error);
+  if (entry == NULL)
+    return false;
+  return subcommand->serve(&serve_context->cache, entry, &options,
+                           serve_context->pool, file, error);
+}
+
+/**
+ * Runs the serve subcommand
+ *
+ * @param argc   The number of arguments
+ * @param argv   The arguments
+ * @param error  The error reported if the server cannot be started
+ * @return       true if and only if the server was stopped by a signal
+ */
+bool run_serve_subcommand(int argc, char* argv[], struct Error* error) {
+  struct Options options;
+  if (!parse_options(argc, argv, 2, "serve",
+                     OPTION_MEMORY | OPTION_SOCKET | OPTION_THREADS, &options,
+                     NULL, error))
+    return false;
+  if (options.socket_path == NULL)
+    return report_error_mandatory_option(error, "--socket");
+  struct Server server;
+  if (!open_server(&server, options.socket_path,
+                   (size_t)options.memory << 20, error))
+    return false;
+  struct ThreadPool pool;
+  if (!create_thread_pool(&pool, options.num_threads, error)) {
+    close_server(&server);
+    return false;
+  }
+  struct ServeContext context;
+  initialize_scene_cache(&context.cache, (size_t)options.memory << 20);
+  context.pool = &pool;
+  run_server(&server, handle_request, &context);
+  free_scene_cache(&context.cache);
+  destroy_thread_pool(&pool);
+  close_server(&server);
+  return true;
+}
+
+/**
+ * Runs the client subcommand
+ *
+ * The subcommand and its options are forwarded to the server, except
+ * --input and --socket, and the scene is sent as the body of the request.
+ *
+ * @param argc   The number of arguments
+ * @param argv   The arguments
+ * @param error  The error reported if the request fails
+ * @return       true if and only if the request succeeded
+ */
+bool run_client_subcommand(int argc, char* argv[], struct Error* error) {
+  if (argc < 3)
+    return report_error_mandatory_subcommand(error);
+  const struct Subcommand* subcommand = find_subcommand(argv[2]);
+  if (subcommand == NULL)
+    return report_error_unrecognized_subcommand(error, argv[2]);
+  struct Options options;
+  if (!parse_options(argc, argv, 3, argv[2],
+                     subcommand->options | OPTION_SOCKET, &options, NULL,
+                     error))
+    return false;
+  if (options.socket_path == NULL)
+    return report_error_mandatory_option(error, "--socket");
+  struct RunStats stats;
+  if (options.is_measured)
+    start_run_stats(&stats);
+  char arguments[MAX_LENGTH_REQUEST_HEADER];
+  size_t length = 0;
+  for (int i = 2; i < argc; ++i) {
+    if (strcmp(argv[i], "--input") == 0 || strcmp(argv[i], "--socket") == 0) {
+      ++i;
+      continue;
+    }
+    if (strncmp(argv[i], "--stats", 7) == 0)
+      continue;
+    size_t size = strlen(argv[i]);
+    if (strpbrk(argv[i], " \n") != NULL ||
+        length + size + 1 >= MAX_LENGTH_REQUEST_HEADER)
+      return report_error_invalid_request(error);
+    if (length > 0)
+      arguments[length++] = ' ';
+    memcpy(arguments + length, argv[i], size);
+    length += size;
+  }
+  arguments[length] = '\0';
+  struct Input input;
+  if (!open_options_input(&options, &input, error))
+    return false;
+  if (options.is_measured) {
+    stats.num_bytes = input.size;
+    record_stats_phase(&stats, PHASE_READ);
+  }
+  struct ServerResponse response;
+  bool is_received = send_request(options.socket_path, arguments, input.data,
+                                  input.size, &response, error),
+       success = is_received;
+  close_input(&input);
+  if (options.is_measured)
+    record_stats_phase(&stats, PHASE_PROCESS);
+  if (is_received) {
+    if (response.success)
+      fwrite(response.data, 1, response.size, stdout);
+    else
+      success = report_error_from_server(error, response.kind,
+                                         response.data, response.size);
+    free_server_response(&response);
+  }
+  if (options.is_measured) {
+    fflush(stdout);
+    record_stats_phase(&stats, PHASE_OUTPUT);
+    print_run_stats(&stats, options.is_json_stats, stderr);
+  }
+  return success;
 }
 
 // Main function
@@ -91,20 +1461,23 @@ void run_summarize_subcommand(void) {
  *
  * @param argc  The number of arguments
  * @param argv  The arguments
+ * @return      0 if the subcommand succeeded on all the scenes, 1 otherwise
  */
 int main(int argc, char* argv[]) {
-  if (argc < 2)
-    report_error_mandatory_subcommand();
-  const char* subcommand = argv[1];
-  if (strcmp(subcommand, "bounding-box") == 0)
-    run_bounding_box_subcommand();
-  else if (strcmp(subcommand, "describe") == 0)
-    run_describe_subcommand();
-  else if (strcmp(subcommand, "help") == 0)
-    run_help_subcommand();
-  else if (strcmp(subcommand, "summarize") == 0)
-    run_summarize_subcommand();
+  struct Error error;
+  unsigned int num_failures = 0;
+  bool success;
+  if (argc >= 2 && strcmp(argv[1], "batch") == 0)
+    success = run_batch_subcommand(argc, argv, &num_failures, &error);
+  else if (argc >= 2 && strcmp(argv[1], "client") == 0)
+    success = run_client_subcommand(argc, argv, &error);
+  else if (argc >= 2 && strcmp(argv[1], "serve") == 0)
+    success = run_serve_subcommand(argc, argv, &error);
   else
-    report_error_unrecognized_subcommand(subcommand);
-  return 0;
+    success = run_subcommand(argc, argv, &error);
+  if (fflush(stdout) != 0 && success)
+    success = report_error_cannot_write_file(&error, "stdout");
+  if (!success)
+    print_error(&error, stderr);
+  return success && num_failures == 0 ? 0 : 1;
 }
@@ -0,0 +1,126 @@
+#include "nearest.h"
+
+#include <stdio.h>
+
+#include "arena.h"
+#include "kdtree.h"
+#include "pool.h"
+#include "rtree.h"
+#include "writer.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The number of buildings handled by a task of the nearest computation
+#define NEAREST_CHUNK_SIZE 256
+
+// Types
+// -----
+
+// A nearest computation, split in chunks of consecutive buildings
+struct NearestJob {
+  // The scene
+  const struct Scene* scene;
+  // The k-d tree over the antennas
+  const struct KdTree* tree;
+  // The resulting nearest antennas
+  struct SceneNearest* nearest;
+  // The neighbors found by each worker (k items per worker)
+  struct KdNeighbor* neighbors;
+};
+
+// Computation
+// -----------
+
+/**
+ * Computes the nearest antennas of a chunk of consecutive buildings
+ *
+ * @param context  The NearestJob
+ * @param chunk    The index of the chunk
+ * @param worker   The index of the worker running the task
+ */
+void compute_chunk_nearest(void* context, unsigned int chunk,
+                           unsigned int worker) {
+  struct NearestJob* job = context;
+  const struct Scene* scene = job->scene;
+  unsigned int k = job->nearest->k;
+  struct KdNeighbor* neighbors = job->neighbors + (size_t)worker * k;
+  unsigned int start = chunk * NEAREST_CHUNK_SIZE,
+               end = scene->num_buildings - start < NEAREST_CHUNK_SIZE
+                   ? scene->num_buildings : start + NEAREST_CHUNK_SIZE;
+  for (unsigned int b = start; b < end; ++b) {
+    const struct Building* building = scene->buildings + b;
+    struct RTreeBox box = {(long long)building->x - building->w,
+                           (long long)building->y - building->h,
+                           (long long)building->x + building->w,
+                           (long long)building->y + building->h};
+    find_nearest_points(job->tree, &box, k, neighbors);
+    unsigned int* antennas = job->nearest->antennas + (size_t)b * k;
+    for (unsigned int n = 0; n < k; ++n)
+      antennas[n] = neighbors[n].index;
+  }
+}
+
+// Public functions definition
+// ===========================
+
+// Computation
+// -----------
+
+void compute_scene_nearest(const struct Scene* scene, unsigned int k,
+                           struct SceneNearest* nearest,
+                           struct ThreadPool* pool, struct Arena* arena) {
+  unsigned int num_buildings = scene->num_buildings,
+               num_antennas = scene->num_antennas;
+  if (k > num_antennas)
+    k = num_antennas;
+  struct KdPoint* points =
+    arena_allocate(arena, num_antennas * sizeof(struct KdPoint));
+  for (unsigned int a = 0; a < num_antennas; ++a) {
+    points[a].x = scene->antennas[a].x;
+    points[a].y = scene->antennas[a].y;
+    points[a].index = a;
+  }
+  struct KdTree tree;
+  build_kdtree(&tree, points, num_antennas);
+  nearest->num_buildings = num_buildings;
+  nearest->k = k;
+  nearest->antennas =
+    arena_allocate(arena, (size_t)num_buildings * k * sizeof(unsigned int));
+  if (k == 0)
+    return;
+  unsigned int num_chunks =
+    (num_buildings + NEAREST_CHUNK_SIZE - 1) / NEAREST_CHUNK_SIZE;
+  struct NearestJob job = {
+    scene, &tree, nearest,
+    arena_allocate(arena, (size_t)pool->num_threads * k *
+                          sizeof(struct KdNeighbor))
+  };
+  run_pool_tasks(pool, num_chunks, compute_chunk_nearest, &job);
+}
+
+// Printing
+// --------
+
+void print_scene_nearest(const struct Scene* scene,
+                         const struct SceneNearest* nearest, FILE* file) {
+  struct Writer writer;
+  open_writer(&writer, file);
+  write_string(&writer, "Nearest antennas\n");
+  for (unsigned int b = 0; b < nearest->num_buildings; ++b) {
+    write_string(&writer, "  building ");
+    write_string(&writer, building_identifier(scene, scene->buildings + b));
+    write_char(&writer, ':');
+    const unsigned int* antennas = nearest->antennas + (size_t)b * nearest->k;
+    for (unsigned int n = 0; n < nearest->k; ++n) {
+      write_char(&writer, ' ');
+      write_string(&writer,
+                   antenna_identifier(scene, scene->antennas + antennas[n]));
+    }
+    write_char(&writer, '\n');
+  }
+  close_writer(&writer);
+}
@@ -0,0 +1,67 @@
+#ifndef NEAREST_H_
+#define NEAREST_H_
+
+#include <stdio.h>
+
+#include "arena.h"
+#include "pool.h"
+#include "scene.h"
+
+// Types
+// -----
+
+// The antennas nearest to each building of a scene
+//
+// The antennas nearest to the building b are the indices antennas[b * k] to
+// antennas[b * k + k - 1], by increasing distance from the building to the
+// antenna, then by index.
+struct SceneNearest {
+  // The number of buildings
+  unsigned int num_buildings;
+  // The number of antennas listed for each building
+  unsigned int k;
+  // The nearest antennas of the buildings
+  unsigned int* antennas;
+};
+
+// Computation
+// -----------
+
+/**
+ * Computes the antennas nearest to each building of a scene
+ *
+ * The distance from a building to an antenna is the distance from the
+ * rectangle of the building to the position of the antenna, so that the
+ * antennas within a building are at distance 0, and the nearest antennas are
+ * found even if none covers the building. The antennas are indexed by a k-d
+ * tree, and the buildings are handled in chunks by the threads of the pool.
+ * The result does not depend on the number of threads.
+ *
+ * @param scene    The scene
+ * @param k        The number of antennas to find for each building, capped
+ *                 by the number of antennas of the scene
+ * @param nearest  The resulting nearest antennas
+ * @param pool     The thread pool
+ * @param arena    The arena from which the result is allocated
+ */
+void compute_scene_nearest(const struct Scene* scene, unsigned int k,
+                           struct SceneNearest* nearest,
+                           struct ThreadPool* pool, struct Arena* arena);
+
+// Printing
+// --------
+
+/**
+ * Prints the antennas nearest to each building of a scene
+ *
+ * The buildings are listed by identifier, each followed by its nearest
+ * antennas, the nearest first.
+ *
+ * @param scene    The scene
+ * @param nearest  The nearest antennas of its buildings
+ * @param file     The file on which they are printed
+ */
+void print_scene_nearest(const struct Scene* scene,
+                         const struct SceneNearest* nearest, FILE* file);
+
+#endif
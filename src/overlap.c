@@ -0,0 +1,808 @@
+#include "overlap.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "identifier.h"
+#include "pool.h"
+#include "radix.h"
+#include "rtree.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The number of tiles per thread of a parallel overlap search
+#define TILES_PER_THREAD 4
+
+// Types
+// -----
+
+// An event of the sweep along the x axis
+struct SweepEvent {
+  // The x coordinate of the event
+  long long x;
+  // The index of the building
+  unsigned int building;
+  // true if the building starts at x, false if it ends at x
+  bool is_start;
+};
+
+// A building index associated with a sort key
+struct KeyedBuilding {
+  // The sort key
+  long long key;
+  // The index of the building
+  unsigned int building;
+};
+
+// The first overlapping pair found by a search in a building grid
+struct GridOverlap {
+  // true if an overlapping pair was found
+  bool is_found;
+  // The key of the smaller identifier of the pair
+  uint64_t first_key;
+  // The smaller identifier of the pair, as a handle
+  uint32_t first_id;
+  // The key of the larger identifier of the pair
+  uint64_t second_key;
+  // The larger identifier of the pair, as a handle
+  uint32_t second_id;
+};
+
+// A set of ranks in [0, n), stored as a Fenwick tree of counts
+struct RankSet {
+  // The number of possible ranks
+  unsigned int n;
+  // The largest power of two not greater than n
+  unsigned int top_bit;
+  // The number of ranks in the set
+  unsigned int size;
+  // The Fenwick tree (1-based)
+  unsigned int* tree;
+};
+
+// A partition of the buildings in vertical tiles
+//
+// The tile t is the open strip bounds[t - 1] < x < bounds[t], where
+// bounds[-1] = -infinity and bounds[num_tiles - 1] = +infinity. A building
+// belongs to every tile its interior meets, so that two overlapping buildings
+// always share a tile.
+struct OverlapTiling {
+  // The number of tiles
+  unsigned int num_tiles;
+  // The inner bounds of the tiles (num_tiles - 1 items, nondecreasing)
+  long long* bounds;
+  // The offsets of the buildings of each tile (num_tiles + 1 items)
+  unsigned int* offsets;
+  // The copies of the buildings of the tiles
+  struct Building* buildings;
+  // The result of the search in each tile
+  bool* is_overlapping;
+  // Set as soon as a tile with overlapping buildings is found
+  bool found;
+};
+
+// Sorting
+// -------
+
+/**
+ * Compares two sweep events
+ *
+ * Events are ordered by x coordinate. At equal coordinates, buildings ending
+ * come before buildings starting, since touching buildings do not overlap.
+ *
+ * @param a  The first event
+ * @param b  The second event
+ * @return   A negative, null or positive value as for strcmp
+ */
+int compare_sweep_events(const void* a, const void* b) {
+  const struct SweepEvent* event1 = a, * event2 = b;
+  if (event1->x != event2->x)
+    return event1->x < event2->x ? -1 : 1;
+  if (event1->is_start != event2->is_start)
+    return event1->is_start ? 1 : -1;
+  if (event1->building != event2->building)
+    return event1->building < event2->building ? -1 : 1;
+  return 0;
+}
+
+/**
+ * Compares two keyed buildings by key, then by index
+ *
+ * @param a  The first keyed building
+ * @param b  The second keyed building
+ * @return   A negative, null or positive value as for strcmp
+ */
+int compare_keyed_buildings(const void* a, const void* b) {
+  const struct KeyedBuilding* keyed1 = a, * keyed2 = b;
+  if (keyed1->key != keyed2->key)
+    return keyed1->key < keyed2->key ? -1 : 1;
+  if (keyed1->building != keyed2->building)
+    return keyed1->building < keyed2->building ? -1 : 1;
+  return 0;
+}
+
+// Rank sets
+// ---------
+
+/**
+ * Initializes an empty rank set
+ *
+ * @param set    The set to initialize
+ * @param n      The number of possible ranks
+ * @param arena  The arena from which the set is allocated
+ */
+void initialize_rank_set(struct RankSet* set, unsigned int n,
+                         struct Arena* arena) {
+  set->n = n;
+  set->top_bit = 1;
+  while (2 * set->top_bit <= n)
+    set->top_bit *= 2;
+  set->size = 0;
+  set->tree = arena_allocate(arena, (n + 1) * sizeof(unsigned int));
+  for (unsigned int i = 0; i <= n; ++i)
+    set->tree[i] = 0;
+}
+
+/**
+ * Adds or removes a rank from a rank set
+ *
+ * @param set    The set
+ * @param rank   The rank
+ * @param delta  1 to add the rank, -1 to remove it
+ */
+void update_rank_set(struct RankSet* set, unsigned int rank, int delta) {
+  for (unsigned int i = rank + 1; i <= set->n; i += i & -i)
+    set->tree[i] += delta;
+  set->size += delta;
+}
+
+/**
+ * Returns the number of ranks of a set that are smaller than a given rank
+ *
+ * @param set   The set
+ * @param rank  The rank
+ * @return      The number of smaller ranks
+ */
+unsigned int count_smaller_ranks(const struct RankSet* set,
+                                 unsigned int rank) {
+  unsigned int count = 0;
+  for (unsigned int i = rank; i > 0; i -= i & -i)
+    count += set->tree[i];
+  return count;
+}
+
+/**
+ * Returns the k-th smallest rank of a set
+ *
+ * @param set  The set
+ * @param k    The order of the rank, starting at 1
+ * @return     The k-th smallest rank
+ */
+unsigned int select_rank(const struct RankSet* set, unsigned int k) {
+  unsigned int position = 0;
+  for (unsigned int bit = set->top_bit; bit > 0; bit /= 2)
+    if (position + bit <= set->n && set->tree[position + bit] < k) {
+      position += bit;
+      k -= set->tree[position];
+    }
+  return position;
+}
+
+// Search
+// ------
+
+/**
+ * Finds the first overlapping pair among buildings known to overlap
+ *
+ * The buildings are indexed by an R-tree, then searched in index order for
+ * the buildings overlapping them. The boxes searched are shrunk by one unit
+ * on each side, so that they only meet the boxes of the buildings sharing
+ * some area with the building. The buildings before the first one of the pair
+ * overlap no other building, so that each of their searches finds only the
+ * building itself, and the search takes O(n log n) time whatever the layout.
+ *
+ * @param buildings      The buildings
+ * @param num_buildings  The number of buildings
+ * @param b1             The index of the first building of the pair
+ * @param b2             The index of the second building of the pair
+ * @param arena          The arena used for temporary storage
+ * @return               true if and only if two buildings are overlapping
+ */
+bool find_first_overlapping_pair(const struct Building* buildings,
+                                 unsigned int num_buildings,
+                                 unsigned int* b1, unsigned int* b2,
+                                 struct Arena* arena) {
+  struct RTreeBox* boxes =
+    arena_allocate(arena, num_buildings * sizeof(struct RTreeBox));
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    const struct Building* building = buildings + b;
+    boxes[b].xmin = (long long)building->x - building->w;
+    boxes[b].ymin = (long long)building->y - building->h;
+    boxes[b].xmax = (long long)building->x + building->w;
+    boxes[b].ymax = (long long)building->y + building->h;
+  }
+  struct RTree tree;
+  build_rtree(&tree, boxes, num_buildings, arena);
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    struct RTreeBox inner = {boxes[b].xmin + 1, boxes[b].ymin + 1,
+                             boxes[b].xmax - 1, boxes[b].ymax - 1};
+    struct RTreeSearch search;
+    unsigned int other;
+    bool found = false;
+    start_rtree_search(&search, &tree, &inner);
+    while (next_rtree_entry(&search, &other))
+      if (other != b && (!found || other < *b2)) {
+        *b2 = other;
+        found = true;
+      }
+    if (found) {
+      *b1 = b;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Indicates if any two buildings are overlapping
+ *
+ * @param buildings      The buildings
+ * @param num_buildings  The number of buildings
+ * @param arena          The arena used for temporary storage
+ * @return               true if and only if two buildings are overlapping
+ */
+bool has_overlapping_buildings(const struct Building* buildings,
+                               unsigned int num_buildings,
+                               struct Arena* arena) {
+  struct SweepEvent* events =
+    arena_allocate(arena, 2 * num_buildings * sizeof(struct SweepEvent));
+  struct KeyedBuilding* by_y =
+    arena_allocate(arena, num_buildings * sizeof(struct KeyedBuilding));
+  unsigned int* rank_of = arena_allocate(arena,
+                                         num_buildings * sizeof(unsigned int));
+  unsigned int* building_of =
+    arena_allocate(arena, num_buildings * sizeof(unsigned int));
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    const struct Building* building = buildings + b;
+    events[2 * b].x = (long long)building->x - building->w;
+    events[2 * b].building = b;
+    events[2 * b].is_start = true;
+    events[2 * b + 1].x = (long long)building->x + building->w;
+    events[2 * b + 1].building = b;
+    events[2 * b + 1].is_start = false;
+    by_y[b].key = (long long)building->y - building->h;
+    by_y[b].building = b;
+  }
+  qsort(events, 2 * num_buildings, sizeof(struct SweepEvent),
+        compare_sweep_events);
+  qsort(by_y, num_buildings, sizeof(struct KeyedBuilding),
+        compare_keyed_buildings);
+  for (unsigned int r = 0; r < num_buildings; ++r) {
+    rank_of[by_y[r].building] = r;
+    building_of[r] = by_y[r].building;
+  }
+  // The active buildings are pairwise disjoint on y, so a new building can
+  // only overlap its neighbors in the order of their bottom sides
+  struct RankSet active;
+  initialize_rank_set(&active, num_buildings, arena);
+  for (unsigned int e = 0; e < 2 * num_buildings; ++e) {
+    unsigned int b = events[e].building, rank = rank_of[b];
+    if (!events[e].is_start) {
+      update_rank_set(&active, rank, -1);
+      continue;
+    }
+    long long bottom = (long long)buildings[b].y - buildings[b].h,
+              top = (long long)buildings[b].y + buildings[b].h;
+    unsigned int num_below = count_smaller_ranks(&active, rank);
+    if (num_below > 0) {
+      const struct Building* below =
+        buildings + building_of[select_rank(&active, num_below)];
+      if ((long long)below->y + below->h > bottom)
+        return true;
+    }
+    if (num_below < active.size) {
+      const struct Building* above =
+        buildings + building_of[select_rank(&active, num_below + 1)];
+      if ((long long)above->y - above->h < top)
+        return true;
+    }
+    update_rank_set(&active, rank, 1);
+  }
+  return false;
+}
+
+// Tiling
+// ------
+
+/**
+ * Returns the number of tile bounds smaller than a value
+ *
+ * @param bounds      The bounds, nondecreasing
+ * @param num_bounds  The number of bounds
+ * @param value       The value
+ * @param or_equal    true to also count the bounds equal to the value
+ * @return            The number of bounds counted
+ */
+unsigned int count_bounds_below(const long long* bounds,
+                                unsigned int num_bounds, long long value,
+                                bool or_equal) {
+  unsigned int low = 0, high = num_bounds;
+  while (low < high) {
+    unsigned int middle = low + (high - low) / 2;
+    if (bounds[middle] < value || (or_equal && bounds[middle] == value))
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+/**
+ * Partitions buildings in vertical tiles holding as many buildings each
+ *
+ * The bounds of the tiles are quantiles of the x coordinates of the
+ * buildings.
+ *
+ * @param tiling         The resulting tiling
+ * @param buildings      The buildings
+ * @param num_buildings  The number of buildings
+ * @param num_tiles      The number of tiles
+ * @param arena          The arena from which the tiling is allocated
+ */
+void tile_buildings(struct OverlapTiling* tiling,
+                    const struct Building* buildings,
+                    unsigned int num_buildings, unsigned int num_tiles,
+                    struct Arena* arena) {
+  struct KeyedIndex* order =
+    arena_allocate(arena, num_buildings * sizeof(struct KeyedIndex));
+  struct KeyedIndex* buffer =
+    arena_allocate(arena, num_buildings * sizeof(struct KeyedIndex));
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    order[b].key = (uint32_t)buildings[b].x ^ 0x80000000u;
+    order[b].index = b;
+  }
+  radix_sort(order, num_buildings, buffer);
+  tiling->num_tiles = num_tiles;
+  tiling->bounds = arena_allocate(arena, num_tiles * sizeof(long long));
+  for (unsigned int t = 0; t + 1 < num_tiles; ++t)
+    tiling->bounds[t] =
+      buildings[order[(unsigned long long)num_buildings * (t + 1) /
+                      num_tiles].index].x;
+  unsigned int* first_tile =
+    arena_allocate(arena, num_buildings * sizeof(unsigned int));
+  unsigned int* last_tile =
+    arena_allocate(arena, num_buildings * sizeof(unsigned int));
+  tiling->offsets =
+    arena_allocate(arena, (num_tiles + 1) * sizeof(unsigned int));
+  for (unsigned int t = 0; t <= num_tiles; ++t)
+    tiling->offsets[t] = 0;
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    // The building meets the tile t iff bounds[t - 1] < x + w and
+    // x - w < bounds[t]
+    first_tile[b] = count_bounds_below(tiling->bounds, num_tiles - 1,
+                                       (long long)buildings[b].x -
+                                       buildings[b].w, true);
+    last_tile[b] = count_bounds_below(tiling->bounds, num_tiles - 1,
+                                      (long long)buildings[b].x +
+                                      buildings[b].w, false);
+    for (unsigned int t = first_tile[b]; t <= last_tile[b]; ++t)
+      ++tiling->offsets[t + 1];
+  }
+  for (unsigned int t = 0; t < num_tiles; ++t)
+    tiling->offsets[t + 1] += tiling->offsets[t];
+  tiling->buildings = arena_allocate(arena, tiling->offsets[num_tiles] *
+                                            sizeof(struct Building));
+  unsigned int* sizes =
+    arena_allocate(arena, num_tiles * sizeof(unsigned int));
+  for (unsigned int t = 0; t < num_tiles; ++t)
+    sizes[t] = 0;
+  for (unsigned int b = 0; b < num_buildings; ++b)
+    for (unsigned int t = first_tile[b]; t <= last_tile[b]; ++t)
+      tiling->buildings[tiling->offsets[t] + sizes[t]++] = buildings[b];
+  tiling->is_overlapping = arena_allocate(arena, num_tiles * sizeof(bool));
+  tiling->found = false;
+}
+
+/**
+ * Searches for overlapping buildings in a tile
+ *
+ * The search is skipped once another tile is known to hold overlapping
+ * buildings.
+ *
+ * @param context  The OverlapTiling
+ * @param tile     The index of the tile
+ * @param worker   The index of the worker running the task (unused)
+ */
+void search_tile(void* context, unsigned int tile, unsigned int worker) {
+  (void)worker;
+  struct OverlapTiling* tiling = context;
+  tiling->is_overlapping[tile] = false;
+  if (__atomic_load_n(&tiling->found, __ATOMIC_RELAXED))
+    return;
+  struct Arena arena;
+  initialize_arena(&arena);
+  unsigned int first = tiling->offsets[tile],
+               num_buildings = tiling->offsets[tile + 1] - first;
+  if (num_buildings >= 2 &&
+      has_overlapping_buildings(tiling->buildings + first, num_buildings,
+                                &arena)) {
+    tiling->is_overlapping[tile] = true;
+    __atomic_store_n(&tiling->found, true, __ATOMIC_RELAXED);
+  }
+  free_arena(&arena);
+}
+
+// Building grid
+// -------------
+
+/**
+ * Returns the level of a building grid at which a building is stored
+ *
+ * @param w  The half width of the building
+ * @param h  The half height of the building
+ * @return   The smallest level l such that 2^l >= 2 * max(w, h)
+ */
+unsigned int grid_level(int w, int h) {
+  long long side = 2 * (long long)(w > h ? w : h);
+  unsigned int level = 0;
+  while (1ll << level < side)
+    ++level;
+  return level;
+}
+
+/**
+ * Returns the hash key of a cell of a building grid
+ *
+ * @param level  The level of the cell
+ * @param cx     The x coordinate of the cell
+ * @param cy     The y coordinate of the cell
+ * @return       The key
+ */
+uint64_t grid_cell_key(unsigned int level, long long cx, long long cy) {
+  return ((uint64_t)cx << 32 ^ (uint64_t)cy) ^ (uint64_t)level << 58;
+}
+
+/**
+ * Returns the hash key of the cell of a building grid storing a building
+ *
+ * @param building  The building
+ * @return          The key
+ */
+uint64_t building_cell_key(const struct GridBuilding* building) {
+  unsigned int level = grid_level(building->w, building->h),
+               shift = level + 1;
+  return grid_cell_key(level, ((long long)building->x - building->w) >> shift,
+                       ((long long)building->y - building->h) >> shift);
+}
+
+/**
+ * Compares two identifiers of the buildings of a grid
+ *
+ * The identifiers are only read when their keys are equal, so that the key 0
+ * can stand for an identifier smaller than all the others.
+ *
+ * @param grid  The grid
+ * @param key1  The key of the first identifier
+ * @param id1   The first identifier, as a handle
+ * @param key2  The key of the second identifier
+ * @param id2   The second identifier, as a handle
+ * @return      A negative, zero or positive integer if the first identifier
+ *              is before, equal to or after the second one
+ */
+int compare_grid_identifiers(const struct BuildingGrid* grid, uint64_t key1,
+                             uint32_t id1, uint64_t key2, uint32_t id2) {
+  if (key1 != key2)
+    return key1 < key2 ? -1 : 1;
+  return compare_identifiers(key1, identifier_string(grid->ids, id1),
+                             key2, identifier_string(grid->ids, id2));
+}
+
+/**
+ * Compares a building to a building of a grid
+ *
+ * If they are overlapping, the first overlapping pair found is updated.
+ *
+ * @param grid      The grid
+ * @param building  The building
+ * @param key       The sort key of the identifier of the building
+ * @param id        The identifier of the building, as a handle
+ * @param other     The index of the building of the grid
+ * @param overlap   The first overlapping pair found
+ */
+void compare_to_grid_building(const struct BuildingGrid* grid,
+                              const struct Building* building, uint64_t key,
+                              uint32_t id, unsigned int other,
+                              struct GridOverlap* overlap) {
+  const struct GridBuilding* stored = grid->buildings + other;
+  if (!are_intervals_overlapping((long long)building->x - building->w,
+                                 (long long)building->x + building->w,
+                                 (long long)stored->x - stored->w,
+                                 (long long)stored->x + stored->w) ||
+      !are_intervals_overlapping((long long)building->y - building->h,
+                                 (long long)building->y + building->h,
+                                 (long long)stored->y - stored->h,
+                                 (long long)stored->y + stored->h))
+    return;
+  bool is_first = compare_grid_identifiers(grid, key, id, stored->key,
+                                           stored->id) < 0;
+  uint64_t key1 = is_first ? key : stored->key,
+           key2 = is_first ? stored->key : key;
+  uint32_t id1 = is_first ? id : stored->id, id2 = is_first ? stored->id : id;
+  int comparison = !overlap->is_found ? -1
+                 : compare_grid_identifiers(grid, key1, id1,
+                                            overlap->first_key,
+                                            overlap->first_id);
+  if (comparison < 0 ||
+      (comparison == 0 &&
+       compare_grid_identifiers(grid, key2, id2, overlap->second_key,
+                                overlap->second_id) < 0)) {
+    overlap->is_found = true;
+    overlap->first_key = key1;
+    overlap->first_id = id1;
+    overlap->second_key = key2;
+    overlap->second_id = id2;
+  }
+}
+
+/**
+ * Compares a building to the buildings of a level of a grid it may overlap
+ *
+ * A building of the level overlapping the given one has its lower left
+ * corner less than 2^level before it, and before its upper right corner. The
+ * cells of the level have side 2^(level + 1).
+ *
+ * @param grid      The grid
+ * @param building  The building
+ * @param key       The sort key of the identifier of the building
+ * @param id        The identifier of the building, as a handle
+ * @param level     The level
+ * @param overlap   The first overlapping pair found
+ */
+void search_grid_level(const struct BuildingGrid* grid,
+                       const struct Building* building, uint64_t key,
+                       uint32_t id, unsigned int level,
+                       struct GridOverlap* overlap) {
+  long long side = 1ll << level;
+  unsigned int shift = level + 1;
+  long long cxmin = ((long long)building->x - building->w - side + 1) >> shift,
+            cxmax = ((long long)building->x + building->w - 1) >> shift,
+            cymin = ((long long)building->y - building->h - side + 1) >> shift,
+            cymax = ((long long)building->y + building->h - 1) >> shift;
+  unsigned long long nx = cxmax - cxmin + 1, ny = cymax - cymin + 1;
+  if (nx > grid->level_sizes[level] / ny) {
+    for (unsigned int other = grid->level_heads[level];
+         other != NO_GRID_BUILDING;
+         other = grid->buildings[other].next_in_level)
+      compare_to_grid_building(grid, building, key, id, other, overlap);
+    return;
+  }
+  for (long long cy = cymin; cy <= cymax; ++cy)
+    for (long long cx = cxmin; cx <= cxmax; ++cx) {
+      unsigned int other;
+      if (!find_in_hash_index(&grid->cells, grid_cell_key(level, cx, cy),
+                              &other))
+        continue;
+      for (; other != NO_GRID_BUILDING;
+           other = grid->buildings[other].next_in_cell)
+        compare_to_grid_building(grid, building, key, id, other, overlap);
+    }
+}
+
+/**
+ * Compares a building to the buildings of a grid it may overlap
+ *
+ * @param grid      The grid
+ * @param building  The building
+ * @param key       The sort key of the identifier of the building
+ * @param id        The identifier of the building, as a handle
+ * @param overlap   The first overlapping pair found
+ */
+void search_building_grid(const struct BuildingGrid* grid,
+                          const struct Building* building, uint64_t key,
+                          uint32_t id, struct GridOverlap* overlap) {
+  for (unsigned int level = 0; level < NUM_GRID_LEVELS; ++level)
+    if (grid->level_sizes[level] > 0)
+      search_grid_level(grid, building, key, id, level, overlap);
+}
+
+// Public functions definition
+// ===========================
+
+// Predicates
+// ----------
+
+bool are_intervals_overlapping(long long a1, long long b1,
+                               long long a2, long long b2) {
+  return (a1 > a2 ? a1 : a2) < (b1 < b2 ? b1 : b2);
+}
+
+bool are_building_overlapping(const struct Building* building1,
+                              const struct Building* building2) {
+  return are_intervals_overlapping((long long)building1->x - building1->w,
+                                   (long long)building1->x + building1->w,
+                                   (long long)building2->x - building2->w,
+                                   (long long)building2->x + building2->w) &&
+         are_intervals_overlapping((long long)building1->y - building1->h,
+                                   (long long)building1->y + building1->h,
+                                   (long long)building2->y - building2->h,
+                                   (long long)building2->y + building2->h);
+}
+
+// Search
+// ------
+
+bool find_overlapping_buildings(const struct Building* buildings,
+                                unsigned int num_buildings,
+                                unsigned int* b1, unsigned int* b2) {
+  if (num_buildings < 2)
+    return false;
+  struct Arena arena;
+  initialize_arena(&arena);
+  bool found = has_overlapping_buildings(buildings, num_buildings, &arena) &&
+               find_first_overlapping_pair(buildings, num_buildings,
+                                           b1, b2, &arena);
+  free_arena(&arena);
+  return found;
+}
+
+bool find_overlapping_buildings_in_parallel(const struct Building* buildings,
+                                            unsigned int num_buildings,
+                                            unsigned int* b1,
+                                            unsigned int* b2,
+                                            struct ThreadPool* pool) {
+  if (pool->num_threads == 1 || num_buildings < 2)
+    return find_overlapping_buildings(buildings, num_buildings, b1, b2);
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct OverlapTiling tiling;
+  tile_buildings(&tiling, buildings, num_buildings,
+                 TILES_PER_THREAD * pool->num_threads, &arena);
+  run_pool_tasks(pool, tiling.num_tiles, search_tile, &tiling);
+  bool found = false;
+  for (unsigned int t = 0; t < tiling.num_tiles; ++t)
+    found = found || tiling.is_overlapping[t];
+  found = found && find_first_overlapping_pair(buildings, num_buildings,
+                                               b1, b2, &arena);
+  free_arena(&arena);
+  return found;
+}
+
+bool find_overlapping_buildings_naive(const struct Building* buildings,
+                                      unsigned int num_buildings,
+                                      unsigned int* b1, unsigned int* b2) {
+  for (unsigned int i = 0; i < num_buildings; ++i)
+    for (unsigned int j = i + 1; j < num_buildings; ++j)
+      if (are_building_overlapping(buildings + i, buildings + j)) {
+        *b1 = i;
+        *b2 = j;
+        return true;
+      }
+  return false;
+}
+
+// Incremental search
+// ------------------
+
+void initialize_building_grid(struct BuildingGrid* grid,
+                              const struct IdentifierPool* ids,
+                              struct Arena* arena) {
+  initialize_hash_index(&grid->cells, 0, arena);
+  grid->num_buildings = 0;
+  grid->capacity_buildings = 0;
+  grid->buildings = NULL;
+  for (unsigned int level = 0; level < NUM_GRID_LEVELS; ++level) {
+    grid->level_heads[level] = NO_GRID_BUILDING;
+    grid->level_sizes[level] = 0;
+  }
+  grid->has_overlap = false;
+  grid->first_key = 0;
+  grid->first_id = 0;
+  grid->second_key = 0;
+  grid->second_id = 0;
+  grid->first_free = NO_GRID_BUILDING;
+  grid->ids = ids;
+  grid->arena = arena;
+}
+
+unsigned int insert_in_building_grid(struct BuildingGrid* grid,
+                                     const struct Building* building) {
+  struct GridOverlap overlap = {grid->has_overlap, grid->first_key,
+                                grid->first_id, grid->second_key,
+                                grid->second_id};
+  search_building_grid(grid, building, building->key, building->id,
+                       &overlap);
+  grid->has_overlap = overlap.is_found;
+  grid->first_key = overlap.first_key;
+  grid->first_id = overlap.first_id;
+  grid->second_key = overlap.second_key;
+  grid->second_id = overlap.second_id;
+  unsigned int b = grid->first_free;
+  if (b != NO_GRID_BUILDING) {
+    grid->first_free = grid->buildings[b].next_in_cell;
+  } else {
+    if (grid->num_buildings == grid->capacity_buildings) {
+      unsigned int capacity = grid->capacity_buildings == 0
+                              ? 16 : 2 * grid->capacity_buildings;
+      grid->buildings = arena_grow(grid->arena, grid->buildings,
+          grid->capacity_buildings * sizeof(struct GridBuilding),
+          capacity * sizeof(struct GridBuilding));
+      grid->capacity_buildings = capacity;
+    }
+    b = grid->num_buildings++;
+  }
+  unsigned int level = grid_level(building->w, building->h);
+  struct GridBuilding* stored = grid->buildings + b;
+  stored->x = building->x;
+  stored->y = building->y;
+  stored->w = building->w;
+  stored->h = building->h;
+  stored->key = building->key;
+  stored->id = building->id;
+  stored->previous_in_level = NO_GRID_BUILDING;
+  stored->next_in_level = grid->level_heads[level];
+  if (stored->next_in_level != NO_GRID_BUILDING)
+    grid->buildings[stored->next_in_level].previous_in_level = b;
+  grid->level_heads[level] = b;
+  ++grid->level_sizes[level];
+  // The building is chained after the first building of its cell, since the
+  // index cannot change the building associated with a cell
+  unsigned int first;
+  if (insert_in_hash_index(&grid->cells, building_cell_key(stored), b,
+                           &first)) {
+    stored->next_in_cell = NO_GRID_BUILDING;
+  } else {
+    stored->next_in_cell = grid->buildings[first].next_in_cell;
+    grid->buildings[first].next_in_cell = b;
+  }
+  return b;
+}
+
+void remove_from_building_grid(struct BuildingGrid* grid, unsigned int slot) {
+  struct GridBuilding* stored = grid->buildings + slot;
+  unsigned int level = grid_level(stored->w, stored->h);
+  if (stored->previous_in_level == NO_GRID_BUILDING)
+    grid->level_heads[level] = stored->next_in_level;
+  else
+    grid->buildings[stored->previous_in_level].next_in_level =
+      stored->next_in_level;
+  if (stored->next_in_level != NO_GRID_BUILDING)
+    grid->buildings[stored->next_in_level].previous_in_level =
+      stored->previous_in_level;
+  --grid->level_sizes[level];
+  // The first building of a cell is replaced in the index by the second one,
+  // and the others are unlinked from their predecessor
+  uint64_t cell_key = building_cell_key(stored);
+  unsigned int first;
+  find_in_hash_index(&grid->cells, cell_key, &first);
+  if (first == slot) {
+    remove_from_hash_index(&grid->cells, cell_key);
+    if (stored->next_in_cell != NO_GRID_BUILDING)
+      insert_in_hash_index(&grid->cells, cell_key, stored->next_in_cell,
+                           &first);
+  } else {
+    unsigned int previous = first;
+    while (grid->buildings[previous].next_in_cell != slot)
+      previous = grid->buildings[previous].next_in_cell;
+    grid->buildings[previous].next_in_cell = stored->next_in_cell;
+  }
+  stored->key = 0;
+  stored->next_in_cell = grid->first_free;
+  grid->first_free = slot;
+}
+
+bool find_in_building_grid(const struct BuildingGrid* grid,
+                           const struct Building* building, uint32_t* id) {
+  // With a key smaller than any other, the first pair is the one with the
+  // smallest identifier of the grid
+  struct GridOverlap overlap = {false, 0, 0, 0, 0};
+  search_building_grid(grid, building, 0, 0, &overlap);
+  if (overlap.is_found)
+    *id = overlap.second_id;
+  return overlap.is_found;
+}
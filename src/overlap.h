@@ -0,0 +1,237 @@
+#ifndef OVERLAP_H_
+#define OVERLAP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "hash.h"
+#include "identifier.h"
+#include "pool.h"
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The number of levels of a building grid
+#define NUM_GRID_LEVELS 33
+// The index marking the end of a chain of grid buildings
+#define NO_GRID_BUILDING 0xFFFFFFFFu
+
+// Types
+// -----
+
+// A building stored in a building grid
+struct GridBuilding {
+  // The x coordinate of the building
+  int x;
+  // The y coordinate of the building
+  int y;
+  // The half width of the building
+  int w;
+  // The half height of the building
+  int h;
+  // The sort key of the identifier of the building (0 for a free slot)
+  uint64_t key;
+  // The identifier of the building, as a handle in the pool of the grid
+  uint32_t id;
+  // The next building of the same cell, or the next free slot
+  unsigned int next_in_cell;
+  // The previous building of the same level
+  unsigned int previous_in_level;
+  // The next building of the same level
+  unsigned int next_in_level;
+};
+
+// A hierarchical grid of buildings, filled one building at a time
+//
+// A building whose larger side is at most 2^l is stored at level l, in the
+// cell of side 2^(l + 1) holding its lower left corner, so that each building
+// is stored once. A new building is compared to the buildings of the cells of
+// each level that it can reach, which are at most 2 x 2 for a building of the
+// same level, or to all the buildings of the level if there are fewer of them
+// than such cells. Distinct cells may share a hash key, which only costs
+// extra comparisons. The slots of the removed buildings are reused by the
+// next insertions.
+struct BuildingGrid {
+  // The index of a building of each nonempty cell, the others of the cell
+  // being chained through next_in_cell
+  struct HashIndex cells;
+  // The number of slots of buildings, free slots included
+  unsigned int num_buildings;
+  // The number of slots the grid can hold before growing
+  unsigned int capacity_buildings;
+  // The slots of buildings of the grid
+  struct GridBuilding* buildings;
+  // The first free slot (NO_GRID_BUILDING if none), the others being chained
+  // through next_in_cell
+  unsigned int first_free;
+  // The index of the first building of each level
+  unsigned int level_heads[NUM_GRID_LEVELS];
+  // The number of buildings of each level
+  unsigned int level_sizes[NUM_GRID_LEVELS];
+  // true if two buildings of the grid are overlapping
+  bool has_overlap;
+  // The key of the smaller identifier of the first overlapping pair, ordered
+  // by identifiers
+  uint64_t first_key;
+  // The smaller identifier of the first overlapping pair, as a handle
+  uint32_t first_id;
+  // The key of the larger identifier of the first overlapping pair
+  uint64_t second_key;
+  // The larger identifier of the first overlapping pair, as a handle
+  uint32_t second_id;
+  // The pool of the identifiers of the buildings
+  const struct IdentifierPool* ids;
+  // The arena from which the grid is allocated
+  struct Arena* arena;
+};
+
+// Predicates
+// ----------
+
+/**
+ * Indicates if two intervals are overlapping
+ *
+ * Two intervals are overlapping if their intersection has a strictly positive
+ * length.
+ *
+ * @param a1  The start of the first interval
+ * @param b1  The end of the first interval
+ * @param a2  The start of the second interval
+ * @param b2  The end of the second interval
+ * @return    true if and only if the intervals are overlapping
+ */
+bool are_intervals_overlapping(long long a1, long long b1,
+                               long long a2, long long b2);
+
+/**
+ * Indicates if two buildings are overlapping
+ *
+ * Two building are overlapping if their intersection has a strictly positive
+ * area.
+ *
+ * @param building1  The first building
+ * @param building2  The second building
+ * @return           true if and only if the buildings are overlapping
+ */
+bool are_building_overlapping(const struct Building* building1,
+                              const struct Building* building2);
+
+// Search
+// ------
+
+/**
+ * Finds the first pair of overlapping buildings
+ *
+ * The pairs (b1, b2), with b1 < b2, are ordered lexicographically, so that the
+ * reported pair is the one that a loop over all pairs would find first.
+ *
+ * The detection is a sweep along the x axis that keeps the active buildings
+ * ordered on y, which takes O(n log n) time. Only when an overlap exists are
+ * the buildings indexed by an R-tree and searched in order, which also takes
+ * O(n log n) time, to find the first pair.
+ *
+ * @param buildings      The buildings
+ * @param num_buildings  The number of buildings
+ * @param b1             The index of the first building of the pair
+ * @param b2             The index of the second building of the pair
+ * @return               true if and only if two buildings are overlapping
+ */
+bool find_overlapping_buildings(const struct Building* buildings,
+                                unsigned int num_buildings,
+                                unsigned int* b1, unsigned int* b2);
+
+/**
+ * Finds the first pair of overlapping buildings with a thread pool
+ *
+ * The plane is cut into vertical tiles holding as many buildings each, and
+ * the tiles are searched in parallel, since two overlapping buildings always
+ * share a tile. The reported pair is the same as find_overlapping_buildings.
+ *
+ * @param buildings      The buildings
+ * @param num_buildings  The number of buildings
+ * @param b1             The index of the first building of the pair
+ * @param b2             The index of the second building of the pair
+ * @param pool           The thread pool
+ * @return               true if and only if two buildings are overlapping
+ */
+bool find_overlapping_buildings_in_parallel(const struct Building* buildings,
+                                            unsigned int num_buildings,
+                                            unsigned int* b1,
+                                            unsigned int* b2,
+                                            struct ThreadPool* pool);
+
+/**
+ * Finds the first pair of overlapping buildings by testing all pairs
+ *
+ * This is the quadratic reference implementation of
+ * find_overlapping_buildings, and reports the same pair.
+ *
+ * @param buildings      The buildings
+ * @param num_buildings  The number of buildings
+ * @param b1             The index of the first building of the pair
+ * @param b2             The index of the second building of the pair
+ * @return               true if and only if two buildings are overlapping
+ */
+bool find_overlapping_buildings_naive(const struct Building* buildings,
+                                      unsigned int num_buildings,
+                                      unsigned int* b1, unsigned int* b2);
+
+// Incremental search
+// ------------------
+
+/**
+ * Initializes an empty building grid
+ *
+ * @param grid   The grid to initialize
+ * @param ids    The pool of the identifiers of the buildings
+ * @param arena  The arena from which the grid is allocated
+ */
+void initialize_building_grid(struct BuildingGrid* grid,
+                              const struct IdentifierPool* ids,
+                              struct Arena* arena);
+
+/**
+ * Inserts a building in a building grid
+ *
+ * The building is compared to every building of the grid it may overlap, and
+ * the first overlapping pair of the grid is updated, the pairs being ordered
+ * lexicographically on the identifiers of their buildings. When the buildings
+ * have comparable sizes, the insertion takes constant expected time.
+ *
+ * @param grid      The grid
+ * @param building  The building to insert, whose identifier is in the pool
+ *                  of the grid
+ * @return          The slot of the building in the grid
+ */
+unsigned int insert_in_building_grid(struct BuildingGrid* grid,
+                                     const struct Building* building);
+
+/**
+ * Removes a building from a building grid
+ *
+ * The first overlapping pair of the grid is left unchanged.
+ *
+ * @param grid  The grid
+ * @param slot  The slot of the building, as returned by
+ *              insert_in_building_grid
+ */
+void remove_from_building_grid(struct BuildingGrid* grid, unsigned int slot);
+
+/**
+ * Finds the building of a grid with the smallest identifier overlapping a
+ * building
+ *
+ * The grid is left unchanged, and the search costs as much as an insertion.
+ *
+ * @param grid      The grid
+ * @param building  The building
+ * @param id        The identifier of the building of the grid found, if any,
+ *                  as a handle
+ * @return          true if and only if a building of the grid overlaps it
+ */
+bool find_in_building_grid(const struct BuildingGrid* grid,
+                           const struct Building* building, uint32_t* id);
+
+#endif
@@ -0,0 +1,277 @@
+#include "placement.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "coverage.h"
+#include "hash.h"
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The initial capacity of the growable arrays
+#define INITIAL_ARRAY_CAPACITY 16
+
+// Types
+// -----
+
+// A site in the max-heap of the lazy greedy algorithm
+struct SiteGain {
+  // The number of uncovered buildings covered by the site (possibly stale)
+  unsigned int gain;
+  // The index of the site
+  unsigned int site;
+};
+
+// Storage
+// -------
+
+/**
+ * Grows an array allocated from an arena so that it can hold one more item
+ *
+ * @param items      The array (may be NULL if capacity is 0)
+ * @param capacity   The capacity of the array, updated if it grows
+ * @param size       The number of items in the array
+ * @param item_size  The size of an item, in bytes
+ * @param arena      The arena from which the array is allocated
+ * @return           The array, possibly moved
+ */
+void* reserve_one_more(void* items, unsigned int* capacity, unsigned int size,
+                       size_t item_size, struct Arena* arena) {
+  if (size < *capacity)
+    return items;
+  unsigned int grown = *capacity == 0 ? INITIAL_ARRAY_CAPACITY : 2 * *capacity;
+  items = arena_grow(arena, items, *capacity * item_size, grown * item_size);
+  *capacity = grown;
+  return items;
+}
+
+// Grid
+// ----
+
+/**
+ * Returns the largest integer not greater than a / b
+ *
+ * @param a  The numerator
+ * @param b  The denominator, which must be positive
+ * @return   floor(a / b)
+ */
+long long floor_division(long long a, long long b) {
+  return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * Returns the smallest integer not smaller than a / b
+ *
+ * @param a  The numerator
+ * @param b  The denominator, which must be positive
+ * @return   ceil(a / b)
+ */
+long long ceiling_division(long long a, long long b) {
+  return -floor_division(-a, b);
+}
+
+// Heap
+// ----
+
+/**
+ * Indicates if a site must be chosen before another one
+ *
+ * @param gain1  The first site
+ * @param gain2  The second site
+ * @return       true if the first site has a larger gain, or the same gain
+ *               and a smaller index
+ */
+bool is_better_site(const struct SiteGain* gain1,
+                    const struct SiteGain* gain2) {
+  return gain1->gain > gain2->gain ||
+         (gain1->gain == gain2->gain && gain1->site < gain2->site);
+}
+
+/**
+ * Moves an item of a max-heap down to its place
+ *
+ * @param heap  The heap
+ * @param size  The number of items of the heap
+ * @param i     The index of the item to move
+ */
+void sift_down(struct SiteGain* heap, unsigned int size, unsigned int i) {
+  struct SiteGain item = heap[i];
+  while (2 * i + 1 < size) {
+    unsigned int child = 2 * i + 1;
+    if (child + 1 < size && is_better_site(heap + child + 1, heap + child))
+      ++child;
+    if (!is_better_site(heap + child, &item))
+      break;
+    heap[i] = heap[child];
+    i = child;
+  }
+  heap[i] = item;
+}
+
+/**
+ * Returns the number of uncovered buildings covered by a site
+ *
+ * @param sites    The sites
+ * @param site     The index of the site
+ * @param covered  Indicates for each building if it is covered
+ * @return         The number of uncovered buildings
+ */
+unsigned int count_uncovered(const struct PlacementSites* sites,
+                             unsigned int site, const bool* covered) {
+  unsigned int count = 0;
+  for (unsigned int i = sites->site_offsets[site];
+       i < sites->site_offsets[site + 1]; ++i)
+    count += !covered[sites->site_buildings[i]];
+  return count;
+}
+
+// Public functions definition
+// ===========================
+
+// Computation
+// -----------
+
+bool find_placement_sites(const struct Scene* scene, int step, int radius,
+                          struct PlacementSites* sites, struct Arena* arena,
+                          struct Error* error) {
+  unsigned int num_buildings = scene->num_buildings,
+               capacity_sites = 0, num_pairs = 0, capacity_pairs = 0;
+  unsigned int* building_offsets =
+    arena_allocate(arena, (num_buildings + 1) * sizeof(unsigned int));
+  unsigned int* building_sites = NULL;
+  struct HashIndex positions;
+  initialize_hash_index(&positions, num_buildings, arena);
+  sites->num_sites = 0;
+  sites->positions = NULL;
+  building_offsets[0] = 0;
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    const struct Building* building = scene->buildings + b;
+    // A site covering the building lies at most radius - w (resp. h) away
+    // from its center along x (resp. y)
+    long long reach_x = (long long)radius - building->w,
+              reach_y = (long long)radius - building->h;
+    long long imin = ceiling_division(building->x - reach_x, step),
+              imax = floor_division(building->x + reach_x, step),
+              jmin = ceiling_division(building->y - reach_y, step),
+              jmax = floor_division(building->y + reach_y, step);
+    imin = imin < INT_MIN / step ? INT_MIN / step : imin;
+    imax = imax > INT_MAX / step ? INT_MAX / step : imax;
+    jmin = jmin < INT_MIN / step ? INT_MIN / step : jmin;
+    jmax = jmax > INT_MAX / step ? INT_MAX / step : jmax;
+    long long num_columns = imax - imin + 1, num_rows = jmax - jmin + 1;
+    if (num_columns > 0 && num_rows > 0 &&
+        num_columns > MAX_PLACEMENT_SITES_PER_BUILDING / num_rows)
+      return report_error_too_many_sites(error,
+          building_identifier(scene, building), radius, step);
+    for (long long j = jmin; j <= jmax; ++j)
+      for (long long i = imin; i <= imax; ++i) {
+        struct Antenna antenna = {0, 0, i * step, j * step, radius};
+        if (antenna_coverage(&antenna, building) != COVERAGE_FULL)
+          continue;
+        unsigned int site;
+        if (insert_in_hash_index(&positions,
+                                 position_key(antenna.x, antenna.y),
+                                 sites->num_sites, &site)) {
+          sites->positions = reserve_one_more(sites->positions,
+                                              &capacity_sites,
+                                              sites->num_sites,
+                                              sizeof(struct SitePosition),
+                                              arena);
+          site = sites->num_sites++;
+          sites->positions[site].x = antenna.x;
+          sites->positions[site].y = antenna.y;
+        }
+        building_sites = reserve_one_more(building_sites, &capacity_pairs,
+                                          num_pairs, sizeof(unsigned int),
+                                          arena);
+        building_sites[num_pairs++] = site;
+      }
+    if (num_pairs == building_offsets[b])
+      return report_error_uncoverable_building(error,
+          building_identifier(scene, building), radius);
+    building_offsets[b + 1] = num_pairs;
+  }
+  // The incidences are transposed from buildings to sites by counting
+  unsigned int num_sites = sites->num_sites;
+  sites->site_offsets =
+    arena_allocate(arena, (num_sites + 1) * sizeof(unsigned int));
+  sites->site_buildings =
+    arena_allocate(arena, num_pairs * sizeof(unsigned int));
+  memset(sites->site_offsets, 0, (num_sites + 1) * sizeof(unsigned int));
+  for (unsigned int p = 0; p < num_pairs; ++p)
+    ++sites->site_offsets[building_sites[p] + 1];
+  for (unsigned int s = 0; s < num_sites; ++s)
+    sites->site_offsets[s + 1] += sites->site_offsets[s];
+  unsigned int* next =
+    arena_allocate(arena, num_sites * sizeof(unsigned int));
+  memcpy(next, sites->site_offsets, num_sites * sizeof(unsigned int));
+  for (unsigned int b = 0; b < num_buildings; ++b)
+    for (unsigned int p = building_offsets[b]; p < building_offsets[b + 1];
+         ++p)
+      sites->site_buildings[next[building_sites[p]]++] = b;
+  return true;
+}
+
+bool place_antennas(struct Scene* scene, int step, int radius,
+                    struct Antenna** antennas, unsigned int* num_antennas,
+                    struct Arena* arena, struct Error* error) {
+  struct PlacementSites sites;
+  if (!find_placement_sites(scene, step, radius, &sites, arena, error))
+    return false;
+  unsigned int num_buildings = scene->num_buildings,
+               size = sites.num_sites;
+  bool* covered = arena_allocate(arena, num_buildings * sizeof(bool));
+  memset(covered, 0, num_buildings * sizeof(bool));
+  struct SiteGain* heap =
+    arena_allocate(arena, size * sizeof(struct SiteGain));
+  for (unsigned int s = 0; s < size; ++s) {
+    heap[s].gain = sites.site_offsets[s + 1] - sites.site_offsets[s];
+    heap[s].site = s;
+  }
+  for (unsigned int i = size / 2; i > 0; --i)
+    sift_down(heap, size, i - 1);
+  // Each chosen site covers at least one new building
+  unsigned int* chosen =
+    arena_allocate(arena, num_buildings * sizeof(unsigned int));
+  unsigned int num_chosen = 0, num_uncovered = num_buildings;
+  while (num_uncovered > 0) {
+    unsigned int site = heap[0].site,
+                 gain = count_uncovered(&sites, site, covered);
+    if (gain < heap[0].gain) {
+      heap[0].gain = gain;
+      sift_down(heap, size, 0);
+      continue;
+    }
+    chosen[num_chosen++] = site;
+    for (unsigned int i = sites.site_offsets[site];
+         i < sites.site_offsets[site + 1]; ++i)
+      covered[sites.site_buildings[i]] = true;
+    num_uncovered -= gain;
+    heap[0] = heap[--size];
+    sift_down(heap, size, 0);
+  }
+  unsigned int num_digits = 1;
+  for (unsigned int n = num_chosen; n >= 10; n /= 10)
+    ++num_digits;
+  *antennas = arena_allocate(arena, num_chosen * sizeof(struct Antenna));
+  for (unsigned int a = 0; a < num_chosen; ++a) {
+    struct Antenna* antenna = *antennas + a;
+    // The names have at most 11 characters, since num_chosen < 2^32
+    char id[12];
+    snprintf(id, sizeof(id), "a%0*u", num_digits, a + 1);
+    set_antenna_identifier(scene, antenna, id);
+    antenna->x = sites.positions[chosen[a]].x;
+    antenna->y = sites.positions[chosen[a]].y;
+    antenna->r = radius;
+  }
+  *num_antennas = num_chosen;
+  return true;
+}
@@ -0,0 +1,95 @@
+#ifndef PLACEMENT_H_
+#define PLACEMENT_H_
+
+#include "arena.h"
+#include "scene.h"
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The default radius of the placed antennas
+#define DEFAULT_PLACEMENT_RADIUS 10
+// The default spacing of the candidate sites
+#define DEFAULT_PLACEMENT_STEP 5
+// The maximum number of grid points enumerated around a building
+#define MAX_PLACEMENT_SITES_PER_BUILDING 65536
+
+// Types
+// -----
+
+// The position of a candidate site
+struct SitePosition {
+  // The x coordinate of the site
+  int x;
+  // The y coordinate of the site
+  int y;
+};
+
+// The candidate sites of a placement and the buildings they cover
+//
+// The sites are the points (i * step, j * step) covering fully at least one
+// building. The buildings covered by the site c are the indices
+// site_buildings[site_offsets[c]] to site_buildings[site_offsets[c + 1] - 1].
+struct PlacementSites {
+  // The number of sites
+  unsigned int num_sites;
+  // The positions of the sites
+  struct SitePosition* positions;
+  // The offsets of the buildings of each site (num_sites + 1 items)
+  unsigned int* site_offsets;
+  // The buildings covered by the sites
+  unsigned int* site_buildings;
+};
+
+// Computation
+// -----------
+
+/**
+ * Finds the candidate sites covering the buildings of a scene
+ *
+ * Each building only enumerates the grid points close enough to its center,
+ * and a hash index on the positions assigns an index to each site. The
+ * placement is rejected if a building has more than
+ * MAX_PLACEMENT_SITES_PER_BUILDING such points, which bounds the time and
+ * memory taken by each building.
+ *
+ * @param scene   The scene
+ * @param step    The spacing of the grid of candidate sites
+ * @param radius  The radius of the antennas
+ * @param sites   The resulting sites
+ * @param arena   The arena from which the sites are allocated
+ * @param error   The error reported if a building cannot be covered by an
+ *                antenna of the given radius on any site, or has too many
+ *                candidate sites
+ * @return        true if and only if every building has a site
+ */
+bool find_placement_sites(const struct Scene* scene, int step, int radius,
+                          struct PlacementSites* sites, struct Arena* arena,
+                          struct Error* error);
+
+/**
+ * Chooses antennas covering fully all the buildings of a scene
+ *
+ * The sites are chosen by the lazy greedy set cover algorithm: a max-heap
+ * holds the number of uncovered buildings of each site, which is only
+ * refreshed when the site reaches the top of the heap, since it can only
+ * decrease. The chosen antennas are named a1, a2, ..., with enough leading
+ * zeros so that the names are sorted, and their names are added to the pool
+ * of identifiers of the scene.
+ *
+ * @param scene         The scene
+ * @param step          The spacing of the grid of candidate sites
+ * @param radius        The radius of the antennas
+ * @param antennas      The resulting antennas
+ * @param num_antennas  The resulting number of antennas
+ * @param arena         The arena from which the antennas are allocated
+ * @param error         The error reported if a building cannot be covered,
+ *                      or has too many candidate sites
+ * @return              true if and only if every building is covered
+ */
+bool place_antennas(struct Scene* scene, int step, int radius,
+                    struct Antenna** antennas, unsigned int* num_antennas,
+                    struct Arena* arena, struct Error* error);
+
+#endif
@@ -0,0 +1,217 @@
+#include "pool.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Types
+// -----
+
+// The argument of a started thread
+struct WorkerArgument {
+  // The pool
+  struct ThreadPool* pool;
+  // The index of the worker
+  unsigned int worker;
+};
+
+// Deques
+// ------
+
+/**
+ * Takes a task from the bottom of a deque
+ *
+ * @param deque  The deque
+ * @param task   The task taken, if any
+ * @return       true if and only if a task was taken
+ */
+bool pop_task(struct WorkDeque* deque, unsigned int* task) {
+  pthread_mutex_lock(&deque->lock);
+  bool found = deque->top < deque->bottom;
+  if (found)
+    *task = --deque->bottom;
+  pthread_mutex_unlock(&deque->lock);
+  return found;
+}
+
+/**
+ * Takes a task from the top of a deque
+ *
+ * @param deque  The deque
+ * @param task   The task taken, if any
+ * @return       true if and only if a task was taken
+ */
+bool steal_task(struct WorkDeque* deque, unsigned int* task) {
+  pthread_mutex_lock(&deque->lock);
+  bool found = deque->top < deque->bottom;
+  if (found)
+    *task = deque->top++;
+  pthread_mutex_unlock(&deque->lock);
+  return found;
+}
+
+// Workers
+// -------
+
+/**
+ * Runs tasks of the current job until no worker has any left
+ *
+ * A worker runs its own tasks first, then steals tasks from the other
+ * workers, starting with its neighbor.
+ *
+ * @param pool    The pool
+ * @param worker  The index of the worker
+ */
+void work(struct ThreadPool* pool, unsigned int worker) {
+  unsigned int task;
+  while (pop_task(pool->deques + worker, &task))
+    pool->function(pool->context, task, worker);
+  for (unsigned int offset = 1; offset < pool->num_threads; ++offset) {
+    struct WorkDeque* victim =
+      pool->deques + (worker + offset) % pool->num_threads;
+    while (steal_task(victim, &task))
+      pool->function(pool->context, task, worker);
+  }
+}
+
+/**
+ * Runs the jobs of a pool in a started thread
+ *
+ * The signals are blocked in the thread, so that they are always handled by
+ * the calling thread.
+ *
+ * @param argument  The WorkerArgument of the thread
+ * @return          NULL
+ */
+void* run_worker(void* argument) {
+  sigset_t signals;
+  sigfillset(&signals);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+  struct WorkerArgument* worker_argument = argument;
+  struct ThreadPool* pool = worker_argument->pool;
+  unsigned int worker = worker_argument->worker;
+  free(worker_argument);
+  unsigned long num_jobs_done = 0;
+  pthread_mutex_lock(&pool->lock);
+  while (true) {
+    while (!pool->is_stopping && pool->num_jobs == num_jobs_done)
+      pthread_cond_wait(&pool->job_submitted, &pool->lock);
+    if (pool->is_stopping)
+      break;
+    num_jobs_done = pool->num_jobs;
+    pthread_mutex_unlock(&pool->lock);
+    work(pool, worker);
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->num_busy == 0)
+      pthread_cond_signal(&pool->job_finished);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+// Release
+// -------
+
+/**
+ * Stops the started threads of a pool and frees its memory
+ *
+ * @param pool         The pool
+ * @param num_started  The number of threads started
+ */
+void release_thread_pool(struct ThreadPool* pool, unsigned int num_started) {
+  pthread_mutex_lock(&pool->lock);
+  pool->is_stopping = true;
+  pthread_cond_broadcast(&pool->job_submitted);
+  pthread_mutex_unlock(&pool->lock);
+  for (unsigned int t = 0; t < num_started; ++t)
+    pthread_join(pool->threads[t], NULL);
+  for (unsigned int w = 0; w < pool->num_threads; ++w)
+    pthread_mutex_destroy(&pool->deques[w].lock);
+  pthread_cond_destroy(&pool->job_finished);
+  pthread_cond_destroy(&pool->job_submitted);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->deques);
+  free(pool->threads);
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+bool create_thread_pool(struct ThreadPool* pool, unsigned int num_threads,
+                        struct Error* error) {
+  pool->num_threads = num_threads;
+  pool->num_jobs = 0;
+  pool->num_busy = 0;
+  pool->is_stopping = false;
+  pool->function = NULL;
+  pool->context = NULL;
+  pool->threads = malloc(num_threads * sizeof(pthread_t));
+  pool->deques = malloc(num_threads * sizeof(struct WorkDeque));
+  if (pool->threads == NULL || pool->deques == NULL)
+    report_error_out_of_memory();
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->job_submitted, NULL);
+  pthread_cond_init(&pool->job_finished, NULL);
+  for (unsigned int w = 0; w < num_threads; ++w) {
+    pthread_mutex_init(&pool->deques[w].lock, NULL);
+    pool->deques[w].top = 0;
+    pool->deques[w].bottom = 0;
+  }
+  for (unsigned int t = 0; t + 1 < num_threads; ++t) {
+    struct WorkerArgument* argument = malloc(sizeof(struct WorkerArgument));
+    if (argument == NULL)
+      report_error_out_of_memory();
+    argument->pool = pool;
+    argument->worker = t + 1;
+    if (pthread_create(pool->threads + t, NULL, run_worker, argument) != 0) {
+      free(argument);
+      release_thread_pool(pool, t);
+      return report_error_cannot_start_thread(error);
+    }
+  }
+  return true;
+}
+
+void destroy_thread_pool(struct ThreadPool* pool) {
+  release_thread_pool(pool, pool->num_threads - 1);
+}
+
+// Jobs
+// ----
+
+void run_pool_tasks(struct ThreadPool* pool, unsigned int num_tasks,
+                    TaskFunction function, void* context) {
+  unsigned int num_threads = pool->num_threads;
+  for (unsigned int w = 0; w < num_threads; ++w) {
+    pool->deques[w].top = (unsigned long long)num_tasks * w / num_threads;
+    pool->deques[w].bottom =
+      (unsigned long long)num_tasks * (w + 1) / num_threads;
+  }
+  if (num_threads == 1) {
+    // Sequential runs take the tasks in order
+    for (unsigned int task = 0; task < num_tasks; ++task)
+      function(context, task, 0);
+    return;
+  }
+  pthread_mutex_lock(&pool->lock);
+  pool->function = function;
+  pool->context = context;
+  pool->num_busy = num_threads - 1;
+  ++pool->num_jobs;
+  pthread_cond_broadcast(&pool->job_submitted);
+  pthread_mutex_unlock(&pool->lock);
+  work(pool, 0);
+  pthread_mutex_lock(&pool->lock);
+  while (pool->num_busy > 0)
+    pthread_cond_wait(&pool->job_finished, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+}
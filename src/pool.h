@@ -0,0 +1,110 @@
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The maximum number of threads of a pool
+#define MAX_NUM_THREADS 256
+
+// Types
+// -----
+
+// A function running one task of a parallel job
+//
+// The worker is the index of the thread running the task, in
+// [0, num_threads), so that the function can use per-thread storage.
+typedef void (*TaskFunction)(void* context, unsigned int task,
+                             unsigned int worker);
+
+// A double-ended queue of tasks owned by a worker
+//
+// The tasks of a job are numbered, and a deque holds the contiguous range of
+// tasks [top, bottom). Its owner takes tasks from the bottom, and the other
+// workers steal them from the top when they run out of work.
+struct WorkDeque {
+  // The lock protecting the range
+  pthread_mutex_t lock;
+  // The first task of the range
+  unsigned int top;
+  // The end of the range
+  unsigned int bottom;
+};
+
+// A pool of threads running jobs made of independent tasks
+//
+// The calling thread is the worker 0 of every job, so that a pool of one
+// thread runs the tasks sequentially, in order, without starting any thread.
+struct ThreadPool {
+  // The number of workers, including the calling thread
+  unsigned int num_threads;
+  // The started threads (the first num_threads - 1 items)
+  pthread_t* threads;
+  // The deques of the workers (num_threads items)
+  struct WorkDeque* deques;
+  // The lock protecting the fields below
+  pthread_mutex_t lock;
+  // Signaled when a job is submitted or when the pool is destroyed
+  pthread_cond_t job_submitted;
+  // Signaled when the last started thread has finished a job
+  pthread_cond_t job_finished;
+  // The number of jobs submitted so far
+  unsigned long num_jobs;
+  // The number of started threads still working on the current job
+  unsigned int num_busy;
+  // true if the threads must exit
+  bool is_stopping;
+  // The function of the current job
+  TaskFunction function;
+  // The context of the current job
+  void* context;
+};
+
+// Construction
+// ------------
+
+/**
+ * Creates a thread pool
+ *
+ * If the threads cannot be started, those already started are stopped and
+ * the pool is released.
+ *
+ * @param pool         The pool to create
+ * @param num_threads  The number of workers (between 1 and MAX_NUM_THREADS)
+ * @param error        The error reported if the threads cannot be started
+ * @return             true if and only if the pool was created
+ */
+bool create_thread_pool(struct ThreadPool* pool, unsigned int num_threads,
+                        struct Error* error);
+
+/**
+ * Stops the threads of a pool and frees its memory
+ *
+ * @param pool  The pool to destroy
+ */
+void destroy_thread_pool(struct ThreadPool* pool);
+
+// Jobs
+// ----
+
+/**
+ * Runs the tasks 0 to num_tasks - 1 on the workers of a pool
+ *
+ * The tasks are first split in equal contiguous ranges, one per worker, and
+ * idle workers then steal tasks from the others. The function returns once
+ * all the tasks are done.
+ *
+ * @param pool       The pool
+ * @param num_tasks  The number of tasks
+ * @param function   The function running a task
+ * @param context    The context passed to the function
+ */
+void run_pool_tasks(struct ThreadPool* pool, unsigned int num_tasks,
+                    TaskFunction function, void* context);
+
+#endif
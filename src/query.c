@@ -0,0 +1,354 @@
+#include "query.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "radix.h"
+#include "rtree.h"
+#include "writer.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The number of queries answered together
+#define QUERY_BATCH_SIZE 65536
+// The initial capacity of the results of a batch
+#define INITIAL_RESULTS_CAPACITY 1024
+
+// The steps along a Hilbert curve: HILBERT_STEPS[orientation][2 * x bit +
+// y bit] is 4 times the quadrant of the point along the curve plus the
+// orientation of the curve in that quadrant, where the orientation tells if
+// the coordinates are swapped (2) and complemented (1)
+const unsigned char HILBERT_STEPS[4][4] = {
+  {2, 4, 15, 8}, {9, 14, 5, 3}, {0, 13, 6, 10}, {11, 7, 12, 1}
+};
+
+// Types
+// -----
+
+// The answer to a query, as a range of the results of its batch
+struct QueryAnswer {
+  // The index in the results of the first object found
+  unsigned int first;
+  // The number of buildings found, which come first
+  unsigned int num_buildings;
+  // The number of antennas found, which follow the buildings
+  unsigned int num_antennas;
+};
+
+// A batch of queries answered together
+//
+// The queries are answered in the order of the Hilbert curve through their
+// centers, so that consecutive searches visit the same nodes of the R-trees
+// while they are still in cache, and printed in the order in which they were
+// read.
+struct QueryBatch {
+  // The number of queries
+  unsigned int num_queries;
+  // The queries, in the order in which they were read
+  struct SceneQuery queries[QUERY_BATCH_SIZE];
+  // The answer to each query
+  struct QueryAnswer answers[QUERY_BATCH_SIZE];
+  // The Hilbert key of each query, with its index
+  struct KeyedIndex order[QUERY_BATCH_SIZE];
+  // The buffer of the sort of the keys
+  struct KeyedIndex buffer[QUERY_BATCH_SIZE];
+  // The number of objects found by the queries
+  unsigned int num_results;
+  // The number of objects that can be held before growing
+  unsigned int capacity_results;
+  // The indices of the objects found, sorted by index for each query and
+  // type of object
+  unsigned int* results;
+  // The arena from which the results are allocated
+  struct Arena arena;
+};
+
+// Geometry
+// --------
+
+/**
+ * Indicates if the disc of an antenna meets the window of a query
+ *
+ * The disc is given by its bounding box, as indexed, so that the antenna
+ * itself is not read. The squares are only computed when both distances are
+ * at most the radius, so that they cannot overflow.
+ *
+ * @param disc   The bounding box of the disc
+ * @param query  The query
+ * @return       true if and only if the disc and the window share a point
+ */
+bool is_disc_meeting_query(const struct RTreeBox* disc,
+                           const struct SceneQuery* query) {
+  long long x = (disc->xmin + disc->xmax) / 2,
+            y = (disc->ymin + disc->ymax) / 2,
+            r = (disc->xmax - disc->xmin) / 2;
+  // The distances from the center to the nearest point of the window
+  long long dx = x < query->xmin ? query->xmin - x
+               : x > query->xmax ? x - query->xmax : 0,
+            dy = y < query->ymin ? query->ymin - y
+               : y > query->ymax ? y - query->ymax : 0;
+  return dx <= r && dy <= r && dx * dx + dy * dy <= r * r;
+}
+
+/**
+ * Returns the key of a point along a Hilbert curve
+ *
+ * The curve fills the whole plane of int coordinates, so that points close
+ * on the curve are close in the plane. The key is computed from the most
+ * significant bits down, with a table giving, for the current orientation
+ * of the curve and the bits of the point, its quadrant along the curve and
+ * the orientation of the curve in that quadrant.
+ *
+ * @param x  The x coordinate of the point
+ * @param y  The y coordinate of the point
+ * @return   The index of the point along the curve
+ */
+uint64_t hilbert_key(int x, int y) {
+  // The coordinates are shifted to unsigned ones, keeping their order
+  uint32_t ux = (uint32_t)x ^ 0x80000000u, uy = (uint32_t)y ^ 0x80000000u;
+  uint64_t key = 0;
+  unsigned int orientation = 0;
+  for (int bit = 31; bit >= 0; --bit) {
+    unsigned int step = HILBERT_STEPS[orientation][((ux >> bit) & 1) << 1 |
+                                                   ((uy >> bit) & 1)];
+    key = key << 2 | step >> 2;
+    orientation = step & 3;
+  }
+  return key;
+}
+
+// Batches
+// -------
+
+/**
+ * Compares two object indices
+ *
+ * @param a  The first index
+ * @param b  The second index
+ * @return   A negative, zero or positive value as a is smaller than, equal
+ *           to or greater than b
+ */
+int compare_query_results(const void* a, const void* b) {
+  unsigned int i = *(const unsigned int*)a, j = *(const unsigned int*)b;
+  return (i > j) - (i < j);
+}
+
+/**
+ * Appends an object found by a query to the results of its batch
+ *
+ * @param batch   The batch
+ * @param object  The index of the object
+ */
+void append_query_result(struct QueryBatch* batch, unsigned int object) {
+  if (batch->num_results == batch->capacity_results) {
+    unsigned int capacity = batch->capacity_results == 0
+                          ? INITIAL_RESULTS_CAPACITY
+                          : 2 * batch->capacity_results;
+    batch->results = arena_grow(&batch->arena, batch->results,
+                                batch->capacity_results * sizeof(unsigned int),
+                                capacity * sizeof(unsigned int));
+    batch->capacity_results = capacity;
+  }
+  batch->results[batch->num_results++] = object;
+}
+
+/**
+ * Answers a query of a batch
+ *
+ * @param index  The index of the scene
+ * @param batch  The batch
+ * @param q      The index of the query in the batch
+ */
+void answer_query(const struct SceneIndex* index, struct QueryBatch* batch,
+                  unsigned int q) {
+  const struct SceneQuery* query = batch->queries + q;
+  struct QueryAnswer* answer = batch->answers + q;
+  struct RTreeBox box = {query->xmin, query->ymin, query->xmax, query->ymax};
+  struct RTreeSearch search;
+  unsigned int entry, slot;
+  answer->first = batch->num_results;
+  // The boxes of the buildings are their rectangles, so that every building
+  // found meets the window
+  if (query->kind != QUERY_ANTENNAS_AT_POINT) {
+    start_rtree_search(&search, &index->buildings, &box);
+    while (next_rtree_entry(&search, &entry))
+      append_query_result(batch, entry);
+  }
+  answer->num_buildings = batch->num_results - answer->first;
+  if (query->kind != QUERY_BUILDINGS_AT_POINT) {
+    const struct RTree* antennas = &index->antennas;
+    start_rtree_search(&search, antennas, &box);
+    while (next_rtree_slot(&search, &slot))
+      if (is_disc_meeting_query(antennas->boxes + slot, query))
+        append_query_result(batch, antennas->entries[slot]);
+  }
+  answer->num_antennas =
+    batch->num_results - answer->first - answer->num_buildings;
+  unsigned int* results = batch->results + answer->first;
+  if (answer->num_buildings > 1)
+    qsort(results, answer->num_buildings, sizeof(unsigned int),
+          compare_query_results);
+  if (answer->num_antennas > 1)
+    qsort(results + answer->num_buildings, answer->num_antennas,
+          sizeof(unsigned int), compare_query_results);
+}
+
+/**
+ * Answers the queries of a batch along the Hilbert curve
+ *
+ * @param index  The index of the scene
+ * @param batch  The batch
+ */
+void answer_query_batch(const struct SceneIndex* index,
+                        struct QueryBatch* batch) {
+  for (unsigned int q = 0; q < batch->num_queries; ++q) {
+    const struct SceneQuery* query = batch->queries + q;
+    batch->order[q].key =
+      hilbert_key((int)(((long long)query->xmin + query->xmax) / 2),
+                  (int)(((long long)query->ymin + query->ymax) / 2));
+    batch->order[q].index = q;
+  }
+  radix_sort(batch->order, batch->num_queries, batch->buffer);
+  batch->num_results = 0;
+  for (unsigned int i = 0; i < batch->num_queries; ++i)
+    answer_query(index, batch, batch->order[i].index);
+}
+
+/**
+ * Prints the identifiers of objects found by a query
+ *
+ * @param results      The indices of the objects
+ * @param num_results  The number of objects
+ * @param is_building  true if the objects are buildings, false if antennas
+ * @param scene        The scene
+ * @param writer       The writer
+ */
+void print_query_results(const unsigned int* results,
+                         unsigned int num_results, bool is_building,
+                         const struct Scene* scene, struct Writer* writer) {
+  for (unsigned int i = 0; i < num_results; ++i) {
+    write_char(writer, ' ');
+    write_string(writer, is_building
+        ? building_identifier(scene, scene->buildings + results[i])
+        : antenna_identifier(scene, scene->antennas + results[i]));
+  }
+}
+
+/**
+ * Prints the answers to the queries of a batch, in the order of the queries
+ *
+ * @param batch   The batch
+ * @param scene   The scene
+ * @param writer  The writer
+ */
+void print_query_batch(const struct QueryBatch* batch,
+                       const struct Scene* scene, struct Writer* writer) {
+  for (unsigned int q = 0; q < batch->num_queries; ++q) {
+    const struct SceneQuery* query = batch->queries + q;
+    const struct QueryAnswer* answer = batch->answers + q;
+    const unsigned int* buildings = batch->results + answer->first,
+                      * antennas = buildings + answer->num_buildings;
+    if (query->kind == QUERY_ANTENNAS_AT_POINT)
+      write_string(writer, "antennas ");
+    else if (query->kind == QUERY_BUILDINGS_AT_POINT)
+      write_string(writer, "buildings ");
+    else
+      write_string(writer, "window ");
+    write_int(writer, query->xmin);
+    write_char(writer, ' ');
+    write_int(writer, query->ymin);
+    if (query->kind == QUERY_WINDOW) {
+      write_char(writer, ' ');
+      write_int(writer, query->xmax);
+      write_char(writer, ' ');
+      write_int(writer, query->ymax);
+    }
+    write_char(writer, ':');
+    if (query->kind == QUERY_WINDOW && answer->num_buildings > 0)
+      write_string(writer, " buildings");
+    print_query_results(buildings, answer->num_buildings, true, scene,
+                        writer);
+    if (query->kind == QUERY_WINDOW && answer->num_antennas > 0)
+      write_string(writer, answer->num_buildings > 0 ? ", antennas"
+                                                     : " antennas");
+    print_query_results(antennas, answer->num_antennas, false, scene,
+                        writer);
+    write_char(writer, '\n');
+  }
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void build_scene_index(struct SceneIndex* index, const struct Scene* scene,
+                       struct Arena* arena) {
+  index->scene = scene;
+  struct RTreeBox* boxes =
+    arena_allocate(arena, scene->num_buildings * sizeof(struct RTreeBox));
+  for (unsigned int b = 0; b < scene->num_buildings; ++b) {
+    const struct Building* building = scene->buildings + b;
+    boxes[b].xmin = (long long)building->x - building->w;
+    boxes[b].ymin = (long long)building->y - building->h;
+    boxes[b].xmax = (long long)building->x + building->w;
+    boxes[b].ymax = (long long)building->y + building->h;
+  }
+  build_rtree(&index->buildings, boxes, scene->num_buildings, arena);
+  boxes = arena_allocate(arena, scene->num_antennas * sizeof(struct RTreeBox));
+  for (unsigned int a = 0; a < scene->num_antennas; ++a) {
+    const struct Antenna* antenna = scene->antennas + a;
+    boxes[a].xmin = (long long)antenna->x - antenna->r;
+    boxes[a].ymin = (long long)antenna->y - antenna->r;
+    boxes[a].xmax = (long long)antenna->x + antenna->r;
+    boxes[a].ymax = (long long)antenna->y + antenna->r;
+  }
+  build_rtree(&index->antennas, boxes, scene->num_antennas, arena);
+}
+
+// Queries
+// -------
+
+bool answer_scene_queries(const struct SceneIndex* index,
+                          struct LineReader* reader, FILE* file,
+                          struct Error* error) {
+  struct QueryBatch* batch = malloc(sizeof(struct QueryBatch));
+  if (batch == NULL)
+    report_error_out_of_memory();
+  batch->num_queries = 0;
+  batch->num_results = 0;
+  batch->capacity_results = 0;
+  batch->results = NULL;
+  initialize_arena(&batch->arena);
+  struct Writer writer;
+  open_writer(&writer, file);
+  bool success = true;
+  int line_number = 1;
+  struct StringView line;
+  while (success && read_next_line(reader, &line)) {
+    success = read_scene_query(line, line_number++,
+                               batch->queries + batch->num_queries, error);
+    if (success && ++batch->num_queries == QUERY_BATCH_SIZE) {
+      answer_query_batch(index, batch);
+      print_query_batch(batch, index->scene, &writer);
+      batch->num_queries = 0;
+    }
+  }
+  if (success && reader->has_failed)
+    success = report_error_cannot_read_file(error, reader->name);
+  // The queries preceding an invalid one are answered
+  answer_query_batch(index, batch);
+  print_query_batch(batch, index->scene, &writer);
+  close_writer(&writer);
+  free_arena(&batch->arena);
+  free(batch);
+  return success;
+}
@@ -0,0 +1,70 @@
+#ifndef QUERY_H_
+#define QUERY_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "input.h"
+#include "rtree.h"
+#include "scene.h"
+#include "validation.h"
+
+// Types
+// -----
+
+// A spatial index over the objects of a scene
+//
+// The buildings are indexed by their rectangles and the antennas by the
+// bounding boxes of their discs, in two static R-trees.
+struct SceneIndex {
+  // The indexed scene
+  const struct Scene* scene;
+  // The R-tree over the buildings
+  struct RTree buildings;
+  // The R-tree over the antennas
+  struct RTree antennas;
+};
+
+// Construction
+// ------------
+
+/**
+ * Builds a spatial index over the objects of a scene
+ *
+ * @param index  The resulting index
+ * @param scene  The scene, which must stay alive as long as the index
+ * @param arena  The arena from which the index is allocated
+ */
+void build_scene_index(struct SceneIndex* index, const struct Scene* scene,
+                       struct Arena* arena);
+
+// Queries
+// -------
+
+/**
+ * Answers the queries read from a query file
+ *
+ * The queries are read by batches, and the answer to each query is printed
+ * on one line, in the order of the queries, as
+ *
+ *   antennas X Y: ID...
+ *   buildings X Y: ID...
+ *   window X1 Y1 X2 Y2: buildings ID..., antennas ID...
+ *
+ * with the identifiers in increasing order. The window is printed with its
+ * minimum corner first, and an empty group is omitted. The first invalid
+ * query stops the answers, after the previous queries are answered.
+ *
+ * @param index   The index of the scene
+ * @param reader  The reader of the query file
+ * @param file    The file on which the answers are printed
+ * @param error   The error reported if a query is invalid or the query file
+ *                cannot be read
+ * @return        true if and only if all the queries were answered
+ */
+bool answer_scene_queries(const struct SceneIndex* index,
+                          struct LineReader* reader, FILE* file,
+                          struct Error* error);
+
+#endif
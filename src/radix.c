@@ -0,0 +1,52 @@
+#include "radix.h"
+
+#include <stdint.h>
+#include <string.h>
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The number of bits of a digit
+#define RADIX_BITS 8
+// The number of distinct digits
+#define RADIX_SIZE (1u << RADIX_BITS)
+// The number of digits of a key
+#define NUM_DIGITS (64 / RADIX_BITS)
+
+// Public functions definition
+// ===========================
+
+// Sorting
+// -------
+
+void radix_sort(struct KeyedIndex* items, unsigned int num_items,
+                struct KeyedIndex* buffer) {
+  unsigned int counts[NUM_DIGITS][RADIX_SIZE];
+  memset(counts, 0, sizeof(counts));
+  for (unsigned int i = 0; i < num_items; ++i)
+    for (unsigned int d = 0; d < NUM_DIGITS; ++d)
+      ++counts[d][(items[i].key >> (d * RADIX_BITS)) & (RADIX_SIZE - 1)];
+  struct KeyedIndex* source = items, * target = buffer;
+  for (unsigned int d = 0; d < NUM_DIGITS; ++d) {
+    unsigned int shift = d * RADIX_BITS, offset = 0;
+    if (num_items == 0 ||
+        counts[d][(source[0].key >> shift) & (RADIX_SIZE - 1)] == num_items)
+      continue;
+    for (unsigned int digit = 0; digit < RADIX_SIZE; ++digit) {
+      unsigned int count = counts[d][digit];
+      counts[d][digit] = offset;
+      offset += count;
+    }
+    for (unsigned int i = 0; i < num_items; ++i)
+      target[counts[d][(source[i].key >> shift) & (RADIX_SIZE - 1)]++] =
+        source[i];
+    struct KeyedIndex* swap = source;
+    source = target;
+    target = swap;
+  }
+  if (source != items)
+    memcpy(items, source, num_items * sizeof(struct KeyedIndex));
+}
@@ -0,0 +1,33 @@
+#ifndef RADIX_H_
+#define RADIX_H_
+
+#include <stdint.h>
+
+// Types
+// -----
+
+// An index associated with a 64-bit sort key
+struct KeyedIndex {
+  // The sort key
+  uint64_t key;
+  // The index
+  unsigned int index;
+};
+
+// Sorting
+// -------
+
+/**
+ * Sorts keyed indices by increasing key
+ *
+ * The sort is a stable least significant digit radix sort on bytes, which
+ * skips the bytes shared by all keys. It runs in O(n) time.
+ *
+ * @param items      The items to sort
+ * @param num_items  The number of items
+ * @param buffer     A buffer of at least num_items items
+ */
+void radix_sort(struct KeyedIndex* items, unsigned int num_items,
+                struct KeyedIndex* buffer);
+
+#endif
@@ -0,0 +1,253 @@
+#include "render.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "arena.h"
+#include "pool.h"
+#include "query.h"
+#include "rtree.h"
+#include "scene.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The number of items of a row of differences of a tile
+#define RENDER_DIFFERENCES_STRIDE (RENDER_TILE_SIZE + 1)
+// The number of differences of a worker (antennas, then buildings)
+#define RENDER_WORKER_DIFFERENCES \
+  (2 * RENDER_TILE_SIZE * RENDER_DIFFERENCES_STRIDE)
+
+// Types
+// -----
+
+// A band of rows of a map, rendered tile by tile
+struct RenderJob {
+  // The spatial index of the scene
+  const struct SceneIndex* index;
+  // The frame of the map
+  const struct RenderFrame* frame;
+  // The first row of the band
+  unsigned int first_row;
+  // The number of rows of the band
+  unsigned int num_rows;
+  // The gray levels of the pixels of the band, row by row
+  unsigned char* pixels;
+  // The differences of the counts of objects along the rows of the tiles
+  // (RENDER_WORKER_DIFFERENCES items per worker)
+  int* differences;
+};
+
+// Pixels
+// ------
+
+/**
+ * Indicates if the center of a pixel of a line lies in an interval
+ *
+ * @param origin  The coordinate of the start of the line
+ * @param step    The signed side of a pixel along the line
+ * @param pixel   The index of the pixel in the line
+ * @param min     The minimum of the interval
+ * @param max     The maximum of the interval
+ * @return        true if and only if min <= origin + (pixel + 0.5) * step
+ *                <= max
+ */
+bool is_pixel_center_in(double origin, double step, long long pixel,
+                        double min, double max) {
+  double center = origin + (pixel + 0.5) * step;
+  return center >= min && center <= max;
+}
+
+/**
+ * Finds the pixels of a line whose centers lie in an interval
+ *
+ * The bounds are estimated by a division, then corrected by testing the
+ * centers, so that a pixel is found if and only if is_pixel_center_in holds,
+ * whatever the tile in which it is searched.
+ *
+ * @param origin  The coordinate of the start of the line
+ * @param step    The signed side of a pixel along the line
+ * @param min     The minimum of the interval
+ * @param max     The maximum of the interval
+ * @param first   The first pixel searched
+ * @param end     The end of the pixels searched
+ * @param span    The first and last pixels found
+ * @return        true if and only if some pixel was found
+ */
+bool find_pixel_span(double origin, double step, double min, double max,
+                     long long first, long long end, long long span[2]) {
+  double low = ((step > 0 ? min : max) - origin) / step - 0.5,
+         high = ((step > 0 ? max : min) - origin) / step - 0.5;
+  if (low > end || high < first - 1)
+    return false;
+  long long i = low <= first ? first : (long long)ceil(low),
+            j = high >= end - 1 ? end - 1 : (long long)floor(high);
+  while (i <= j && !is_pixel_center_in(origin, step, i, min, max))
+    ++i;
+  while (i > first && is_pixel_center_in(origin, step, i - 1, min, max))
+    --i;
+  while (j >= i && !is_pixel_center_in(origin, step, j, min, max))
+    --j;
+  while (j + 1 < end && is_pixel_center_in(origin, step, j + 1, min, max))
+    ++j;
+  span[0] = i;
+  span[1] = j;
+  return i <= j;
+}
+
+// Tiles
+// -----
+
+/**
+ * Renders a tile of a band of a map
+ *
+ * The objects meeting the tile add 1 to the differences at the first pixel
+ * of each of their row spans, and subtract 1 after the last one, so that the
+ * prefix sums of the rows count the objects at each pixel.
+ *
+ * @param context  The RenderJob
+ * @param tile     The index of the tile in the band
+ * @param worker   The index of the worker running the task
+ */
+void render_tile(void* context, unsigned int tile, unsigned int worker) {
+  const struct RenderJob* job = context;
+  const struct RenderFrame* frame = job->frame;
+  const struct SceneIndex* index = job->index;
+  const struct Scene* scene = index->scene;
+  long long first_column = (long long)tile * RENDER_TILE_SIZE,
+            end_column = first_column + RENDER_TILE_SIZE < frame->width
+                       ? first_column + RENDER_TILE_SIZE : frame->width,
+            first_row = job->first_row,
+            end_row = first_row + job->num_rows;
+  int* antenna_differences =
+    job->differences + (size_t)worker * RENDER_WORKER_DIFFERENCES;
+  int* building_differences =
+    antenna_differences + RENDER_TILE_SIZE * RENDER_DIFFERENCES_STRIDE;
+  memset(antenna_differences, 0, RENDER_WORKER_DIFFERENCES * sizeof(int));
+  double scale = frame->scale;
+  // The box of the scene enclosing the centers of the pixels of the tile
+  struct RTreeBox box = {
+    floor(frame->xmin + (first_column + 0.5) * scale),
+    floor(frame->ymax - (end_row - 0.5) * scale),
+    ceil(frame->xmin + (end_column - 0.5) * scale),
+    ceil(frame->ymax - (first_row + 0.5) * scale)
+  };
+  struct RTreeSearch search;
+  unsigned int entry;
+  long long rows[2], columns[2];
+  start_rtree_search(&search, &index->buildings, &box);
+  while (next_rtree_entry(&search, &entry)) {
+    const struct Building* building = scene->buildings + entry;
+    if (!find_pixel_span(frame->ymax, -scale,
+                         (double)building->y - building->h,
+                         (double)building->y + building->h, first_row,
+                         end_row, rows) ||
+        !find_pixel_span(frame->xmin, scale,
+                         (double)building->x - building->w,
+                         (double)building->x + building->w, first_column,
+                         end_column, columns))
+      continue;
+    for (long long row = rows[0]; row <= rows[1]; ++row) {
+      int* differences = building_differences +
+                         (row - first_row) * RENDER_DIFFERENCES_STRIDE;
+      ++differences[columns[0] - first_column];
+      --differences[columns[1] + 1 - first_column];
+    }
+  }
+  start_rtree_search(&search, &index->antennas, &box);
+  while (next_rtree_entry(&search, &entry)) {
+    const struct Antenna* antenna = scene->antennas + entry;
+    double x = antenna->x, y = antenna->y, r = antenna->r;
+    if (!find_pixel_span(frame->ymax, -scale, y - r, y + r, first_row,
+                         end_row, rows))
+      continue;
+    for (long long row = rows[0]; row <= rows[1]; ++row) {
+      double dy = frame->ymax - (row + 0.5) * scale - y,
+             half = sqrt(r * r - dy * dy);
+      if (!find_pixel_span(frame->xmin, scale, x - half, x + half,
+                           first_column, end_column, columns))
+        continue;
+      int* differences = antenna_differences +
+                         (row - first_row) * RENDER_DIFFERENCES_STRIDE;
+      ++differences[columns[0] - first_column];
+      --differences[columns[1] + 1 - first_column];
+    }
+  }
+  for (long long row = first_row; row < end_row; ++row) {
+    const int* antennas = antenna_differences +
+                          (row - first_row) * RENDER_DIFFERENCES_STRIDE,
+             * buildings = building_differences +
+                           (row - first_row) * RENDER_DIFFERENCES_STRIDE;
+    unsigned char* pixels = job->pixels +
+                            (size_t)(row - first_row) * frame->width +
+                            first_column;
+    int num_antennas = 0, num_buildings = 0;
+    for (long long c = 0; c < end_column - first_column; ++c) {
+      num_antennas += antennas[c];
+      num_buildings += buildings[c];
+      pixels[c] = (num_buildings > 0 ? RENDER_BUILDING_LEVEL : 0) +
+                  (num_antennas < RENDER_MAX_ANTENNAS
+                   ? num_antennas : RENDER_MAX_ANTENNAS) *
+                  RENDER_ANTENNA_LEVEL;
+    }
+  }
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void compute_render_frame(const struct Scene* scene, unsigned int resolution,
+                          struct RenderFrame* frame) {
+  struct SceneAggregates aggregates;
+  compute_scene_aggregates(scene, &aggregates);
+  if (scene_is_empty(scene)) {
+    aggregates.xmin = aggregates.xmax = 0;
+    aggregates.ymin = aggregates.ymax = 0;
+  }
+  double width = aggregates.xmax - aggregates.xmin,
+         height = aggregates.ymax - aggregates.ymin,
+         extent = width > height ? width : height;
+  frame->scale = (extent > 0 ? extent : 1) / resolution;
+  frame->xmin = aggregates.xmin;
+  frame->ymax = aggregates.ymax;
+  double columns = ceil(width / frame->scale),
+         rows = ceil(height / frame->scale);
+  frame->width = columns < 1 ? 1 : columns > resolution ? resolution
+                                                         : columns;
+  frame->height = rows < 1 ? 1 : rows > resolution ? resolution : rows;
+}
+
+// Rendering
+// ---------
+
+void render_scene(const struct SceneIndex* index,
+                  const struct RenderFrame* frame, struct ThreadPool* pool,
+                  FILE* file) {
+  struct Arena arena;
+  initialize_arena(&arena);
+  unsigned int num_tiles =
+    (frame->width + RENDER_TILE_SIZE - 1) / RENDER_TILE_SIZE;
+  struct RenderJob job = {
+    index, frame, 0, 0,
+    arena_allocate(&arena, (size_t)frame->width * RENDER_TILE_SIZE),
+    arena_allocate(&arena, (size_t)pool->num_threads *
+                           RENDER_WORKER_DIFFERENCES * sizeof(int))
+  };
+  fprintf(file, "P5\n%u %u\n255\n", frame->width, frame->height);
+  for (unsigned int row = 0; row < frame->height; row += RENDER_TILE_SIZE) {
+    job.first_row = row;
+    job.num_rows = frame->height - row < RENDER_TILE_SIZE
+                 ? frame->height - row : RENDER_TILE_SIZE;
+    run_pool_tasks(pool, num_tiles, render_tile, &job);
+    fwrite(job.pixels, 1, (size_t)frame->width * job.num_rows, file);
+  }
+  free_arena(&arena);
+}
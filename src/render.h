@@ -0,0 +1,86 @@
+#ifndef RENDER_H_
+#define RENDER_H_
+
+#include <stdio.h>
+
+#include "pool.h"
+#include "query.h"
+#include "scene.h"
+
+// Constants
+// ---------
+
+// The default number of pixels along the longest side of a rendered map
+#define DEFAULT_RENDER_RESOLUTION 1024
+// The maximum number of pixels along the longest side of a rendered map
+#define MAX_RENDER_RESOLUTION 65536
+// The number of pixels along each side of a tile rendered by a task
+#define RENDER_TILE_SIZE 256
+// The gray level added to the pixels inside a building
+#define RENDER_BUILDING_LEVEL 135
+// The gray level added by each antenna covering a pixel
+#define RENDER_ANTENNA_LEVEL 8
+// The number of antennas beyond which the gray level of a pixel saturates
+#define RENDER_MAX_ANTENNAS 15
+
+// Types
+// -----
+
+// The frame of a map, mapping its pixels to the plane of a scene
+//
+// The center of the pixel of column i and row j, counted from the top left
+// corner, is the point (xmin + (i + 0.5) * scale, ymax - (j + 0.5) * scale),
+// so that the y axis points up as in the scene.
+struct RenderFrame {
+  // The number of columns
+  unsigned int width;
+  // The number of rows
+  unsigned int height;
+  // The x coordinate of the left side
+  double xmin;
+  // The y coordinate of the top side
+  double ymax;
+  // The side of a pixel, in units of the scene
+  double scale;
+};
+
+// Construction
+// ------------
+
+/**
+ * Computes the frame of the map of a scene
+ *
+ * The map covers the bounding box of the scene, with resolution pixels along
+ * its longest side and square pixels.
+ *
+ * @param scene       The scene
+ * @param resolution  The number of pixels along the longest side (between 1
+ *                    and MAX_RENDER_RESOLUTION)
+ * @param frame       The resulting frame
+ */
+void compute_render_frame(const struct Scene* scene, unsigned int resolution,
+                          struct RenderFrame* frame);
+
+// Rendering
+// ---------
+
+/**
+ * Renders the coverage map of a scene as a binary PGM image
+ *
+ * The gray level of a pixel is RENDER_BUILDING_LEVEL if its center lies in a
+ * building (0 otherwise), plus RENDER_ANTENNA_LEVEL for each antenna whose
+ * disc contains its center, up to RENDER_MAX_ANTENNAS antennas. The image is
+ * computed by bands of RENDER_TILE_SIZE rows, whose tiles are rendered in
+ * parallel by the threads of the pool, each from the objects found by the
+ * index near the tile. The result does not depend on the number of threads.
+ *
+ * @param index  The spatial index of the scene
+ * @param frame  The frame of the map
+ * @param pool   The thread pool
+ * @param file   The file on which the image is written
+ */
+void render_scene(const struct SceneIndex* index,
+                  const struct RenderFrame* frame, struct ThreadPool* pool,
+                  FILE* file);
+
+#endif
@@ -0,0 +1,247 @@
+#include "rtree.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "radix.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Sorting
+// -------
+
+/**
+ * Returns a sort key preserving the order of a signed integer
+ *
+ * @param value  The integer
+ * @return       The key
+ */
+uint64_t signed_key(long long value) {
+  return (uint64_t)value ^ ((uint64_t)1 << 63);
+}
+
+/**
+ * Returns the number of items of a level packed in each vertical slice
+ *
+ * With n items, there are P = ceil(n / RTREE_NODE_CAPACITY) nodes to fill,
+ * arranged in S = ceil(sqrt(P)) slices of S full nodes each.
+ *
+ * @param num_items  The number of items of the level
+ * @return           The number of items in a slice
+ */
+unsigned int slice_size(unsigned int num_items) {
+  unsigned long long num_nodes =
+    (num_items + RTREE_NODE_CAPACITY - 1) / RTREE_NODE_CAPACITY;
+  unsigned long long num_slices = 1;
+  while (num_slices * num_slices < num_nodes)
+    ++num_slices;
+  return num_slices * RTREE_NODE_CAPACITY;
+}
+
+/**
+ * Orders boxes according to the Sort-Tile-Recursive algorithm
+ *
+ * The boxes are sorted by x center, then each slice is sorted by y center.
+ *
+ * @param boxes      The boxes
+ * @param num_boxes  The number of boxes
+ * @param items      The resulting indices of the boxes, in STR order
+ * @param buffer     A buffer of at least num_boxes items
+ */
+void str_order(const struct RTreeBox* boxes, unsigned int num_boxes,
+               struct KeyedIndex* items, struct KeyedIndex* buffer) {
+  for (unsigned int i = 0; i < num_boxes; ++i) {
+    items[i].key = signed_key(boxes[i].xmin + boxes[i].xmax);
+    items[i].index = i;
+  }
+  radix_sort(items, num_boxes, buffer);
+  unsigned int size = slice_size(num_boxes);
+  for (unsigned int start = 0; start < num_boxes; start += size) {
+    unsigned int length = num_boxes - start < size ? num_boxes - start : size;
+    for (unsigned int i = start; i < start + length; ++i) {
+      const struct RTreeBox* box = boxes + items[i].index;
+      items[i].key = signed_key(box->ymin + box->ymax);
+    }
+    radix_sort(items + start, length, buffer);
+  }
+}
+
+// Packing
+// -------
+
+/**
+ * Extends a box so that it encloses another one
+ *
+ * @param box    The box to extend
+ * @param other  The box to enclose
+ */
+void extend_box(struct RTreeBox* box, const struct RTreeBox* other) {
+  box->xmin = other->xmin < box->xmin ? other->xmin : box->xmin;
+  box->ymin = other->ymin < box->ymin ? other->ymin : box->ymin;
+  box->xmax = other->xmax > box->xmax ? other->xmax : box->xmax;
+  box->ymax = other->ymax > box->ymax ? other->ymax : box->ymax;
+}
+
+/**
+ * Returns the number of nodes obtained by packing a level
+ *
+ * @param num_items  The number of items of the level
+ * @return           The number of nodes of the next level
+ */
+unsigned int count_packed_nodes(unsigned int num_items) {
+  unsigned int size = slice_size(num_items), num_nodes = 0;
+  for (unsigned int start = 0; start < num_items; start += size) {
+    unsigned int length = num_items - start < size ? num_items - start : size;
+    num_nodes += (length + RTREE_NODE_CAPACITY - 1) / RTREE_NODE_CAPACITY;
+  }
+  return num_nodes;
+}
+
+/**
+ * Packs a level of items in STR order into nodes
+ *
+ * The nodes never straddle two slices.
+ *
+ * @param boxes      The boxes of the items
+ * @param first      The index of the first item
+ * @param num_items  The number of items
+ * @param nodes      The resulting nodes
+ * @return           The number of nodes
+ */
+unsigned int pack_level(const struct RTreeBox* boxes, unsigned int first,
+                        unsigned int num_items, struct RTreeNode* nodes) {
+  unsigned int size = slice_size(num_items), num_nodes = 0;
+  for (unsigned int start = 0; start < num_items; start += size) {
+    unsigned int end = num_items - start < size ? num_items : start + size;
+    for (unsigned int i = start; i < end; i += RTREE_NODE_CAPACITY) {
+      struct RTreeNode* node = nodes + num_nodes++;
+      node->first = first + i;
+      node->count = end - i < RTREE_NODE_CAPACITY
+                  ? end - i : RTREE_NODE_CAPACITY;
+      node->box = boxes[i];
+      for (unsigned int c = i + 1; c < i + node->count; ++c)
+        extend_box(&node->box, boxes + c);
+    }
+  }
+  return num_nodes;
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void build_rtree(struct RTree* tree, const struct RTreeBox* boxes,
+                 unsigned int num_boxes, struct Arena* arena) {
+  unsigned int level_size = count_packed_nodes(num_boxes),
+               num_nodes = level_size;
+  while (level_size > 1) {
+    level_size = count_packed_nodes(level_size);
+    num_nodes += level_size;
+  }
+  tree->num_entries = num_boxes;
+  tree->entries = arena_allocate(arena, num_boxes * sizeof(unsigned int));
+  tree->boxes = arena_allocate(arena, num_boxes * sizeof(struct RTreeBox));
+  tree->nodes = arena_allocate(arena, num_nodes * sizeof(struct RTreeNode));
+  struct KeyedIndex* items =
+    arena_allocate(arena, num_boxes * sizeof(struct KeyedIndex));
+  struct KeyedIndex* buffer =
+    arena_allocate(arena, num_boxes * sizeof(struct KeyedIndex));
+  str_order(boxes, num_boxes, items, buffer);
+  for (unsigned int e = 0; e < num_boxes; ++e) {
+    tree->entries[e] = items[e].index;
+    tree->boxes[e] = boxes[items[e].index];
+  }
+  tree->num_leaves = pack_level(tree->boxes, 0, num_boxes, tree->nodes);
+  tree->num_nodes = tree->num_leaves;
+  struct RTreeBox* level_boxes =
+    arena_allocate(arena, tree->num_leaves * sizeof(struct RTreeBox));
+  struct RTreeNode* level_nodes =
+    arena_allocate(arena, tree->num_leaves * sizeof(struct RTreeNode));
+  unsigned int level_start = 0;
+  level_size = tree->num_leaves;
+  while (level_size > 1) {
+    struct RTreeNode* level = tree->nodes + level_start;
+    for (unsigned int i = 0; i < level_size; ++i)
+      level_boxes[i] = level[i].box;
+    str_order(level_boxes, level_size, items, buffer);
+    for (unsigned int i = 0; i < level_size; ++i)
+      level_nodes[i] = level[items[i].index];
+    for (unsigned int i = 0; i < level_size; ++i) {
+      level[i] = level_nodes[i];
+      level_boxes[i] = level_nodes[i].box;
+    }
+    level_size = pack_level(level_boxes, level_start, level_size,
+                            tree->nodes + tree->num_nodes);
+    level_start = tree->num_nodes;
+    tree->num_nodes += level_size;
+  }
+}
+
+// Predicates
+// ----------
+
+bool are_boxes_intersecting(const struct RTreeBox* box1,
+                            const struct RTreeBox* box2) {
+  // The four comparisons are combined without branching, since their
+  // outcomes are hard to predict during a search
+  return (box1->xmin <= box2->xmax) & (box2->xmin <= box1->xmax) &
+         (box1->ymin <= box2->ymax) & (box2->ymin <= box1->ymax);
+}
+
+// Search
+// ------
+
+void start_rtree_search(struct RTreeSearch* search, const struct RTree* tree,
+                        const struct RTreeBox* box) {
+  search->tree = tree;
+  search->box = *box;
+  search->stack_size = 0;
+  search->next_entry = 0;
+  search->end_entry = 0;
+  if (tree->num_nodes > 0 &&
+      are_boxes_intersecting(&tree->nodes[tree->num_nodes - 1].box, box))
+    search->stack[search->stack_size++] = tree->num_nodes - 1;
+}
+
+bool next_rtree_entry(struct RTreeSearch* search, unsigned int* entry) {
+  unsigned int slot;
+  if (!next_rtree_slot(search, &slot))
+    return false;
+  *entry = search->tree->entries[slot];
+  return true;
+}
+
+bool next_rtree_slot(struct RTreeSearch* search, unsigned int* slot) {
+  const struct RTree* tree = search->tree;
+  while (true) {
+    while (search->next_entry < search->end_entry) {
+      unsigned int e = search->next_entry++;
+      if (are_boxes_intersecting(tree->boxes + e, &search->box)) {
+        *slot = e;
+        return true;
+      }
+    }
+    if (search->stack_size == 0)
+      return false;
+    unsigned int n = search->stack[--search->stack_size];
+    const struct RTreeNode* node = tree->nodes + n;
+    if (n < tree->num_leaves) {
+      search->next_entry = node->first;
+      search->end_entry = node->first + node->count;
+    } else {
+      // The stack holds at most RTREE_NODE_CAPACITY - 1 nodes per level.
+      // Each child is written on top of it, and kept if it intersects the
+      // searched box, without branching.
+      unsigned int size = search->stack_size;
+      for (unsigned int c = node->first; c < node->first + node->count; ++c) {
+        search->stack[size] = c;
+        size += are_boxes_intersecting(&tree->nodes[c].box, &search->box);
+      }
+      search->stack_size = size;
+    }
+  }
+}
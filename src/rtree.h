@@ -0,0 +1,144 @@
+#ifndef RTREE_H_
+#define RTREE_H_
+
+#include <stdbool.h>
+
+#include "arena.h"
+
+// Constants
+// ---------
+
+// The maximum number of children of a node
+#define RTREE_NODE_CAPACITY 16
+// The maximum number of nodes waiting to be visited during a search
+#define RTREE_STACK_CAPACITY 256
+
+// Types
+// -----
+
+// An axis-aligned box, with inclusive bounds
+struct RTreeBox {
+  // The minimum x coordinate
+  long long xmin;
+  // The minimum y coordinate
+  long long ymin;
+  // The maximum x coordinate
+  long long xmax;
+  // The maximum y coordinate
+  long long ymax;
+};
+
+// A node of an R-tree
+struct RTreeNode {
+  // The box enclosing the children of the node
+  struct RTreeBox box;
+  // The index of the first child (an entry for a leaf, a node otherwise)
+  unsigned int first;
+  // The number of children
+  unsigned int count;
+};
+
+// A static R-tree over a set of boxes
+//
+// The tree is bulk loaded with the Sort-Tile-Recursive (STR) algorithm: the
+// boxes of each level are sorted by x center, cut into vertical slices, and
+// each slice is sorted by y center before being packed into full nodes. The
+// leaves are the first nodes, and the root is the last one. All its memory is
+// allocated from an arena.
+struct RTree {
+  // The number of entries
+  unsigned int num_entries;
+  // The indices of the entries, in leaf order
+  unsigned int* entries;
+  // The boxes of the entries, in leaf order
+  struct RTreeBox* boxes;
+  // The number of leaves (the nodes whose children are entries)
+  unsigned int num_leaves;
+  // The number of nodes
+  unsigned int num_nodes;
+  // The nodes
+  struct RTreeNode* nodes;
+};
+
+// A search in an R-tree, visiting the entries intersecting a box
+struct RTreeSearch {
+  // The tree
+  const struct RTree* tree;
+  // The searched box
+  struct RTreeBox box;
+  // The nodes waiting to be visited
+  unsigned int stack[RTREE_STACK_CAPACITY];
+  // The number of nodes waiting to be visited
+  unsigned int stack_size;
+  // The next entry of the current leaf
+  unsigned int next_entry;
+  // The end of the entries of the current leaf
+  unsigned int end_entry;
+};
+
+// Construction
+// ------------
+
+/**
+ * Builds an R-tree over a set of boxes
+ *
+ * The entry i of the tree is the box boxes[i]. It runs in O(n log n) time.
+ *
+ * @param tree       The resulting tree
+ * @param boxes      The boxes
+ * @param num_boxes  The number of boxes
+ * @param arena      The arena from which the tree is allocated
+ */
+void build_rtree(struct RTree* tree, const struct RTreeBox* boxes,
+                 unsigned int num_boxes, struct Arena* arena);
+
+// Predicates
+// ----------
+
+/**
+ * Indicates if two boxes intersect
+ *
+ * @param box1  The first box
+ * @param box2  The second box
+ * @return      true if and only if the boxes share at least one point
+ */
+bool are_boxes_intersecting(const struct RTreeBox* box1,
+                            const struct RTreeBox* box2);
+
+// Search
+// ------
+
+/**
+ * Starts a search for the entries of an R-tree intersecting a box
+ *
+ * @param search  The resulting search
+ * @param tree    The tree
+ * @param box     The searched box
+ */
+void start_rtree_search(struct RTreeSearch* search, const struct RTree* tree,
+                        const struct RTreeBox* box);
+
+/**
+ * Returns the next entry found by a search
+ *
+ * The entries are returned in no particular order.
+ *
+ * @param search  The search
+ * @param entry   The index of the entry found, if any
+ * @return        true if and only if an entry was found
+ */
+bool next_rtree_entry(struct RTreeSearch* search, unsigned int* entry);
+
+/**
+ * Returns the position in leaf order of the next entry found by a search
+ *
+ * The entry found is tree->entries[slot], and its box tree->boxes[slot],
+ * which lies next to the boxes of the entries found before it.
+ *
+ * @param search  The search
+ * @param slot    The position of the entry found, if any
+ * @return        true if and only if an entry was found
+ */
+bool next_rtree_slot(struct RTreeSearch* search, unsigned int* slot);
+
+#endif
@@ -1,11 +1,25 @@
 #include "scene.h"
 
 #include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "binary.h"
+#include "hash.h"
+#include "identifier.h"
+#include "input.h"
+#include "overlap.h"
+#include "pool.h"
+#include "radix.h"
+#include "stats.h"
 #include "validation.h"
+#include "writer.h"
 
 // Private constants, types and functions
 // ======================================
@@ -13,115 +27,523 @@
 // Constants
 // ---------
 
-// The maximum length of a line in a scene stream
-#define MAX_LENGTH 50
-// The maximum number of tokens in a line
-#define MAX_NUM_TOKENS 6
-// The maximum length of a token in a line
-#define MAX_TOKEN_LENGTH 10
+// The maximum number of tokens kept from a line
+#define MAX_NUM_TOKENS 7
+// The size of the chunks of a text scene parsed in parallel, in bytes
+#define PARSE_CHUNK_SIZE (1 << 20)
 
 // Types
 // -----
 
 // A parsed line
+//
+// The tokens are views on the input, so that parsing a line copies nothing.
 struct ParsedLine {
-  // The number of parsed token
+  // The number of tokens of the line (only the first MAX_NUM_TOKENS are kept)
   unsigned int num_tokens;
   // The tokens
-  char tokens[MAX_NUM_TOKENS][MAX_TOKEN_LENGTH];
+  struct StringView tokens[MAX_NUM_TOKENS];
   // The number of the line
   int line_number;
 };
 
+// A scene being loaded
+//
+// The objects are appended to the scene in the order they are read, and
+// sorted by identifier once the whole scene is loaded.
+struct SceneLoader {
+  // The scene in which the objects are loaded
+  struct Scene* scene;
+  // The arena holding the temporary loading structures
+  struct Arena arena;
+  // The index of the building identifiers
+  struct IdentifierIndex building_ids;
+  // The index of the antenna identifiers
+  struct IdentifierIndex antenna_ids;
+  // The measures of the loading (NULL if they are not measured)
+  struct RunStats* stats;
+  // The wall time spent appending objects, in seconds, if measured
+  double insert_time;
+};
+
+// A chunk of a text scene parsed by one task
+//
+// The chunks are made of whole lines, and their objects are parsed in their
+// own scene, without checking the identifiers, before being merged.
+struct SceneChunk {
+  // The text of the chunk
+  struct StringView text;
+  // The number of lines of the chunk
+  unsigned int num_lines;
+  // The number of the first line of the chunk
+  int first_line_number;
+  // The objects parsed, in the order of their lines
+  struct Scene objects;
+  // The index in the loaded scene of the first building of the chunk
+  unsigned int first_building;
+  // The index in the loaded scene of the first antenna of the chunk
+  unsigned int first_antenna;
+  // The offset in the pool of the loaded scene of the identifiers of the
+  // chunk
+  size_t first_id;
+  // true if the last line of the chunk is "end scene"
+  bool last_line;
+  // true if a line of the chunk is invalid
+  bool has_failed;
+  // The error of the first invalid line, if any
+  struct Error error;
+};
+
+// The merge of the chunks of a text scene into the loaded scene
+struct SceneChunkMerge {
+  // The loaded scene
+  struct Scene* scene;
+  // The chunks
+  struct SceneChunk* chunks;
+};
+
+// The two smallest identifiers of the antennas sharing a position
+struct PositionIds {
+  // The key of the smallest identifier
+  uint64_t first_key;
+  // The smallest identifier, as a handle
+  uint32_t first;
+  // The key of the second smallest identifier (0 if there is a single
+  // antenna)
+  uint64_t second_key;
+  // The second smallest identifier, as a handle
+  uint32_t second;
+};
+
+// A tied identifier, whose key is the key of other identifiers
+struct TiedIdentifier {
+  // The identifier
+  const char* id;
+  // The index of its object
+  unsigned int index;
+};
+
+// The incremental validation of a scene being streamed
+//
+// Only the identifiers, the buildings coordinates and the antenna positions
+// are kept, and the first invalid pairs are tracked as the objects are read,
+// so that they are the same as if the scene had been loaded.
+struct StreamValidator {
+  // The arena holding the validation structures
+  struct Arena arena;
+  // The identifiers of the objects
+  struct IdentifierPool ids;
+  // The index of the building identifiers
+  struct IdentifierIndex building_ids;
+  // The index of the antenna identifiers
+  struct IdentifierIndex antenna_ids;
+  // The buildings read
+  struct BuildingGrid buildings;
+  // The index in positions of each antenna position
+  struct HashIndex antenna_positions;
+  // The number of distinct antenna positions
+  unsigned int num_positions;
+  // The number of positions that can be held before growing
+  unsigned int capacity_positions;
+  // The identifiers of the antennas of each position
+  struct PositionIds* positions;
+};
+
 // Validation
 // ----------
 
 /**
- * Indicates if two intervals are overlapping
+ * Checks if the buildings of a scene are valid.
  *
- * @param a1  The start of the first interval
- * @param b1  The end of the first interval
- * @param a2  The start of the second interval
- * @param b2  The end of the second interval
+ * @param scene  The scene to validate
+ * @param pool   The thread pool
+ * @param error  The error, if the buildings are invalid
+ * @return       true if and only if the buildings are valid
  */
-bool are_intervals_overlapping(int a1, int b1, int a2, int b2) {
-  return (a1 <= a2 && a2 < b1 && b1 <= b2) ||
-         (a2 <= a1 && a1 < b2 && b2 <= b1);
+bool validate_buildings(const struct Scene* scene, struct ThreadPool* pool,
+                        struct Error* error) {
+  unsigned int b1, b2;
+  if (!find_overlapping_buildings_in_parallel(scene->buildings,
+                                              scene->num_buildings,
+                                              &b1, &b2, pool))
+    return true;
+  return report_error_overlapping_buildings(error,
+      building_identifier(scene, scene->buildings + b1),
+      building_identifier(scene, scene->buildings + b2));
 }
 
 /**
- * Indicates if two buildings are overlapping
+ * Checks if the antennas of a scene are valid.
  *
- * Two building are overlapping if their intersection has a strictly positive
- * area.
+ * @param scene  The scene to validate
+ * @param error  The error, if the antennas are invalid
+ * @return       true if and only if the antennas are valid
+ */
+bool validate_antennas(const struct Scene* scene, struct Error* error) {
+  // Each antenna is compared to the first antenna at its position, and the
+  // reported pair is the first one in the order of the pairs of indices
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct HashIndex positions;
+  initialize_hash_index(&positions, scene->num_antennas, &arena);
+  unsigned int a1 = 0, a2 = 0;
+  bool found = false;
+  for (unsigned int a = 0; a < scene->num_antennas; ++a) {
+    const struct Antenna* antenna = scene->antennas + a;
+    unsigned int first;
+    if (!insert_in_hash_index(&positions,
+                              position_key(antenna->x, antenna->y),
+                              a, &first) &&
+        (!found || first < a1)) {
+      a1 = first;
+      a2 = a;
+      found = true;
+    }
+  }
+  free_arena(&arena);
+  return !found || report_error_same_position_antennas(error,
+      antenna_identifier(scene, scene->antennas + a1),
+      antenna_identifier(scene, scene->antennas + a2));
+}
+
+// Storage
+// -------
+
+/**
+ * Returns the capacity to use when growing an array
  *
- * @param building1  The first building
- * @param building2  The second building
+ * @param capacity  The current capacity
+ * @return          The new capacity
  */
-bool are_building_overlapping(const struct Building* building1,
-                              const struct Building* building2) {
-  return are_intervals_overlapping(building1->x - building1->w,
-                                   building1->x + building1->w,
-                                   building2->x - building2->w,
-                                   building2->x + building2->w) &&
-         are_intervals_overlapping(building1->y - building1->h,
-                                   building1->y + building1->h,
-                                   building2->y - building2->h,
-                                   building2->y + building2->h);
+unsigned int grown_capacity(unsigned int capacity) {
+  return capacity == 0 ? 16 : 2 * capacity;
 }
 
 /**
- * Indicates if two antennas have the same position
+ * Ensures that a scene can hold a given number of buildings
  *
- * @param antenna1  The first antenna
- * @param antenna2  The second antenna
+ * @param scene          The scene
+ * @param num_buildings  The number of buildings
  */
-bool have_antennas_same_position(const struct Antenna* antenna1,
-                                 const struct Antenna* antenna2) {
-  return antenna1->x == antenna2->x && antenna1->y == antenna2->y;
+void reserve_buildings(struct Scene* scene, unsigned int num_buildings) {
+  scene->has_columns = false;
+  if (num_buildings <= scene->capacity_buildings)
+    return;
+  unsigned int capacity = grown_capacity(scene->capacity_buildings);
+  while (capacity < num_buildings)
+    capacity = grown_capacity(capacity);
+  scene->buildings = arena_grow(&scene->arena, scene->buildings,
+      scene->capacity_buildings * sizeof(struct Building),
+      capacity * sizeof(struct Building));
+  scene->capacity_buildings = capacity;
 }
 
 /**
- * Checks if the buildings of a scene are valid.
+ * Ensures that a scene can hold a given number of antennas
  *
- * @param scene  The scene to validate
+ * @param scene         The scene
+ * @param num_antennas  The number of antennas
  */
-void validate_buildings(const struct Scene* scene) {
-  for (unsigned int b1 = 0; b1 < scene->num_buildings; ++b1)
-    for (unsigned int b2 = b1 + 1; b2 < scene->num_buildings; ++b2) {
-      const struct Building* building1 = scene->buildings + b1,
-                           * building2 = scene->buildings + b2;
-      if (are_building_overlapping(building1, building2))
-        report_error_overlapping_buildings(building1->id, building2->id);
+void reserve_antennas(struct Scene* scene, unsigned int num_antennas) {
+  scene->has_columns = false;
+  if (num_antennas <= scene->capacity_antennas)
+    return;
+  unsigned int capacity = grown_capacity(scene->capacity_antennas);
+  while (capacity < num_antennas)
+    capacity = grown_capacity(capacity);
+  scene->antennas = arena_grow(&scene->arena, scene->antennas,
+      scene->capacity_antennas * sizeof(struct Antenna),
+      capacity * sizeof(struct Antenna));
+  scene->capacity_antennas = capacity;
+}
+
+/**
+ * Permutes objects into the order of their sorted keys
+ *
+ * The objects are permuted in place by following the cycles of the sorting
+ * permutation, so that each object is moved at most twice.
+ *
+ * @param objects      The objects to sort
+ * @param num_objects  The number of objects
+ * @param object_size  The size of an object, in bytes
+ * @param order        The sorted keys, with the index of their object
+ * @param arena        The arena used for temporary storage
+ * @return             The number of objects moved
+ */
+unsigned int permute_objects(void* objects, unsigned int num_objects,
+                             size_t object_size, struct KeyedIndex* order,
+                             struct Arena* arena) {
+  char* bytes = objects, * saved = arena_allocate(arena, object_size);
+  unsigned int num_moves = 0;
+  for (unsigned int i = 0; i < num_objects; ++i) {
+    if (order[i].index == i)
+      continue;
+    memcpy(saved, bytes + i * object_size, object_size);
+    unsigned int j = i;
+    while (order[j].index != i) {
+      unsigned int k = order[j].index;
+      memcpy(bytes + j * object_size, bytes + k * object_size, object_size);
+      order[j].index = j;
+      j = k;
+      ++num_moves;
     }
+    memcpy(bytes + j * object_size, saved, object_size);
+    order[j].index = j;
+    ++num_moves;
+  }
+  return num_moves;
 }
 
 /**
- * Checks if the antennas of a scene are valid.
+ * Returns the identifier of an object of a scene
  *
- * @param scene  The scene to validate
+ * @param scene        The scene
+ * @param is_building  true for a building, false for an antenna
+ * @param index        The index of the object
+ * @return             The identifier
+ */
+const char* object_identifier(const struct Scene* scene, bool is_building,
+                              unsigned int index) {
+  return is_building ? building_identifier(scene, scene->buildings + index)
+                     : antenna_identifier(scene, scene->antennas + index);
+}
+
+/**
+ * Compares two tied identifiers, by identifier and then by index
+ *
+ * @param a  The first tied identifier
+ * @param b  The second tied identifier
+ * @return   A negative, zero or positive integer if a is before, equal to or
+ *           after b
  */
-void validate_antennas(const struct Scene* scene) {
-  for (unsigned int a1 = 0; a1 < scene->num_antennas; ++a1)
-    for (unsigned int a2 = a1 + 1; a2 < scene->num_antennas; ++a2) {
-      const struct Antenna* antenna1 = scene->antennas + a1,
-                          * antenna2 = scene->antennas + a2;
-      if (have_antennas_same_position(antenna1, antenna2))
-        report_error_same_position_antennas(antenna1->id, antenna2->id);
+int compare_tied_identifiers(const void* a, const void* b) {
+  const struct TiedIdentifier* tied1 = a, * tied2 = b;
+  int comparison = strcmp(tied1->id, tied2->id);
+  if (comparison != 0)
+    return comparison;
+  return (tied1->index > tied2->index) - (tied1->index < tied2->index);
+}
+
+/**
+ * Sorts by identifier the runs of equal keys of sorted identifier keys
+ *
+ * Only identifiers sharing their first IDENTIFIER_KEY_LENGTH characters can
+ * have equal keys, and they are then compared as strings. The objects with
+ * the same identifier are left in the order of their indices.
+ *
+ * @param order        The sorted keys, with the index of their object
+ * @param num_objects  The number of objects
+ * @param scene        The scene of the objects
+ * @param is_building  true for buildings, false for antennas
+ * @param arena        The arena used for temporary storage
+ */
+void sort_tied_keys(struct KeyedIndex* order, unsigned int num_objects,
+                    const struct Scene* scene, bool is_building,
+                    struct Arena* arena) {
+  unsigned int first = 0;
+  while (first < num_objects) {
+    unsigned int last = first + 1;
+    while (last < num_objects && order[last].key == order[first].key)
+      ++last;
+    // A key ending with the digit 0 encodes its whole identifier
+    if (last - first > 1 && (order[first].key & 63) != 0) {
+      struct TiedIdentifier* tied =
+        arena_allocate(arena, (last - first) * sizeof(struct TiedIdentifier));
+      for (unsigned int i = first; i < last; ++i) {
+        tied[i - first].id = object_identifier(scene, is_building,
+                                               order[i].index);
+        tied[i - first].index = order[i].index;
+      }
+      qsort(tied, last - first, sizeof(struct TiedIdentifier),
+            compare_tied_identifiers);
+      for (unsigned int i = first; i < last; ++i)
+        order[i].index = tied[i - first].index;
     }
+    first = last;
+  }
+}
+
+/**
+ * Returns the identifier keys of the buildings of a scene, in the order of
+ * their identifiers
+ *
+ * @param scene  The scene
+ * @param arena  The arena holding the keys
+ * @return       The sorted keys, with the index of their building
+ */
+struct KeyedIndex* sorted_building_keys(const struct Scene* scene,
+                                        struct Arena* arena) {
+  struct KeyedIndex* order =
+    arena_allocate(arena, scene->num_buildings * sizeof(struct KeyedIndex));
+  for (unsigned int b = 0; b < scene->num_buildings; ++b) {
+    order[b].key = scene->buildings[b].key;
+    order[b].index = b;
+  }
+  radix_sort(order, scene->num_buildings,
+             arena_allocate(arena,
+                            scene->num_buildings * sizeof(struct KeyedIndex)));
+  sort_tied_keys(order, scene->num_buildings, scene, true, arena);
+  return order;
+}
+
+/**
+ * Returns the identifier keys of the antennas of a scene, in the order of
+ * their identifiers
+ *
+ * @param scene  The scene
+ * @param arena  The arena holding the keys
+ * @return       The sorted keys, with the index of their antenna
+ */
+struct KeyedIndex* sorted_antenna_keys(const struct Scene* scene,
+                                       struct Arena* arena) {
+  struct KeyedIndex* order =
+    arena_allocate(arena, scene->num_antennas * sizeof(struct KeyedIndex));
+  for (unsigned int a = 0; a < scene->num_antennas; ++a) {
+    order[a].key = scene->antennas[a].key;
+    order[a].index = a;
+  }
+  radix_sort(order, scene->num_antennas,
+             arena_allocate(arena,
+                            scene->num_antennas * sizeof(struct KeyedIndex)));
+  sort_tied_keys(order, scene->num_antennas, scene, false, arena);
+  return order;
+}
+
+/**
+ * Sorts the buildings of a scene by identifier
+ *
+ * @param scene  The scene
+ * @param arena  The arena used for temporary storage
+ * @return       The number of buildings moved
+ */
+unsigned int sort_buildings(struct Scene* scene, struct Arena* arena) {
+  return permute_objects(scene->buildings, scene->num_buildings,
+                         sizeof(struct Building),
+                         sorted_building_keys(scene, arena), arena);
+}
+
+/**
+ * Sorts the antennas of a scene by identifier
+ *
+ * @param scene  The scene
+ * @param arena  The arena used for temporary storage
+ * @return       The number of antennas moved
+ */
+unsigned int sort_antennas(struct Scene* scene, struct Arena* arena) {
+  return permute_objects(scene->antennas, scene->num_antennas,
+                         sizeof(struct Antenna),
+                         sorted_antenna_keys(scene, arena), arena);
 }
 
 // Loading
 // -------
 
+/**
+ * Initializes a scene loader
+ *
+ * The objects already in the scene are indexed.
+ *
+ * @param loader  The loader to initialize
+ * @param scene   The scene in which the objects are loaded
+ */
+void initialize_scene_loader(struct SceneLoader* loader,
+                             struct Scene* scene) {
+  unsigned int existing;
+  loader->scene = scene;
+  loader->stats = scene->stats;
+  loader->insert_time = 0;
+  initialize_arena(&loader->arena);
+  initialize_identifier_index(&loader->building_ids, &scene->ids,
+                              scene->num_buildings, &loader->arena);
+  initialize_identifier_index(&loader->antenna_ids, &scene->ids,
+                              scene->num_antennas, &loader->arena);
+  for (unsigned int b = 0; b < scene->num_buildings; ++b)
+    insert_in_identifier_index(&loader->building_ids, scene->buildings[b].id,
+                               b, &existing);
+  for (unsigned int a = 0; a < scene->num_antennas; ++a)
+    insert_in_identifier_index(&loader->antenna_ids, scene->antennas[a].id,
+                               a, &existing);
+}
+
+/**
+ * Sorts the loaded objects and releases the loading structures
+ *
+ * If the loading is measured, the sort is charged to the insert phase, and
+ * the comparisons of the identifier indices and the moves of the sort are
+ * counted.
+ *
+ * @param loader  The loader
+ */
+void finalize_scene_loader(struct SceneLoader* loader) {
+  unsigned int num_moves = sort_buildings(loader->scene, &loader->arena) +
+                           sort_antennas(loader->scene, &loader->arena);
+  struct RunStats* stats = loader->stats;
+  if (stats != NULL) {
+    stats->num_comparisons +=
+      count_identifier_comparisons(&loader->building_ids) +
+      count_identifier_comparisons(&loader->antenna_ids);
+    stats->num_moves += num_moves;
+    record_stats_phase(stats, PHASE_INSERT);
+  }
+  free_arena(&loader->arena);
+}
+
+/**
+ * Appends a building to the scene being loaded
+ *
+ * @param loader    The loader
+ * @param building  The building to append
+ * @param error     The error, if the identifier of the building is used
+ * @return          true if and only if the building was appended
+ */
+bool append_building(struct SceneLoader* loader,
+                     const struct Building* building, struct Error* error) {
+  struct Scene* scene = loader->scene;
+  double start = loader->stats == NULL ? 0 : stats_wall_clock();
+  unsigned int existing;
+  if (!insert_in_identifier_index(&loader->building_ids, building->id,
+                                  scene->num_buildings, &existing))
+    return report_error_non_unique_identifiers(error, "building",
+        building_identifier(scene, building));
+  reserve_buildings(scene, scene->num_buildings + 1);
+  scene->buildings[scene->num_buildings++] = *building;
+  if (loader->stats != NULL)
+    loader->insert_time += stats_wall_clock() - start;
+  return true;
+}
+
+/**
+ * Appends an antenna to the scene being loaded
+ *
+ * @param loader   The loader
+ * @param antenna  The antenna to append
+ * @param error    The error, if the identifier of the antenna is used
+ * @return         true if and only if the antenna was appended
+ */
+bool append_antenna(struct SceneLoader* loader,
+                    const struct Antenna* antenna, struct Error* error) {
+  struct Scene* scene = loader->scene;
+  double start = loader->stats == NULL ? 0 : stats_wall_clock();
+  unsigned int existing;
+  if (!insert_in_identifier_index(&loader->antenna_ids, antenna->id,
+                                  scene->num_antennas, &existing))
+    return report_error_non_unique_identifiers(error, "antenna",
+        antenna_identifier(scene, antenna));
+  reserve_antennas(scene, scene->num_antennas + 1);
+  scene->antennas[scene->num_antennas++] = *antenna;
+  if (loader->stats != NULL)
+    loader->insert_time += stats_wall_clock() - start;
+  return true;
+}
+
 /**
  * Indicates if the line is a valid "begin scene" line
  *
  * @param line  The line to check
  * @return      true if and only if the line is valid
  */
-bool is_begin_scene_line(const char* line) {
-  return strcmp(line, "begin scene") == 0;
+bool is_begin_scene_line(struct StringView line) {
+  return string_view_equals(line, "begin scene");
 }
 
 /**
@@ -130,104 +552,652 @@ bool is_begin_scene_line(const char* line) {
  * @param line  The line to check
  * @return      true if and only if the line is valid
  */
-bool is_end_scene_line(const char* line) {
-  return strcmp(line, "end scene") == 0;
+bool is_end_scene_line(struct StringView line) {
+  return string_view_equals(line, "end scene");
 }
 
 /**
  * Parses a line
  *
+ * The tokens are the maximal sequences of characters other than spaces.
+ *
  * @param line         The line to parse
  * @param parsed_line  The resulting parsed line
  * @param line_number  The number of the line
  */
-void parse_line(const char* line,
+void parse_line(struct StringView line,
                 struct ParsedLine* parsed_line,
                 int line_number) {
-  char line_copy[MAX_LENGTH + 1];
-  strncpy(line_copy, line, MAX_LENGTH);
-  char *token = strtok(line_copy, " ");
-  int t = 0;
-  while (token != NULL) {
-    strncpy(parsed_line->tokens[t], token, MAX_TOKEN_LENGTH);
+  const char* c = line.start, * end = line.start + line.length;
+  unsigned int t = 0;
+  while (true) {
+    while (c != end && *c == ' ')
+      ++c;
+    if (c == end)
+      break;
+    const char* token = c;
+    while (c != end && *c != ' ')
+      ++c;
+    if (t < MAX_NUM_TOKENS) {
+      parsed_line->tokens[t].start = token;
+      parsed_line->tokens[t].length = c - token;
+    }
     ++t;
-    token = strtok(NULL, " ");
   }
   parsed_line->num_tokens = t;
   parsed_line->line_number = line_number;
 }
 
 /**
- * Loads a building from a parsed line
+ * Parses an identifier token
+ *
+ * @param token        The token
+ * @param ids          The pool receiving the identifier
+ * @param key          The key of the identifier
+ * @param id           The resulting identifier, as a handle in the pool
+ * @param line_number  The number of the line
+ * @param error        The error, if the token is not a valid identifier
+ * @return             true if and only if the token is a valid identifier
+ */
+bool parse_identifier(struct StringView token, struct IdentifierPool* ids,
+                      uint64_t* key, uint32_t* id, int line_number,
+                      struct Error* error) {
+  if (!is_valid_id(token.start, token.length))
+    return report_error_invalid_identifier(error, token.start, token.length,
+                                           line_number);
+  *key = identifier_key(token.start, token.length);
+  *id = add_identifier(ids, token.start, token.length);
+  return true;
+}
+
+/**
+ * Reads a line of a text scene
+ *
+ * The first line must be "begin scene", and the lines other than
+ * "end scene" are parsed. The other lines are given no token.
+ *
+ * @param line         The line
+ * @param line_number  The number of the line
+ * @param parsed_line  The resulting parsed line
+ * @param last_line    Set to true if and only if the line is "end scene"
+ * @param error        The error, if the line is invalid
+ * @return             true if and only if the line is valid
+ */
+bool read_scene_line(struct StringView line, int line_number,
+                     struct ParsedLine* parsed_line, bool* last_line,
+                     struct Error* error) {
+  *last_line = false;
+  parsed_line->num_tokens = 0;
+  parsed_line->line_number = line_number;
+  if (line_number == 1)
+    return is_begin_scene_line(line) || report_error_scene_first_line(error);
+  if (is_end_scene_line(line)) {
+    *last_line = true;
+    return true;
+  }
+  parse_line(line, parsed_line, line_number);
+  return parsed_line->num_tokens > 0 ||
+         report_error_line_without_token(error, line_number);
+}
+
+/**
+ * Indicates if a parsed line describes a given type of object
+ *
+ * @param parsed_line  The parsed line, which has at least one token
+ * @param object       The type of object ("building" or "antenna")
+ * @return             true if and only if the line starts with the type
+ */
+bool is_object_line(const struct ParsedLine* parsed_line, const char* object) {
+  return string_view_equals(parsed_line->tokens[0], object);
+}
+
+/**
+ * Parses a building from a parsed line starting with "building"
  *
  * @param parsed_line  The parsed line
- * @param scene        The scene in which the building is loaded
- * @return             true if and only if the loading was successful
+ * @param ids          The pool receiving the identifier of the building
+ * @param building     The resulting building
+ * @param error        The error, if the line is not a valid building
+ * @return             true if and only if the line is a valid building
  */
-bool load_building_from_parsed_line(const struct ParsedLine* parsed_line,
-                                    struct Scene* scene) {
-  if (strcmp(parsed_line->tokens[0], "building") != 0)
-    return false;
+bool parse_building_line(const struct ParsedLine* parsed_line,
+                         struct IdentifierPool* ids, struct Building* building,
+                         struct Error* error) {
+  const struct StringView* tokens = parsed_line->tokens;
+  int line_number = parsed_line->line_number;
   if (parsed_line->num_tokens != 6)
-    report_error_line_wrong_arguments_number("building",
-                                             parsed_line->line_number);
-  if (!is_valid_id(parsed_line->tokens[1]))
-      report_error_invalid_identifier(parsed_line->tokens[1],
-                                      parsed_line->line_number);
-  if (!is_valid_integer(parsed_line->tokens[2]))
-      report_error_invalid_int(parsed_line->tokens[2],
-                               parsed_line->line_number);
-  if (!is_valid_integer(parsed_line->tokens[3]))
-      report_error_invalid_int(parsed_line->tokens[3],
-                               parsed_line->line_number);
-  if (!is_valid_positive_integer(parsed_line->tokens[4]))
-      report_error_invalid_positive_int(parsed_line->tokens[4],
-                                        parsed_line->line_number);
-  if (!is_valid_positive_integer(parsed_line->tokens[5]))
-      report_error_invalid_positive_int(parsed_line->tokens[5],
-                                        parsed_line->line_number);
-  struct Building building;
-  strncpy(building.id, parsed_line->tokens[1], MAX_LENGTH_ID);
-  building.x = atoi(parsed_line->tokens[2]);
-  building.y = atoi(parsed_line->tokens[3]);
-  building.w = atoi(parsed_line->tokens[4]);
-  building.h = atoi(parsed_line->tokens[5]);
-  add_building(scene, &building);
+    return report_error_line_wrong_arguments_number(error, "building",
+                                                    line_number);
+  if (!parse_identifier(tokens[1], ids, &building->key, &building->id,
+                        line_number, error))
+    return false;
+  if (!parse_integer(tokens[2].start, tokens[2].length, &building->x))
+    return report_error_invalid_int(error, tokens[2].start, tokens[2].length,
+                                    line_number);
+  if (!parse_integer(tokens[3].start, tokens[3].length, &building->y))
+    return report_error_invalid_int(error, tokens[3].start, tokens[3].length,
+                                    line_number);
+  if (!parse_positive_integer(tokens[4].start, tokens[4].length, &building->w))
+    return report_error_invalid_positive_int(error, tokens[4].start,
+                                             tokens[4].length, line_number);
+  if (!parse_positive_integer(tokens[5].start, tokens[5].length, &building->h))
+    return report_error_invalid_positive_int(error, tokens[5].start,
+                                             tokens[5].length, line_number);
   return true;
 }
 
 /**
- * Loads an antenna from a parsed line
+ * Parses an antenna from a parsed line starting with "antenna"
  *
  * @param parsed_line  The parsed line
- * @param scene        The scene in which the antenna is loaded
- * @return             true if and only if the loading was successful
+ * @param ids          The pool receiving the identifier of the antenna
+ * @param antenna      The resulting antenna
+ * @param error        The error, if the line is not a valid antenna
+ * @return             true if and only if the line is a valid antenna
  */
-bool load_antenna_from_parsed_line(const struct ParsedLine* parsed_line,
-                                   struct Scene* scene) {
-  if (strcmp(parsed_line->tokens[0], "antenna") != 0)
-    return false;
+bool parse_antenna_line(const struct ParsedLine* parsed_line,
+                        struct IdentifierPool* ids, struct Antenna* antenna,
+                        struct Error* error) {
+  const struct StringView* tokens = parsed_line->tokens;
+  int line_number = parsed_line->line_number;
   if (parsed_line->num_tokens != 5)
-    report_error_line_wrong_arguments_number("antenna",
-                                             parsed_line->line_number);
-  if (!is_valid_id(parsed_line->tokens[1]))
-      report_error_invalid_identifier(parsed_line->tokens[1],
-                                      parsed_line->line_number);
-  if (!is_valid_integer(parsed_line->tokens[2]))
-      report_error_invalid_int(parsed_line->tokens[2],
-                               parsed_line->line_number);
-  if (!is_valid_integer(parsed_line->tokens[3]))
-      report_error_invalid_int(parsed_line->tokens[3],
-                               parsed_line->line_number);
-  if (!is_valid_positive_integer(parsed_line->tokens[4]))
-      report_error_invalid_positive_int(parsed_line->tokens[4],
-                                        parsed_line->line_number);
+    return report_error_line_wrong_arguments_number(error, "antenna",
+                                                    line_number);
+  if (!parse_identifier(tokens[1], ids, &antenna->key, &antenna->id,
+                        line_number, error))
+    return false;
+  if (!parse_integer(tokens[2].start, tokens[2].length, &antenna->x))
+    return report_error_invalid_int(error, tokens[2].start, tokens[2].length,
+                                    line_number);
+  if (!parse_integer(tokens[3].start, tokens[3].length, &antenna->y))
+    return report_error_invalid_int(error, tokens[3].start, tokens[3].length,
+                                    line_number);
+  if (!parse_positive_integer(tokens[4].start, tokens[4].length, &antenna->r))
+    return report_error_invalid_positive_int(error, tokens[4].start,
+                                             tokens[4].length, line_number);
+  return true;
+}
+
+/**
+ * Loads the object of a parsed line, if any
+ *
+ * @param parsed_line  The parsed line
+ * @param loader       The loader of the scene
+ * @param error        The error, if the object cannot be loaded
+ * @return             true if and only if the loading was successful
+ */
+bool load_parsed_line(const struct ParsedLine* parsed_line,
+                      struct SceneLoader* loader, struct Error* error) {
+  struct Building building;
+  struct Antenna antenna;
+  if (parsed_line->num_tokens == 0)
+    return true;
+  if (is_object_line(parsed_line, "building"))
+    return parse_building_line(parsed_line, &loader->scene->ids, &building,
+                               error) &&
+           append_building(loader, &building, error);
+  if (is_object_line(parsed_line, "antenna"))
+    return parse_antenna_line(parsed_line, &loader->scene->ids, &antenna,
+                              error) &&
+           append_antenna(loader, &antenna, error);
+  return report_error_unrecognized_line(error, parsed_line->line_number);
+}
+
+// Parallel loading
+// ----------------
+
+/**
+ * Splits a text input into chunks of whole lines
+ *
+ * Each chunk but the last ends after the first newline following a multiple
+ * of PARSE_CHUNK_SIZE, so that a line longer than a chunk is never split.
+ *
+ * @param input   The input
+ * @param arena   The arena holding the chunks
+ * @param chunks  The resulting chunks, whose other fields are uninitialized
+ * @return        The number of chunks
+ */
+unsigned int split_scene_chunks(const struct Input* input,
+                                struct Arena* arena,
+                                struct SceneChunk** chunks) {
+  unsigned int capacity = input->size / PARSE_CHUNK_SIZE + 1, num_chunks = 0;
+  *chunks = arena_allocate(arena, capacity * sizeof(struct SceneChunk));
+  const char* c = input->data, * end = input->data + input->size;
+  while (c != end) {
+    const char* newline = end - c <= PARSE_CHUNK_SIZE
+                        ? NULL
+                        : memchr(c + PARSE_CHUNK_SIZE, '\n',
+                                 end - c - PARSE_CHUNK_SIZE);
+    const char* next = newline == NULL ? end : newline + 1;
+    struct SceneChunk* chunk = *chunks + num_chunks++;
+    chunk->text.start = c;
+    chunk->text.length = next - c;
+    c = next;
+  }
+  return num_chunks;
+}
+
+/**
+ * Counts the lines of a chunk
+ *
+ * @param context  The chunks
+ * @param task     The index of the chunk
+ * @param worker   The index of the worker (unused)
+ */
+void count_chunk_lines(void* context, unsigned int task,
+                       unsigned int worker) {
+  (void)worker;
+  struct SceneChunk* chunk = (struct SceneChunk*)context + task;
+  const char* c = chunk->text.start, * end = c + chunk->text.length;
+  unsigned int num_lines = 0;
+  while (c != end) {
+    const char* newline = memchr(c, '\n', end - c);
+    c = newline == NULL ? end : newline + 1;
+    ++num_lines;
+  }
+  chunk->num_lines = num_lines;
+}
+
+/**
+ * Stores the object of a parsed line in the objects of a chunk, if any
+ *
+ * @param parsed_line  The parsed line
+ * @param objects      The objects of the chunk
+ * @param error        The error, if the object cannot be parsed
+ * @return             true if and only if the object was parsed
+ */
+bool collect_parsed_line(const struct ParsedLine* parsed_line,
+                         struct Scene* objects, struct Error* error) {
+  if (parsed_line->num_tokens == 0)
+    return true;
+  if (is_object_line(parsed_line, "building")) {
+    reserve_buildings(objects, objects->num_buildings + 1);
+    if (!parse_building_line(parsed_line, &objects->ids,
+                             objects->buildings + objects->num_buildings,
+                             error))
+      return false;
+    ++objects->num_buildings;
+    return true;
+  }
+  if (is_object_line(parsed_line, "antenna")) {
+    reserve_antennas(objects, objects->num_antennas + 1);
+    if (!parse_antenna_line(parsed_line, &objects->ids,
+                            objects->antennas + objects->num_antennas, error))
+      return false;
+    ++objects->num_antennas;
+    return true;
+  }
+  return report_error_unrecognized_line(error, parsed_line->line_number);
+}
+
+/**
+ * Parses the lines of a chunk, up to the first invalid one
+ *
+ * @param context  The chunks
+ * @param task     The index of the chunk
+ * @param worker   The index of the worker (unused)
+ */
+void parse_scene_chunk(void* context, unsigned int task,
+                       unsigned int worker) {
+  (void)worker;
+  struct SceneChunk* chunk = (struct SceneChunk*)context + task;
+  const char* c = chunk->text.start, * end = c + chunk->text.length;
+  int line_number = chunk->first_line_number;
+  bool success = true;
+  initialize_empty_scene(&chunk->objects);
+  chunk->last_line = false;
+  while (success && c != end) {
+    const char* newline = memchr(c, '\n', end - c);
+    struct StringView line = {c, (newline == NULL ? end : newline) - c};
+    c = newline == NULL ? end : newline + 1;
+    struct ParsedLine parsed_line;
+    success = read_scene_line(line, line_number, &parsed_line,
+                              &chunk->last_line, &chunk->error) &&
+              collect_parsed_line(&parsed_line, &chunk->objects,
+                                  &chunk->error);
+    ++line_number;
+  }
+  chunk->has_failed = !success;
+}
+
+/**
+ * Copies the objects of a chunk into the loaded scene and frees them
+ *
+ * @param context  The merge (the chunks and the scene)
+ * @param task     The index of the chunk
+ * @param worker   The index of the worker (unused)
+ */
+void merge_scene_chunk(void* context, unsigned int task,
+                       unsigned int worker) {
+  (void)worker;
+  struct SceneChunkMerge* merge = context;
+  struct SceneChunk* chunk = merge->chunks + task;
+  struct Scene* objects = &chunk->objects;
+  struct Building* buildings = merge->scene->buildings + chunk->first_building;
+  struct Antenna* antennas = merge->scene->antennas + chunk->first_antenna;
+  if (objects->ids.size > 0)
+    memcpy(merge->scene->ids.chars + chunk->first_id, objects->ids.chars,
+           objects->ids.size);
+  // The handles are offset by the position of the identifiers of the chunk
+  for (unsigned int b = 0; b < objects->num_buildings; ++b) {
+    buildings[b] = objects->buildings[b];
+    buildings[b].id += (uint32_t)chunk->first_id;
+  }
+  for (unsigned int a = 0; a < objects->num_antennas; ++a) {
+    antennas[a] = objects->antennas[a];
+    antennas[a].id += (uint32_t)chunk->first_id;
+  }
+  free_arena(&objects->arena);
+}
+
+/**
+ * Returns the smallest index of an object whose identifier is used by a
+ * previous object
+ *
+ * @param order        The sorted keys, with the index of their object
+ * @param num_objects  The number of objects
+ * @param scene        The scene of the objects
+ * @param is_building  true for buildings, false for antennas
+ * @return             The index, or UINT_MAX if the identifiers are distinct
+ */
+unsigned int first_repeated_identifier(const struct KeyedIndex* order,
+                                       unsigned int num_objects,
+                                       const struct Scene* scene,
+                                       bool is_building) {
+  // The objects with the same identifier are ordered by index, so the
+  // repeated identifiers follow their first occurrence
+  unsigned int first = UINT_MAX;
+  for (unsigned int i = 1; i < num_objects; ++i)
+    if (order[i].key == order[i - 1].key && order[i].index < first &&
+        compare_identifiers(order[i].key,
+            object_identifier(scene, is_building, order[i].index),
+            order[i - 1].key,
+            object_identifier(scene, is_building, order[i - 1].index)) == 0)
+      first = order[i].index;
+  return first;
+}
+
+/**
+ * Indicates if a building of a merged scene precedes an antenna in its input
+ *
+ * @param chunks      The chunks of the input
+ * @param num_chunks  The number of chunks
+ * @param b           The index of the building in the merged scene
+ * @param a           The index of the antenna in the merged scene
+ * @return            true if and only if the building line comes first
+ */
+bool building_precedes_antenna(const struct SceneChunk* chunks,
+                               unsigned int num_chunks,
+                               unsigned int b, unsigned int a) {
+  unsigned int cb = 0, ca = 0;
+  while (cb + 1 < num_chunks && chunks[cb + 1].first_building <= b)
+    ++cb;
+  while (ca + 1 < num_chunks && chunks[ca + 1].first_antenna <= a)
+    ++ca;
+  if (cb != ca)
+    return cb < ca;
+  // Both objects are in the same chunk, whose lines are read again
+  const struct SceneChunk* chunk = chunks + cb;
+  const char* c = chunk->text.start, * end = c + chunk->text.length;
+  b -= chunk->first_building;
+  a -= chunk->first_antenna;
+  while (true) {
+    const char* newline = memchr(c, '\n', end - c);
+    struct StringView line = {c, (newline == NULL ? end : newline) - c};
+    c = newline == NULL ? end : newline + 1;
+    struct ParsedLine parsed_line;
+    parse_line(line, &parsed_line, 0);
+    if (parsed_line.num_tokens == 0)
+      continue;
+    if (is_object_line(&parsed_line, "building") && b-- == 0)
+      return true;
+    if (is_object_line(&parsed_line, "antenna") && a-- == 0)
+      return false;
+  }
+}
+
+/**
+ * Merges the chunks of a text scene parsed in parallel
+ *
+ * The chunks following the first invalid one are discarded. Then, the
+ * identifiers are checked by sorting them, and the first error of the input
+ * is reported, as if the lines had been loaded one by one.
+ *
+ * @param scene       The scene in which the objects are loaded
+ * @param chunks      The chunks
+ * @param num_chunks  The number of chunks
+ * @param pool        The thread pool
+ * @param error       The error, if the scene is invalid
+ * @return            true if and only if the scene was loaded
+ */
+bool merge_scene_chunks(struct Scene* scene, struct SceneChunk* chunks,
+                        unsigned int num_chunks, struct ThreadPool* pool,
+                        struct Error* error) {
+  unsigned int num_merged = 0, num_buildings = 0, num_antennas = 0;
+  size_t num_chars = scene->ids.size;
+  while (num_merged < num_chunks) {
+    struct SceneChunk* chunk = chunks + num_merged++;
+    chunk->first_building = num_buildings;
+    chunk->first_antenna = num_antennas;
+    chunk->first_id = num_chars;
+    num_buildings += chunk->objects.num_buildings;
+    num_antennas += chunk->objects.num_antennas;
+    num_chars += chunk->objects.ids.size;
+    if (chunk->has_failed)
+      break;
+  }
+  for (unsigned int c = num_merged; c < num_chunks; ++c)
+    free_arena(&chunks[c].objects.arena);
+  reserve_scene(scene, num_buildings, num_antennas);
+  reserve_identifier_pool(&scene->ids, num_chars);
+  struct SceneChunkMerge merge = {scene, chunks};
+  run_pool_tasks(pool, num_merged, merge_scene_chunk, &merge);
+  scene->num_buildings = num_buildings;
+  scene->num_antennas = num_antennas;
+  scene->ids.size = num_chars;
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct KeyedIndex* building_order = sorted_building_keys(scene, &arena),
+                   * antenna_order = sorted_antenna_keys(scene, &arena);
+  unsigned int b = first_repeated_identifier(building_order, num_buildings,
+                                             scene, true),
+               a = first_repeated_identifier(antenna_order, num_antennas,
+                                             scene, false);
+  const struct SceneChunk* last = chunks + num_merged - 1;
+  bool success = false;
+  if (b != UINT_MAX &&
+      (a == UINT_MAX ||
+       building_precedes_antenna(chunks, num_merged, b, a)))
+    report_error_non_unique_identifiers(error, "building",
+        building_identifier(scene, scene->buildings + b));
+  else if (a != UINT_MAX)
+    report_error_non_unique_identifiers(error, "antenna",
+        antenna_identifier(scene, scene->antennas + a));
+  else if (last->has_failed)
+    *error = last->error;
+  else if (!last->last_line)
+    report_error_scene_last_line(error);
+  else
+    success = true;
+  if (success) {
+    unsigned int num_moves =
+      permute_objects(scene->buildings, num_buildings,
+                      sizeof(struct Building), building_order, &arena) +
+      permute_objects(scene->antennas, num_antennas, sizeof(struct Antenna),
+                      antenna_order, &arena);
+    if (scene->stats != NULL) {
+      // Each sorted key is compared to the previous one, and the tied
+      // identifiers are not counted
+      scene->stats->num_comparisons += num_buildings + num_antennas;
+      scene->stats->num_moves += num_moves;
+    }
+  }
+  free_arena(&arena);
+  return success;
+}
+
+// Streaming
+// ---------
+
+/**
+ * Initializes the incremental validation of a streamed scene
+ *
+ * @param validator  The validator to initialize
+ */
+void initialize_stream_validator(struct StreamValidator* validator) {
+  initialize_arena(&validator->arena);
+  initialize_identifier_pool(&validator->ids, &validator->arena);
+  initialize_identifier_index(&validator->building_ids, &validator->ids, 0,
+                              &validator->arena);
+  initialize_identifier_index(&validator->antenna_ids, &validator->ids, 0,
+                              &validator->arena);
+  initialize_building_grid(&validator->buildings, &validator->ids,
+                           &validator->arena);
+  initialize_hash_index(&validator->antenna_positions, 0, &validator->arena);
+  validator->num_positions = 0;
+  validator->capacity_positions = 0;
+  validator->positions = NULL;
+}
+
+/**
+ * Validates a building of a streamed scene
+ *
+ * @param validator  The validator
+ * @param building   The building
+ * @param error      The error, if the identifier of the building is used
+ * @return           true if and only if the identifier is not used
+ */
+bool validate_streamed_building(struct StreamValidator* validator,
+                                const struct Building* building,
+                                struct Error* error) {
+  unsigned int existing;
+  if (!insert_in_identifier_index(&validator->building_ids, building->id, 0,
+                                  &existing))
+    return report_error_non_unique_identifiers(error, "building",
+        identifier_string(&validator->ids, building->id));
+  insert_in_building_grid(&validator->buildings, building);
+  return true;
+}
+
+/**
+ * Validates an antenna of a streamed scene
+ *
+ * @param validator  The validator
+ * @param antenna    The antenna
+ * @param error      The error, if the identifier of the antenna is used
+ * @return           true if and only if the identifier is not used
+ */
+bool validate_streamed_antenna(struct StreamValidator* validator,
+                               const struct Antenna* antenna,
+                               struct Error* error) {
+  const char* id = identifier_string(&validator->ids, antenna->id);
+  unsigned int p;
+  if (!insert_in_identifier_index(&validator->antenna_ids, antenna->id, 0,
+                                  &p))
+    return report_error_non_unique_identifiers(error, "antenna", id);
+  if (insert_in_hash_index(&validator->antenna_positions,
+                           position_key(antenna->x, antenna->y),
+                           validator->num_positions, &p)) {
+    if (validator->num_positions == validator->capacity_positions) {
+      unsigned int capacity = grown_capacity(validator->capacity_positions);
+      validator->positions = arena_grow(&validator->arena,
+          validator->positions,
+          validator->capacity_positions * sizeof(struct PositionIds),
+          capacity * sizeof(struct PositionIds));
+      validator->capacity_positions = capacity;
+    }
+    p = validator->num_positions++;
+    validator->positions[p].first_key = antenna->key;
+    validator->positions[p].first = antenna->id;
+    validator->positions[p].second_key = 0;
+    return true;
+  }
+  struct PositionIds* ids = validator->positions + p;
+  if (compare_identifiers(antenna->key, id, ids->first_key,
+                          identifier_string(&validator->ids, ids->first)) < 0) {
+    ids->second_key = ids->first_key;
+    ids->second = ids->first;
+    ids->first_key = antenna->key;
+    ids->first = antenna->id;
+  } else if (ids->second_key == 0 ||
+             compare_identifiers(antenna->key, id, ids->second_key,
+                 identifier_string(&validator->ids, ids->second)) < 0) {
+    ids->second_key = antenna->key;
+    ids->second = antenna->id;
+  }
+  return true;
+}
+
+/**
+ * Validates the object of a parsed line of a streamed scene, if any
+ *
+ * The object is folded into the aggregates of the scene.
+ *
+ * @param parsed_line  The parsed line
+ * @param ids          The pool receiving the identifier of the object
+ * @param validator    The validator (NULL if the scene is not validated)
+ * @param aggregates   The aggregates
+ * @param error        The error, if the object is invalid
+ * @return             true if and only if the object is valid
+ */
+bool stream_parsed_line(const struct ParsedLine* parsed_line,
+                        struct IdentifierPool* ids,
+                        struct StreamValidator* validator,
+                        struct SceneAggregates* aggregates,
+                        struct Error* error) {
+  struct Building building;
   struct Antenna antenna;
-  strncpy(antenna.id, parsed_line->tokens[1], MAX_LENGTH_ID);
-  antenna.x = atoi(parsed_line->tokens[2]);
-  antenna.y = atoi(parsed_line->tokens[3]);
-  antenna.r = atoi(parsed_line->tokens[4]);
-  add_antenna(scene, &antenna);
+  if (parsed_line->num_tokens == 0)
+    return true;
+  if (is_object_line(parsed_line, "building")) {
+    if (!parse_building_line(parsed_line, ids, &building, error) ||
+        (validator != NULL &&
+         !validate_streamed_building(validator, &building, error)))
+      return false;
+    fold_building(aggregates, &building);
+    return true;
+  }
+  if (is_object_line(parsed_line, "antenna")) {
+    if (!parse_antenna_line(parsed_line, ids, &antenna, error) ||
+        (validator != NULL &&
+         !validate_streamed_antenna(validator, &antenna, error)))
+      return false;
+    fold_antenna(aggregates, &antenna);
+    return true;
+  }
+  return report_error_unrecognized_line(error, parsed_line->line_number);
+}
+
+/**
+ * Checks the pairs of objects of a streamed scene
+ *
+ * @param validator  The validator
+ * @param error      The error, if two objects are conflicting
+ * @return           true if and only if no objects are conflicting
+ */
+bool check_streamed_pairs(const struct StreamValidator* validator,
+                          struct Error* error) {
+  if (validator->buildings.has_overlap)
+    return report_error_overlapping_buildings(error,
+        identifier_string(&validator->ids, validator->buildings.first_id),
+        identifier_string(&validator->ids, validator->buildings.second_id));
+  // The first pair has the smallest first antenna among the positions
+  // shared by several antennas
+  const struct PositionIds* first = NULL;
+  for (unsigned int p = 0; p < validator->num_positions; ++p) {
+    const struct PositionIds* ids = validator->positions + p;
+    if (ids->second_key != 0 &&
+        (first == NULL ||
+         compare_identifiers(ids->first_key,
+             identifier_string(&validator->ids, ids->first),
+             first->first_key,
+             identifier_string(&validator->ids, first->first)) < 0))
+      first = ids;
+  }
+  if (first != NULL)
+    return report_error_same_position_antennas(error,
+        identifier_string(&validator->ids, first->first),
+        identifier_string(&validator->ids, first->second));
   return true;
 }
 
@@ -239,46 +1209,270 @@ bool load_antenna_from_parsed_line(const struct ParsedLine* parsed_line,
 
 void initialize_empty_scene(struct Scene* scene) {
   scene->num_buildings = 0;
+  scene->capacity_buildings = 0;
+  scene->buildings = NULL;
   scene->num_antennas = 0;
+  scene->capacity_antennas = 0;
+  scene->antennas = NULL;
+  memset(&scene->columns, 0, sizeof(scene->columns));
+  scene->has_columns = false;
+  scene->is_validated = false;
+  initialize_arena(&scene->arena);
+  initialize_identifier_pool(&scene->ids, &scene->arena);
+  scene->stats = NULL;
 }
 
-void load_scene_from_stdin(struct Scene* scene) {
+struct Scene* create_scene(void) {
+  struct Scene* scene = malloc(sizeof(struct Scene));
+  if (scene == NULL)
+    report_error_out_of_memory();
   initialize_empty_scene(scene);
-  char line[MAX_LENGTH + 1];
-  bool first_line = true, last_line = false;
+  return scene;
+}
+
+void delete_scene(struct Scene* scene) {
+  free_arena(&scene->arena);
+  free(scene);
+}
+
+bool load_scene(struct Scene* scene, const struct Input* input,
+                struct Error* error) {
+  struct RunStats* stats = scene->stats;
+  if (stats != NULL)
+    stats->num_bytes += input->size;
+  if (is_binary_input(input)) {
+    bool success = load_binary_scene(scene, input, error);
+    if (success)
+      sync_scene_columns(scene);
+    if (stats != NULL)
+      record_stats_phase(stats, PHASE_TOKENIZE);
+    return success;
+  }
+  struct SceneLoader loader;
+  initialize_scene_loader(&loader, scene);
+  const char* c = input->data, * end = input->data + input->size;
+  bool last_line = false, success = true;
   int line_number = 1;
-  while (fgets(line, MAX_LENGTH, stdin) != NULL) {
-    last_line = false;
-    line[strcspn(line, "\n")] = '\0';
-    if (first_line) {
-      if (!is_begin_scene_line(line))
-        report_error_scene_first_line();
-      first_line = false;
-    } else if (is_end_scene_line(line)) {
-      last_line = true;
-    } else {
-      struct ParsedLine parsed_line;
-      parse_line(line, &parsed_line, line_number);
-      if (parsed_line.num_tokens == 0) {
-        fprintf(stderr, "error: line has no token\n");
-        exit(1);
-      }
-      if (!load_building_from_parsed_line(&parsed_line, scene) &&
-          !load_antenna_from_parsed_line(&parsed_line, scene))
-        report_error_unrecognized_line(line_number);
-    }
+  while (success && c != end) {
+    const char* newline = memchr(c, '\n', end - c);
+    struct StringView line = {c, (newline == NULL ? end : newline) - c};
+    c = newline == NULL ? end : newline + 1;
+    struct ParsedLine parsed_line;
+    success = read_scene_line(line, line_number, &parsed_line, &last_line,
+                              error) &&
+              load_parsed_line(&parsed_line, &loader, error);
+    ++line_number;
+  }
+  if (success && !last_line)
+    success = report_error_scene_last_line(error);
+  if (stats != NULL) {
+    // The objects are appended as their lines are tokenized
+    stats->num_lines += line_number - 1;
+    record_stats_phase(stats, PHASE_TOKENIZE);
+    shift_stats_time(stats, PHASE_TOKENIZE, PHASE_INSERT, loader.insert_time);
+  }
+  if (success) {
+    finalize_scene_loader(&loader);
+    sync_scene_columns(scene);
+  } else {
+    free_arena(&loader.arena);
+  }
+  return success;
+}
+
+bool load_scene_in_parallel(struct Scene* scene, const struct Input* input,
+                            struct ThreadPool* pool, struct Error* error) {
+  if (pool->num_threads == 1 || input->size <= PARSE_CHUNK_SIZE ||
+      is_binary_input(input))
+    return load_scene(scene, input, error);
+  struct RunStats* stats = scene->stats;
+  struct Arena arena;
+  initialize_arena(&arena);
+  struct SceneChunk* chunks;
+  unsigned int num_chunks = split_scene_chunks(input, &arena, &chunks);
+  run_pool_tasks(pool, num_chunks, count_chunk_lines, chunks);
+  // The line numbers of the chunks are the prefix sums of their line counts
+  int line_number = 1;
+  for (unsigned int c = 0; c < num_chunks; ++c) {
+    chunks[c].first_line_number = line_number;
+    line_number += chunks[c].num_lines;
+  }
+  run_pool_tasks(pool, num_chunks, parse_scene_chunk, chunks);
+  if (stats != NULL) {
+    stats->num_bytes += input->size;
+    stats->num_lines += line_number - 1;
+    record_stats_phase(stats, PHASE_TOKENIZE);
+  }
+  bool success = merge_scene_chunks(scene, chunks, num_chunks, pool, error);
+  if (success)
+    sync_scene_columns(scene);
+  if (stats != NULL)
+    record_stats_phase(stats, PHASE_INSERT);
+  free_arena(&arena);
+  return success;
+}
+
+bool load_scene_from_stdin(struct Scene* scene, struct Error* error) {
+  struct Input input;
+  if (!open_stdin_input(&input, error))
+    return false;
+  bool success = load_scene(scene, &input, error);
+  close_input(&input);
+  return success;
+}
+
+bool load_scene_from_buffer(struct Scene* scene, const char* data,
+                            size_t size, struct Error* error) {
+  struct Input input = {data, size, false};
+  return load_scene(scene, &input, error);
+}
+
+bool stream_scene(struct LineReader* reader, bool is_validating,
+                  struct SceneAggregates* aggregates, struct Error* error) {
+  struct StreamValidator validator;
+  initialize_stream_validator(&validator);
+  initialize_scene_aggregates(aggregates);
+  bool last_line = false, success = true;
+  int line_number = 1;
+  struct StringView line;
+  while (success && read_next_line(reader, &line)) {
+    struct ParsedLine parsed_line;
+    success = read_scene_line(line, line_number, &parsed_line, &last_line,
+                              error) &&
+              stream_parsed_line(&parsed_line, &validator.ids,
+                                 is_validating ? &validator : NULL,
+                                 aggregates, error);
+    // Without validation, the identifiers are not kept
+    if (!is_validating)
+      validator.ids.size = 0;
     ++line_number;
   }
-  if (!last_line)
-    report_error_scene_last_line();
+  if (success && reader->has_failed)
+    success = report_error_cannot_read_file(error, reader->name);
+  if (success && !last_line)
+    success = report_error_scene_last_line(error);
+  if (success && is_validating)
+    success = check_streamed_pairs(&validator, error);
+  free_arena(&validator.arena);
+  return success;
+}
+
+bool read_scene_edit(struct StringView line, int line_number,
+                     struct IdentifierPool* ids, struct SceneEdit* edit,
+                     struct Error* error) {
+  struct ParsedLine parsed_line;
+  parse_line(line, &parsed_line, line_number);
+  if (parsed_line.num_tokens == 0)
+    return report_error_line_without_token(error, line_number);
+  // The rest of the line is parsed as an object line, without its verb
+  struct ParsedLine object_line = parsed_line;
+  object_line.num_tokens = parsed_line.num_tokens - 1;
+  for (unsigned int t = 0; t + 1 < MAX_NUM_TOKENS; ++t)
+    object_line.tokens[t] = parsed_line.tokens[t + 1];
+  bool is_building = object_line.num_tokens > 0 &&
+                     is_object_line(&object_line, "building"),
+       is_antenna = object_line.num_tokens > 0 &&
+                    is_object_line(&object_line, "antenna");
+  const struct StringView* tokens = object_line.tokens;
+  uint64_t* key = is_building ? &edit->building.key : &edit->antenna.key;
+  uint32_t* id = is_building ? &edit->building.id : &edit->antenna.id;
+  int* x = is_building ? &edit->building.x : &edit->antenna.x,
+     * y = is_building ? &edit->building.y : &edit->antenna.y;
+  if (!is_building && !is_antenna)
+    return report_error_unrecognized_line(error, line_number);
+  if (string_view_equals(parsed_line.tokens[0], "add")) {
+    edit->kind = is_building ? EDIT_ADD_BUILDING : EDIT_ADD_ANTENNA;
+    return is_building
+           ? parse_building_line(&object_line, ids, &edit->building, error)
+           : parse_antenna_line(&object_line, ids, &edit->antenna, error);
+  }
+  if (string_view_equals(parsed_line.tokens[0], "remove")) {
+    edit->kind = is_building ? EDIT_REMOVE_BUILDING : EDIT_REMOVE_ANTENNA;
+    if (object_line.num_tokens != 2)
+      return report_error_line_wrong_arguments_number(error, "remove",
+                                                      line_number);
+    return parse_identifier(tokens[1], ids, key, id, line_number, error);
+  }
+  if (string_view_equals(parsed_line.tokens[0], "move")) {
+    edit->kind = is_building ? EDIT_MOVE_BUILDING : EDIT_MOVE_ANTENNA;
+    if (object_line.num_tokens != 4)
+      return report_error_line_wrong_arguments_number(error, "move",
+                                                      line_number);
+    if (!parse_identifier(tokens[1], ids, key, id, line_number, error))
+      return false;
+    if (!parse_integer(tokens[2].start, tokens[2].length, x))
+      return report_error_invalid_int(error, tokens[2].start,
+                                      tokens[2].length, line_number);
+    if (!parse_integer(tokens[3].start, tokens[3].length, y))
+      return report_error_invalid_int(error, tokens[3].start,
+                                      tokens[3].length, line_number);
+    return true;
+  }
+  return report_error_unrecognized_line(error, line_number);
+}
+
+bool read_scene_query(struct StringView line, int line_number,
+                      struct SceneQuery* query, struct Error* error) {
+  struct ParsedLine parsed_line;
+  parse_line(line, &parsed_line, line_number);
+  if (parsed_line.num_tokens == 0)
+    return report_error_line_without_token(error, line_number);
+  const struct StringView* tokens = parsed_line.tokens;
+  const char* name;
+  unsigned int num_tokens;
+  if (string_view_equals(tokens[0], "antennas")) {
+    query->kind = QUERY_ANTENNAS_AT_POINT;
+    name = "antennas";
+    num_tokens = 3;
+  } else if (string_view_equals(tokens[0], "buildings")) {
+    query->kind = QUERY_BUILDINGS_AT_POINT;
+    name = "buildings";
+    num_tokens = 3;
+  } else if (string_view_equals(tokens[0], "window")) {
+    query->kind = QUERY_WINDOW;
+    name = "window";
+    num_tokens = 5;
+  } else {
+    return report_error_unrecognized_line(error, line_number);
+  }
+  if (parsed_line.num_tokens != num_tokens)
+    return report_error_line_wrong_arguments_number(error, name, line_number);
+  int coordinates[4];
+  for (unsigned int t = 1; t < num_tokens; ++t)
+    if (!parse_integer(tokens[t].start, tokens[t].length,
+                       coordinates + t - 1))
+      return report_error_invalid_int(error, tokens[t].start,
+                                      tokens[t].length, line_number);
+  // A point is a window reduced to a single point
+  if (num_tokens == 3) {
+    coordinates[2] = coordinates[0];
+    coordinates[3] = coordinates[1];
+  }
+  query->xmin = coordinates[0] < coordinates[2]
+              ? coordinates[0] : coordinates[2];
+  query->xmax = coordinates[0] < coordinates[2]
+              ? coordinates[2] : coordinates[0];
+  query->ymin = coordinates[1] < coordinates[3]
+              ? coordinates[1] : coordinates[3];
+  query->ymax = coordinates[1] < coordinates[3]
+              ? coordinates[3] : coordinates[1];
+  return true;
 }
 
 // Validation
 // ----------
 
-void validate_scene(const struct Scene* scene) {
-  validate_buildings(scene);
-  validate_antennas(scene);
+bool validate_scene(const struct Scene* scene, struct ThreadPool* pool,
+                    struct Error* error) {
+  bool success = validate_buildings(scene, pool, error);
+  if (scene->stats != NULL)
+    record_stats_phase(scene->stats, PHASE_VALIDATE_BUILDINGS);
+  if (!success)
+    return false;
+  success = validate_antennas(scene, error);
+  if (scene->stats != NULL)
+    record_stats_phase(scene->stats, PHASE_VALIDATE_ANTENNAS);
+  return success;
 }
 
 // Accessors
@@ -288,104 +1482,473 @@ bool scene_is_empty(const struct Scene* scene) {
   return scene->num_buildings == 0 && scene->num_antennas == 0;
 }
 
-void print_scene_summary(const struct Scene* scene) {
-  if (scene->num_buildings == 0 && scene->num_antennas == 0) {
-    puts("An empty scene");
-    return;
+const struct Building* find_building(const struct Scene* scene,
+                                     const char* id) {
+  size_t length = strlen(id);
+  if (!is_valid_id(id, length))
+    return NULL;
+  uint64_t key = identifier_key(id, length);
+  unsigned int low = 0, high = scene->num_buildings;
+  while (low < high) {
+    unsigned int middle = low + (high - low) / 2;
+    const struct Building* building = scene->buildings + middle;
+    int comparison = compare_identifiers(key, id, building->key,
+        building_identifier(scene, building));
+    if (comparison == 0)
+      return building;
+    if (comparison > 0)
+      low = middle + 1;
+    else
+      high = middle;
   }
-  printf("A scene with ");
-  if (scene->num_buildings > 0)
-    printf("%d building%s", scene->num_buildings,
-           scene->num_buildings > 1 ? "s" : "");
-  if (scene->num_buildings > 0 && scene->num_antennas > 0)
-    printf(" and ");
-  if (scene->num_antennas > 0)
-    printf("%d antenna%s", scene->num_antennas,
-           scene->num_antennas > 1 ? "s" : "");
-  printf("\n");
+  return NULL;
 }
 
-void print_scene_buildings(const struct Scene* scene) {
+const struct Antenna* find_antenna(const struct Scene* scene, const char* id) {
+  size_t length = strlen(id);
+  if (!is_valid_id(id, length))
+    return NULL;
+  uint64_t key = identifier_key(id, length);
+  unsigned int low = 0, high = scene->num_antennas;
+  while (low < high) {
+    unsigned int middle = low + (high - low) / 2;
+    const struct Antenna* antenna = scene->antennas + middle;
+    int comparison = compare_identifiers(key, id, antenna->key,
+        antenna_identifier(scene, antenna));
+    if (comparison == 0)
+      return antenna;
+    if (comparison > 0)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return NULL;
+}
+
+void print_scene(const struct Scene* scene, FILE* file) {
+  struct Writer writer;
+  open_writer(&writer, file);
+  write_string(&writer, "begin scene\n");
   for (unsigned int b = 0; b < scene->num_buildings; ++b) {
     const struct Building* building = scene->buildings + b;
-    printf("  building %s at %d %d with dimensions %d %d\n",
-           building->id, building->x, building->y, building->w, building->h);
+    write_string(&writer, "  building ");
+    write_string(&writer, building_identifier(scene, building));
+    write_char(&writer, ' ');
+    write_int(&writer, building->x);
+    write_char(&writer, ' ');
+    write_int(&writer, building->y);
+    write_char(&writer, ' ');
+    write_int(&writer, building->w);
+    write_char(&writer, ' ');
+    write_int(&writer, building->h);
+    write_char(&writer, '\n');
+  }
+  for (unsigned int a = 0; a < scene->num_antennas; ++a) {
+    const struct Antenna* antenna = scene->antennas + a;
+    write_string(&writer, "  antenna ");
+    write_string(&writer, antenna_identifier(scene, antenna));
+    write_char(&writer, ' ');
+    write_int(&writer, antenna->x);
+    write_char(&writer, ' ');
+    write_int(&writer, antenna->y);
+    write_char(&writer, ' ');
+    write_int(&writer, antenna->r);
+    write_char(&writer, '\n');
   }
+  write_string(&writer, "end scene\n");
+  close_writer(&writer);
 }
 
-void print_scene_antennas(const struct Scene* scene) {
+void print_scene_summary(const struct Scene* scene, FILE* file) {
+  struct SceneAggregates aggregates;
+  initialize_scene_aggregates(&aggregates);
+  aggregates.num_buildings = scene->num_buildings;
+  aggregates.num_antennas = scene->num_antennas;
+  print_aggregates_summary(&aggregates, file);
+}
+
+void print_aggregates_summary(const struct SceneAggregates* aggregates,
+                              FILE* file) {
+  unsigned int num_buildings = aggregates->num_buildings,
+               num_antennas = aggregates->num_antennas;
+  struct Writer writer;
+  open_writer(&writer, file);
+  if (num_buildings == 0 && num_antennas == 0) {
+    write_string(&writer, "An empty scene\n");
+  } else {
+    write_string(&writer, "A scene with ");
+    if (num_buildings > 0) {
+      write_unsigned(&writer, num_buildings);
+      write_string(&writer, num_buildings > 1 ? " buildings" : " building");
+    }
+    if (num_buildings > 0 && num_antennas > 0)
+      write_string(&writer, " and ");
+    if (num_antennas > 0) {
+      write_unsigned(&writer, num_antennas);
+      write_string(&writer, num_antennas > 1 ? " antennas" : " antenna");
+    }
+    write_char(&writer, '\n');
+  }
+  close_writer(&writer);
+}
+
+void print_scene_buildings(const struct Scene* scene, FILE* file) {
+  struct Writer writer;
+  open_writer(&writer, file);
+  for (unsigned int b = 0; b < scene->num_buildings; ++b) {
+    const struct Building* building = scene->buildings + b;
+    write_string(&writer, "  building ");
+    write_string(&writer, building_identifier(scene, building));
+    write_string(&writer, " at ");
+    write_int(&writer, building->x);
+    write_char(&writer, ' ');
+    write_int(&writer, building->y);
+    write_string(&writer, " with dimensions ");
+    write_int(&writer, building->w);
+    write_char(&writer, ' ');
+    write_int(&writer, building->h);
+    write_char(&writer, '\n');
+  }
+  close_writer(&writer);
+}
+
+void print_scene_antennas(const struct Scene* scene, FILE* file) {
+  struct Writer writer;
+  open_writer(&writer, file);
   for (unsigned int a = 0; a < scene->num_antennas; ++a) {
     const struct Antenna* antenna = scene->antennas + a;
-    printf("  antenna %s at %d %d with range %d\n",
-           antenna->id, antenna->x, antenna->y, antenna->r);
+    write_string(&writer, "  antenna ");
+    write_string(&writer, antenna_identifier(scene, antenna));
+    write_string(&writer, " at ");
+    write_int(&writer, antenna->x);
+    write_char(&writer, ' ');
+    write_int(&writer, antenna->y);
+    write_string(&writer, " with range ");
+    write_int(&writer, antenna->r);
+    write_char(&writer, '\n');
+  }
+  close_writer(&writer);
+}
+
+void print_scene_bounding_box(const struct Scene* scene, FILE* file) {
+  struct SceneAggregates aggregates;
+  compute_scene_aggregates(scene, &aggregates);
+  print_aggregates_bounding_box(&aggregates, file);
+}
+
+void print_aggregates_bounding_box(const struct SceneAggregates* aggregates,
+                                   FILE* file) {
+  struct Writer writer;
+  open_writer(&writer, file);
+  if (aggregates->num_buildings == 0 && aggregates->num_antennas == 0) {
+    write_string(&writer, "undefined (empty scene)\n");
+  } else {
+    write_string(&writer, "bounding box [");
+    write_long(&writer, aggregates->xmin);
+    write_string(&writer, ", ");
+    write_long(&writer, aggregates->xmax);
+    write_string(&writer, "] x [");
+    write_long(&writer, aggregates->ymin);
+    write_string(&writer, ", ");
+    write_long(&writer, aggregates->ymax);
+    write_string(&writer, "]\n");
   }
+  close_writer(&writer);
+}
+
+// Aggregates
+// ----------
+
+void initialize_scene_aggregates(struct SceneAggregates* aggregates) {
+  aggregates->num_buildings = 0;
+  aggregates->num_antennas = 0;
+  aggregates->xmin = LLONG_MAX;
+  aggregates->xmax = LLONG_MIN;
+  aggregates->ymin = LLONG_MAX;
+  aggregates->ymax = LLONG_MIN;
 }
 
-void print_scene_bounding_box(const struct Scene* scene) {
-  if (scene_is_empty(scene)) {
-    printf("undefined (empty scene)\n");
+void fold_building(struct SceneAggregates* aggregates,
+                   const struct Building* building) {
+  long long x = building->x, y = building->y, w = building->w,
+            h = building->h;
+  ++aggregates->num_buildings;
+  aggregates->xmin = x - w < aggregates->xmin ? x - w : aggregates->xmin;
+  aggregates->xmax = x + w > aggregates->xmax ? x + w : aggregates->xmax;
+  aggregates->ymin = y - h < aggregates->ymin ? y - h : aggregates->ymin;
+  aggregates->ymax = y + h > aggregates->ymax ? y + h : aggregates->ymax;
+}
+
+void fold_antenna(struct SceneAggregates* aggregates,
+                  const struct Antenna* antenna) {
+  long long x = antenna->x, y = antenna->y, r = antenna->r;
+  ++aggregates->num_antennas;
+  aggregates->xmin = x - r < aggregates->xmin ? x - r : aggregates->xmin;
+  aggregates->xmax = x + r > aggregates->xmax ? x + r : aggregates->xmax;
+  aggregates->ymin = y - r < aggregates->ymin ? y - r : aggregates->ymin;
+  aggregates->ymax = y + r > aggregates->ymax ? y + r : aggregates->ymax;
+}
+
+void fold_box_columns(struct SceneAggregates* aggregates, const int* x,
+                      const int* y, const int* w, const int* h,
+                      unsigned int num_boxes) {
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("avx2")) {
+    fold_box_columns_avx2(aggregates, x, y, w, h, num_boxes);
     return;
   }
-  int xmin = INT_MAX, xmax = INT_MIN,
-      ymin = INT_MAX, ymax = INT_MIN;
-  for (unsigned int b = 0; b < scene->num_buildings; ++b) {
-    int x = scene->buildings[b].x,
-        y = scene->buildings[b].y,
-        w = scene->buildings[b].w,
-        h = scene->buildings[b].h;
-    xmin = x - w < xmin ? x - w : xmin;
-    xmax = x + w > xmax ? x + w : xmax;
-    ymin = y - h < ymin ? y - h : ymin;
-    ymax = y + h > ymax ? y + h : ymax;
+#endif
+  fold_box_columns_scalar(aggregates, x, y, w, h, num_boxes);
+}
+
+void fold_box_columns_scalar(struct SceneAggregates* aggregates, const int* x,
+                             const int* y, const int* w, const int* h,
+                             unsigned int num_boxes) {
+  long long xmin = aggregates->xmin, xmax = aggregates->xmax,
+            ymin = aggregates->ymin, ymax = aggregates->ymax;
+  for (unsigned int i = 0; i < num_boxes; ++i) {
+    long long left = (long long)x[i] - w[i], right = (long long)x[i] + w[i],
+              bottom = (long long)y[i] - h[i], top = (long long)y[i] + h[i];
+    xmin = left < xmin ? left : xmin;
+    xmax = right > xmax ? right : xmax;
+    ymin = bottom < ymin ? bottom : ymin;
+    ymax = top > ymax ? top : ymax;
   }
-  for (unsigned int a = 0; a < scene->num_antennas; ++a) {
-    int x = scene->antennas[a].x,
-        y = scene->antennas[a].y,
-        r = scene->antennas[a].r;
-    xmin = x - r < xmin ? x - r : xmin;
-    xmax = x + r > xmax ? x + r : xmax;
-    ymin = y - r < ymin ? y - r : ymin;
-    ymax = y + r > ymax ? y + r : ymax;
+  aggregates->xmin = xmin;
+  aggregates->xmax = xmax;
+  aggregates->ymin = ymin;
+  aggregates->ymax = ymax;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2")))
+void fold_box_columns_avx2(struct SceneAggregates* aggregates, const int* x,
+                           const int* y, const int* w, const int* h,
+                           unsigned int num_boxes) {
+  __m256i xmin = _mm256_set1_epi64x(aggregates->xmin),
+          xmax = _mm256_set1_epi64x(aggregates->xmax),
+          ymin = _mm256_set1_epi64x(aggregates->ymin),
+          ymax = _mm256_set1_epi64x(aggregates->ymax);
+  unsigned int i = 0;
+  for (; i + 8 <= num_boxes; i += 8) {
+    // The sides are computed on 64 bits, for two halves of 4 boxes
+    const __m128i* x4 = (const __m128i*)(x + i), * y4 = (const __m128i*)(y + i),
+                 * w4 = (const __m128i*)(w + i), * h4 = (const __m128i*)(h + i);
+    __m256i x0 = _mm256_cvtepi32_epi64(_mm_loadu_si128(x4)),
+            x1 = _mm256_cvtepi32_epi64(_mm_loadu_si128(x4 + 1)),
+            y0 = _mm256_cvtepi32_epi64(_mm_loadu_si128(y4)),
+            y1 = _mm256_cvtepi32_epi64(_mm_loadu_si128(y4 + 1)),
+            w0 = _mm256_cvtepi32_epi64(_mm_loadu_si128(w4)),
+            w1 = _mm256_cvtepi32_epi64(_mm_loadu_si128(w4 + 1)),
+            h0 = _mm256_cvtepi32_epi64(_mm_loadu_si128(h4)),
+            h1 = _mm256_cvtepi32_epi64(_mm_loadu_si128(h4 + 1));
+    __m256i left0 = _mm256_sub_epi64(x0, w0),
+            left1 = _mm256_sub_epi64(x1, w1),
+            right0 = _mm256_add_epi64(x0, w0),
+            right1 = _mm256_add_epi64(x1, w1),
+            bottom0 = _mm256_sub_epi64(y0, h0),
+            bottom1 = _mm256_sub_epi64(y1, h1),
+            top0 = _mm256_add_epi64(y0, h0),
+            top1 = _mm256_add_epi64(y1, h1);
+    // The halves are reduced together first, so that the bounds only wait
+    // for one comparison per group of 8 boxes
+    __m256i left = _mm256_blendv_epi8(left0, left1,
+                                      _mm256_cmpgt_epi64(left0, left1)),
+            right = _mm256_blendv_epi8(right0, right1,
+                                       _mm256_cmpgt_epi64(right1, right0)),
+            bottom = _mm256_blendv_epi8(bottom0, bottom1,
+                                        _mm256_cmpgt_epi64(bottom0, bottom1)),
+            top = _mm256_blendv_epi8(top0, top1,
+                                     _mm256_cmpgt_epi64(top1, top0));
+    xmin = _mm256_blendv_epi8(xmin, left, _mm256_cmpgt_epi64(xmin, left));
+    xmax = _mm256_blendv_epi8(xmax, right, _mm256_cmpgt_epi64(right, xmax));
+    ymin = _mm256_blendv_epi8(ymin, bottom, _mm256_cmpgt_epi64(ymin, bottom));
+    ymax = _mm256_blendv_epi8(ymax, top, _mm256_cmpgt_epi64(top, ymax));
   }
-  printf("bounding box [%d, %d] x [%d, %d]\n", xmin, xmax, ymin, ymax);
+  long long lanes[4][4];
+  _mm256_storeu_si256((__m256i*)lanes[0], xmin);
+  _mm256_storeu_si256((__m256i*)lanes[1], xmax);
+  _mm256_storeu_si256((__m256i*)lanes[2], ymin);
+  _mm256_storeu_si256((__m256i*)lanes[3], ymax);
+  for (unsigned int lane = 0; lane < 4; ++lane) {
+    if (lanes[0][lane] < aggregates->xmin)
+      aggregates->xmin = lanes[0][lane];
+    if (lanes[1][lane] > aggregates->xmax)
+      aggregates->xmax = lanes[1][lane];
+    if (lanes[2][lane] < aggregates->ymin)
+      aggregates->ymin = lanes[2][lane];
+    if (lanes[3][lane] > aggregates->ymax)
+      aggregates->ymax = lanes[3][lane];
+  }
+  // The remaining boxes are handled by the scalar kernel
+  fold_box_columns_scalar(aggregates, x + i, y + i, w + i, h + i,
+                          num_boxes - i);
+}
+
+#else
+
+void fold_box_columns_avx2(struct SceneAggregates* aggregates, const int* x,
+                           const int* y, const int* w, const int* h,
+                           unsigned int num_boxes) {
+  fold_box_columns_scalar(aggregates, x, y, w, h, num_boxes);
+}
+
+#endif
+
+void compute_scene_aggregates(const struct Scene* scene,
+                              struct SceneAggregates* aggregates) {
+  initialize_scene_aggregates(aggregates);
+  if (scene->has_columns) {
+    const struct SceneColumns* columns = &scene->columns;
+    aggregates->num_buildings = scene->num_buildings;
+    aggregates->num_antennas = scene->num_antennas;
+    fold_box_columns(aggregates, columns->building_x, columns->building_y,
+                     columns->building_w, columns->building_h,
+                     scene->num_buildings);
+    // The antennas are folded as the boxes enclosing their discs
+    fold_box_columns(aggregates, columns->antenna_x, columns->antenna_y,
+                     columns->antenna_r, columns->antenna_r,
+                     scene->num_antennas);
+    return;
+  }
+  for (unsigned int b = 0; b < scene->num_buildings; ++b)
+    fold_building(aggregates, scene->buildings + b);
+  for (unsigned int a = 0; a < scene->num_antennas; ++a)
+    fold_antenna(aggregates, scene->antennas + a);
 }
 
 // Modifiers
 // ---------
 
-void add_building(struct Scene* scene, const struct Building* building) {
-  unsigned int b = 0;
-  while (b < scene->num_buildings &&
-         strcmp(building->id, scene->buildings[b].id) > 0)
-    ++b;
-  if (b < scene->num_buildings &&
-      strcmp(building->id, scene->buildings[b].id) == 0)
-    report_error_non_unique_identifiers("building", building->id);
-  for (unsigned int b2 = scene->num_buildings; b2 > b; --b2)
-    scene->buildings[b2] = scene->buildings[b2 - 1];
+void reserve_scene(struct Scene* scene, unsigned int num_buildings,
+                   unsigned int num_antennas) {
+  reserve_buildings(scene, num_buildings);
+  reserve_antennas(scene, num_antennas);
+}
+
+bool add_building(struct Scene* scene, const struct Building* building,
+                  struct Error* error) {
+  const char* id = building_identifier(scene, building);
+  unsigned int low = 0, high = scene->num_buildings;
+  while (low < high) {
+    unsigned int middle = low + (high - low) / 2;
+    int comparison = compare_identifiers(building->key, id,
+        scene->buildings[middle].key,
+        building_identifier(scene, scene->buildings + middle));
+    if (comparison == 0)
+      return report_error_non_unique_identifiers(error, "building", id);
+    if (comparison > 0)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  unsigned int b = low;
+  reserve_buildings(scene, scene->num_buildings + 1);
+  memmove(scene->buildings + b + 1, scene->buildings + b,
+          (scene->num_buildings - b) * sizeof(struct Building));
   struct Building* scene_building = scene->buildings + b;
-  strncpy(scene_building->id, building->id, MAX_LENGTH_ID);
+  scene_building->key = building->key;
+  scene_building->id = building->id;
   scene_building->x = building->x;
   scene_building->y = building->y;
   scene_building->w = building->w;
   scene_building->h = building->h;
   ++scene->num_buildings;
+  return true;
 }
 
-void add_antenna(struct Scene* scene, const struct Antenna* antenna) {
-  unsigned int a = 0;
-  while (a < scene->num_antennas &&
-         strcmp(antenna->id, scene->antennas[a].id) > 0)
-    ++a;
-  if (a < scene->num_antennas &&
-      strcmp(antenna->id, scene->antennas[a].id) == 0)
-    report_error_non_unique_identifiers("antenna", antenna->id);
-  for (unsigned int a2 = scene->num_antennas; a2 > a; --a2)
-    scene->antennas[a2] = scene->antennas[a2 - 1];
+bool add_antenna(struct Scene* scene, const struct Antenna* antenna,
+                 struct Error* error) {
+  const char* id = antenna_identifier(scene, antenna);
+  unsigned int low = 0, high = scene->num_antennas;
+  while (low < high) {
+    unsigned int middle = low + (high - low) / 2;
+    int comparison = compare_identifiers(antenna->key, id,
+        scene->antennas[middle].key,
+        antenna_identifier(scene, scene->antennas + middle));
+    if (comparison == 0)
+      return report_error_non_unique_identifiers(error, "antenna", id);
+    if (comparison > 0)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  unsigned int a = low;
+  reserve_antennas(scene, scene->num_antennas + 1);
+  memmove(scene->antennas + a + 1, scene->antennas + a,
+          (scene->num_antennas - a) * sizeof(struct Antenna));
   struct Antenna* scene_antenna = scene->antennas + a;
-  strncpy(scene_antenna->id, antenna->id, MAX_LENGTH_ID);
+  scene_antenna->key = antenna->key;
+  scene_antenna->id = antenna->id;
   scene_antenna->x = antenna->x;
   scene_antenna->y = antenna->y;
   scene_antenna->r = antenna->r;
   ++scene->num_antennas;
+  return true;
+}
+
+void sync_scene_columns(struct Scene* scene) {
+  struct SceneColumns* columns = &scene->columns;
+  unsigned int num_buildings = scene->num_buildings,
+               num_antennas = scene->num_antennas;
+  size_t building_size = num_buildings * sizeof(int),
+         antenna_size = num_antennas * sizeof(int);
+  columns->building_x = arena_allocate(&scene->arena, building_size);
+  columns->building_y = arena_allocate(&scene->arena, building_size);
+  columns->building_w = arena_allocate(&scene->arena, building_size);
+  columns->building_h = arena_allocate(&scene->arena, building_size);
+  columns->antenna_x = arena_allocate(&scene->arena, antenna_size);
+  columns->antenna_y = arena_allocate(&scene->arena, antenna_size);
+  columns->antenna_r = arena_allocate(&scene->arena, antenna_size);
+  for (unsigned int b = 0; b < num_buildings; ++b) {
+    const struct Building* building = scene->buildings + b;
+    columns->building_x[b] = building->x;
+    columns->building_y[b] = building->y;
+    columns->building_w[b] = building->w;
+    columns->building_h[b] = building->h;
+  }
+  for (unsigned int a = 0; a < num_antennas; ++a) {
+    const struct Antenna* antenna = scene->antennas + a;
+    columns->antenna_x[a] = antenna->x;
+    columns->antenna_y[a] = antenna->y;
+    columns->antenna_r[a] = antenna->r;
+  }
+  scene->has_columns = true;
+}
+
+void sort_scene(struct Scene* scene) {
+  scene->has_columns = false;
+  struct Arena arena;
+  initialize_arena(&arena);
+  sort_buildings(scene, &arena);
+  sort_antennas(scene, &arena);
+  free_arena(&arena);
+}
+
+// Identifiers
+// -----------
+
+void set_building_identifier(struct Scene* scene, struct Building* building,
+                             const char* id) {
+  size_t length = strlen(id);
+  building->key = identifier_key(id, length);
+  building->id = add_identifier(&scene->ids, id, length);
+}
+
+void set_antenna_identifier(struct Scene* scene, struct Antenna* antenna,
+                            const char* id) {
+  size_t length = strlen(id);
+  antenna->key = identifier_key(id, length);
+  antenna->id = add_identifier(&scene->ids, id, length);
+}
+
+const char* building_identifier(const struct Scene* scene,
+                                const struct Building* building) {
+  return identifier_string(&scene->ids, building->id);
+}
+
+const char* antenna_identifier(const struct Scene* scene,
+                               const struct Antenna* antenna) {
+  return identifier_string(&scene->ids, antenna->id);
 }
@@ -2,24 +2,32 @@
 #define SCENE_H_
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 
-// Constants
-// ---------
-
-// The maximum length of an identifier
-#define MAX_LENGTH_ID 10
-// The maximum number of buildings in a scene
-#define NUM_MAX_BUILDINGS 100
-// The maximum number of antennas in a scene
-#define NUM_MAX_ANTENNAS 100
+#include "arena.h"
+#include "identifier.h"
+#include "input.h"
+#include "pool.h"
+#include "stats.h"
+#include "validation.h"
 
 // Types
 // -----
 
 // A building
+//
+// The identifiers of the objects are stored in the pool of identifiers of
+// their scene, and each object holds the handle of its identifier together
+// with its key (see identifier_key), so that most comparisons of identifiers
+// compare the keys only and the size of an object does not depend on the
+// length of its identifier.
 struct Building {
-  // The identifier of the building
-  char id[MAX_LENGTH_ID + 1];
+  // The key of the identifier of the building
+  uint64_t key;
+  // The identifier of the building, as a handle in the pool of its scene
+  uint32_t id;
   // The x coordinate of the building
   int x;
   // The y coordinate of the building
@@ -32,8 +40,10 @@ struct Building {
 
 // An antenna
 struct Antenna {
-  // The identifier of the antenna
-  char id[MAX_LENGTH_ID + 1];
+  // The key of the identifier of the antenna
+  uint64_t key;
+  // The identifier of the antenna, as a handle in the pool of its scene
+  uint32_t id;
   // The x coordinate of the antenna
   int x;
   // The y coordinate of the antenna
@@ -42,16 +52,158 @@ struct Antenna {
   int r;
 };
 
+// The coordinates of the objects of a scene, stored as a structure of arrays
+//
+// The item i of each building column belongs to the building i of the scene,
+// and the item i of each antenna column to its antenna i, so that the kernels
+// scanning coordinates load neither the identifiers nor the other columns.
+struct SceneColumns {
+  // The x coordinates of the buildings
+  int* building_x;
+  // The y coordinates of the buildings
+  int* building_y;
+  // The half widths of the buildings
+  int* building_w;
+  // The half heights of the buildings
+  int* building_h;
+  // The x coordinates of the antennas
+  int* antenna_x;
+  // The y coordinates of the antennas
+  int* antenna_y;
+  // The radii of the antennas
+  int* antenna_r;
+};
+
 // A scene
+//
+// The buildings and antennas are stored in arrays whose capacities double
+// when full, and sorted by identifier. All of them, and the pool of their
+// identifiers, are allocated from the arena of the scene, which is released
+// at once when the scene is deleted.
+//
+// A loaded scene also holds the columns of its coordinates. They are dropped
+// when the arrays are reserved or modified by the functions of this module,
+// and code writing the arrays directly must call reserve_scene first.
 struct Scene {
   // The number of building in the scene
   unsigned int num_buildings;
+  // The number of buildings the scene can hold before growing
+  unsigned int capacity_buildings;
   // The buildings of the scene
-  struct Building buildings[NUM_MAX_BUILDINGS];
+  struct Building* buildings;
   // The number of antennas in the scene
   unsigned int num_antennas;
+  // The number of antennas the scene can hold before growing
+  unsigned int capacity_antennas;
   // The antennas of the scene
-  struct Antenna antennas[NUM_MAX_ANTENNAS];
+  struct Antenna* antennas;
+  // The identifiers of the objects
+  struct IdentifierPool ids;
+  // The coordinates of the objects, by columns (if has_columns is true)
+  struct SceneColumns columns;
+  // true if the columns hold the coordinates of the objects of the arrays
+  bool has_columns;
+  // true if the scene is known to be valid (e.g. loaded from a validated
+  // binary scene)
+  bool is_validated;
+  // The arena from which the scene memory is allocated
+  struct Arena arena;
+  // The measures of the loading and validation of the scene (NULL if they
+  // are not measured)
+  struct RunStats* stats;
+};
+
+// The aggregates of a scene printed by summarize and bounding-box
+//
+// The aggregates are folded one object at a time, so that they can be
+// computed while a scene is streamed, without storing its objects. The bounds
+// are 64-bit integers, since the sides of an object, such as x + w, may leave
+// the range of int.
+struct SceneAggregates {
+  // The number of buildings
+  unsigned int num_buildings;
+  // The number of antennas
+  unsigned int num_antennas;
+  // The minimum x coordinate of the objects
+  long long xmin;
+  // The maximum x coordinate of the objects
+  long long xmax;
+  // The minimum y coordinate of the objects
+  long long ymin;
+  // The maximum y coordinate of the objects
+  long long ymax;
+};
+
+// The kinds of edits of a scene
+enum SceneEditKind {
+  // Adds a building
+  EDIT_ADD_BUILDING,
+  // Adds an antenna
+  EDIT_ADD_ANTENNA,
+  // Removes a building
+  EDIT_REMOVE_BUILDING,
+  // Removes an antenna
+  EDIT_REMOVE_ANTENNA,
+  // Moves the center of a building
+  EDIT_MOVE_BUILDING,
+  // Moves an antenna
+  EDIT_MOVE_ANTENNA
+};
+
+// An edit of a scene, read from a line of a delta
+//
+// A delta is a text file with one edit per line, among
+//
+//   add building ID X Y W H
+//   add antenna ID X Y R
+//   remove building ID
+//   remove antenna ID
+//   move building ID X Y
+//   move antenna ID X Y
+//
+// The identifier of the edited object is stored in the pool of the edited
+// scene.
+struct SceneEdit {
+  // The kind of the edit
+  enum SceneEditKind kind;
+  // The building edited (only the identifier and the position are set
+  // when it is moved, and only the identifier when it is removed)
+  struct Building building;
+  // The antenna edited (same as building)
+  struct Antenna antenna;
+};
+
+// The kinds of queries on a scene
+enum SceneQueryKind {
+  // Finds the antennas whose disc contains a point
+  QUERY_ANTENNAS_AT_POINT,
+  // Finds the buildings containing a point
+  QUERY_BUILDINGS_AT_POINT,
+  // Finds the buildings and the antenna discs meeting a window
+  QUERY_WINDOW
+};
+
+// A query on a scene, read from a line of a query file
+//
+// A query file is a text file with one query per line, among
+//
+//   antennas X Y
+//   buildings X Y
+//   window X1 Y1 X2 Y2
+//
+// where the window is given by two opposite corners. The boundaries of the
+// buildings, discs and windows are included.
+struct SceneQuery {
+  // The kind of the query
+  enum SceneQueryKind kind;
+  // The minimum x coordinate of the window (the x coordinate of a point)
+  int xmin;
+  // The minimum y coordinate of the window (the y coordinate of a point)
+  int ymin;
+  // The maximum x coordinate of the window (the x coordinate of a point)
+  int xmax;
+  // The maximum y coordinate of the window (the y coordinate of a point)
+  int ymax;
 };
 
 // Construction
@@ -64,12 +216,131 @@ struct Scene {
  */
 void initialize_empty_scene(struct Scene* scene);
 
+/**
+ * Creates an empty scene on the heap
+ *
+ * The scene must be released with delete_scene.
+ *
+ * @return  The created scene
+ */
+struct Scene* create_scene(void);
+
+/**
+ * Deletes a scene created with create_scene
+ *
+ * @param scene  The scene to delete
+ */
+void delete_scene(struct Scene* scene);
+
+/**
+ * Loads a scene from an input
+ *
+ * The input is either a text scene or a binary scene, which is recognized by
+ * its magic number. The objects read are added to the given scene, which is
+ * expected to be empty. The lines of a text scene are tokenized in place,
+ * without any length limit.
+ *
+ * If the input is not a valid scene, the error is reported and the objects
+ * already read are discarded. If the scene has stats, the tokenize and
+ * insert phases are recorded with their counters.
+ *
+ * @param scene  The resulting scene
+ * @param input  The input
+ * @param error  The error reported if the scene is invalid
+ * @return       true if and only if the scene was loaded
+ */
+bool load_scene(struct Scene* scene, const struct Input* input,
+                struct Error* error);
+
+/**
+ * Loads a scene from an input, parsing a large text scene in parallel
+ *
+ * A text scene larger than one chunk is split into chunks of whole lines,
+ * whose lines are counted and then parsed by the workers of the pool. The
+ * line numbers of each chunk follow from the prefix sums of the line counts,
+ * and the objects of the chunks are merged in their order. The scene loaded
+ * and the error reported are the same as with load_scene, which is used for
+ * small and binary inputs and with single-threaded pools.
+ *
+ * @param scene  The resulting scene, which must be empty
+ * @param input  The input
+ * @param pool   The thread pool
+ * @param error  The error reported if the scene is invalid
+ * @return       true if and only if the scene was loaded
+ */
+bool load_scene_in_parallel(struct Scene* scene, const struct Input* input,
+                            struct ThreadPool* pool, struct Error* error);
+
 /**
  * Loads a scene from the standard input
  *
+ * The objects read are added to the given scene, which is expected to be
+ * empty.
+ *
  * @param scene  The resulting scene
+ * @param error  The error reported if the scene is invalid
+ * @return       true if and only if the scene was loaded
+ */
+bool load_scene_from_stdin(struct Scene* scene, struct Error* error);
+
+/**
+ * Loads a scene from a buffer
+ *
+ * The buffer holds a text scene or a binary scene, as for load_scene, and is
+ * neither modified nor kept by the scene.
+ *
+ * @param scene  The resulting scene, which must be empty
+ * @param data   The content of the buffer
+ * @param size   The size of the buffer, in bytes
+ * @param error  The error reported if the scene is invalid
+ * @return       true if and only if the scene was loaded
+ */
+bool load_scene_from_buffer(struct Scene* scene, const char* data,
+                            size_t size, struct Error* error);
+
+/**
+ * Computes the aggregates of a text scene read line by line
+ *
+ * The objects are folded into the aggregates as soon as they are parsed,
+ * without being stored. If validation is requested, the identifiers, the
+ * buildings and the antenna positions are checked incrementally, and the
+ * same errors as load_scene and validate_scene are reported. Otherwise, the
+ * memory used does not depend on the number of objects.
+ *
+ * @param reader         The reader of the text scene
+ * @param is_validating  true if the scene must be validated
+ * @param aggregates     The resulting aggregates
+ * @param error          The error reported if the scene is invalid
+ * @return               true if and only if the whole scene was read
+ */
+bool stream_scene(struct LineReader* reader, bool is_validating,
+                  struct SceneAggregates* aggregates, struct Error* error);
+
+/**
+ * Reads an edit from a line of a delta
+ *
+ * @param line         The line
+ * @param line_number  The number of the line
+ * @param ids          The pool receiving the identifier of the edit
+ * @param edit         The resulting edit
+ * @param error        The error reported if the line is not a valid edit
+ * @return             true if and only if the line is a valid edit
+ */
+bool read_scene_edit(struct StringView line, int line_number,
+                     struct IdentifierPool* ids, struct SceneEdit* edit,
+                     struct Error* error);
+
+/**
+ * Reads a query from a line of a query file
+ *
+ * @param line         The line
+ * @param line_number  The number of the line
+ * @param query        The resulting query
+ * @param error        The error reported if the line is not a valid query
+ * @return             true if and only if the line is a valid query
  */
-void load_scene_from_stdin(struct Scene* scene);
+bool read_scene_query(struct StringView line, int line_number,
+                      struct SceneQuery* query, struct Error* error);
 
 // Validation
 // ----------
@@ -77,12 +348,16 @@ void load_scene_from_stdin(struct Scene* scene);
 /**
  * Checks if a scene is valid
  *
- * If the scene is invalid, an error is printed on stdout and the program exits
- * with 1.
+ * If the scene has stats, the validate_buildings and validate_antennas
+ * phases are recorded.
  *
  * @param scene  The scene to validate
+ * @param pool   The thread pool running the validation
+ * @param error  The error reported if the scene is invalid
+ * @return       true if and only if the scene is valid
  */
-void validate_scene(const struct Scene* scene);
+bool validate_scene(const struct Scene* scene, struct ThreadPool* pool,
+                    struct Error* error);
 
 // Accessors
 // ---------
@@ -96,50 +371,273 @@ void validate_scene(const struct Scene* scene);
 bool scene_is_empty(const struct Scene* scene);
 
 /**
- * Prints a summary of the scene on stdout
+ * Returns the building of a scene with a given identifier
+ *
+ * @param scene  The scene
+ * @param id     The identifier
+ * @return       The building, or NULL if there is none
+ */
+const struct Building* find_building(const struct Scene* scene,
+                                     const char* id);
+
+/**
+ * Returns the antenna of a scene with a given identifier
+ *
+ * @param scene  The scene
+ * @param id     The identifier
+ * @return       The antenna, or NULL if there is none
+ */
+const struct Antenna* find_antenna(const struct Scene* scene, const char* id);
+
+/**
+ * Prints a scene in the text format read by load_scene
  *
  * @param scene  The scene to print
+ * @param file   The file on which the scene is printed
+ */
+void print_scene(const struct Scene* scene, FILE* file);
+
+/**
+ * Prints a summary of the scene
+ *
+ * @param scene  The scene to print
+ * @param file   The file on which the summary is printed
+ */
+void print_scene_summary(const struct Scene* scene, FILE* file);
+
+/**
+ * Prints a summary of a scene from its aggregates
+ *
+ * @param aggregates  The aggregates of the scene
+ * @param file        The file on which the summary is printed
  */
-void print_scene_summary(const struct Scene* scene);
+void print_aggregates_summary(const struct SceneAggregates* aggregates,
+                              FILE* file);
 
 /**
- * Prints the building of the scene to stdout
+ * Prints the building of the scene
  *
  * @param scene  The scene whose buildings are printed
+ * @param file   The file on which the buildings are printed
  */
-void print_scene_buildings(const struct Scene* scene);
+void print_scene_buildings(const struct Scene* scene, FILE* file);
 
 /**
- * Prints the antenna of the scene to stdout
+ * Prints the antenna of the scene
  *
  * @param scene  The scene whose antennas are printed
+ * @param file   The file on which the antennas are printed
  */
-void print_scene_antennas(const struct Scene* scene);
+void print_scene_antennas(const struct Scene* scene, FILE* file);
 
 /**
- * Prints the bounding box of the scene to stdout
+ * Prints the bounding box of the scene
  *
  * @param scene  The scene whose bounding box is printed
+ * @param file   The file on which the bounding box is printed
+ */
+void print_scene_bounding_box(const struct Scene* scene, FILE* file);
+
+/**
+ * Prints the bounding box of a scene from its aggregates
+ *
+ * @param aggregates  The aggregates of the scene
+ * @param file        The file on which the bounding box is printed
+ */
+void print_aggregates_bounding_box(const struct SceneAggregates* aggregates,
+                                   FILE* file);
+
+// Aggregates
+// ----------
+
+/**
+ * Initializes the aggregates of an empty scene
+ *
+ * @param aggregates  The aggregates to initialize
+ */
+void initialize_scene_aggregates(struct SceneAggregates* aggregates);
+
+/**
+ * Folds a building into the aggregates of a scene
+ *
+ * @param aggregates  The aggregates
+ * @param building    The building
+ */
+void fold_building(struct SceneAggregates* aggregates,
+                   const struct Building* building);
+
+/**
+ * Folds an antenna into the aggregates of a scene
+ *
+ * @param aggregates  The aggregates
+ * @param antenna     The antenna
+ */
+void fold_antenna(struct SceneAggregates* aggregates,
+                  const struct Antenna* antenna);
+
+/**
+ * Folds boxes given by columns into the bounds of the aggregates of a scene
+ *
+ * The box i has center (x[i], y[i]), half width w[i] and half height h[i].
+ * The sides of the boxes are computed on 64-bit integers. The boxes are
+ * processed 8 at a time with AVX2 when the processor supports it, and one at
+ * a time otherwise, with identical results. The numbers of objects are left
+ * unchanged.
+ *
+ * @param aggregates  The aggregates
+ * @param x           The x coordinates of the centers
+ * @param y           The y coordinates of the centers
+ * @param w           The half widths
+ * @param h           The half heights
+ * @param num_boxes   The number of boxes
+ */
+void fold_box_columns(struct SceneAggregates* aggregates, const int* x,
+                      const int* y, const int* w, const int* h,
+                      unsigned int num_boxes);
+
+/**
+ * Folds boxes given by columns into bounds, one box at a time
+ *
+ * This is the scalar implementation of fold_box_columns.
+ *
+ * @param aggregates  The aggregates
+ * @param x           The x coordinates of the centers
+ * @param y           The y coordinates of the centers
+ * @param w           The half widths
+ * @param h           The half heights
+ * @param num_boxes   The number of boxes
+ */
+void fold_box_columns_scalar(struct SceneAggregates* aggregates, const int* x,
+                             const int* y, const int* w, const int* h,
+                             unsigned int num_boxes);
+
+/**
+ * Folds boxes given by columns into bounds, 8 boxes at a time with AVX2
+ *
+ * This function must only be called if the processor supports AVX2.
+ *
+ * @param aggregates  The aggregates
+ * @param x           The x coordinates of the centers
+ * @param y           The y coordinates of the centers
+ * @param w           The half widths
+ * @param h           The half heights
+ * @param num_boxes   The number of boxes
+ */
+void fold_box_columns_avx2(struct SceneAggregates* aggregates, const int* x,
+                           const int* y, const int* w, const int* h,
+                           unsigned int num_boxes);
+
+/**
+ * Computes the aggregates of a scene
+ *
+ * The columns of the scene are scanned by fold_box_columns if it has them,
+ * and its objects are folded one at a time otherwise.
+ *
+ * @param scene       The scene
+ * @param aggregates  The resulting aggregates
  */
-void print_scene_bounding_box(const struct Scene* scene);
+void compute_scene_aggregates(const struct Scene* scene,
+                              struct SceneAggregates* aggregates);
 
 // Modifiers
 // ---------
 
+/**
+ * Ensures that a scene can hold given numbers of objects without growing
+ *
+ * @param scene          The scene
+ * @param num_buildings  The number of buildings
+ * @param num_antennas   The number of antennas
+ */
+void reserve_scene(struct Scene* scene, unsigned int num_buildings,
+                   unsigned int num_antennas);
+
+/**
+ * Fills the columns of a scene from its arrays of objects
+ *
+ * It is called by the functions loading a scene. The columns are allocated
+ * from the arena of the scene.
+ *
+ * @param scene  The scene
+ */
+void sync_scene_columns(struct Scene* scene);
+
 /**
  * Adds a building to a scene
  *
+ * The identifier of the building must be stored in the pool of the scene.
+ *
  * @param scene     The scene to which the building is added
  * @param building  The building to add
+ * @param error     The error reported if its identifier is already used
+ * @return          true if and only if the building was added
  */
-void add_building(struct Scene* scene, const struct Building* building);
+bool add_building(struct Scene* scene, const struct Building* building,
+                  struct Error* error);
 
 /**
  * Adds an antenna to a scene
  *
+ * The identifier of the antenna must be stored in the pool of the scene.
+ *
  * @param scene    The scene to which the antenna is added
  * @param antenna  The antenna to add
+ * @param error    The error reported if its identifier is already used
+ * @return         true if and only if the antenna was added
+ */
+bool add_antenna(struct Scene* scene, const struct Antenna* antenna,
+                 struct Error* error);
+
+/**
+ * Sorts the objects of a scene by identifier
+ *
+ * This restores the order of a scene whose arrays were filled directly.
+ *
+ * @param scene  The scene to sort
+ */
+void sort_scene(struct Scene* scene);
+
+// Identifiers
+// -----------
+
+/**
+ * Sets the identifier of a building, stored in the pool of a scene
+ *
+ * @param scene     The scene
+ * @param building  The building
+ * @param id        The identifier, which must be valid
+ */
+void set_building_identifier(struct Scene* scene, struct Building* building,
+                             const char* id);
+
+/**
+ * Sets the identifier of an antenna, stored in the pool of a scene
+ *
+ * @param scene    The scene
+ * @param antenna  The antenna
+ * @param id       The identifier, which must be valid
+ */
+void set_antenna_identifier(struct Scene* scene, struct Antenna* antenna,
+                            const char* id);
+
+/**
+ * Returns the identifier of a building of a scene
+ *
+ * @param scene     The scene
+ * @param building  The building
+ * @return          The identifier
+ */
+const char* building_identifier(const struct Scene* scene,
+                                const struct Building* building);
+
+/**
+ * Returns the identifier of an antenna of a scene
+ *
+ * @param scene    The scene
+ * @param antenna  The antenna
+ * @return         The identifier
  */
-void add_antenna(struct Scene* scene, const struct Antenna* antenna);
+const char* antenna_identifier(const struct Scene* scene,
+                               const struct Antenna* antenna);
 
 #endif
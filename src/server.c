@@ -0,0 +1,469 @@
+// accept4 is a GNU extension
+#define _GNU_SOURCE
+
+#include "server.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The initial capacity of the buffers of requests and responses
+#define INITIAL_MESSAGE_CAPACITY 65536
+// The initial number of connections indexed by a server
+#define INITIAL_NUM_CONNECTIONS 16
+// The maximum length of the status line of a response
+#define MAX_LENGTH_RESPONSE_STATUS 63
+
+// Buffers
+// -------
+
+/**
+ * Grows a buffer allocated with malloc so that it can hold a given size
+ *
+ * @param buffer    The buffer (may be NULL if capacity is 0)
+ * @param capacity  The capacity of the buffer, updated if it grows
+ * @param size      The size that the buffer must hold
+ * @return          The buffer, possibly moved
+ */
+char* reserve_message(char* buffer, size_t* capacity, size_t size) {
+  if (size <= *capacity)
+    return buffer;
+  size_t grown = *capacity == 0 ? INITIAL_MESSAGE_CAPACITY : *capacity;
+  while (grown < size)
+    grown *= 2;
+  buffer = realloc(buffer, grown);
+  if (buffer == NULL)
+    report_error_out_of_memory();
+  *capacity = grown;
+  return buffer;
+}
+
+/**
+ * Writes a whole buffer on a blocking socket
+ *
+ * @param fd    The socket
+ * @param data  The buffer
+ * @param size  The size of the buffer
+ * @return      true if and only if the whole buffer was written
+ */
+bool send_all(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+    if (written < 0 && errno != EINTR)
+      return false;
+    if (written > 0) {
+      data += written;
+      size -= written;
+    }
+  }
+  return true;
+}
+
+/**
+ * Fills the address of a Unix domain socket
+ *
+ * @param address  The resulting address
+ * @param path     The path of the socket
+ * @return         false if the path is too long
+ */
+bool make_socket_address(struct sockaddr_un* address, const char* path) {
+  memset(address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(address->sun_path))
+    return false;
+  strcpy(address->sun_path, path);
+  return true;
+}
+
+// Connections
+// -----------
+
+/**
+ * Starts watching a new connection of a server
+ *
+ * @param server  The server
+ * @param fd      The socket of the connection
+ */
+void add_connection(struct Server* server, int fd) {
+  if (fd >= server->num_connections) {
+    int num_connections = server->num_connections == 0
+                        ? INITIAL_NUM_CONNECTIONS : server->num_connections;
+    while (num_connections <= fd)
+      num_connections *= 2;
+    server->connections = realloc(server->connections,
+                                  num_connections *
+                                  sizeof(struct Connection*));
+    if (server->connections == NULL)
+      report_error_out_of_memory();
+    memset(server->connections + server->num_connections, 0,
+           (num_connections - server->num_connections) *
+           sizeof(struct Connection*));
+    server->num_connections = num_connections;
+  }
+  struct Connection* connection = calloc(1, sizeof(struct Connection));
+  if (connection == NULL)
+    report_error_out_of_memory();
+  struct epoll_event event = {.events = EPOLLIN, .data.fd = fd};
+  if (epoll_ctl(server->epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+    free(connection);
+    close(fd);
+    return;
+  }
+  server->connections[fd] = connection;
+}
+
+/**
+ * Closes a connection of a server
+ *
+ * @param server  The server
+ * @param fd      The socket of the connection
+ */
+void remove_connection(struct Server* server, int fd) {
+  struct Connection* connection = server->connections[fd];
+  epoll_ctl(server->epoll, EPOLL_CTL_DEL, fd, NULL);
+  close(fd);
+  free(connection->request);
+  free(connection->response);
+  free(connection);
+  server->connections[fd] = NULL;
+}
+
+/**
+ * Accepts the pending connections of a server
+ *
+ * @param server  The server
+ */
+void accept_connections(struct Server* server) {
+  while (true) {
+    int fd = accept4(server->listener, NULL, NULL,
+                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+      return;
+    add_connection(server, fd);
+  }
+}
+
+// Requests
+// --------
+
+/**
+ * Parses the header line of a request if it was received
+ *
+ * The header line is 'SIZE ARGUMENTS', where SIZE is the size of the body.
+ * Its newline is replaced by a null character.
+ *
+ * @param connection  The connection
+ * @return            false if the header line is malformed
+ */
+bool parse_request_header(struct Connection* connection) {
+  size_t length = connection->request_size < MAX_LENGTH_REQUEST_HEADER + 1
+                ? connection->request_size : MAX_LENGTH_REQUEST_HEADER + 1;
+  char* newline = memchr(connection->request, '\n', length);
+  if (newline == NULL)
+    return length <= MAX_LENGTH_REQUEST_HEADER;
+  *newline = '\0';
+  const char* c = connection->request;
+  size_t body_size = 0;
+  if (!isdigit(*c))
+    return false;
+  for (; isdigit(*c); ++c) {
+    if (body_size > ((size_t)-1 - 9) / 10)
+      return false;
+    body_size = 10 * body_size + (*c - '0');
+  }
+  if (*c != ' ' && *c != '\0')
+    return false;
+  connection->body_size = body_size;
+  connection->arguments_start = c - connection->request + (*c == ' ');
+  connection->header_size = newline - connection->request + 1;
+  return true;
+}
+
+/**
+ * Builds the response of a connection
+ *
+ * @param server        The server
+ * @param connection    The connection
+ * @param is_malformed  true if the request is malformed
+ * @param handler       The function answering the request
+ * @param context       The context passed to the function
+ */
+void answer_request(const struct Server* server,
+                    struct Connection* connection, bool is_malformed,
+                    RequestHandler handler, void* context) {
+  char* answer;
+  size_t answer_size;
+  FILE* file = open_memstream(&answer, &answer_size);
+  if (file == NULL)
+    report_error_out_of_memory();
+  struct Error error;
+  bool success = is_malformed
+               ? report_error_invalid_request(&error)
+               : connection->body_size > server->max_body_size
+               ? report_error_request_too_large(&error, server->max_body_size)
+               : handler(context,
+                         connection->request + connection->arguments_start,
+                         connection->request + connection->header_size,
+                         connection->body_size, file, &error);
+  if (fclose(file) != 0)
+    report_error_out_of_memory();
+  file = open_memstream(&connection->response, &connection->response_size);
+  if (file == NULL)
+    report_error_out_of_memory();
+  if (success) {
+    fprintf(file, "ok %zu\n", answer_size);
+    fwrite(answer, 1, answer_size, file);
+  } else {
+    fprintf(file, "error %d %zu\n%s", (int)error.kind,
+            strlen(error.message), error.message);
+  }
+  if (fclose(file) != 0)
+    report_error_out_of_memory();
+  free(answer);
+}
+
+/**
+ * Writes as much of the response of a connection as possible
+ *
+ * The connection is closed once the response is completely written, or if
+ * the client went away.
+ *
+ * @param server  The server
+ * @param fd      The socket of the connection
+ */
+void write_response(struct Server* server, int fd) {
+  struct Connection* connection = server->connections[fd];
+  while (connection->num_written < connection->response_size) {
+    ssize_t written = send(fd, connection->response + connection->num_written,
+                           connection->response_size -
+                           connection->num_written, MSG_NOSIGNAL);
+    if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      return;
+    if (written < 0 && errno != EINTR)
+      break;
+    if (written > 0)
+      connection->num_written += written;
+  }
+  remove_connection(server, fd);
+}
+
+/**
+ * Reads the available bytes of the request of a connection
+ *
+ * Once the request is complete, or as soon as its header line shows that it
+ * is malformed or too large, it is answered and the connection switches to
+ * writing the response.
+ *
+ * @param server   The server
+ * @param fd       The socket of the connection
+ * @param handler  The function answering the request
+ * @param context  The context passed to the function
+ */
+void read_request(struct Server* server, int fd, RequestHandler handler,
+                  void* context) {
+  struct Connection* connection = server->connections[fd];
+  bool is_closed = false, is_malformed = false, is_too_large = false;
+  while (!is_closed && !is_malformed && !is_too_large) {
+    connection->request = reserve_message(connection->request,
+                                          &connection->request_capacity,
+                                          connection->request_size + 1);
+    ssize_t num_read = read(fd, connection->request + connection->request_size,
+                            connection->request_capacity -
+                            connection->request_size);
+    if (num_read > 0)
+      connection->request_size += num_read;
+    else if (num_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      break;
+    else if (num_read == 0 || errno != EINTR)
+      is_closed = true;
+    is_malformed = connection->header_size == 0 &&
+                   !parse_request_header(connection);
+    is_too_large = connection->header_size > 0 &&
+                   connection->body_size > server->max_body_size;
+  }
+  bool is_complete = connection->header_size > 0 &&
+                     connection->request_size - connection->header_size >=
+                     connection->body_size;
+  if (is_malformed || is_too_large || is_complete) {
+    answer_request(server, connection, is_malformed, handler, context);
+    struct epoll_event event = {.events = EPOLLOUT, .data.fd = fd};
+    epoll_ctl(server->epoll, EPOLL_CTL_MOD, fd, &event);
+    write_response(server, fd);
+  } else if (is_closed) {
+    remove_connection(server, fd);
+  }
+}
+
+// Public functions definition
+// ===========================
+
+// Server
+// ------
+
+bool open_server(struct Server* server, const char* path,
+                 size_t max_body_size, struct Error* error) {
+  struct sockaddr_un address;
+  if (!make_socket_address(&address, path))
+    return report_error_cannot_listen(error, path);
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, &server->previous_signals);
+  server->path = path;
+  server->max_body_size = max_body_size;
+  server->connections = NULL;
+  server->num_connections = 0;
+  server->signals = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+  server->listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK |
+                            SOCK_CLOEXEC, 0);
+  server->epoll = epoll_create1(EPOLL_CLOEXEC);
+  bool is_bound = server->signals >= 0 && server->listener >= 0 &&
+                  server->epoll >= 0 &&
+                  bind(server->listener, (struct sockaddr*)&address,
+                       sizeof(address)) == 0;
+  struct epoll_event listener_event = {.events = EPOLLIN,
+                                       .data.fd = server->listener},
+                     signals_event = {.events = EPOLLIN,
+                                      .data.fd = server->signals};
+  if (is_bound && listen(server->listener, SOMAXCONN) == 0 &&
+      epoll_ctl(server->epoll, EPOLL_CTL_ADD, server->listener,
+                &listener_event) == 0 &&
+      epoll_ctl(server->epoll, EPOLL_CTL_ADD, server->signals,
+                &signals_event) == 0)
+    return true;
+  if (is_bound)
+    unlink(path);
+  if (server->signals >= 0)
+    close(server->signals);
+  if (server->listener >= 0)
+    close(server->listener);
+  if (server->epoll >= 0)
+    close(server->epoll);
+  pthread_sigmask(SIG_SETMASK, &server->previous_signals, NULL);
+  return report_error_cannot_listen(error, path);
+}
+
+void run_server(struct Server* server, RequestHandler handler,
+                void* context) {
+  struct epoll_event events[MAX_SERVER_EVENTS];
+  bool is_running = true;
+  while (is_running) {
+    int num_events = epoll_wait(server->epoll, events, MAX_SERVER_EVENTS, -1);
+    if (num_events < 0 && errno != EINTR)
+      break;
+    for (int e = 0; e < num_events; ++e) {
+      int fd = events[e].data.fd;
+      if (fd == server->signals)
+        is_running = false;
+      else if (fd == server->listener)
+        accept_connections(server);
+      else if (server->connections[fd]->response != NULL)
+        write_response(server, fd);
+      else
+        read_request(server, fd, handler, context);
+    }
+  }
+}
+
+void close_server(struct Server* server) {
+  for (int fd = 0; fd < server->num_connections; ++fd)
+    if (server->connections[fd] != NULL)
+      remove_connection(server, fd);
+  free(server->connections);
+  close(server->listener);
+  struct signalfd_siginfo signal_info;
+  while (read(server->signals, &signal_info, sizeof(signal_info)) ==
+         (ssize_t)sizeof(signal_info))
+    continue;
+  pthread_sigmask(SIG_SETMASK, &server->previous_signals, NULL);
+  close(server->signals);
+  close(server->epoll);
+  unlink(server->path);
+}
+
+// Client
+// ------
+
+bool send_request(const char* path, const char* arguments, const char* body,
+                  size_t body_size, struct ServerResponse* response,
+                  struct Error* error) {
+  char header[MAX_LENGTH_REQUEST_HEADER + 1];
+  int header_length = snprintf(header, sizeof(header), "%zu %s\n",
+                               body_size, arguments);
+  if (header_length < 0 || (size_t)header_length >= sizeof(header))
+    return report_error_invalid_request(error);
+  struct sockaddr_un address;
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  bool success = fd >= 0 && make_socket_address(&address, path) &&
+                 connect(fd, (struct sockaddr*)&address,
+                         sizeof(address)) == 0;
+  // The server may answer before the whole body is sent, when it rejects
+  // the request, so that the response is read even if the sending fails
+  if (success && send_all(fd, header, header_length))
+    send_all(fd, body, body_size);
+  char* buffer = NULL;
+  size_t size = 0, capacity = 0;
+  while (success) {
+    buffer = reserve_message(buffer, &capacity, size + 1);
+    ssize_t num_read = read(fd, buffer + size, capacity - size);
+    if (num_read > 0)
+      size += num_read;
+    else if (num_read == 0)
+      break;
+    else if (errno != EINTR)
+      success = false;
+  }
+  if (fd >= 0)
+    close(fd);
+  // The status line is 'ok SIZE' or 'error KIND SIZE'
+  const char* newline = success ? memchr(buffer, '\n', size) : NULL;
+  char status[MAX_LENGTH_RESPONSE_STATUS + 1];
+  size_t status_length = newline == NULL ? 0 : newline - buffer;
+  int kind = 0, num_parsed = 0;
+  size_t data_size = 0;
+  if (newline != NULL && status_length <= MAX_LENGTH_RESPONSE_STATUS) {
+    memcpy(status, buffer, status_length);
+    status[status_length] = '\0';
+    response->success = sscanf(status, "ok %zu%n", &data_size,
+                               &num_parsed) == 1;
+    if (!response->success &&
+        sscanf(status, "error %d %zu%n", &kind, &data_size,
+               &num_parsed) != 2)
+      num_parsed = 0;
+  }
+  if (num_parsed == 0 || (size_t)num_parsed != status_length ||
+      data_size != size - status_length - 1) {
+    free(buffer);
+    return report_error_cannot_connect(error, path);
+  }
+  response->buffer = buffer;
+  response->kind = kind;
+  response->data = newline + 1;
+  response->size = data_size;
+  return true;
+}
+
+void free_server_response(struct ServerResponse* response) {
+  free(response->buffer);
+  response->buffer = NULL;
+}
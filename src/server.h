@@ -0,0 +1,170 @@
+#ifndef SERVER_H_
+#define SERVER_H_
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "validation.h"
+
+// Constants
+// ---------
+
+// The maximum length of the header line of a request
+#define MAX_LENGTH_REQUEST_HEADER 4096
+// The maximum number of events handled by one wait of the event loop
+#define MAX_SERVER_EVENTS 64
+
+// Types
+// -----
+
+// A function answering a request received by a server
+//
+// The arguments are the header line of the request, without its size and
+// its newline, which the function may modify, and the body of the request.
+// The answer is printed on the given file. If the request fails, the error
+// is recorded and false is returned.
+typedef bool (*RequestHandler)(void* context, char* arguments,
+                               const char* body, size_t body_size,
+                               FILE* file, struct Error* error);
+
+// A connection accepted by a server
+//
+// A connection carries a single request, made of a header line 'SIZE
+// ARGUMENTS' followed by SIZE bytes of body, and a single response, made of
+// a line 'ok SIZE' or 'error KIND SIZE' followed by SIZE bytes of answer or
+// of error message. The server closes the connection once the response is
+// written.
+struct Connection {
+  // The bytes of the request received so far
+  char* request;
+  // The number of bytes of the request received so far
+  size_t request_size;
+  // The capacity of the request buffer
+  size_t request_capacity;
+  // The size of the header line, newline included (0 until received)
+  size_t header_size;
+  // The offset of the arguments in the header line
+  size_t arguments_start;
+  // The size of the body
+  size_t body_size;
+  // The response (NULL until the request is answered)
+  char* response;
+  // The size of the response
+  size_t response_size;
+  // The number of bytes of the response already written
+  size_t num_written;
+};
+
+// A server answering requests on a Unix domain socket
+//
+// The server runs a single-threaded event loop on epoll. The connections are
+// indexed by their file descriptor. SIGINT and SIGTERM are received through a
+// signalfd, and stop the server cleanly.
+struct Server {
+  // The path of the socket
+  const char* path;
+  // The maximum size of the body of a request, in bytes
+  size_t max_body_size;
+  // The listening socket
+  int listener;
+  // The file descriptor receiving the stopping signals
+  int signals;
+  // The signal mask of the calling thread before the server was opened
+  sigset_t previous_signals;
+  // The epoll instance
+  int epoll;
+  // The connections, indexed by file descriptor (NULL if none)
+  struct Connection** connections;
+  // The number of items of connections
+  int num_connections;
+};
+
+// A response received by a client
+struct ServerResponse {
+  // The bytes received (allocated with malloc)
+  char* buffer;
+  // true if the request succeeded
+  bool success;
+  // The kind of the error if the request failed
+  enum ErrorKind kind;
+  // The answer, or the error message, inside buffer
+  const char* data;
+  // The size of data
+  size_t size;
+};
+
+// Server
+// ------
+
+/**
+ * Opens a server listening on a Unix domain socket
+ *
+ * SIGINT and SIGTERM are blocked in the calling thread, which must be the one
+ * running the server, so that they are received by the event loop, until the
+ * server is closed. They must also be blocked in every other thread of the
+ * process.
+ *
+ * @param server         The server to open
+ * @param path           The path of the socket, which must not exist
+ * @param max_body_size  The maximum size of the body of a request, in bytes,
+ *                       beyond which the request is answered with an error
+ *                       without being read
+ * @param error          The error reported if the socket cannot be created
+ * @return               true if and only if the server is listening
+ */
+bool open_server(struct Server* server, const char* path,
+                 size_t max_body_size, struct Error* error);
+
+/**
+ * Answers the requests received by a server until it is stopped
+ *
+ * The requests are answered one at a time, in the order in which they are
+ * completely received. A malformed request, or a request whose body is too
+ * large, is answered with an error as soon as its header line is received.
+ *
+ * @param server   The server
+ * @param handler  The function answering the requests
+ * @param context  The context passed to the function
+ */
+void run_server(struct Server* server, RequestHandler handler,
+                void* context);
+
+/**
+ * Closes a server and removes its socket
+ *
+ * The pending SIGINT and SIGTERM are discarded, and the signal mask of the
+ * calling thread is restored as it was before the server was opened.
+ *
+ * @param server  The server to close
+ */
+void close_server(struct Server* server);
+
+// Client
+// ------
+
+/**
+ * Sends a request to a server and waits for its response
+ *
+ * @param path       The path of the socket of the server
+ * @param arguments  The header line of the request, without size or newline
+ * @param body       The body of the request
+ * @param body_size  The size of the body
+ * @param response   The resulting response, to be released with
+ *                   free_server_response
+ * @param error      The error reported if the exchange fails
+ * @return           true if and only if a response was received
+ */
+bool send_request(const char* path, const char* arguments, const char* body,
+                  size_t body_size, struct ServerResponse* response,
+                  struct Error* error);
+
+/**
+ * Releases the memory held by a response
+ *
+ * @param response  The response
+ */
+void free_server_response(struct ServerResponse* response);
+
+#endif
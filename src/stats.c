@@ -0,0 +1,127 @@
+#include "stats.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The names of the phases, as printed
+const char* STATS_PHASE_NAMES[NUM_STATS_PHASES] = {
+  "read", "tokenize", "insert", "validate_buildings", "validate_antennas",
+  "process", "output"
+};
+
+// Clocks
+// ------
+
+/**
+ * Returns the CPU time used by all the threads of the process
+ *
+ * @return  The time, in seconds
+ */
+double stats_cpu_clock(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Returns the peak resident set size of the process
+ *
+ * @return  The size, in KB
+ */
+long stats_peak_rss(void) {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void start_run_stats(struct RunStats* stats) {
+  memset(stats, 0, sizeof(struct RunStats));
+  stats->lap_wall_time = stats_wall_clock();
+  stats->lap_cpu_time = stats_cpu_clock();
+}
+
+// Measures
+// --------
+
+double stats_wall_clock(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+void record_stats_phase(struct RunStats* stats, enum StatsPhase phase) {
+  double wall_time = stats_wall_clock(), cpu_time = stats_cpu_clock();
+  struct PhaseStats* measures = stats->phases + phase;
+  measures->wall_time += wall_time - stats->lap_wall_time;
+  measures->cpu_time += cpu_time - stats->lap_cpu_time;
+  measures->peak_rss = stats_peak_rss();
+  stats->lap_wall_time = wall_time;
+  stats->lap_cpu_time = cpu_time;
+}
+
+void shift_stats_time(struct RunStats* stats, enum StatsPhase from,
+                      enum StatsPhase to, double wall_time) {
+  struct PhaseStats* source = stats->phases + from,
+                   * target = stats->phases + to;
+  if (wall_time > source->wall_time)
+    wall_time = source->wall_time;
+  double cpu_time = source->wall_time > 0
+                  ? source->cpu_time * wall_time / source->wall_time : 0;
+  source->wall_time -= wall_time;
+  source->cpu_time -= cpu_time;
+  target->wall_time += wall_time;
+  target->cpu_time += cpu_time;
+  if (source->peak_rss > target->peak_rss)
+    target->peak_rss = source->peak_rss;
+}
+
+// Printing
+// --------
+
+void print_run_stats(const struct RunStats* stats, bool is_json, FILE* file) {
+  if (is_json) {
+    fprintf(file, "{\"phases\": {");
+    for (unsigned int p = 0; p < NUM_STATS_PHASES; ++p) {
+      const struct PhaseStats* phase = stats->phases + p;
+      fprintf(file, "%s\"%s\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f, "
+              "\"peak_rss_kb\": %ld}", p == 0 ? "" : ", ",
+              STATS_PHASE_NAMES[p], phase->wall_time * 1e3,
+              phase->cpu_time * 1e3, phase->peak_rss);
+    }
+    fprintf(file, "}, \"counters\": {\"lines\": %llu, \"bytes\": %llu, "
+            "\"comparisons\": %llu, \"moves\": %llu}}\n",
+            (unsigned long long)stats->num_lines,
+            (unsigned long long)stats->num_bytes,
+            (unsigned long long)stats->num_comparisons,
+            (unsigned long long)stats->num_moves);
+    return;
+  }
+  fprintf(file, "%-18s %12s %12s %14s\n", "phase", "wall (ms)", "cpu (ms)",
+          "peak rss (KB)");
+  for (unsigned int p = 0; p < NUM_STATS_PHASES; ++p) {
+    const struct PhaseStats* phase = stats->phases + p;
+    fprintf(file, "%-18s %12.3f %12.3f %14ld\n", STATS_PHASE_NAMES[p],
+            phase->wall_time * 1e3, phase->cpu_time * 1e3, phase->peak_rss);
+  }
+  fprintf(file, "lines %llu, bytes %llu, comparisons %llu, moves %llu\n",
+          (unsigned long long)stats->num_lines,
+          (unsigned long long)stats->num_bytes,
+          (unsigned long long)stats->num_comparisons,
+          (unsigned long long)stats->num_moves);
+}
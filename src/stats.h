@@ -0,0 +1,123 @@
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Types
+// -----
+
+// The phases of a run measured by --stats
+enum StatsPhase {
+  // The input is opened (mapped, or read if it is a stream)
+  PHASE_READ,
+  // The lines are split in tokens and decoded
+  PHASE_TOKENIZE,
+  // The objects are indexed by identifier and sorted
+  PHASE_INSERT,
+  // The buildings are checked for overlaps
+  PHASE_VALIDATE_BUILDINGS,
+  // The antennas are checked for shared positions
+  PHASE_VALIDATE_ANTENNAS,
+  // The result is computed (coverage, placement)
+  PHASE_PROCESS,
+  // The result is written
+  PHASE_OUTPUT,
+  // The number of phases
+  NUM_STATS_PHASES
+};
+
+// The resources used by a phase
+struct PhaseStats {
+  // The wall time, in seconds
+  double wall_time;
+  // The CPU time of all the threads, in seconds
+  double cpu_time;
+  // The peak resident set size of the process at the end of the phase, in KB
+  long peak_rss;
+};
+
+// The measures of a run
+//
+// The phases are measured by laps: recording a phase charges it with the
+// time elapsed since the previous record, so that consecutive phases only
+// read the clocks once between them.
+struct RunStats {
+  // The resources used by each phase
+  struct PhaseStats phases[NUM_STATS_PHASES];
+  // The wall time of the last record, in seconds
+  double lap_wall_time;
+  // The CPU time of the last record, in seconds
+  double lap_cpu_time;
+  // The number of lines read
+  uint64_t num_lines;
+  // The number of bytes read
+  uint64_t num_bytes;
+  // The number of identifier keys compared to index the objects
+  uint64_t num_comparisons;
+  // The number of objects moved to sort them
+  uint64_t num_moves;
+};
+
+// Construction
+// ------------
+
+/**
+ * Starts measuring a run
+ *
+ * All the phases and counters are zeroed, and the first lap starts.
+ *
+ * @param stats  The measures to start
+ */
+void start_run_stats(struct RunStats* stats);
+
+// Measures
+// --------
+
+/**
+ * Returns the wall time elapsed since an arbitrary origin
+ *
+ * This clock is cheap enough to time each object separately.
+ *
+ * @return  The time, in seconds
+ */
+double stats_wall_clock(void);
+
+/**
+ * Charges a phase with the resources used since the previous record
+ *
+ * @param stats  The measures
+ * @param phase  The phase
+ */
+void record_stats_phase(struct RunStats* stats, enum StatsPhase phase);
+
+/**
+ * Moves wall time from a phase to another one, with a proportional share of
+ * its CPU time
+ *
+ * This splits phases that alternate on each object, whose CPU time is too
+ * costly to read every time.
+ *
+ * @param stats      The measures
+ * @param from       The phase losing the time
+ * @param to         The phase receiving the time
+ * @param wall_time  The wall time moved, in seconds
+ */
+void shift_stats_time(struct RunStats* stats, enum StatsPhase from,
+                      enum StatsPhase to, double wall_time);
+
+// Printing
+// --------
+
+/**
+ * Prints the measures of a run
+ *
+ * @param stats    The measures
+ * @param is_json  true to print a JSON object on one line, false to print
+ *                 a table
+ * @param file     The file on which the measures are printed
+ */
+void print_run_stats(const struct RunStats* stats, bool is_json, FILE* file);
+
+#endif
@@ -1,17 +1,163 @@
 #include "validation.h"
 
 #include <ctype.h>
+#include <limits.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The maximum number of digits of a positive int
+#define MAX_INT_DIGITS 10
+
+// Errors
+// ------
+
+/**
+ * Records the kind and the message of an error
+ *
+ * The line number is set to 0 and the identifiers are cleared. The message
+ * is truncated to MAX_LENGTH_ERROR_MESSAGE characters.
+ *
+ * @param error   The error
+ * @param kind    The kind of the error
+ * @param format  The format of the message, as for printf
+ * @param ...     The arguments of the format
+ * @return        false
+ */
+bool format_error(struct Error* error, enum ErrorKind kind,
+                  const char* format, ...) {
+  error->kind = kind;
+  error->line_number = 0;
+  error->ids[0][0] = '\0';
+  error->ids[1][0] = '\0';
+  va_list arguments;
+  va_start(arguments, format);
+  vsnprintf(error->message, sizeof(error->message), format, arguments);
+  va_end(arguments);
+  return false;
+}
+
+/**
+ * Records the identifiers of the objects involved in an error
+ *
+ * The identifiers are truncated to MAX_LENGTH_ERROR_ID characters.
+ *
+ * @param error  The error
+ * @param id1    The first identifier
+ * @param id2    The second identifier (NULL if there is only one)
+ * @return       false
+ */
+bool record_error_ids(struct Error* error, const char* id1,
+                      const char* id2) {
+  snprintf(error->ids[0], sizeof(error->ids[0]), "%s", id1);
+  if (id2 != NULL)
+    snprintf(error->ids[1], sizeof(error->ids[1]), "%s", id2);
+  return false;
+}
+
+/**
+ * Records the line of the scene where an error was found
+ *
+ * @param error        The error
+ * @param line_number  The line number
+ * @return             false
+ */
+bool record_error_line(struct Error* error, int line_number) {
+  error->line_number = line_number;
+  return false;
+}
+
+// Decoding
+// --------
+
+/**
+ * Indicates if 8 characters packed in a word are all decimal digits
+ *
+ * Each byte is checked at once (SWAR): a byte is a digit if its high nibble
+ * is 3 and adding 6 to it does not carry into the high nibble.
+ *
+ * @param word  The characters
+ * @return      true if and only if all characters are digits
+ */
+bool are_eight_digits(uint64_t word) {
+  return (word & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull &&
+         ((word + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) ==
+           0x3030303030303030ull;
+}
+
+/**
+ * Decodes 8 decimal digits packed in a word
+ *
+ * The first digit is in the lowest byte. Pairs of digits, then pairs of
+ * pairs, are combined with one multiplication each.
+ *
+ * @param word  The digits
+ * @return      The value of the digits
+ */
+uint64_t decode_eight_digits(uint64_t word) {
+  word -= 0x3030303030303030ull;
+  word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFull;
+  word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFull;
+  return (word * 10000 + (word >> 32)) & 0x00000000FFFFFFFFull;
+}
+
+/**
+ * Parses a string of digits whose first digit is not 0
+ *
+ * The digits are right-aligned in a 16-byte block padded with '0', which is
+ * then classified and decoded 8 bytes at a time.
+ *
+ * @param s        The digits
+ * @param length   The number of digits
+ * @param maximum  The largest accepted value
+ * @param value    The resulting value, if the digits are valid
+ * @return         true if and only if s is a valid value at most maximum
+ */
+bool parse_digits(const char* s, size_t length, uint64_t maximum,
+                  uint64_t* value) {
+  if (length == 0 || length > MAX_INT_DIGITS || *s < '1' || *s > '9')
+    return false;
+  char block[16];
+  memset(block, '0', sizeof(block));
+  memcpy(block + sizeof(block) - length, s, length);
+  uint64_t high, low;
+  memcpy(&high, block, sizeof(high));
+  memcpy(&low, block + sizeof(high), sizeof(low));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (!are_eight_digits(high) || !are_eight_digits(low))
+    return false;
+  *value = decode_eight_digits(high) * 100000000 + decode_eight_digits(low);
+#else
+  *value = 0;
+  for (size_t i = 0; i < sizeof(block); ++i) {
+    if (!isdigit((unsigned char)block[i]))
+      return false;
+    *value = 10 * *value + (block[i] - '0');
+  }
+#endif
+  return *value <= maximum;
+}
+
+// Public functions definition
+// ===========================
 
 // Validation
 // ----------
 
-bool is_valid_id(const char* s) {
-  if (*s == '\0' || (!isalpha(*s) && *s != '_'))
+bool is_valid_id(const char* s, size_t length) {
+  const char* end = s + length;
+  if (s == end || (!isalpha(*s) && *s != '_'))
     return false;
-  while (*s != '\0') {
+  while (s != end) {
     if (!isalnum(*s) && *s != '_')
       return false;
     ++s;
@@ -19,100 +165,258 @@ bool is_valid_id(const char* s) {
   return true;
 }
 
-bool is_valid_integer(const char* s) {
-  if (*s == '0' && *(s + 1) == '\0')
+bool parse_integer(const char* s, size_t length, int* value) {
+  uint64_t magnitude;
+  if (length == 1 && *s == '0') {
+    *value = 0;
     return true;
-  if (*s == '-')
-    ++s;
-  if (*s < '1' || *s > '9')
-    return false;
-  ++s;
-  while (*s != '\0') {
-    if (!isdigit(*s))
+  }
+  if (length > 0 && *s == '-') {
+    if (!parse_digits(s + 1, length - 1, (uint64_t)INT_MAX + 1, &magnitude))
       return false;
-    ++s;
+    *value = (int)(-(int64_t)magnitude);
+    return true;
   }
+  if (!parse_digits(s, length, INT_MAX, &magnitude))
+    return false;
+  *value = (int)magnitude;
   return true;
 }
 
-bool is_valid_positive_integer(const char* s) {
-  if (*s < '1' || *s > '9')
+bool parse_positive_integer(const char* s, size_t length, int* value) {
+  uint64_t magnitude;
+  if (!parse_digits(s, length, INT_MAX, &magnitude))
     return false;
-  ++s;
-  while (*s != '\0') {
-    if (!isdigit(*s))
-      return false;
-    ++s;
-  }
+  *value = (int)magnitude;
   return true;
 }
 
 // Error reporting
 // ---------------
 
-void report_error_non_unique_identifiers(const char* object, const char* id) {
-  fprintf(stderr, "error: %s identifier %s is non unique\n", object, id);
-  exit(1);
+void print_error(const struct Error* error, FILE* file) {
+  fprintf(file, "error: %s\n", error->message);
 }
 
-void report_error_invalid_identifier(const char* id, int line_number) {
-  fprintf(stderr, "error: invalid identifier \"%s\" (line #%d)\n", id,
-          line_number);
-  exit(1);
+bool report_error_non_unique_identifiers(struct Error* error,
+                                         const char* object, const char* id) {
+  format_error(error, ERROR_NON_UNIQUE_IDENTIFIER,
+               "%s identifier %s is non unique", object, id);
+  return record_error_ids(error, id, NULL);
 }
 
-void report_error_invalid_int(const char* s, int line_number) {
-  fprintf(stderr, "error: invalid integer \"%s\" (line #%d)\n", s, line_number);
-  exit(1);
+bool report_error_invalid_identifier(struct Error* error, const char* id,
+                                     size_t length, int line_number) {
+  format_error(error, ERROR_INVALID_IDENTIFIER,
+               "invalid identifier \"%.*s\" (line #%d)", (int)length, id,
+               line_number);
+  return record_error_line(error, line_number);
 }
 
-void report_error_invalid_positive_int(const char* s, int line_number) {
-  fprintf(stderr, "error: invalid positive integer \"%s\" (line #%d)\n", s,
-          line_number);
-  exit(1);
+bool report_error_invalid_int(struct Error* error, const char* s,
+                              size_t length, int line_number) {
+  format_error(error, ERROR_INVALID_INTEGER,
+               "invalid integer \"%.*s\" (line #%d)", (int)length, s,
+               line_number);
+  return record_error_line(error, line_number);
 }
 
-void report_error_scene_first_line(void) {
-  fprintf(stderr, "error: first line must be exactly 'begin scene'\n");
-  exit(1);
+bool report_error_invalid_positive_int(struct Error* error, const char* s,
+                                       size_t length, int line_number) {
+  format_error(error, ERROR_INVALID_INTEGER,
+               "invalid positive integer \"%.*s\" (line #%d)", (int)length,
+               s, line_number);
+  return record_error_line(error, line_number);
 }
 
-void report_error_unrecognized_line(int line_number) {
-  fprintf(stderr, "error: unrecognized line (line #%d)\n", line_number);
-  exit(1);
+bool report_error_scene_first_line(struct Error* error) {
+  format_error(error, ERROR_SCENE_FIRST_LINE,
+               "first line must be exactly 'begin scene'");
+  return record_error_line(error, 1);
+}
+
+bool report_error_unrecognized_line(struct Error* error, int line_number) {
+  format_error(error, ERROR_UNRECOGNIZED_LINE,
+               "unrecognized line (line #%d)", line_number);
+  return record_error_line(error, line_number);
 }
 
-void report_error_line_wrong_arguments_number(const char* object,
+bool report_error_line_wrong_arguments_number(struct Error* error,
+                                              const char* object,
                                               int line_number) {
-  fprintf(stderr,
-          "error: %s line has wrong number of arguments (line #%d)\n",
-          object,
-          line_number);
-  exit(1);
+  format_error(error, ERROR_WRONG_NUMBER_OF_ARGUMENTS,
+               "%s line has wrong number of arguments (line #%d)", object,
+               line_number);
+  return record_error_line(error, line_number);
 }
 
-void report_error_scene_last_line(void) {
-  fprintf(stderr, "error: last line must be exactly 'end scene'\n");
-  exit(1);
+bool report_error_line_without_token(struct Error* error, int line_number) {
+  format_error(error, ERROR_UNRECOGNIZED_LINE, "line has no token");
+  return record_error_line(error, line_number);
 }
 
-void report_error_overlapping_buildings(const char* id1, const char* id2) {
-  fprintf(stderr, "error: buildings %s and %s are overlapping\n", id1, id2);
-  exit(1);
+bool report_error_scene_last_line(struct Error* error) {
+  return format_error(error, ERROR_SCENE_LAST_LINE,
+                      "last line must be exactly 'end scene'");
 }
 
-void report_error_same_position_antennas(const char* id1, const char* id2) {
-  fprintf(stderr, "error: antennas %s and %s have the same position\n",
-          id1, id2);
-  exit(1);
+bool report_error_overlapping_buildings(struct Error* error, const char* id1,
+                                        const char* id2) {
+  format_error(error, ERROR_OVERLAPPING_BUILDINGS,
+               "buildings %s and %s are overlapping", id1, id2);
+  return record_error_ids(error, id1, id2);
 }
 
-void report_error_mandatory_subcommand(void) {
-  fprintf(stderr, "error: subcommand is mandatory\n");
-  exit(1);
+bool report_error_same_position_antennas(struct Error* error, const char* id1,
+                                         const char* id2) {
+  format_error(error, ERROR_SAME_POSITION_ANTENNAS,
+               "antennas %s and %s have the same position", id1, id2);
+  return record_error_ids(error, id1, id2);
 }
 
-void report_error_unrecognized_subcommand(const char* subcommand) {
-  fprintf(stderr, "error: subcommand '%s' is not recognized\n", subcommand);
+bool report_error_uncoverable_building(struct Error* error, const char* id,
+                                       int radius) {
+  format_error(error, ERROR_UNCOVERABLE_BUILDING,
+               "building %s cannot be covered by an antenna of radius %d", id,
+               radius);
+  return record_error_ids(error, id, NULL);
+}
+
+bool report_error_too_many_sites(struct Error* error, const char* id,
+                                 int radius, int step) {
+  format_error(error, ERROR_TOO_MANY_SITES,
+               "building %s has too many candidate sites for radius %d and "
+               "step %d", id, radius, step);
+  return record_error_ids(error, id, NULL);
+}
+
+void report_error_out_of_memory(void) {
+  fprintf(stderr, "error: out of memory\n");
   exit(1);
 }
+
+bool report_error_cannot_start_thread(struct Error* error) {
+  return format_error(error, ERROR_CANNOT_START_THREAD,
+                      "cannot start thread");
+}
+
+bool report_error_invalid_binary_scene(struct Error* error) {
+  return format_error(error, ERROR_INVALID_BINARY_SCENE,
+                      "invalid binary scene");
+}
+
+bool report_error_cannot_write_file(struct Error* error, const char* path) {
+  return format_error(error, ERROR_CANNOT_WRITE_FILE,
+                      "cannot write file '%s'", path);
+}
+
+bool report_error_cannot_read_file(struct Error* error, const char* path) {
+  return format_error(error, ERROR_CANNOT_READ_FILE,
+                      "cannot read file '%s'", path);
+}
+
+bool report_error_mandatory_subcommand(struct Error* error) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "subcommand is mandatory");
+}
+
+bool report_error_unrecognized_subcommand(struct Error* error,
+                                          const char* subcommand) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "subcommand '%s' is not recognized", subcommand);
+}
+
+bool report_error_unrecognized_option(struct Error* error,
+                                      const char* option) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "option '%s' is not recognized", option);
+}
+
+bool report_error_missing_option_argument(struct Error* error,
+                                          const char* option) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "option '%s' requires an argument", option);
+}
+
+bool report_error_invalid_option_argument(struct Error* error,
+                                          const char* option,
+                                          const char* argument) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "invalid argument '%s' for option '%s'", argument,
+                      option);
+}
+
+bool report_error_unbatchable_subcommand(struct Error* error,
+                                         const char* subcommand) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "subcommand '%s' cannot be run by batch", subcommand);
+}
+
+bool report_error_unbatchable_option(struct Error* error, const char* option) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "option '%s' cannot be given to batch", option);
+}
+
+bool report_error_mandatory_option(struct Error* error, const char* option) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "option '%s' is mandatory", option);
+}
+
+bool report_error_unservable_subcommand(struct Error* error,
+                                        const char* subcommand) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "subcommand '%s' cannot be served", subcommand);
+}
+
+bool report_error_cannot_listen(struct Error* error, const char* path) {
+  return format_error(error, ERROR_SOCKET,
+                      "cannot listen on socket '%s'", path);
+}
+
+bool report_error_cannot_connect(struct Error* error, const char* path) {
+  return format_error(error, ERROR_SOCKET,
+                      "cannot exchange with server on socket '%s'", path);
+}
+
+bool report_error_invalid_request(struct Error* error) {
+  return format_error(error, ERROR_INVALID_REQUEST, "invalid request");
+}
+
+bool report_error_request_too_large(struct Error* error,
+                                    size_t max_body_size) {
+  return format_error(error, ERROR_INVALID_REQUEST,
+                      "request larger than %zu bytes", max_body_size);
+}
+
+bool report_error_from_server(struct Error* error, enum ErrorKind kind,
+                              const char* message, size_t length) {
+  return format_error(error, kind, "%.*s", (int)length, message);
+}
+
+bool report_error_unknown_identifier(struct Error* error, const char* object,
+                                     const char* id) {
+  format_error(error, ERROR_UNKNOWN_IDENTIFIER, "%s identifier %s is unknown",
+               object, id);
+  return record_error_ids(error, id, NULL);
+}
+
+bool append_error_line(struct Error* error, int line_number) {
+  if (error->line_number != 0)
+    return false;
+  size_t length = strlen(error->message);
+  snprintf(error->message + length, sizeof(error->message) - length,
+           " (line #%d)", line_number);
+  return record_error_line(error, line_number);
+}
+
+bool report_error_too_large_scene(struct Error* error) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "generated scene is too large");
+}
+
+bool report_error_unsupported_option(struct Error* error, const char* option,
+                                     const char* subcommand) {
+  return format_error(error, ERROR_INVALID_USAGE,
+                      "option '%s' cannot be given to %s", option,
+                      subcommand);
+}
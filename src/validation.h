@@ -2,6 +2,77 @@
 #define VALIDATION_H_
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Constants
+// ---------
+
+// The maximum length of an error message
+#define MAX_LENGTH_ERROR_MESSAGE 255
+// The maximum length of an identifier recorded in an error
+#define MAX_LENGTH_ERROR_ID 63
+
+// Types
+// -----
+
+// The kinds of errors
+enum ErrorKind {
+  // An identifier is used by two objects of the same type
+  ERROR_NON_UNIQUE_IDENTIFIER,
+  // A token is not a valid identifier
+  ERROR_INVALID_IDENTIFIER,
+  // A token is not a valid (positive) integer
+  ERROR_INVALID_INTEGER,
+  // The first line of a scene is not 'begin scene'
+  ERROR_SCENE_FIRST_LINE,
+  // The last line of a scene is not 'end scene'
+  ERROR_SCENE_LAST_LINE,
+  // A line of a scene is neither a building nor an antenna
+  ERROR_UNRECOGNIZED_LINE,
+  // An object line has the wrong number of tokens
+  ERROR_WRONG_NUMBER_OF_ARGUMENTS,
+  // Two buildings are overlapping
+  ERROR_OVERLAPPING_BUILDINGS,
+  // Two antennas have the same position
+  ERROR_SAME_POSITION_ANTENNAS,
+  // A building cannot be covered by a placed antenna
+  ERROR_UNCOVERABLE_BUILDING,
+  // An input is not a well-formed binary scene
+  ERROR_INVALID_BINARY_SCENE,
+  // A file cannot be read
+  ERROR_CANNOT_READ_FILE,
+  // A file cannot be written
+  ERROR_CANNOT_WRITE_FILE,
+  // The command line is invalid
+  ERROR_INVALID_USAGE,
+  // A socket cannot be opened or used
+  ERROR_SOCKET,
+  // A request received by a server is malformed
+  ERROR_INVALID_REQUEST,
+  // An identifier edited by a delta designates no object
+  ERROR_UNKNOWN_IDENTIFIER,
+  // A building has too many candidate sites for a placement
+  ERROR_TOO_MANY_SITES,
+  // A thread cannot be started
+  ERROR_CANNOT_START_THREAD
+};
+
+// An error reported by a function that failed
+//
+// The functions that can fail return false and describe the failure in an
+// error provided by their caller, so that a failure never ends the program
+// by itself.
+struct Error {
+  // The kind of the error
+  enum ErrorKind kind;
+  // The line of the scene where the error was found (0 if none)
+  int line_number;
+  // The identifiers of the objects involved ("" if none)
+  char ids[2][MAX_LENGTH_ERROR_ID + 1];
+  // The message of the error, without the "error: " prefix
+  char message[MAX_LENGTH_ERROR_MESSAGE + 1];
+};
 
 // Validations
 // -----------
@@ -13,120 +84,413 @@
  *
  *   [a-zA-Z_][a-zA-Z0-1_]*
  *
- * @param s  The string to verify
- * @return   true if and only if the string is a valid identifier
+ * @param s       The string to verify
+ * @param length  The length of the string
+ * @return        true if and only if the string is a valid identifier
  */
-bool is_valid_id(const char* s);
+bool is_valid_id(const char* s, size_t length);
 
 /**
- * Indicates if a string is a valid integer
+ * Parses a string as an integer
  *
  * An string is a valid integer if it completely matches the BRE
  *
  *   0|([-]?[1-9][0-9]*)
  *
- * @param s  The string to verify
- * @return   true if and only if the string is a valid identifier
+ * and if its value fits in an int. The string is validated and decoded in
+ * a single pass.
+ *
+ * @param s       The string to parse
+ * @param length  The length of the string
+ * @param value   The resulting value, if the string is valid
+ * @return        true if and only if the string is a valid integer
  */
-bool is_valid_integer(const char* s);
+bool parse_integer(const char* s, size_t length, int* value);
 
 /**
- * Indicates if a string is a valid positive integer
+ * Parses a string as a positive integer
  *
  * An string is a valid positive integer if it completely matches the BRE
  *
  *   [1-9][0-9]*
  *
- * @param s  The string to verify
- * @return   true if and only if the string is a valid identifier
+ * and if its value fits in an int. The string is validated and decoded in
+ * a single pass.
+ *
+ * @param s       The string to parse
+ * @param length  The length of the string
+ * @param value   The resulting value, if the string is valid
+ * @return        true if and only if the string is a valid positive integer
  */
-bool is_valid_positive_integer(const char* s);
+bool parse_positive_integer(const char* s, size_t length, int* value);
 
 // Error reporting
 // ---------------
 
 /**
- * Reports on stderr that a given object identifier is not unique
+ * Prints an error on a file, prefixed with "error: "
  *
+ * @param error  The error
+ * @param file   The file
+ */
+void print_error(const struct Error* error, FILE* file);
+
+/**
+ * Records in an error that a given object identifier is not unique
+ *
+ * @param error   The error
  * @param object  The object
  * @param id      The identifier
+ * @return        false
  */
-void report_error_non_unique_identifiers(const char* object, const char* id);
+bool report_error_non_unique_identifiers(struct Error* error,
+                                         const char* object, const char* id);
 
 /**
- * Reports on stderr that an identifier is invalid
+ * Records in an error that an identifier is invalid
  *
+ * @param error        The error
  * @param id           The identifier
+ * @param length       The length of the identifier
  * @param line_number  The line number
+ * @return             false
  */
-void report_error_invalid_identifier(const char* id, int line_number);
+bool report_error_invalid_identifier(struct Error* error, const char* id,
+                                     size_t length, int line_number);
 
 /**
- * Reports on stderr that a string is not a valid integer
+ * Records in an error that a string is not a valid integer
  *
+ * @param error        The error
  * @param s            The string
+ * @param length       The length of the string
  * @param line_number  The line number
+ * @return             false
  */
-void report_error_invalid_int(const char* s, int line_number);
+bool report_error_invalid_int(struct Error* error, const char* s,
+                              size_t length, int line_number);
 
 /**
- * Reports on stderr that a string is not a valid positive integer
+ * Records in an error that a string is not a valid positive integer
  *
+ * @param error        The error
  * @param s            The string
+ * @param length       The length of the string
  * @param line_number  The line number
+ * @return             false
  */
-void report_error_invalid_positive_int(const char* s, int line_number);
+bool report_error_invalid_positive_int(struct Error* error, const char* s,
+                                       size_t length, int line_number);
 
 /**
- * Reports on stderr that the first line of a scene is invalid
+ * Records in an error that the first line of a scene is invalid
+ *
+ * @param error  The error
+ * @return       false
  */
-void report_error_scene_first_line(void);
+bool report_error_scene_first_line(struct Error* error);
 
 /**
- * Reports on stderr that a scene line is not recognized
+ * Records in an error that a scene line is not recognized
  *
+ * @param error        The error
  * @param line_number  The number of the unrecognized line
+ * @return             false
  */
-void report_error_unrecognized_line(int line_number);
+bool report_error_unrecognized_line(struct Error* error, int line_number);
 
 /**
- * Reports on stderr that a building line has the wrong number of arguments
+ * Records in an error that a building line has the wrong number of arguments
  *
+ * @param error        The error
  * @param object       The object on the line
  * @param line_number  The number of the unrecognized line
+ * @return             false
  */
-void report_error_line_wrong_arguments_number(const char* object,
+bool report_error_line_wrong_arguments_number(struct Error* error,
+                                              const char* object,
                                               int line_number);
 
 /**
- * Reports on stderr that the last line of a scene is invalid
+ * Records in an error that a line of a scene has no token
+ *
+ * @param error        The error
+ * @param line_number  The line number
+ * @return             false
+ */
+bool report_error_line_without_token(struct Error* error, int line_number);
+
+/**
+ * Records in an error that the last line of a scene is invalid
+ *
+ * @param error  The error
+ * @return       false
+ */
+bool report_error_scene_last_line(struct Error* error);
+
+/**
+ * Records in an error that two buildings are overlapping
+ *
+ * @param error  The error
+ * @param id1    The identifier of the first building
+ * @param id2    The identifier of the second building
+ * @return       false
+ */
+bool report_error_overlapping_buildings(struct Error* error, const char* id1,
+                                        const char* id2);
+
+/**
+ * Records in an error that two antennas have the same position
+ *
+ * @param error  The error
+ * @param id1    The identifier of the first antenna
+ * @param id2    The identifier of the second antenna
+ * @return       false
+ */
+bool report_error_same_position_antennas(struct Error* error, const char* id1,
+                                         const char* id2);
+
+/**
+ * Records in an error that a building cannot be covered by a placed antenna
+ *
+ * @param error   The error
+ * @param id      The identifier of the building
+ * @param radius  The radius of the placed antennas
+ * @return        false
+ */
+bool report_error_uncoverable_building(struct Error* error, const char* id,
+                                       int radius);
+
+/**
+ * Records in an error that a building has too many candidate sites
+ *
+ * @param error   The error
+ * @param id      The identifier of the building
+ * @param radius  The radius of the placed antennas
+ * @param step    The spacing of the grid of candidate sites
+ * @return        false
+ */
+bool report_error_too_many_sites(struct Error* error, const char* id,
+                                 int radius, int step);
+
+/**
+ * Reports on stderr that memory could not be allocated
+ *
+ * The program exits with 1.
+ */
+void report_error_out_of_memory(void);
+
+/**
+ * Records in an error that a thread could not be started
+ *
+ * @param error  The error
+ * @return       false
+ */
+bool report_error_cannot_start_thread(struct Error* error);
+
+/**
+ * Records in an error that a binary scene is malformed
+ *
+ * @param error  The error
+ * @return       false
+ */
+bool report_error_invalid_binary_scene(struct Error* error);
+
+/**
+ * Records in an error that a file cannot be written
+ *
+ * @param error  The error
+ * @param path   The path of the file
+ * @return       false
+ */
+bool report_error_cannot_write_file(struct Error* error, const char* path);
+
+/**
+ * Records in an error that a file cannot be read
+ *
+ * @param error  The error
+ * @param path   The path of the file
+ * @return       false
+ */
+bool report_error_cannot_read_file(struct Error* error, const char* path);
+
+/**
+ * Records in an error that the subcommand is mandatory
+ *
+ * @param error  The error
+ * @return       false
+ */
+bool report_error_mandatory_subcommand(struct Error* error);
+
+/**
+ * Records in an error that the subcommand is unrecognized
+ *
+ * @param error       The error
+ * @param subcommand  The subcommand
+ * @return            false
+ */
+bool report_error_unrecognized_subcommand(struct Error* error,
+                                          const char* subcommand);
+
+/**
+ * Records in an error that an option is unrecognized
+ *
+ * @param error   The error
+ * @param option  The option
+ * @return        false
+ */
+bool report_error_unrecognized_option(struct Error* error,
+                                      const char* option);
+
+/**
+ * Records in an error that an option is missing its argument
+ *
+ * @param error   The error
+ * @param option  The option
+ * @return        false
+ */
+bool report_error_missing_option_argument(struct Error* error,
+                                          const char* option);
+
+/**
+ * Records in an error that the argument of an option is invalid
+ *
+ * @param error     The error
+ * @param option    The option
+ * @param argument  The argument
+ * @return          false
+ */
+bool report_error_invalid_option_argument(struct Error* error,
+                                          const char* option,
+                                          const char* argument);
+
+/**
+ * Records in an error that a subcommand cannot be run by batch
+ *
+ * @param error       The error
+ * @param subcommand  The subcommand
+ * @return            false
+ */
+bool report_error_unbatchable_subcommand(struct Error* error,
+                                         const char* subcommand);
+
+/**
+ * Records in an error that an option cannot be given to batch
+ *
+ * @param error   The error
+ * @param option  The option
+ * @return        false
+ */
+bool report_error_unbatchable_option(struct Error* error, const char* option);
+
+/**
+ * Records in an error that a mandatory option is missing
+ *
+ * @param error   The error
+ * @param option  The option
+ * @return        false
+ */
+bool report_error_mandatory_option(struct Error* error, const char* option);
+
+/**
+ * Records in an error that a subcommand cannot be answered by a server
+ *
+ * @param error       The error
+ * @param subcommand  The subcommand
+ * @return            false
+ */
+bool report_error_unservable_subcommand(struct Error* error,
+                                        const char* subcommand);
+
+/**
+ * Records in an error that a server cannot listen on a socket
+ *
+ * @param error  The error
+ * @param path   The path of the socket
+ * @return       false
  */
-void report_error_scene_last_line(void);
+bool report_error_cannot_listen(struct Error* error, const char* path);
 
 /**
- * Reports on stderr that two buildings are overlapping
+ * Records in an error that a client cannot exchange with a server
  *
- * @param id1  The identifier of the first building
- * @param id2  The identifier of the second building
+ * @param error  The error
+ * @param path   The path of the socket of the server
+ * @return       false
  */
-void report_error_overlapping_buildings(const char* id1, const char* id2);
+bool report_error_cannot_connect(struct Error* error, const char* path);
 
 /**
- * Reports on stderr that two antennas have the same position
+ * Records in an error that a request received by a server is malformed
  *
- * @param id1  The identifier of the first antenna
- * @param id2  The identifier of the second antenna
+ * @param error  The error
+ * @return       false
  */
-void report_error_same_position_antennas(const char* id1, const char* id2);
+bool report_error_invalid_request(struct Error* error);
 
 /**
- * Reports on stderr that the subcommand is mandatory
+ * Records in an error that the body of a request received by a server is too
+ * large
+ *
+ * @param error          The error
+ * @param max_body_size  The maximum size of a body, in bytes
+ * @return               false
  */
-void report_error_mandatory_subcommand(void);
+bool report_error_request_too_large(struct Error* error,
+                                    size_t max_body_size);
 
 /**
- * Reports on stderr that the subcommand is unrecognized
+ * Records in an error a failure reported by a server
+ *
+ * @param error    The error
+ * @param kind     The kind of the failure
+ * @param message  The message of the failure (not null-terminated)
+ * @param length   The length of the message
+ * @return         false
+ */
+bool report_error_from_server(struct Error* error, enum ErrorKind kind,
+                              const char* message, size_t length);
+
+/**
+ * Records in an error that a given object identifier designates no object
+ *
+ * @param error   The error
+ * @param object  The object
+ * @param id      The identifier
+ * @return        false
+ */
+bool report_error_unknown_identifier(struct Error* error, const char* object,
+                                     const char* id);
+
+/**
+ * Appends to an error the line of a delta where it was found
+ *
+ * An error already carrying a line number is left unchanged.
+ *
+ * @param error        The error
+ * @param line_number  The line number
+ * @return             false
+ */
+bool append_error_line(struct Error* error, int line_number);
+
+/**
+ * Records in an error that the parameters of a generated scene give
+ * coordinates or identifiers out of range
+ *
+ * @param error  The error
+ * @return       false
+ */
+bool report_error_too_large_scene(struct Error* error);
+
+/**
+ * Records in an error that an option cannot be given to a subcommand
+ *
+ * @param error       The error
+ * @param option      The option
+ * @param subcommand  The subcommand
+ * @return            false
  */
-void report_error_unrecognized_subcommand(const char* subcommand);
+bool report_error_unsupported_option(struct Error* error, const char* option,
+                                     const char* subcommand);
 
 #endif
@@ -0,0 +1,172 @@
+#include "writer.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "validation.h"
+
+// Private constants, types and functions
+// ======================================
+
+// Constants
+// ---------
+
+// The decimal digits of the numbers from 00 to 99
+const char DIGIT_PAIRS[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536"
+  "37383940414243444546474849505152535455565758596061626364656667686970717273"
+  "7475767778798081828384858687888990919293949596979899";
+
+// Output
+// ------
+
+/**
+ * Writes all the bytes of a list of buffers on a descriptor
+ *
+ * @param fd       The descriptor
+ * @param iov      The buffers, whose lengths are reduced to the numbers of
+ *                 bytes left unwritten
+ * @param num_iov  The number of buffers
+ * @return         true if and only if all the bytes were written
+ */
+bool write_all_buffers(int fd, struct iovec* iov, int num_iov) {
+  while (num_iov > 0) {
+    ssize_t written = writev(fd, iov, num_iov);
+    if (written < 0 && errno == EINTR)
+      continue;
+    if (written <= 0)
+      return false;
+    while (num_iov > 0 && (size_t)written >= iov->iov_len) {
+      written -= iov->iov_len;
+      iov->iov_len = 0;
+      ++iov;
+      --num_iov;
+    }
+    if (num_iov > 0) {
+      iov->iov_base = (char*)iov->iov_base + written;
+      iov->iov_len -= written;
+    }
+  }
+  return true;
+}
+
+/**
+ * Writes the buffered text of a writer followed by other bytes
+ *
+ * @param writer  The writer
+ * @param data    The other bytes
+ * @param length  The number of other bytes
+ */
+void write_through(struct Writer* writer, const char* data, size_t length) {
+  struct iovec iov[2] = {{writer->buffer, writer->size},
+                         {(char*)data, length}};
+  writer->size = 0;
+  if (writer->fd >= 0 && write_all_buffers(writer->fd, iov, 2))
+    return;
+  // The bytes left are given to the file, which records any failure
+  for (unsigned int i = 0; i < 2; ++i)
+    fwrite(iov[i].iov_base, 1, iov[i].iov_len, writer->file);
+}
+
+// Public functions definition
+// ===========================
+
+// Construction
+// ------------
+
+void open_writer(struct Writer* writer, FILE* file) {
+  fflush(file);
+  writer->file = file;
+  writer->fd = fileno(file);
+  writer->size = 0;
+  writer->buffer = malloc(WRITER_CAPACITY);
+  if (writer->buffer == NULL)
+    report_error_out_of_memory();
+}
+
+void close_writer(struct Writer* writer) {
+  flush_writer(writer);
+  free(writer->buffer);
+  writer->buffer = NULL;
+}
+
+// Writing
+// -------
+
+void flush_writer(struct Writer* writer) {
+  if (writer->size > 0)
+    write_through(writer, NULL, 0);
+}
+
+void write_bytes(struct Writer* writer, const char* data, size_t length) {
+  if (writer->size + length <= WRITER_CAPACITY) {
+    memcpy(writer->buffer + writer->size, data, length);
+    writer->size += length;
+  } else if (length < WRITER_CAPACITY / 2) {
+    flush_writer(writer);
+    memcpy(writer->buffer, data, length);
+    writer->size = length;
+  } else {
+    write_through(writer, data, length);
+  }
+}
+
+void write_string(struct Writer* writer, const char* s) {
+  write_bytes(writer, s, strlen(s));
+}
+
+void write_char(struct Writer* writer, char c) {
+  if (writer->size == WRITER_CAPACITY)
+    flush_writer(writer);
+  writer->buffer[writer->size++] = c;
+}
+
+void write_int(struct Writer* writer, int value) {
+  if (value >= 0) {
+    write_unsigned(writer, value);
+    return;
+  }
+  write_char(writer, '-');
+  // The negation is done on unsigned integers so that INT_MIN is handled
+  write_unsigned(writer, 0u - (unsigned int)value);
+}
+
+void write_long(struct Writer* writer, long long value) {
+  if (value >= INT_MIN && value <= INT_MAX) {
+    write_int(writer, value);
+    return;
+  }
+  // The values beyond int are rare enough to be formatted by the C library
+  char text[24];
+  write_bytes(writer, text, snprintf(text, sizeof(text), "%lld", value));
+}
+
+void write_unsigned(struct Writer* writer, unsigned int value) {
+  unsigned int length = 1;
+  for (unsigned int bound = 10; length < 10 && value >= bound; bound *= 10)
+    ++length;
+  if (writer->size + length > WRITER_CAPACITY)
+    flush_writer(writer);
+  // The digits are written by pairs, from the last one
+  char* c = writer->buffer + writer->size + length;
+  writer->size += length;
+  while (value >= 100) {
+    const char* pair = DIGIT_PAIRS + 2 * (value % 100);
+    value /= 100;
+    *--c = pair[1];
+    *--c = pair[0];
+  }
+  if (value >= 10) {
+    *--c = DIGIT_PAIRS[2 * value + 1];
+    *--c = DIGIT_PAIRS[2 * value];
+  } else {
+    *--c = '0' + value;
+  }
+}
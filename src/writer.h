@@ -0,0 +1,120 @@
+#ifndef WRITER_H_
+#define WRITER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Constants
+// ---------
+
+// The capacity of the buffer of a writer, in bytes
+#define WRITER_CAPACITY (1 << 16)
+
+// Types
+// -----
+
+// A buffered writer of text on a file
+//
+// The text is formatted by hand in a buffer, without going through the
+// format parsing of printf, and the buffer is written at once when full. If
+// the file has a descriptor, the buffer is written with write, bypassing the
+// buffer of the file, and a string too long for the buffer is written along
+// with it by a single writev. Otherwise (e.g. a memory stream), the buffer
+// is given to fwrite.
+struct Writer {
+  // The file on which the text is written
+  FILE* file;
+  // The descriptor of the file (-1 if it has none)
+  int fd;
+  // The number of bytes in the buffer
+  size_t size;
+  // The buffer
+  char* buffer;
+};
+
+// Construction
+// ------------
+
+/**
+ * Starts writing on a file
+ *
+ * The file is flushed first, so that the text written by the writer follows
+ * the text already written on the file. The file must not be used directly
+ * until the writer is closed.
+ *
+ * @param writer  The writer to open
+ * @param file    The file
+ */
+void open_writer(struct Writer* writer, FILE* file);
+
+/**
+ * Writes the buffered text and releases the buffer of a writer
+ *
+ * @param writer  The writer
+ */
+void close_writer(struct Writer* writer);
+
+// Writing
+// -------
+
+/**
+ * Writes the buffered text of a writer on its file
+ *
+ * If the descriptor cannot be written, the text is handed to the file, so
+ * that its error indicator reports the failure when it is flushed.
+ *
+ * @param writer  The writer
+ */
+void flush_writer(struct Writer* writer);
+
+/**
+ * Writes bytes
+ *
+ * @param writer  The writer
+ * @param data    The bytes
+ * @param length  The number of bytes
+ */
+void write_bytes(struct Writer* writer, const char* data, size_t length);
+
+/**
+ * Writes a null-terminated string
+ *
+ * @param writer  The writer
+ * @param s       The string
+ */
+void write_string(struct Writer* writer, const char* s);
+
+/**
+ * Writes a character
+ *
+ * @param writer  The writer
+ * @param c       The character
+ */
+void write_char(struct Writer* writer, char c);
+
+/**
+ * Writes an integer in decimal, as printf("%d") would
+ *
+ * @param writer  The writer
+ * @param value   The integer
+ */
+void write_int(struct Writer* writer, int value);
+
+/**
+ * Writes a 64-bit integer in decimal, as printf("%lld") would
+ *
+ * @param writer  The writer
+ * @param value   The integer
+ */
+void write_long(struct Writer* writer, long long value);
+
+/**
+ * Writes an unsigned integer in decimal, as printf("%u") would
+ *
+ * @param writer  The writer
+ * @param value   The integer
+ */
+void write_unsigned(struct Writer* writer, unsigned int value);
+
+#endif